@@ -0,0 +1,117 @@
+/******************************************************************************/
+/*!
+\file		BallHash.h
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 5, 2023
+\brief
+	Spatial hash over the balls, for "which balls are in here" queries
+	(picking, culling, neighbours) without going over every ball.
+	The balls are filed by the cell holding their center, on an unbounded
+	grid; the cells are hashed into a table about twice as big as the
+	number of balls, so only the occupied cells cost memory. The balls move
+	every step, so the table is rebuilt every step with a counting sort,
+	which is linear in the number of balls.
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef CSD1130_BALL_HASH_H_
+#define CSD1130_BALL_HASH_H_
+
+
+/******************************************************************************/
+/*!
+	One filed ball: a copy of it, so the queries read the balls of a cell in
+	memory order. A slot can be shared by several cells, so each entry keeps
+	its cell
+ */
+/******************************************************************************/
+template <typename T>
+struct BallHashEntryT
+{
+	T				m_x;
+	T				m_y;
+	T				m_radius;
+	int				m_cellX;
+	int				m_cellY;
+	unsigned int	m_ball;				// index of the ball
+};
+
+/******************************************************************************/
+/*!
+	Slot s holds m_entries[m_slotStart[s], m_slotStart[s + 1])
+ */
+/******************************************************************************/
+template <typename T>
+struct BallHashT
+{
+	T					m_cellSize;
+	T					m_maxRadius;		// biggest ball radius, region queries are grown by it
+
+	unsigned int		m_tableSize;		// number of slots, a power of 2
+	unsigned int		*m_slotStart;		// m_tableSize + 1 entries
+
+	BallHashEntryT<T>	*m_entries;			// sorted by slot
+	unsigned int		m_num;
+
+	// occupied cells, the searches stop at their edge
+	int					m_minCellX;
+	int					m_minCellY;
+	int					m_maxCellX;
+	int					m_maxCellY;
+
+	unsigned int		*m_slotOf;			// slot of each ball, used while building
+};
+
+typedef BallHashT<float>			BallHash;
+typedef BallHashT<double>			BallHashd;
+typedef BallHashT<CSD1130::Fixed>	BallHashx;
+
+// Allocates a table for ballNum balls (empty until BuildBallHash)
+template <typename T>
+void InitBallHash(BallHashT<T> &hash,										//Hash - output
+				unsigned int ballNum,											//Number of balls - input
+				T cellSize);													//Cell side, about a ball diameter - input
+
+// Releases what InitBallHash allocated
+template <typename T>
+void FreeBallHash(BallHashT<T> &hash);										//Hash - input/output
+
+// Files the balls (as many as given to InitBallHash) by cell
+template <typename T>
+void BuildBallHash(BallHashT<T> &hash,										//Hash - input/output
+					const CircleT<T> *pBalls);									//Balls - input
+
+// Balls touching the box [boxMin, boxMax]. Returns how many there are,
+// only the first outMax are written to pOut (in no particular order)
+template <typename T>
+unsigned int QueryBallHashRegion(const BallHashT<T> &hash,					//Hash - input
+								const CSD1130::Vector2DT<T> &boxMin,			//Box bottom left - input
+								const CSD1130::Vector2DT<T> &boxMax,			//Box top right - input
+								unsigned int *pOut,								//Ball indices - output
+								unsigned int outMax);							//Room in pOut - input
+
+// Balls touching the circle (center, radius). Returns how many there are,
+// only the first outMax are written to pOut (in no particular order)
+template <typename T>
+unsigned int QueryBallHashRadius(const BallHashT<T> &hash,					//Hash - input
+								const CSD1130::Vector2DT<T> &center,			//Circle center - input
+								T radius,										//Circle radius - input
+								unsigned int *pOut,								//Ball indices - output
+								unsigned int outMax);							//Room in pOut - input
+
+// The k balls with their center closest to pt, closest first. Returns how
+// many were found (k, unless there are fewer balls)
+template <typename T>
+unsigned int QueryBallHashNearest(const BallHashT<T> &hash,					//Hash - input
+								const CSD1130::Vector2DT<T> &pt,				//Point - input
+								unsigned int k,									//Number of balls wanted - input
+								unsigned int *pOut,								//Ball indices - output
+								T *pDistSq);									//Their squared distance to pt - output
+
+
+#endif // CSD1130_BALL_HASH_H_
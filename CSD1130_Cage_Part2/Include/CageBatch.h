@@ -0,0 +1,65 @@
+/******************************************************************************/
+/*!
+\file		CageBatch.h
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 23, 2023
+\brief
+	Steps many cages together. The worlds of a batch are handed out to a
+	pool of threads one at a time, each thread stepping a whole world, and
+	the balls of every world are written into two shared arrays (positions
+	and velocities) after the steps. The worlds share nothing, so the
+	output is the same whatever the number of threads.
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef CSD1130_CAGE_BATCH_H_
+#define CSD1130_CAGE_BATCH_H_
+
+
+// the threads, and what they share with the caller (CageBatch.cpp)
+struct CageBatchPool;
+
+/******************************************************************************/
+/*!
+	The balls of world w are m_pos[m_ballStart[w] + k] and m_vel[m_ballStart[w]
+	+ k], k the ball of the level (particles left out): the order of the
+	level, whatever order the world keeps them in (see m_ballId).
+	m_ballStart has m_worldNum + 1 entries, the last one the ball count of
+	the batch. The worlds are the caller's, built and freed by it
+ */
+/******************************************************************************/
+struct CageBatch
+{
+	CageWorld		*m_worlds;
+	unsigned int	m_worldNum;
+	unsigned int	*m_ballStart;
+
+	CSD1130::Vec2	*m_pos;
+	CSD1130::Vec2	*m_vel;
+
+	CageBatchPool	*m_pool;
+};
+
+// Sizes the output for the worlds, writes their balls there and starts
+// the threads (threadNum 0: one per hardware thread, the caller being one
+// of them)
+void InitCageBatch(CageBatch &batch,										//Batch - output
+					CageWorld *pWorlds,										//Worlds - input
+					unsigned int worldNum,									//Number of worlds - input
+					unsigned int threadNum);								//Threads stepping them - input
+
+// Steps every world stepNum times, then writes their balls to m_pos and
+// m_vel. Returns when all of them are done
+void StepCageBatch(CageBatch &batch,										//Batch - input/output
+					unsigned int stepNum);									//Steps of each world - input
+
+// Stops the threads and releases the output (not the worlds)
+void FreeCageBatch(CageBatch &batch);										//Batch - input/output
+
+
+#endif // CSD1130_CAGE_BATCH_H_
@@ -0,0 +1,150 @@
+/******************************************************************************/
+/*!
+\file		CageShard.h
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 25, 2023
+\brief
+	One cage split across processes. The cage is cut into vertical strips,
+	as many balls in each at the start, and each strip is a shard: a
+	process with a world of the whole cage (the walls) but only the balls
+	it owns, those in its strip, and ghosts of the balls of the next strips
+	close enough to touch them this step.
+	The shards step together, in shared memory. After a step, a shard
+	exports the balls it owns within the halo of its edges (or past them);
+	once every shard has, each one takes from its neighbours the balls now
+	in its strip (those migrate) and the ones in its halo (ghosts), and
+	drops its own that went to a neighbour. Where a ball is says who owns
+	it, so no ball is ever owned twice or not at all.
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef CSD1130_CAGE_SHARD_H_
+#define CSD1130_CAGE_SHARD_H_
+
+#include <atomic>
+
+
+const unsigned int	SHARD_NUM_MAX		= 64;
+const float			SHARD_TIMEOUT		= 10.0f;		// seconds a shard waits for the others at a step
+
+/******************************************************************************/
+/*!
+	Shared memory of the shards: the header, the ShardStats of each shard,
+	two export buffers per shard (even and odd steps), then the position
+	and velocity of every ball of the level (m_ballNum, particles left out),
+	written by its owner each step. Shard s is the strip [m_cut[s],
+	m_cut[s + 1])
+ */
+/******************************************************************************/
+struct ShardSpaceHeader
+{
+	char						m_tag[4];			// "CSHD", written last
+	unsigned int				m_version;
+	unsigned int				m_shardNum;
+	unsigned int				m_ballNum;
+	float						m_halo;				// reach of the ghosts past an edge
+	float						m_dt;				// step of every shard
+	float						m_cut[SHARD_NUM_MAX + 1];
+	float						m_timeout;			// seconds at the barrier before giving up (SHARD_TIMEOUT)
+
+	std::atomic<unsigned int>	m_arrived;			// shards at the barrier
+	std::atomic<unsigned int>	m_round;			// barriers passed
+	std::atomic<unsigned int>	m_failed;			// a shard gave up waiting: the others stop too
+};
+
+struct ShardStats
+{
+	unsigned int				m_owned;
+	unsigned int				m_ghostNum;
+	unsigned int				m_migrateNum;		// balls taken from the neighbours so far
+	unsigned int				m_strayNum;			// balls kept that went past the next strip (m_halo too short)
+	double						m_stepTime;			// seconds stepping the world, so far
+	double						m_waitTime;			// seconds at the barrier, so far
+};
+
+// balls of a shard within the halo of its edges, after a step
+struct ShardExport
+{
+	unsigned int				m_num;
+	unsigned int				m_pad;
+	CageWorldBall				m_balls[1];			// m_ballNum of the space
+};
+
+/******************************************************************************/
+/*!
+	The shared memory, as one process maps it
+ */
+/******************************************************************************/
+struct ShardSpace
+{
+	ShardSpaceHeader			*m_header;
+	ShardStats					*m_stats;
+	unsigned char				*m_exports;
+	size_t						m_exportBytes;		// of one export buffer
+	CSD1130::Vec2				*m_pos;				// by ball of the level
+	CSD1130::Vec2				*m_vel;
+
+	size_t						m_bytes;
+	void						*m_handle;
+	char						m_name[64];
+	bool						m_creator;			// removes the name when done
+};
+
+/******************************************************************************/
+/*!
+	The part of the cage one process steps. m_owned[k] is 1 if the shard
+	owns ball k of the level; m_balls holds the balls of the next step
+	(owned and ghosts) while they are put together
+ */
+/******************************************************************************/
+struct CageShard
+{
+	ShardSpace					*m_space;
+	unsigned int				m_index;
+	CageWorld					m_world;
+	unsigned char				*m_owned;
+	CageWorldBall				*m_balls;
+	unsigned int				m_ghostNum;
+	unsigned int				m_step;
+};
+
+// Creates the shared memory for shardNum shards of the level, stepping by
+// dt, with the cuts between the strips. Returns false if it can't
+bool CreateShardSpace(ShardSpace &space,									//Space - output
+						const char *name,									//Name of the shared memory - input
+						const CageLevel &level,								//Level - input
+						unsigned int shardNum,								//Number of shards - input
+						float dt);											//Step - input
+
+// Maps the shared memory made by CreateShardSpace, in a shard process.
+// Returns false if there is none of that name
+bool OpenShardSpace(ShardSpace &space,										//Space - output
+					const char *name);										//Name of the shared memory - input
+
+// Unmaps the shared memory (and takes the name away, for its creator)
+void FreeShardSpace(ShardSpace &space);										//Space - input/output
+
+// Builds the world of shard index out of the level the space was made
+// for. The shard with index 0 also steps the particles
+void BuildCageShard(CageShard &shard,										//Shard - output
+					ShardSpace &space,										//Space - input
+					const CageLevel &level,									//Level - input
+					unsigned int index,										//Shard - input
+					int extraCredits);										//Collision policy - input
+
+// Steps the shard and trades balls with its neighbours. Every shard of the
+// space has to step: it waits for the others, m_timeout seconds at most.
+// Returns false if one didn't get there in time (it hung or died), or gave
+// up itself: the space is no good anymore, every shard stops
+bool StepCageShard(CageShard &shard);										//Shard - input/output
+
+// Releases what BuildCageShard allocated
+void FreeCageShard(CageShard &shard);										//Shard - input/output
+
+
+#endif // CSD1130_CAGE_SHARD_H_
@@ -0,0 +1,294 @@
+/******************************************************************************/
+/*!
+\file		CageWorld.h
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 23, 2023
+\brief
+	The simulation of one cage, on its own: the balls, the walls and
+	everything built over them live in a CageWorld instead of in file
+	globals, so a process can hold as many cages as it needs (parameter
+	sweeps, training data) and step each of them on any thread. Nothing in
+	here draws or reads input; the game state keeps one world and draws it.
+	A level is read into a CageLevel (or filled in by hand), then built
+	into a world in the simulation mode asked for.
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef CSD1130_CAGE_WORLD_H_
+#define CSD1130_CAGE_WORLD_H_
+
+
+/******************************************************************************/
+/*!
+	A level as its file has it. A ball with a zero radius is a tracer
+	particle. Wall i goes from m_wallPts[2 * i] to m_wallPts[2 * i + 1].
+	Room r has the walls m_roomWalls[m_roomWallStart[r], m_roomWallStart[r
+	+ 1]), indices of walls of the level (m_wallNum for none)
+ */
+/******************************************************************************/
+struct CageLevelBall
+{
+	CSD1130::Vec2	m_pos;
+	float			m_dir;				// degree
+	float			m_speed;
+	float			m_radius;
+};
+
+struct CageLevelArc
+{
+	CSD1130::Vec2	m_pos;
+	float			m_radius;
+	float			m_angle0;			// degree, counter clockwise from m_angle0 to m_angle1
+	float			m_angle1;
+};
+
+// a kinematic wall at rest, turning about m_pivot (degree per second) while
+// m_pivot goes at m_pivotVel for m_period seconds one way (0: no turning back)
+struct CageLevelKinematic
+{
+	CSD1130::Vec2	m_pt0;
+	CSD1130::Vec2	m_pt1;
+	CSD1130::Vec2	m_pivot;
+	CSD1130::Vec2	m_pivotVel;
+	float			m_spin;
+	float			m_period;
+};
+
+struct CageLevel
+{
+	CageLevelBall		*m_balls;
+	unsigned int		m_ballNum;
+	CSD1130::Vec2		*m_wallPts;
+	unsigned int		m_wallNum;
+	CageLevelArc		*m_arcs;
+	unsigned int		m_arcNum;
+	Circle				*m_pillars;
+	unsigned int		m_pillarNum;
+
+	CSD1130::Vec2		*m_roomMin;
+	CSD1130::Vec2		*m_roomMax;
+	unsigned int		*m_roomWallStart;
+	unsigned int		*m_roomWalls;
+	unsigned int		m_roomNum;
+	Portal				*m_portals;
+	unsigned int		m_portalNum;
+
+	CageLevelKinematic	*m_kinematic;
+	unsigned int		m_kinematicNum;
+
+	std::string			m_packPath;			// empty: no wall pack
+	unsigned int		m_packBudget;		// KB
+};
+
+// a ball handed to a world from outside (see ReplaceCageWorldBalls)
+struct CageWorldBall
+{
+	unsigned int	m_id;				// ball of the level
+	Circle			m_ball;
+	CSD1130::Vec2	m_vel;
+	float			m_speed;
+};
+
+// earliest wall hit of a ball over the tiles, and where the ball goes from
+template <typename T>
+struct WallHitT
+{
+	CircleT<T>				m_sweep;		// ball at the start of what is left of its step
+	CSD1130::Vector2DT<T>	m_interPt;
+	CSD1130::Vector2DT<T>	m_normal;
+	T						m_time;
+	bool					m_hit;
+};
+
+/******************************************************************************/
+/*!
+	Simulation state of one cage. The ball arrays are indexed the same way
+	(m_ballData, m_ballVel, ...), and m_ballId[i] is the ball of the level
+	(particles left out) that ball i is: the balls get renumbered when they
+	are sorted (m_ballSort), m_ballNewIndex says where each went and
+	m_sorted is true for the step that did it.
+	The fixed-point copy (X) is only there with m_fixedPoint, the float
+	state is then written back from it every step. m_ballCollisions,
+	m_eventDriven, m_tiledWalls, m_ballSort and m_dt can be changed between
+	steps
+ */
+/******************************************************************************/
+struct CageWorld
+{
+	int					m_fixedPoint;		// see FIXED_POINT_SIM
+	int					m_ballCollisions;	// see BALL_COLLISIONS
+	int					m_eventDriven;		// see EVENT_DRIVEN_SIM
+	int					m_tiledWalls;		// see TILED_WALLS
+	int					m_ballSort;			// see BALL_SORT
+	float				m_dt;				// step of the float simulation
+
+	Circle				*m_ballData;
+	LineSegment			*m_wallData;
+	unsigned int		m_ballNum;
+	unsigned int		m_wallNum;
+	unsigned int		*m_ballId;
+
+	// m_wallData is grouped by LINE_CLASS: class c is [m_wallClassStart[c], m_wallClassStart[c + 1])
+	unsigned int		m_wallClassStart[(int)LINE_CLASS::LINE_CLASS_NUM + 1];
+
+	// walls expanded by each distinct ball radius: m_wallBands[m_ballBand[i] * m_wallNum + w]
+	// is wall w as seen by ball i (m_ballBand[i] == BAND_NONE: past BAND_RADIUS_MAX radii)
+	LineSegmentBand		*m_wallBands;
+	unsigned int		*m_ballBand;
+	float				*m_bandRadius;		// radius of each band
+	unsigned int		m_bandNum;
+
+	// wall end points merged into unique vertices, so a corner is tested once and not once per wall
+	LineVertex			*m_wallVertices;
+	unsigned int		m_wallVertexNum;
+
+	// round walls, one test each instead of one per chord
+	Arc					*m_arcData;
+	unsigned int		m_arcNum;
+
+	// static circles, filed in a grid
+	PillarGrid			m_pillarGrid;
+
+	// rooms joined by portals (optional), the room of each ball (ROOM_NONE: tested
+	// against every wall), and the walls and vertices of the rooms a ball is tested in
+	RoomSet				m_rooms;
+	unsigned int		*m_ballRoom;
+	unsigned int		*m_roomWalls;
+	unsigned int		*m_roomVertices;
+	unsigned int		m_roomClassStart[(int)LINE_CLASS::LINE_CLASS_NUM + 1];
+
+	// walls moved by a script
+	KinematicWallSet	m_kinematicWalls;
+	unsigned int		*m_kinematicQuery;	// output of the queries, room for every kinematic wall
+
+	// walls of the level pack, read in tile by tile around the balls
+	WallStream			m_wallStream;
+
+	// distance to all of the above, sampled at load
+	DistanceField		m_cageField;
+
+	CSD1130::Vec2		*m_ballVel;
+	float				*m_ballSpeed;
+	CSD1130::Vec2		*m_ballNext;		// end of the step, collisions included
+
+	// how far each ball can go before it can touch the cage, and how far it went
+	// since that was worked out (sum of |dx| + |dy|, never less than the distance);
+	// the balls that can't reach it this step skip the cage tests
+	float				*m_ballClearance;
+	float				*m_ballTravel;
+	unsigned char		*m_ballNear;		// 1 if the ball was tested against the cage this step
+	unsigned int		m_ballNearNum;
+
+	// walls and vertices around each ball, kept from step to step; the cage tests
+	// that found their cache still good, out of the ones that looked
+	ContactCache		*m_contactCache;
+	unsigned int		m_cacheHitNum;
+	unsigned int		m_cacheLookupNum;
+
+	// tiled wall tests (m_tiledWalls == 1): the balls that can reach the cage, and
+	// the ones still moving after a bounce
+	unsigned int		*m_tileBalls;
+	unsigned int		*m_tileActive;
+	WallHitT<float>		*m_tileHits;
+
+	// event driven simulation: ball i goes in a straight line from m_ballAnchor[i], where
+	// it was at m_ballAnchorTime[i], until its next impact with the cage in m_ballEvents
+	EventQueue			m_ballEvents;
+	CSD1130::Vec2		*m_ballAnchor;
+	double				*m_ballAnchorTime;
+	double				m_eventClock;		// simulation time, in seconds
+	bool				m_eventsOn;			// the anchors and the queue are up to date
+	unsigned int		m_eventNum;			// balls stepped last step
+
+	// bounces of each ball in the event driven simulation, and the balls on an orbit
+	OrbitSet			m_orbits;
+	unsigned int		m_orbitNum;
+	SweepAndPrune		m_ballSap;			// ball/ball broadphase, keeps its order between steps
+
+	// Z-order of the balls (m_ballSort == 1), and where each ball went in the last sort
+	MortonEntry			*m_ballOrder;
+	unsigned int		*m_ballNewIndex;
+	unsigned int		m_ballSortClock;
+	bool				m_sorted;
+	CSD1130::Vec2		m_ballSortMin;		// square the keys are taken on: the cage, the wall pack
+	float				m_ballSortSide;		// and the balls at load
+
+	// zero radius balls, stepped as points against the walls
+	ParticleSet			m_particles;
+
+	// fixed-point copy of the simulation state, indexed like m_ballData/m_wallData
+	Circlex				*m_ballDataX;
+	CSD1130::Vec2x		*m_ballVelX;
+	CSD1130::Fixed		*m_ballSpeedX;
+	CSD1130::Vec2x		*m_ballNextX;
+	CSD1130::Fixed		*m_ballClearanceX;
+	CSD1130::Fixed		*m_ballTravelX;
+	ContactCachex		*m_contactCacheX;
+	WallHitT<CSD1130::Fixed>	*m_tileHitsX;
+	SweepAndPrunex		m_ballSapX;
+	ParticleSetx		m_particlesX;
+
+	LineSegmentx		*m_wallDataX;
+	LineVertexx			*m_wallVerticesX;
+	unsigned int		m_wallVertexNumX;
+	Arcx				*m_arcDataX;
+	PillarGridx			m_pillarGridX;
+	RoomSetx			m_roomsX;
+	KinematicWallSetx	m_kinematicWallsX;
+	WallStreamx			m_wallStreamX;
+	DistanceFieldx		m_cageFieldX;
+	LineSegmentBandx	*m_wallBandsX;
+
+	unsigned long long	m_simChecksum;		// running hash of the fixed-point state, for replay comparisons
+
+	// step for the simulation mode and collision policy, picked once in BuildCageWorld
+	void				(*m_updateBalls)(CageWorld &);
+
+	// same for the event driven simulation: runs it up to a time
+	void				(*m_advanceBallEvents)(CageWorld &, double);
+};
+
+// Reads a level file (the sections after the walls are optional). Returns
+// false, with the level left empty, if the file can't be opened or is
+// malformed (bad counts, cut short, negative radii, walls without length)
+bool ReadCageLevel(CageLevel &level,										//Level - output
+					const char *path);										//Level file - input
+
+// Releases what ReadCageLevel allocated and empties the level
+void FreeCageLevel(CageLevel &level);										//Level - input/output
+
+// Builds the world out of the level, with the collision policy of
+// extraCredits (see EXTRA_CREDITS), in fixed point if fixedPoint is 1. The
+// world starts with the ball collisions on, the other options off
+void BuildCageWorld(CageWorld &world,										//World - output
+					const CageLevel &level,									//Level - input
+					int extraCredits,										//Collision policy - input
+					int fixedPoint);										//Fixed-point simulation - input
+
+// Releases what BuildCageWorld allocated and empties the world
+void FreeCageWorld(CageWorld &world);										//World - input/output
+
+// Steps the world by m_dt (FIXED_DT in fixed point)
+void StepCageWorld(CageWorld &world);										//World - input/output
+
+// Replaces the balls of a float world (not its particles), in the order
+// given: what the world knows of a ball it already has where it is now is
+// kept, the others start afresh. The event driven simulation restarts.
+// Given the balls it has (its ghosts moved, say), the world keeps its
+// order and its arrays, and only sets again the balls that changed
+void ReplaceCageWorldBalls(CageWorld &world,								//World - input/output
+							const CageWorldBall *pBalls,					//Balls - input
+							unsigned int ballNum);							//Number of balls - input
+
+// With the event driven simulation running, goes straight to seconds
+// later: only the impacts on the way cost anything
+void SkipCageWorldTime(CageWorld &world,									//World - input/output
+						double seconds);									//Time skipped - input
+
+
+#endif // CSD1130_CAGE_WORLD_H_
@@ -18,56 +18,443 @@ prior written consent of DigiPen Institute of Technology is prohibited.
 
 /******************************************************************************/
 /*!
+	Line segment classes, decided once by BuildLineSegment. Axis aligned
+	segments have an exactly axis aligned normal, so their kernels only use
+	the non-zero component of the normal.
  */
 /******************************************************************************/
-struct LineSegment
+enum class LINE_CLASS
 {
-	CSD1130::Vec2	m_pt0;
-	CSD1130::Vec2	m_pt1;
-	CSD1130::Vec2	m_normal;
+	LINE_HORIZONTAL,	//0: normal is (0, +/-1)
+	LINE_VERTICAL,		//1: normal is (+/-1, 0)
+	LINE_GENERAL,		//2
+
+	LINE_CLASS_NUM
+};
+
+/******************************************************************************/
+/*!
+	T is the scalar type: float, double or Fixed (see Scalar.h)
+ */
+/******************************************************************************/
+template <typename T>
+struct LineSegmentT
+{
+	CSD1130::Vector2DT<T>	m_pt0;
+	CSD1130::Vector2DT<T>	m_pt1;
+	CSD1130::Vector2DT<T>	m_normal;
+	LINE_CLASS				m_class;
+};
+
+typedef LineSegmentT<float>		LineSegment;
+typedef LineSegmentT<double>	LineSegmentd;
+typedef LineSegmentT<CSD1130::Fixed>	LineSegmentx;
+
+template <typename T>
+void BuildLineSegment(LineSegmentT<T> &lineSegment,							//Line segment reference - input
+						const CSD1130::Vector2DT<T>& p0,							//Point P0 - input
+						const CSD1130::Vector2DT<T>& p1);							//Point P1 - input
+
+/******************************************************************************/
+/*!
+	A line segment as seen by balls of one radius R: the two lines the ball
+	center crosses when it touches the segment, on each side of it. Built
+	once per wall and ball radius, so the test is left with a moving point
+	against these lines.
+ */
+/******************************************************************************/
+template <typename T>
+struct LineSegmentBandT
+{
+	T						m_NP0;			// n.P0
+	CSD1130::Vector2DT<T>	m_pt0Back;		// P0 - R * n, touching from behind the normal
+	CSD1130::Vector2DT<T>	m_pt1Back;		// P1 - R * n
+	CSD1130::Vector2DT<T>	m_pt0Front;		// P0 + R * n, touching from in front of it
+	CSD1130::Vector2DT<T>	m_pt1Front;		// P1 + R * n
+};
+
+typedef LineSegmentBandT<float>				LineSegmentBand;
+typedef LineSegmentBandT<double>			LineSegmentBandd;
+typedef LineSegmentBandT<CSD1130::Fixed>	LineSegmentBandx;
+
+// C as for CollisionIntersection_CircleLineSegment: lineSeg has to be of that class
+template <typename T, LINE_CLASS C = LINE_CLASS::LINE_GENERAL>
+void BuildLineSegmentBand(LineSegmentBandT<T> &band,						//Band - output
+						const LineSegmentT<T> &lineSeg,							//Line segment - input
+						T radius);												//Ball radius - input
+
+/******************************************************************************/
+/*!
+	End point shared by one or more line segments (a polygon/polyline vertex).
+	m_normal holds the normals of the segments meeting there, so a vertex is
+	only tested when the circle moves toward the front of one of them.
+	m_normalNum == 0 means too many segments meet there: always test.
+ */
+/******************************************************************************/
+const unsigned int LINE_VERTEX_NORMAL_MAX = 4;
+
+template <typename T>
+struct LineVertexT
+{
+	CSD1130::Vector2DT<T>	m_pt;
+	CSD1130::Vector2DT<T>	m_normal[LINE_VERTEX_NORMAL_MAX];
+	unsigned int			m_normalNum;
+};
+
+typedef LineVertexT<float>			LineVertex;
+typedef LineVertexT<double>			LineVertexd;
+typedef LineVertexT<CSD1130::Fixed>	LineVertexx;
+
+// Merges identical end points of the line segments into unique vertices.
+// pVertices must hold 2 * lineNum entries, returns the number of vertices written.
+template <typename T>
+unsigned int BuildLineVertices(const LineSegmentT<T> *pLines,					//Line segments - input
+								unsigned int lineNum,							//Number of line segments - input
+								LineVertexT<T> *pVertices);						//Unique end points - output
+
+/******************************************************************************/
+/*!
+	How much of the circle an arc covers, decided once by BuildArc
+ */
+/******************************************************************************/
+enum class ARC_SPAN
+{
+	ARC_MINOR,			//0: up to 180 degrees
+	ARC_MAJOR,			//1: more than 180 degrees
+	ARC_FULL,			//2: the whole circle (round cage)
+
+	ARC_SPAN_NUM
+};
+
+/******************************************************************************/
+/*!
+	Circular wall going counter clockwise from m_dir0 to m_dir1 (unit
+	vectors from m_center). Like a line segment it is one sided: balls
+	collide with it from the inside (the side of the center). Its end points
+	are not tested, join partial arcs to walls whose end points are.
+ */
+/******************************************************************************/
+template <typename T>
+struct ArcT
+{
+	CSD1130::Vector2DT<T>	m_center;
+	T						m_radius;
+	CSD1130::Vector2DT<T>	m_dir0;
+	CSD1130::Vector2DT<T>	m_dir1;
+	ARC_SPAN				m_span;
+};
+
+typedef ArcT<float>				Arc;
+typedef ArcT<double>			Arcd;
+typedef ArcT<CSD1130::Fixed>	Arcx;
+
+// angle0 and angle1 in radian, counter clockwise; angle1 - angle0 >= 2 PI gives a full circle
+template <typename T>
+void BuildArc(ArcT<T> &arc,													//Arc reference - output
+				const CSD1130::Vector2DT<T> &center,							//Center - input
+				T radius,														//Radius - input
+				T angle0,														//Start angle - input
+				T angle1);														//End angle - input
+
+/******************************************************************************/
+/*!
+ */
+/******************************************************************************/
+template <typename T>
+struct CircleT
+{
+	CSD1130::Vector2DT<T>  m_center;
+	T	m_radius;
+};
+
+typedef CircleT<float>			Circle;
+typedef CircleT<double>			Circled;
+typedef CircleT<CSD1130::Fixed>	Circlex;
+
+/******************************************************************************/
+/*!
+	Static circles (pillars) stored as one array per member, so the batched
+	kernel can load several of them at once
+ */
+/******************************************************************************/
+template <typename T>
+struct CircleSetT
+{
+	T				*m_x;
+	T				*m_y;
+	T				*m_radius;
+	unsigned int	m_num;
+};
+
+typedef CircleSetT<float>			CircleSet;
+typedef CircleSetT<double>			CircleSetd;
+typedef CircleSetT<CSD1130::Fixed>	CircleSetx;
+
+
+/******************************************************************************/
+/*!
+	Dot product of any vector with the normal of a line segment of class C,
+	and a point moved along or against that normal by a distance.
+	Specialised for the axis aligned classes (the other component of their
+	normal is exactly 0, so the result is the same).
+ */
+/******************************************************************************/
+template <LINE_CLASS C>
+struct LineNormal
+{
+	template <typename T>
+	static T Dot(const CSD1130::Vector2DT<T> &v, const CSD1130::Vector2DT<T> &normal)
+	{
+		return CSD1130::Vector2DDotProduct(v, normal);
+	}
+
+	template <typename T>
+	static CSD1130::Vector2DT<T> Along(const CSD1130::Vector2DT<T> &pt, T dist, const CSD1130::Vector2DT<T> &normal)
+	{
+		return pt + dist * normal;
+	}
+
+	template <typename T>
+	static CSD1130::Vector2DT<T> Against(const CSD1130::Vector2DT<T> &pt, T dist, const CSD1130::Vector2DT<T> &normal)
+	{
+		return pt - dist * normal;
+	}
+};
+
+template <>
+struct LineNormal<LINE_CLASS::LINE_HORIZONTAL>
+{
+	template <typename T>
+	static T Dot(const CSD1130::Vector2DT<T> &v, const CSD1130::Vector2DT<T> &normal)
+	{
+		return v.y * normal.y;
+	}
+
+	template <typename T>
+	static CSD1130::Vector2DT<T> Along(const CSD1130::Vector2DT<T> &pt, T dist, const CSD1130::Vector2DT<T> &normal)
+	{
+		return CSD1130::Vector2DT<T>{ pt.x, pt.y + dist * normal.y };
+	}
+
+	template <typename T>
+	static CSD1130::Vector2DT<T> Against(const CSD1130::Vector2DT<T> &pt, T dist, const CSD1130::Vector2DT<T> &normal)
+	{
+		return CSD1130::Vector2DT<T>{ pt.x, pt.y - dist * normal.y };
+	}
+};
+
+template <>
+struct LineNormal<LINE_CLASS::LINE_VERTICAL>
+{
+	template <typename T>
+	static T Dot(const CSD1130::Vector2DT<T> &v, const CSD1130::Vector2DT<T> &normal)
+	{
+		return v.x * normal.x;
+	}
+
+	template <typename T>
+	static CSD1130::Vector2DT<T> Along(const CSD1130::Vector2DT<T> &pt, T dist, const CSD1130::Vector2DT<T> &normal)
+	{
+		return CSD1130::Vector2DT<T>{ pt.x + dist * normal.x, pt.y };
+	}
+
+	template <typename T>
+	static CSD1130::Vector2DT<T> Against(const CSD1130::Vector2DT<T> &pt, T dist, const CSD1130::Vector2DT<T> &normal)
+	{
+		return CSD1130::Vector2DT<T>{ pt.x - dist * normal.x, pt.y };
+	}
 };
 
-void BuildLineSegment(LineSegment &lineSegment,								//Line segment reference - input
-						const CSD1130::Vec2& p0,									//Point P0 - input
-						const CSD1130::Vec2& p1);									//Point P1 - input
 
 /******************************************************************************/
 /*!
+	Collision policies, chosen at compile time so the kernels carry no
+	mode branches
  */
 /******************************************************************************/
-struct Circle
+enum class COLLISION_POLICY
 {
-	CSD1130::Vec2  m_center;
-	float	m_radius;
+	POLICY_SEGMENT_ONLY,		//0: original, line segment body only
+	POLICY_SEGMENT_AND_EDGES,	//1: Extra Credits: also collide with the line segment end points
+
+	POLICY_NUM
 };
 
 
 // INTERSECTION FUNCTIONS
-int CollisionIntersection_CircleLineSegment(const Circle &circle,			//Circle data - input
-	const CSD1130::Vec2 &ptEnd,													//End circle position - input
-	const LineSegment &lineSeg,												//Line segment - input
-	CSD1130::Vec2 &interPt,														//Intersection point - output
-	CSD1130::Vec2 &normalAtCollision,												//Normal vector at collision time - output
-	float &interTime,														//Intersection time ti - output
-	bool & checkLineEdges);													//The last parameter is for Extra Credits: when true => check collision with line segment edges
+// C selects the kernel for the class of lineSeg, the caller must only pass segments of that class
+// P selects whether the line segment edges are checked (Extra Credits)
+template <typename T,
+		LINE_CLASS C = LINE_CLASS::LINE_GENERAL,
+		COLLISION_POLICY P = COLLISION_POLICY::POLICY_SEGMENT_AND_EDGES>
+int CollisionIntersection_CircleLineSegment(const CircleT<T> &circle,		//Circle data - input
+	const CSD1130::Vector2DT<T> &ptEnd,											//End circle position - input
+	const LineSegmentT<T> &lineSeg,												//Line segment - input
+	CSD1130::Vector2DT<T> &interPt,												//Intersection point - output
+	CSD1130::Vector2DT<T> &normalAtCollision,									//Normal vector at collision time - output
+	T &interTime);																//Intersection time ti - output
+
+// Same, with the segment already expanded by the circle radius (band built with circle.m_radius)
+template <typename T,
+		LINE_CLASS C = LINE_CLASS::LINE_GENERAL,
+		COLLISION_POLICY P = COLLISION_POLICY::POLICY_SEGMENT_AND_EDGES>
+int CollisionIntersection_CircleLineSegment(const CircleT<T> &circle,		//Circle data - input
+	const CSD1130::Vector2DT<T> &ptEnd,											//End circle position - input
+	const LineSegmentT<T> &lineSeg,												//Line segment - input
+	const LineSegmentBandT<T> &band,											//Line segment expanded by the circle radius - input
+	CSD1130::Vector2DT<T> &interPt,												//Intersection point - output
+	CSD1130::Vector2DT<T> &normalAtCollision,									//Normal vector at collision time - output
+	T &interTime);																//Intersection time ti - output
+
+// Runtime selected policy, for callers outside of the update loop
+template <typename T>
+int CollisionIntersection_CircleLineSegment(const CircleT<T> &circle,		//Circle data - input
+	const CSD1130::Vector2DT<T> &ptEnd,											//End circle position - input
+	const LineSegmentT<T> &lineSeg,												//Line segment - input
+	CSD1130::Vector2DT<T> &interPt,												//Intersection point - output
+	CSD1130::Vector2DT<T> &normalAtCollision,									//Normal vector at collision time - output
+	T &interTime,																//Intersection time ti - output
+	bool checkLineEdges);													//The last parameter is for Extra Credits: when true => check collision with line segment edges
+
+
+
+// Moving point (zero radius circle) against the front of a line segment (the side its
+// normal points to): a plain segment/segment intersection, no square root
+template <typename T>
+int CollisionIntersection_PointLineSegment(const CSD1130::Vector2DT<T> &ptStart,	//Start point position - input
+	const CSD1130::Vector2DT<T> &ptEnd,											//End point position - input
+	const LineSegmentT<T> &lineSeg,												//Line segment - input
+	T &interTime);																//Intersection time ti - output
+
+
+
+// Squared distance from a point to the closest point of a line segment
+template <typename T>
+T DistanceSquared_PointLineSegment(const CSD1130::Vector2DT<T> &pt,			//Point - input
+	const LineSegmentT<T> &lineSeg);											//Line segment - input
+
+// Moving point against a circle, from either side: first time it is on it
+template <typename T>
+int CollisionIntersection_PointCircle(const CSD1130::Vector2DT<T> &ptStart,	//Start point position - input
+	const CSD1130::Vector2DT<T> &ptEnd,											//End point position - input
+	const CSD1130::Vector2DT<T> &center,										//Circle center - input
+	T radius,																	//Circle radius - input
+	T &interTime);																//Intersection time ti - output
+
+// Moving point against a line segment grown by radius on every side (both
+// sides and both ends): first time it gets that close, 0 if it already is
+template <typename T>
+int CollisionIntersection_PointCapsule(const CSD1130::Vector2DT<T> &ptStart,	//Start point position - input
+	const CSD1130::Vector2DT<T> &ptEnd,											//End point position - input
+	const LineSegmentT<T> &lineSeg,												//Line segment - input
+	T radius,																	//Distance to the segment - input
+	T &interTime);																//Intersection time ti - output
 
 
 
 // For Extra Credits
+template <typename T>
 int CheckMovingCircleToLineEdge(bool withinBothLines,						//Flag stating that the circle is starting from between 2 imaginary line segments distant +/- Radius respectively - input
-	const Circle &circle,													//Circle data - input
-	const CSD1130::Vec2 &ptEnd,													//End circle position - input
-	const LineSegment &lineSeg,												//Line segment - input
-	CSD1130::Vec2 &interPt,														//Intersection point - output
-	CSD1130::Vec2 &normalAtCollision,												//Normal vector at collision time - output
-	float &interTime);														//Intersection time ti - output
+	const CircleT<T> &circle,												//Circle data - input
+	const CSD1130::Vector2DT<T> &ptEnd,											//End circle position - input
+	const LineSegmentT<T> &lineSeg,												//Line segment - input
+	CSD1130::Vector2DT<T> &interPt,												//Intersection point - output
+	CSD1130::Vector2DT<T> &normalAtCollision,									//Normal vector at collision time - output
+	T &interTime);															//Intersection time ti - output
+
+
+
+// Moving circle against a static point (line segment end point / polygon vertex)
+template <typename T>
+int CollisionIntersection_CirclePoint(const CircleT<T> &circle,				//Circle data - input
+	const CSD1130::Vector2DT<T> &ptEnd,											//End circle position - input
+	const CSD1130::Vector2DT<T> &pt,											//Point - input
+	CSD1130::Vector2DT<T> &interPt,												//Intersection point - output
+	CSD1130::Vector2DT<T> &normalAtCollision,									//Normal vector at collision time - output
+	T &interTime);																//Intersection time ti - output
+
+// Sweeps the moving circle over pVertices[first, vertexNum), skipping the vertices it
+// does not move toward, and returns the index of the first one hit (vertexNum if none)
+template <typename T>
+unsigned int CollisionIntersection_CircleVertices(const CircleT<T> &circle,	//Circle data - input
+	const CSD1130::Vector2DT<T> &ptEnd,											//End circle position - input
+	const CSD1130::Vector2DT<T> &velCurr,										//Circle velocity - input
+	const LineVertexT<T> *pVertices,											//Vertices - input
+	unsigned int first,															//First vertex to test - input
+	unsigned int vertexNum,														//Number of vertices - input
+	CSD1130::Vector2DT<T> &interPt,												//Intersection point - output
+	CSD1130::Vector2DT<T> &normalAtCollision,									//Normal vector at collision time - output
+	T &interTime);																//Intersection time ti - output
+
+
+
+// Moving circle against a static circle
+template <typename T>
+int CollisionIntersection_CircleCircle(const CircleT<T> &circle,				//Circle data - input
+	const CSD1130::Vector2DT<T> &ptEnd,											//End circle position - input
+	const CircleT<T> &other,													//Static circle - input
+	CSD1130::Vector2DT<T> &interPt,												//Intersection point - output
+	CSD1130::Vector2DT<T> &normalAtCollision,									//Normal vector at collision time - output
+	T &interTime);																//Intersection time ti - output
+
+// Batched version over set[first, last) (4 at a time with SSE2 for float), returns
+// the index of the static circle hit earliest (smallest ti), last if none
+template <typename T>
+unsigned int CollisionIntersection_CircleCircleSet(const CircleT<T> &circle,	//Circle data - input
+	const CSD1130::Vector2DT<T> &ptEnd,											//End circle position - input
+	const CircleSetT<T> &set,													//Static circles - input
+	unsigned int first,															//First static circle to test - input
+	unsigned int last,															//One past the last one - input
+	CSD1130::Vector2DT<T> &interPt,												//Intersection point - output
+	CSD1130::Vector2DT<T> &normalAtCollision,									//Normal vector at collision time - output
+	T &interTime);																//Intersection time ti - output
+
+// Two moving circles (ball against ball). interTime is the same for both, the
+// normal points from circleB to circleA
+template <typename T>
+int CollisionIntersection_CircleCircleMoving(const CircleT<T> &circleA,		//Circle A data - input
+	const CSD1130::Vector2DT<T> &ptEndA,										//End circle A position - input
+	const CircleT<T> &circleB,													//Circle B data - input
+	const CSD1130::Vector2DT<T> &ptEndB,										//End circle B position - input
+	CSD1130::Vector2DT<T> &interPtA,											//Intersection point of A - output
+	CSD1130::Vector2DT<T> &interPtB,											//Intersection point of B - output
+	CSD1130::Vector2DT<T> &normalAtCollision,									//Normal vector at collision time - output
+	T &interTime);																//Intersection time ti - output
+
+// Moving circle inside an arc. One test covers the whole arc, whatever its length
+template <typename T>
+int CollisionIntersection_CircleArc(const CircleT<T> &circle,				//Circle data - input
+	const CSD1130::Vector2DT<T> &ptEnd,											//End circle position - input
+	const ArcT<T> &arc,															//Arc data - input
+	CSD1130::Vector2DT<T> &interPt,												//Intersection point - output
+	CSD1130::Vector2DT<T> &normalAtCollision,									//Normal vector at collision time - output
+	T &interTime);																//Intersection time ti - output
 
 
 
 // RESPONSE FUNCTIONS
-void CollisionResponse_CircleLineSegment(const CSD1130::Vec2 &ptInter,				//Intersection position of the circle - input
-	const CSD1130::Vec2 &normal,													//Normal vector of reflection on collision time - input
-	CSD1130::Vec2 &ptEnd,															//Final position of the circle after reflection - output
-	CSD1130::Vec2 &reflected);														//Normalized reflection vector direction - output
+template <typename T>
+void CollisionResponse_CircleLineSegment(const CSD1130::Vector2DT<T> &ptInter,	//Intersection position of the circle - input
+	const CSD1130::Vector2DT<T> &normal,											//Normal vector of reflection on collision time - input
+	const CSD1130::Vector2DT<T> &velocity,											//Velocity of the circle before the collision - input
+	CSD1130::Vector2DT<T> &ptEnd,													//Final position of the circle after reflection - output
+	CSD1130::Vector2DT<T> &reflected);												//Normalized reflection vector direction - output
+
+// Elastic collision between two circles in contact: the normal components of
+// the velocities are exchanged according to the masses, and both circles go on
+// from their contact points with the new velocities for the rest of the step.
+// Circles already moving apart are left untouched (returns 0)
+template <typename T>
+int CollisionResponse_CircleCircle(const CSD1130::Vector2DT<T> &normal,		//Normal vector at collision time (from B to A) - input
+	T interTime,																	//Intersection time ti - input
+	T dt,																			//Step duration - input
+	T massA,																		//Mass of circle A - input
+	const CSD1130::Vector2DT<T> &ptInterA,											//Intersection position of circle A - input
+	CSD1130::Vector2DT<T> &velA,													//Velocity of circle A - input/output
+	CSD1130::Vector2DT<T> &ptEndA,													//Final position of circle A - output
+	T massB,																		//Mass of circle B - input
+	const CSD1130::Vector2DT<T> &ptInterB,											//Intersection position of circle B - input
+	CSD1130::Vector2DT<T> &velB,													//Velocity of circle B - input/output
+	CSD1130::Vector2DT<T> &ptEndB);													//Final position of circle B - output
 
 #endif // CSD1130_COLLISION_H_
\ No newline at end of file
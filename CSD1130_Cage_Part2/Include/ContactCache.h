@@ -0,0 +1,74 @@
+/******************************************************************************/
+/*!
+\file		ContactCache.h
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 17, 2023
+\brief
+	Per ball cache of the walls and wall vertices around it. A ball moves
+	a few units a step, so the walls it can touch change slowly: the cache
+	keeps the ones within a reach of where it was built, and stays good for
+	as long as the ball's step stays within that reach. Only the cached
+	walls need testing then, instead of every wall of the cage. The walls
+	are kept in the order of the cage (grouped by class), so testing them
+	gives the same bounces, in the same order, as testing them all.
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef CSD1130_CONTACT_CACHE_H_
+#define CSD1130_CONTACT_CACHE_H_
+
+
+// Walls and vertices a cache holds; more than that around a ball and it
+// falls back to testing them all
+const unsigned int	CONTACT_WALL_MAX	= 8;
+const unsigned int	CONTACT_VERTEX_MAX	= 8;
+
+/******************************************************************************/
+/*!
+	Walls of class c are m_walls[m_classStart[c], m_classStart[c + 1]),
+	indices into the cage walls. m_full: too many walls or vertices around,
+	test them all (the cache is still good for as long, it just saves
+	nothing)
+ */
+/******************************************************************************/
+template <typename T>
+struct ContactCacheT
+{
+	CSD1130::Vector2DT<T>	m_center;
+	T						m_reach;			// 0 until built: never covers anything
+	bool					m_full;
+	unsigned int			m_classStart[(int)LINE_CLASS::LINE_CLASS_NUM + 1];
+	unsigned int			m_walls[CONTACT_WALL_MAX];
+	unsigned int			m_vertices[CONTACT_VERTEX_MAX];
+	unsigned int			m_vertexNum;
+};
+
+typedef ContactCacheT<float>			ContactCache;
+typedef ContactCacheT<double>			ContactCached;
+typedef ContactCacheT<CSD1130::Fixed>	ContactCachex;
+
+// Files the walls and vertices a circle of radius can touch while its
+// center stays within reach of center
+template <typename T>
+void BuildContactCache(ContactCacheT<T> &cache,								//Cache - output
+						const CSD1130::Vector2DT<T> &center,					//Center of the cached region - input
+						T reach,												//Radius of the cached region - input
+						T radius,												//Ball radius - input
+						const LineSegmentT<T> *pWalls,							//Walls, grouped by class - input
+						const unsigned int *pClassStart,						//Start of each class group, LINE_CLASS_NUM + 1 - input
+						const LineVertexT<T> *pVertices,						//Wall vertices - input
+						unsigned int vertexNum);								//Number of vertices - input
+
+// True if a ball going from ptStart to ptEnd stays in the cached region
+template <typename T>
+bool ContactCacheCovers(const ContactCacheT<T> &cache,						//Cache - input
+						const CSD1130::Vector2DT<T> &ptStart,					//Start of the step - input
+						const CSD1130::Vector2DT<T> &ptEnd);					//End of the step - input
+
+
+#endif // CSD1130_CONTACT_CACHE_H_
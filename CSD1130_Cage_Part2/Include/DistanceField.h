@@ -0,0 +1,81 @@
+/******************************************************************************/
+/*!
+\file		DistanceField.h
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 11, 2023
+\brief
+	Signed distance field of the static cage (walls, arcs and pillars),
+	sampled on a grid when the level loads. The distance is positive on the
+	side the cage is bounced off from (the wall normals, inside an arc,
+	outside a pillar) and negative behind it. Between the samples it is
+	interpolated bilinearly; the distance to the cage changes by at most
+	the distance moved, so the interpolated value is never more than
+	m_slack above the real one. That gives a lower bound on the distance to
+	the cage in constant time, and its gradient is an approximate normal.
+	The rows are sampled in parallel.
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef CSD1130_DISTANCE_FIELD_H_
+#define CSD1130_DISTANCE_FIELD_H_
+
+
+/******************************************************************************/
+/*!
+	Sample (x, y) is m_dist[y * m_samplesX + x], taken at
+	(m_minX + x * m_cellSize, m_minY + y * m_cellSize)
+ */
+/******************************************************************************/
+template <typename T>
+struct DistanceFieldT
+{
+	T				m_minX;
+	T				m_minY;
+	T				m_cellSize;
+	T				m_slack;			// the interpolated distance is at most this much too big
+	int				m_samplesX;
+	int				m_samplesY;
+	T				*m_dist;
+};
+
+typedef DistanceFieldT<float>			DistanceField;
+typedef DistanceFieldT<double>			DistanceFieldd;
+typedef DistanceFieldT<CSD1130::Fixed>	DistanceFieldx;
+
+// Samples the distance to the cage over its bounding box. The cell size is
+// doubled until the field fits in its sample cap. threadNum == 0: one
+// thread per hardware thread
+template <typename T>
+void BuildDistanceField(DistanceFieldT<T> &field,							//Field - output
+						const LineSegmentT<T> *pWalls,							//Walls - input
+						unsigned int wallNum,									//Number of walls - input
+						const ArcT<T> *pArcs,									//Arcs - input
+						unsigned int arcNum,									//Number of arcs - input
+						const CircleSetT<T> &pillars,							//Pillars - input
+						T cellSize,												//Distance between samples - input
+						unsigned int threadNum);								//Threads sampling it - input
+
+// Releases what BuildDistanceField allocated and empties the field
+template <typename T>
+void FreeDistanceField(DistanceFieldT<T> &field);							//Field - input/output
+
+// Interpolated distance at pt. Returns false outside the field
+template <typename T>
+bool SampleDistanceField(const DistanceFieldT<T> &field,					//Field - input
+						const CSD1130::Vector2DT<T> &pt,						//Point - input
+						T &dist);												//Distance - output
+
+// Unit gradient of the interpolated distance at pt: the approximate normal of
+// the closest part of the cage. Returns false outside the field or where it is flat
+template <typename T>
+bool DistanceFieldGradient(const DistanceFieldT<T> &field,					//Field - input
+							const CSD1130::Vector2DT<T> &pt,					//Point - input
+							CSD1130::Vector2DT<T> &normal);						//Normal - output
+
+
+#endif // CSD1130_DISTANCE_FIELD_H_
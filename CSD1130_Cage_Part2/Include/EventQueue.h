@@ -0,0 +1,65 @@
+/******************************************************************************/
+/*!
+\file		EventQueue.h
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 13, 2023
+\brief
+	Priority queue of timed events, one per id (a ball), earliest first.
+	A binary heap that also tracks where each id sits in it, so the time
+	of a queued id can be changed in place instead of queuing it twice.
+	Times are in seconds of simulation, as double: they keep growing, and
+	float runs out of precision within hours.
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef CSD1130_EVENT_QUEUE_H_
+#define CSD1130_EVENT_QUEUE_H_
+
+
+/******************************************************************************/
+/*!
+	m_heap[0, m_num) holds the queued ids, m_heap[0] is the earliest.
+	Id i is due at m_time[i], and sits at m_heap[m_slot[i]]
+ */
+/******************************************************************************/
+struct EventQueue
+{
+	double			*m_time;
+	unsigned int	*m_heap;
+	unsigned int	*m_slot;			// EVENT_NOT_QUEUED for the ids not in the heap
+	unsigned int	m_num;
+	unsigned int	m_idNum;
+};
+
+const unsigned int	EVENT_NOT_QUEUED	= 0xFFFFFFFF;
+
+// Allocates an empty queue for ids [0, idNum)
+void InitEventQueue(EventQueue &queue,										//Queue - output
+					unsigned int idNum);										//Number of ids - input
+
+// Releases what InitEventQueue allocated
+void FreeEventQueue(EventQueue &queue);										//Queue - input/output
+
+// Queues id at time, or moves it there if it is queued already
+void PushEvent(EventQueue &queue,											//Queue - input/output
+				unsigned int id,												//Id - input
+				double time);													//Time - input
+
+// Earliest event. Returns false if the queue is empty
+bool PeekEvent(const EventQueue &queue,										//Queue - input
+				unsigned int &id,												//Id - output
+				double &time);													//Time - output
+
+// Takes the earliest event out of the queue
+void PopEvent(EventQueue &queue);											//Queue - input/output
+
+// Takes every event out of the queue
+void ClearEventQueue(EventQueue &queue);									//Queue - input/output
+
+
+#endif // CSD1130_EVENT_QUEUE_H_
@@ -0,0 +1,102 @@
+/******************************************************************************/
+/*!
+\file		FastMath.h
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	March 28, 2023
+\brief
+	Approximate trigonometry and reciprocal square root used by the hot
+	math/collision paths. The approximations are only used when
+	CSD1130_FAST_MATH is defined, otherwise every function below falls back
+	to the precise C runtime version.
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#pragma once
+
+#include "Vector2D.h"
+
+// Define this (here or in the project preprocessor settings) to opt in to the
+// approximated paths
+//#define CSD1130_FAST_MATH
+
+namespace CSD1130
+{
+	/**************************************************************************/
+	/*!
+		How far the fast path lets a ball stray from its precise path: less
+		than FAST_MATH_DRIFT_MAX (world units) over the first
+		FAST_MATH_DRIFT_STEPS steps of a cage, ball collisions off. With
+		them on, the bounces between balls amplify the rounding (about 10
+		times every 20 steps), as they do any change in rounding, so the
+		drift says more about the level than about the fast path.
+		Each fast function is also held to its own bound below.
+		Checked by Tools/FastMathCheck.cpp
+	 */
+	/**************************************************************************/
+	constexpr unsigned int	FAST_MATH_DRIFT_STEPS	= 50;
+	constexpr float			FAST_MATH_DRIFT_MAX		= 0.1f;
+	constexpr float			FAST_SINCOS_ERROR_MAX	= 4.0e-7f;		// absolute, |angle| <= 1000
+	constexpr float			FAST_RSQRT_ERROR_MAX	= 4.8e-6f;		// relative, FastRSqrt and Vector2DNormalizeLength
+
+	/**************************************************************************/
+	/*!
+		Computes the sine and cosine of angle (radian) in one go.
+		Fast path: quadrant reduction to [-PI/4, PI/4] followed by a degree 7
+		(sin) / degree 8 (cos) polynomial.
+		Max absolute error: 4.0e-7 for |angle| <= 1000, 1.2e-6 for
+		|angle| <= 1.0e5. Angles beyond 1.0e5 are not supported.
+	 */
+	/**************************************************************************/
+	void	FastSinCos(float angle, float &pSin, float &pCos);
+
+	/**************************************************************************/
+	/*!
+		double version, always precise (double is only used where accuracy
+		matters more than speed)
+	 */
+	/**************************************************************************/
+	void	FastSinCos(double angle, double &pSin, double &pCos);
+
+	/**************************************************************************/
+	/*!
+		Fixed version, always the polynomial evaluated in integer arithmetic
+		so the result is bit exact everywhere.
+		Max absolute error: 4.0e-5 for |angle| <= 1000.
+	 */
+	/**************************************************************************/
+	void	FastSinCos(Fixed angle, Fixed &pSin, Fixed &pCos);
+
+	/**************************************************************************/
+	/*!
+		Returns 1 / sqrt(x) for x > 0.
+		Fast path: bit level initial guess refined by 2 Newton-Raphson steps.
+		Max relative error: 4.8e-6.
+	 */
+	/**************************************************************************/
+	float	FastRSqrt(float x);
+
+	/**************************************************************************/
+	/*!
+		In this function, pResult will be the unit vector of pVec0 and the
+		length of pVec0 is returned, so a caller that needs both only pays
+		for a single square root.
+		Fast path (float only) max relative error (on both outputs): 4.8e-6.
+		Fixed: short vectors are scaled up before the square root so their
+		direction keeps its precision; the zero vector is returned as is.
+	 */
+	/**************************************************************************/
+	template <typename T>
+	T		Vector2DNormalizeLength(Vector2DT<T> &pResult, const Vector2DT<T> &pVec0);
+
+	// float (fast path) and Fixed (short vectors) have their own, defined in FastMath.cpp
+	template <>
+	float	Vector2DNormalizeLength<float>(Vector2D &pResult, const Vector2D &pVec0);
+
+	template <>
+	Fixed	Vector2DNormalizeLength<Fixed>(Vector2Dx &pResult, const Vector2Dx &pVec0);
+}
@@ -0,0 +1,186 @@
+/******************************************************************************/
+/*!
+\file		Fixed.h
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	March 29, 2023
+\brief
+	Signed fixed-point scalar (Q47.16 stored in 64 bits) used to instantiate
+	the math and collision templates when results have to be bit exact.
+
+	The arithmetic operators are defined inline here since they are a couple
+	of integer instructions each and sit in every inner loop.
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+namespace CSD1130
+{
+	/**************************************************************************/
+	/*!
+		Every operation is integer only, so a given sequence of operations
+		produces the same bits with every compiler and optimization level.
+		Products and quotients round toward negative infinity, and are
+		worked out on 128 bits: one that doesn't fit saturates to
+		+/-INT64_MAX (|value| < 2^47) instead of overflowing.
+	 */
+	/**************************************************************************/
+	struct Fixed
+	{
+		static constexpr int		FRAC_BITS	= 16;
+		static constexpr int64_t	ONE			= int64_t(1) << FRAC_BITS;
+
+		int64_t raw;
+
+		// Constructors (the default one is trivial so Fixed can live in the math unions)
+		Fixed() = default;
+		constexpr explicit Fixed(int v) : raw(int64_t(v) * ONE) {}
+		explicit Fixed(float v) : raw((int64_t)floor((double)v * (double)ONE + 0.5)) {}
+		explicit Fixed(double v) : raw((int64_t)floor(v * (double)ONE + 0.5)) {}
+
+		static constexpr Fixed FromRaw(int64_t r) { return Fixed(r, 0); }
+
+		// Conversions
+		explicit operator float() const		{ return (float)raw / (float)ONE; }
+		explicit operator double() const	{ return (double)raw / (double)ONE; }
+
+		// Assignment operators
+		Fixed& operator += (Fixed rhs)		{ raw += rhs.raw; return *this; }
+		Fixed& operator -= (Fixed rhs)		{ raw -= rhs.raw; return *this; }
+		Fixed& operator *= (Fixed rhs);
+		Fixed& operator /= (Fixed rhs);
+
+		// Unary operators
+		constexpr Fixed operator -() const	{ return FromRaw(-raw); }
+
+	private:
+		constexpr Fixed(int64_t r, int) : raw(r) {}
+	};
+
+	// Binary operators
+	inline Fixed operator + (Fixed lhs, Fixed rhs)	{ return Fixed::FromRaw(lhs.raw + rhs.raw); }
+	inline Fixed operator - (Fixed lhs, Fixed rhs)	{ return Fixed::FromRaw(lhs.raw - rhs.raw); }
+
+	/**************************************************************************/
+	/*!
+		(m >> FRAC_BITS) with the sign neg, rounded down and saturated:
+		m is the 128 bit magnitude hi:lo of a product
+	 */
+	/**************************************************************************/
+	inline int64_t FixedShiftProduct(uint64_t hi, uint64_t lo, bool neg)
+	{
+		const uint64_t FRAC_MASK = (uint64_t(1) << Fixed::FRAC_BITS) - 1;
+
+		if (hi >> Fixed::FRAC_BITS)
+			return neg ? -INT64_MAX : INT64_MAX;
+
+		uint64_t m = (hi << (64 - Fixed::FRAC_BITS)) | (lo >> Fixed::FRAC_BITS);
+
+		// floor of a negative product: one more if any bit was shifted out
+		if (neg && (lo & FRAC_MASK) != 0)
+			++m;
+		if (m > (uint64_t)INT64_MAX)
+			return neg ? -INT64_MAX : INT64_MAX;
+		return neg ? -(int64_t)m : (int64_t)m;
+	}
+
+	inline Fixed operator * (Fixed lhs, Fixed rhs)
+	{
+		bool neg	= (lhs.raw < 0) != (rhs.raw < 0);
+		uint64_t a	= (lhs.raw < 0) ? 0 - (uint64_t)lhs.raw : (uint64_t)lhs.raw;
+		uint64_t b	= (rhs.raw < 0) ? 0 - (uint64_t)rhs.raw : (uint64_t)rhs.raw;
+
+#if defined(__SIZEOF_INT128__)
+		unsigned __int128 m = (unsigned __int128)a * b;
+		return Fixed::FromRaw(FixedShiftProduct((uint64_t)(m >> 64), (uint64_t)m, neg));
+#else
+		// 32 bit halves
+		uint64_t aLo = a & 0xFFFFFFFFu, aHi = a >> 32;
+		uint64_t bLo = b & 0xFFFFFFFFu, bHi = b >> 32;
+
+		uint64_t ll		= aLo * bLo;
+		uint64_t mid	= (ll >> 32) + (aHi * bLo & 0xFFFFFFFFu) + (aLo * bHi & 0xFFFFFFFFu);
+		uint64_t hi		= aHi * bHi + (aHi * bLo >> 32) + (aLo * bHi >> 32) + (mid >> 32);
+		uint64_t lo		= (mid << 32) | (ll & 0xFFFFFFFFu);
+
+		return Fixed::FromRaw(FixedShiftProduct(hi, lo, neg));
+#endif
+	}
+
+	inline Fixed operator / (Fixed lhs, Fixed rhs)
+	{
+		// dividing by zero saturates instead of trapping
+		if (rhs.raw == 0)
+			return Fixed::FromRaw(lhs.raw < 0 ? -INT64_MAX : INT64_MAX);
+
+		bool neg	= (lhs.raw < 0) != (rhs.raw < 0);
+		uint64_t n	= (lhs.raw < 0) ? 0 - (uint64_t)lhs.raw : (uint64_t)lhs.raw;
+		uint64_t d	= (rhs.raw < 0) ? 0 - (uint64_t)rhs.raw : (uint64_t)rhs.raw;
+		uint64_t q	= n / d;
+		uint64_t r	= n % d;
+
+		if (q >> (63 - Fixed::FRAC_BITS))
+			return Fixed::FromRaw(neg ? -INT64_MAX : INT64_MAX);
+
+		// n << FRAC_BITS without its top bits: all at once when r << FRAC_BITS
+		// fits, a bit at a time otherwise (r < d, so 2r doesn't overflow)
+		if ((r >> (63 - Fixed::FRAC_BITS)) == 0)
+		{
+			q = (q << Fixed::FRAC_BITS) + (r << Fixed::FRAC_BITS) / d;
+			r = (r << Fixed::FRAC_BITS) % d;
+		}
+		else
+		{
+			for (int k = 0; k < Fixed::FRAC_BITS; ++k)
+			{
+				q <<= 1;
+				r <<= 1;
+				if (r >= d)
+				{
+					r -= d;
+					q |= 1;
+				}
+			}
+		}
+
+		// rounded toward 0 so far, step down to floor
+		if (neg && r != 0)
+			++q;
+		if (q > (uint64_t)INT64_MAX)
+			return Fixed::FromRaw(neg ? -INT64_MAX : INT64_MAX);
+		return Fixed::FromRaw(neg ? -(int64_t)q : (int64_t)q);
+	}
+
+	inline Fixed& Fixed::operator*=(Fixed rhs) { *this = *this * rhs; return *this; }
+	inline Fixed& Fixed::operator/=(Fixed rhs) { *this = *this / rhs; return *this; }
+
+	// Comparison operators
+	inline bool operator == (Fixed lhs, Fixed rhs)	{ return lhs.raw == rhs.raw; }
+	inline bool operator != (Fixed lhs, Fixed rhs)	{ return lhs.raw != rhs.raw; }
+	inline bool operator <  (Fixed lhs, Fixed rhs)	{ return lhs.raw <  rhs.raw; }
+	inline bool operator <= (Fixed lhs, Fixed rhs)	{ return lhs.raw <= rhs.raw; }
+	inline bool operator >  (Fixed lhs, Fixed rhs)	{ return lhs.raw >  rhs.raw; }
+	inline bool operator >= (Fixed lhs, Fixed rhs)	{ return lhs.raw >= rhs.raw; }
+
+	/**************************************************************************/
+	/*!
+		Integer square root, rounded down. Negative input returns 0.
+	 */
+	/**************************************************************************/
+	Fixed	ScalarSqrt(Fixed x);
+
+	/**************************************************************************/
+	/*!
+		Returns |x|
+	 */
+	/**************************************************************************/
+	inline Fixed ScalarAbs(Fixed x) { return x.raw < 0 ? -x : x; }
+}
@@ -0,0 +1,158 @@
+/******************************************************************************/
+/*!
+\file		KinematicWalls.h
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 21, 2023
+\brief
+	Walls moved by a script instead of by collisions: rotating paddles,
+	pistons. A kinematic wall turns about a pivot at a constant rate, and
+	the pivot goes back and forth along a line. They are kept out of the
+	static walls so everything built over those (bands, vertices, distance
+	field, rooms) stays valid; they get their own small bounding volume
+	tree, built once when the level loads and refit to the swept boxes of
+	the walls every step (a piston goes back over the same ground, so the
+	tree built at the start stays a good one).
+	A ball is tested against a moving wall as against a capsule, end
+	points included, by conservative advancement: the step is never
+	crossed by more than the gap between the two, so no hit is missed. The
+	ball bounces off the wall as seen from the wall, which is how a paddle
+	pushes a ball, but like off the static walls, keeps its speed: the
+	walls would otherwise only ever add to it (Fermi acceleration). A ball
+	leaving slower along the normal than the wall point it hits gets the
+	normal velocity of that point.
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef CSD1130_KINEMATIC_WALLS_H_
+#define CSD1130_KINEMATIC_WALLS_H_
+
+
+/******************************************************************************/
+/*!
+	Wall with ends m_pivot + p + Rot(a) * m_arm0 and m_pivot + p + Rot(a) *
+	m_arm1, at a = m_spin * t and p = m_vel * t, t going from 0 to
+	m_period and back (or on and on with no period).
+	m_line is the wall at the start of the step, and each end goes on by
+	m_move0 / m_move1 by the end of it
+ */
+/******************************************************************************/
+template <typename T>
+struct KinematicWallT
+{
+	CSD1130::Vector2DT<T>	m_pivot;
+	CSD1130::Vector2DT<T>	m_arm0;
+	CSD1130::Vector2DT<T>	m_arm1;
+	CSD1130::Vector2DT<T>	m_vel;
+	T						m_spin;			// radian per second, counter clockwise
+	T						m_period;		// seconds, 0 for a pivot that never turns around
+
+	T						m_phase;		// time along the back and forth, in [0, 2 * m_period)
+	T						m_angle;		// in [-PI, PI]
+	LineSegmentT<T>			m_line;
+	CSD1130::Vector2DT<T>	m_move0;
+	CSD1130::Vector2DT<T>	m_move1;
+};
+
+typedef KinematicWallT<float>			KinematicWall;
+typedef KinematicWallT<double>			KinematicWalld;
+typedef KinematicWallT<CSD1130::Fixed>	KinematicWallx;
+
+/******************************************************************************/
+/*!
+	Node of the tree: a leaf holds m_order[m_first, m_first + m_num), an
+	inner node (m_num == 0) has its children at the next index and at
+	m_first. Children always come after their parent
+ */
+/******************************************************************************/
+template <typename T>
+struct KinematicNodeT
+{
+	CSD1130::Vector2DT<T>	m_boxMin;
+	CSD1130::Vector2DT<T>	m_boxMax;
+	unsigned int			m_first;
+	unsigned int			m_num;
+};
+
+template <typename T>
+struct KinematicWallSetT
+{
+	KinematicWallT<T>		*m_walls;
+	unsigned int			m_num;
+	KinematicNodeT<T>		*m_nodes;
+	unsigned int			m_nodeNum;
+	unsigned int			*m_order;			// walls, leaf by leaf
+};
+
+typedef KinematicWallSetT<float>			KinematicWallSet;
+typedef KinematicWallSetT<double>			KinematicWallSetd;
+typedef KinematicWallSetT<CSD1130::Fixed>	KinematicWallSetx;
+
+// Builds the set out of the walls at rest (m_pivot to m_period filled in),
+// and its tree over where they are at time 0
+template <typename T>
+void BuildKinematicWallSet(KinematicWallSetT<T> &set,						//Walls - output
+							const KinematicWallT<T> *pWalls,					//Walls at rest - input
+							unsigned int wallNum);								//Number of walls - input
+
+// Releases what BuildKinematicWallSet allocated and empties the set
+template <typename T>
+void FreeKinematicWallSet(KinematicWallSetT<T> &set);						//Walls - input/output
+
+// Moves the walls to the end of the last step, works out how far they go
+// over the next one, and refits the tree to the boxes they sweep
+template <typename T>
+void StepKinematicWalls(KinematicWallSetT<T> &set,							//Walls - input/output
+						T dt);													//Time step - input
+
+// Walls whose swept box overlaps [boxMin, boxMax]. pOut must have room for
+// every wall. Returns how many
+template <typename T>
+unsigned int QueryKinematicWalls(const KinematicWallSetT<T> &set,			//Walls - input
+								const CSD1130::Vector2DT<T> &boxMin,			//Box bottom left - input
+								const CSD1130::Vector2DT<T> &boxMax,			//Box top right - input
+								unsigned int *pOut);							//Walls - output
+
+// First time in [timeFrom, 1] the circle, going from its center (at
+// timeFrom) to ptEnd (at 1), touches the wall while getting closer to it.
+// wallMove is how far the wall point it touches goes over the whole step
+template <typename T>
+int CollisionIntersection_CircleKinematicWall(const CircleT<T> &circle,		//Circle data, at timeFrom - input
+											const CSD1130::Vector2DT<T> &ptEnd,	//End circle position - input
+											T timeFrom,							//Step time of the circle data - input
+											const KinematicWallT<T> &wall,		//Wall - input
+											CSD1130::Vector2DT<T> &interPt,		//Intersection point - output
+											CSD1130::Vector2DT<T> &normalAtCollision,	//Normal vector at collision time - output
+											CSD1130::Vector2DT<T> &wallMove,	//Move of the wall point over the step - output
+											T &interTime);						//Intersection time, in [timeFrom, 1] - output
+
+// Bounces the circle off the wall as seen from the wall (the part of the
+// velocity going into the wall is turned around), at the speed it came,
+// or the speed of the wall point if faster. ptEnd is where the rest of the
+// step takes the circle. Returns the new speed
+template <typename T>
+T CollisionResponse_CircleKinematicWall(const CSD1130::Vector2DT<T> &ptInter,	//Intersection position of the circle - input
+										const CSD1130::Vector2DT<T> &normal,	//Normal vector of the wall - input
+										const CSD1130::Vector2DT<T> &wallMove,	//Move of the wall point over the step - input
+										T interTime,							//Intersection time - input
+										T dt,									//Time step - input
+										CSD1130::Vector2DT<T> &velCurr,			//Circle velocity - input/output
+										CSD1130::Vector2DT<T> &ptEnd);			//End circle position - output
+
+// Pushes the circle out of where the wall is at the end of the step, and
+// bounces it off the wall there. A wall turning into a circle sliding
+// along it catches up with it during the step, after their contact.
+// Returns 1 if the circle was pushed
+template <typename T>
+int CollisionResolve_CircleKinematicWall(T radius,							//Circle radius - input
+										const KinematicWallT<T> &wall,			//Wall - input
+										T dt,									//Time step - input
+										CSD1130::Vector2DT<T> &velCurr,			//Circle velocity - input/output
+										CSD1130::Vector2DT<T> &ptEnd);			//End circle position - input/output
+
+
+#endif // CSD1130_KINEMATIC_WALLS_H_
@@ -25,42 +25,48 @@ namespace CSD1130
 
 /**************************************************************************/
 /*!
-
+	T is the scalar type: float, double or Fixed (see Scalar.h)
  */
  /**************************************************************************/
-	typedef union Matrix3x3
+	template <typename T>
+	union Matrix3x3T
 	{
 		struct
 		{
-			float m00, m01, m02;
-			float m10, m11, m12;
-			float m20, m21, m22;
+			T m00, m01, m02;
+			T m10, m11, m12;
+			T m20, m21, m22;
 		};
 
-		float m[9];
-		float m2[3][3];//You need this for the second part of the assignment
+		T m[9];
+		T m2[3][3];//You need this for the second part of the assignment
 
-		Matrix3x3() : m00(0.0f), m01(0.0f), m02(0.0f), m10(0.0f), m11(0.0f), m12(0.0f), m20(0.0f), m21(0.0f), m22(0.0f) {}
-		Matrix3x3(const float* pArr);
-		Matrix3x3(float _00, float _01, float _02,
-			float _10, float _11, float _12,
-			float _20, float _21, float _22);
-		Matrix3x3& operator=(const Matrix3x3& rhs);
+		Matrix3x3T() : m00(T(0)), m01(T(0)), m02(T(0)), m10(T(0)), m11(T(0)), m12(T(0)), m20(T(0)), m21(T(0)), m22(T(0)) {}
+		Matrix3x3T(const T* pArr);
+		Matrix3x3T(T _00, T _01, T _02,
+			T _10, T _11, T _12,
+			T _20, T _21, T _22);
+		Matrix3x3T& operator=(const Matrix3x3T& rhs);
 
 		//Do not change the following
-		Matrix3x3(const Matrix3x3& rhs) = default;
+		Matrix3x3T(const Matrix3x3T& rhs) = default;
 
 		// Assignment operators
-		Matrix3x3& operator*=(const Matrix3x3& rhs);
+		Matrix3x3T& operator*=(const Matrix3x3T& rhs);
+
+	};
 
-	} Matrix3x3, Mtx33;
+	typedef Matrix3x3T<float>	Matrix3x3, Mtx33;
+	typedef Matrix3x3T<double>	Matrix3x3d, Mtx33d;
+	typedef Matrix3x3T<Fixed>	Matrix3x3x, Mtx33x;
 
 #ifdef _MSC_VER
 	// Supress warning: nonstandard extension used : nameless struct/union
 #pragma warning( default : 4201 )
 #endif
 
-	Matrix3x3 operator*(const Matrix3x3& lhs, const Matrix3x3& rhs);
+	template <typename T>
+	Matrix3x3T<T> operator*(const Matrix3x3T<T>& lhs, const Matrix3x3T<T>& rhs);
 
 	/**************************************************************************/
 	/*!
@@ -68,14 +74,16 @@ namespace CSD1130
 		and returns the result as a vector
 	 */
 	 /**************************************************************************/
-	Vector2D  operator*(const Matrix3x3& pMtx, const Vector2D& rhs);
+	template <typename T>
+	Vector2DT<T>  operator*(const Matrix3x3T<T>& pMtx, const Vector2DT<T>& rhs);
 
 	/**************************************************************************/
 	/*!
 		This function sets the matrix pResult to the identity matrix
 	 */
 	 /**************************************************************************/
-	void Mtx33Identity(Matrix3x3& pResult);
+	template <typename T>
+	void Mtx33Identity(Matrix3x3T<T>& pResult);
 
 	/**************************************************************************/
 	/*!
@@ -83,7 +91,8 @@ namespace CSD1130
 		and saves it in pResult
 	 */
 	 /**************************************************************************/
-	void Mtx33Translate(Matrix3x3& pResult, float x, float y);
+	template <typename T>
+	void Mtx33Translate(Matrix3x3T<T>& pResult, T x, T y);
 
 	/**************************************************************************/
 	/*!
@@ -91,7 +100,8 @@ namespace CSD1130
 		and saves it in pResult
 	 */
 	 /**************************************************************************/
-	void Mtx33Scale(Matrix3x3& pResult, float x, float y);
+	template <typename T>
+	void Mtx33Scale(Matrix3x3T<T>& pResult, T x, T y);
 
 	/**************************************************************************/
 	/*!
@@ -99,7 +109,8 @@ namespace CSD1130
 		is in radian. Save the resultant matrix in pResult.
 	 */
 	 /**************************************************************************/
-	void Mtx33RotRad(Matrix3x3& pResult, float angle);
+	template <typename T>
+	void Mtx33RotRad(Matrix3x3T<T>& pResult, T angle);
 
 	/**************************************************************************/
 	/*!
@@ -107,7 +118,8 @@ namespace CSD1130
 		is in degree. Save the resultant matrix in pResult.
 	 */
 	 /**************************************************************************/
-	void Mtx33RotDeg(Matrix3x3& pResult, float angle);
+	template <typename T>
+	void Mtx33RotDeg(Matrix3x3T<T>& pResult, T angle);
 
 	/**************************************************************************/
 	/*!
@@ -115,7 +127,8 @@ namespace CSD1130
 		and saves it in pResult
 	 */
 	 /**************************************************************************/
-	void Mtx33Transpose(Matrix3x3& pResult, const Matrix3x3& pMtx);
+	template <typename T>
+	void Mtx33Transpose(Matrix3x3T<T>& pResult, const Matrix3x3T<T>& pMtx);
 
 	/**************************************************************************/
 	/*!
@@ -124,5 +137,6 @@ namespace CSD1130
 		would be set to NULL.
 	*/
 	/**************************************************************************/
-	void Mtx33Inverse(Matrix3x3* pResult, float* determinant, const Matrix3x3& pMtx);
+	template <typename T>
+	void Mtx33Inverse(Matrix3x3T<T>* pResult, T* determinant, const Matrix3x3T<T>& pMtx);
 }
\ No newline at end of file
@@ -0,0 +1,58 @@
+/******************************************************************************/
+/*!
+\file		Morton.h
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 19, 2023
+\brief
+	Z-order (Morton) keys of points: the bits of the grid cell coordinates,
+	interleaved. Points sorted by key are mostly next to the points that
+	are close to them in the plane, so storing the balls in that order puts
+	neighbours next to each other in memory. The balls barely move between
+	two sorts, so the entries are kept sorted with an insertion sort, in
+	close to linear time.
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef CSD1130_MORTON_H_
+#define CSD1130_MORTON_H_
+
+
+/******************************************************************************/
+/*!
+	Key of item m_item
+ */
+/******************************************************************************/
+struct MortonEntry
+{
+	unsigned int	m_key;
+	unsigned int	m_item;
+};
+
+// Interleaves the low 16 bits of x (even bits) and y (odd bits)
+unsigned int MortonKey(unsigned int x,										//Cell column - input
+						unsigned int y);										//Cell row - input
+
+// Keys of the ball centers on a 65536 x 65536 grid over the square
+// [boxMin, boxMin + side] (centers outside go to the border cells), as
+// entries pEntries[i] = { key of ball i, i }. The square is fixed, so a
+// ball that stays put keeps its key whatever the others do
+template <typename T>
+void MortonKeys(const CircleT<T> *pBalls,									//Balls - input
+				unsigned int ballNum,										//Number of balls - input
+				const CSD1130::Vector2DT<T> &boxMin,						//Bottom left corner of the grid - input
+				T side,														//Side of the grid - input
+				MortonEntry *pEntries);										//Keys - output
+
+// Sorts the entries by key, stable, in place: by insertion when they are
+// close to sorted, a full sort otherwise (the first sort). Returns 0 if
+// they were sorted already, else how many entries were out of place
+unsigned int SortMortonEntries(MortonEntry *pEntries,						//Entries - input/output
+								unsigned int entryNum);						//Number of entries - input
+
+
+#endif // CSD1130_MORTON_H_
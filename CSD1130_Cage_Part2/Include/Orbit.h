@@ -0,0 +1,99 @@
+/******************************************************************************/
+/*!
+\file		Orbit.h
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 14, 2023
+\brief
+	Periodic orbit detection. Without ball collisions, a ball's path is
+	decided by where it last bounced and how fast it left: the same bounce
+	again means the same path again. Each ball keeps its last bounces (the
+	point where its path turned, the velocity it left with, and when); once
+	its last k bounces repeat the k before them, within a tolerance, the
+	ball is on an orbit of k bounces. From then on its position at any time
+	comes from those k bounces, in constant time, instead of being
+	simulated.
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef CSD1130_ORBIT_H_
+#define CSD1130_ORBIT_H_
+
+
+// Longest orbit looked for, in bounces (twice as many are kept per ball)
+const unsigned int	ORBIT_BOUNCE_MAX	= 8;
+
+/******************************************************************************/
+/*!
+	One bounce: the ball went through m_hit at m_time, then at m_vel
+ */
+/******************************************************************************/
+template <typename T>
+struct BounceT
+{
+	CSD1130::Vector2DT<T>	m_hit;
+	CSD1130::Vector2DT<T>	m_vel;
+	double					m_time;
+};
+
+/******************************************************************************/
+/*!
+	Ball b's bounces are m_bounces[b * 2 * ORBIT_BOUNCE_MAX, ...), used as a
+	ring: bounce n is at n % (2 * ORBIT_BOUNCE_MAX). Once the ball is on an
+	orbit (m_period[b] != 0), its last m_period[b] bounces are the orbit,
+	and the ring isn't written anymore
+ */
+/******************************************************************************/
+template <typename T>
+struct OrbitSetT
+{
+	BounceT<T>		*m_bounces;
+	unsigned int	*m_bounceNum;		// bounces seen by each ball
+	unsigned int	*m_period;			// bounces per orbit, 0 while not on one
+	double			*m_duration;		// time per orbit
+	unsigned int	m_ballNum;
+	T				m_tolerance;		// bounces this close (hit point and velocity) are the same
+};
+
+typedef OrbitSetT<float>			OrbitSet;
+typedef OrbitSetT<double>			OrbitSetd;
+typedef OrbitSetT<CSD1130::Fixed>	OrbitSetx;
+
+// Allocates the bounce history of ballNum balls, all off orbit
+template <typename T>
+void InitOrbitSet(OrbitSetT<T> &set,										//Orbits - output
+					unsigned int ballNum,										//Number of balls - input
+					T tolerance);												//Distance under which bounces match - input
+
+// Releases what InitOrbitSet allocated
+template <typename T>
+void FreeOrbitSet(OrbitSetT<T> &set);										//Orbits - input/output
+
+// Forgets the bounces of a ball (its path changed some other way)
+template <typename T>
+void ResetOrbit(OrbitSetT<T> &set,											//Orbits - input/output
+				unsigned int ball);												//Ball - input
+
+// Records a bounce of a ball off orbit. Returns true if it put the ball on one
+template <typename T>
+bool AddBounce(OrbitSetT<T> &set,											//Orbits - input/output
+				unsigned int ball,												//Ball - input
+				const CSD1130::Vector2DT<T> &hit,								//Where its path turned - input
+				const CSD1130::Vector2DT<T> &vel,								//Velocity it left with - input
+				double time);													//When - input
+
+// Position and velocity at time (not before the orbit started) of a ball on
+// an orbit. Returns false if the ball isn't on one
+template <typename T>
+bool OrbitState(const OrbitSetT<T> &set,									//Orbits - input
+				unsigned int ball,												//Ball - input
+				double time,													//Time - input
+				CSD1130::Vector2DT<T> &pos,										//Position - output
+				CSD1130::Vector2DT<T> &vel);									//Velocity - output
+
+
+#endif // CSD1130_ORBIT_H_
@@ -0,0 +1,72 @@
+/******************************************************************************/
+/*!
+\file		Particles.h
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 7, 2023
+\brief
+	Tracer particles: zero radius bodies, in their own set instead of the
+	balls. A particle is a point, so its step against a wall is a plain
+	segment/segment intersection, and its reflection needs no square root
+	(the wall normals are unit length already). The set is stored as one
+	array per component and, for float, stepped 4 particles at a time with
+	SSE2. Particles only bounce off the line segment walls, and go through
+	each other.
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef CSD1130_PARTICLES_H_
+#define CSD1130_PARTICLES_H_
+
+
+/******************************************************************************/
+/*!
+	Particle i is at (m_x[i], m_y[i]) moving at (m_vx[i], m_vy[i])
+ */
+/******************************************************************************/
+template <typename T>
+struct ParticleSetT
+{
+	T				*m_x;
+	T				*m_y;
+	T				*m_vx;
+	T				*m_vy;
+	unsigned int	m_num;
+	unsigned int	m_max;				// room in the arrays
+
+	T				*m_wall;			// the walls as the SSE2 step reads them (float only),
+	unsigned int	m_wallMax;			// kept from step to step, room for m_wallMax walls
+};
+
+typedef ParticleSetT<float>				ParticleSet;
+typedef ParticleSetT<double>			ParticleSetd;
+typedef ParticleSetT<CSD1130::Fixed>	ParticleSetx;
+
+// Allocates room for particleMax particles (the set starts empty)
+template <typename T>
+void InitParticleSet(ParticleSetT<T> &set,									//Particles - output
+					unsigned int particleMax);									//Room for particles - input
+
+// Releases what InitParticleSet allocated
+template <typename T>
+void FreeParticleSet(ParticleSetT<T> &set);									//Particles - input/output
+
+// Adds a particle, if there is room. Returns its index (set.m_max if none)
+template <typename T>
+unsigned int AddParticle(ParticleSetT<T> &set,								//Particles - input/output
+						const CSD1130::Vector2DT<T> &pos,						//Position - input
+						const CSD1130::Vector2DT<T> &vel);						//Velocity - input
+
+// Moves every particle by vel * dt, reflecting it off the walls it hits
+template <typename T>
+void StepParticles(ParticleSetT<T> &set,									//Particles - input/output
+					const LineSegmentT<T> *pWalls,								//Walls - input
+					unsigned int wallNum,										//Number of walls - input
+					T dt);														//Time step - input
+
+
+#endif // CSD1130_PARTICLES_H_
@@ -0,0 +1,67 @@
+/******************************************************************************/
+/*!
+\file		PillarGrid.h
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	March 31, 2023
+\brief
+	Uniform grid over the static pillars (broadphase). Pillars never move,
+	so the grid is built once when the level loads: each pillar goes in the
+	cell holding its center, and the pillars are stored cell by cell, row by
+	row. The cells a ball can reach on one row are then one contiguous range
+	of pillars, which is what the batched collision kernel wants.
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef CSD1130_PILLAR_GRID_H_
+#define CSD1130_PILLAR_GRID_H_
+
+
+/******************************************************************************/
+/*!
+	Cell (x, y) holds m_pillars[m_cellStart[c], m_cellStart[c + 1]) with
+	c = y * m_cellsX + x
+ */
+/******************************************************************************/
+template <typename T>
+struct PillarGridT
+{
+	CircleSetT<T>	m_pillars;			// sorted by cell
+	T				m_minX;				// bottom left corner of cell (0, 0)
+	T				m_minY;
+	T				m_cellSize;
+	T				m_maxRadius;		// biggest pillar radius, queries are grown by it
+	int				m_cellsX;
+	int				m_cellsY;
+	unsigned int	*m_cellStart;
+};
+
+typedef PillarGridT<float>			PillarGrid;
+typedef PillarGridT<double>			PillarGridd;
+typedef PillarGridT<CSD1130::Fixed>	PillarGridx;
+
+// Builds the grid (and its own sorted copy of the pillars)
+template <typename T>
+void BuildPillarGrid(PillarGridT<T> &grid,									//Grid - output
+					const CircleT<T> *pPillars,									//Pillars - input
+					unsigned int pillarNum);									//Number of pillars - input
+
+// Releases what BuildPillarGrid allocated and empties the grid
+template <typename T>
+void FreePillarGrid(PillarGridT<T> &grid);									//Grid - input/output
+
+// Cells holding the pillars that can touch a circle inside [boxMin, boxMax].
+// Returns false when there are none
+template <typename T>
+bool PillarGridCellRange(const PillarGridT<T> &grid,						//Grid - input
+						const CSD1130::Vector2DT<T> &boxMin,					//Box bottom left - input
+						const CSD1130::Vector2DT<T> &boxMax,					//Box top right - input
+						int &x0, int &y0,										//First cell - output
+						int &x1, int &y1);										//Last cell (included) - output
+
+
+#endif // CSD1130_PILLAR_GRID_H_
@@ -0,0 +1,123 @@
+/******************************************************************************/
+/*!
+\file		Rooms.h
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 20, 2023
+\brief
+	Levels made of rooms joined by openings. Each room lists the walls
+	around it, and a portal is a segment across an opening, between the
+	room on its front (the side its normal points to) and the one behind.
+	A ball is in one room at a time, and only changes room through a
+	portal, so it only needs testing against the walls of its room, and of
+	the rooms past the portals it is close to: the cost of a ball depends
+	on the size of its room, not on the size of the level.
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef CSD1130_ROOMS_H_
+#define CSD1130_ROOMS_H_
+
+
+const unsigned int	ROOM_NONE			= 0xFFFFFFFF;
+
+/******************************************************************************/
+/*!
+	Opening between rooms m_front and m_back
+ */
+/******************************************************************************/
+template <typename T>
+struct PortalT
+{
+	LineSegmentT<T>	m_line;
+	unsigned int	m_front;			// room on the side of m_line.m_normal
+	unsigned int	m_back;
+};
+
+typedef PortalT<float>				Portal;
+typedef PortalT<double>				Portald;
+typedef PortalT<CSD1130::Fixed>		Portalx;
+
+/******************************************************************************/
+/*!
+	Walls of class c of room r (its own, and the ones meeting them at an
+	end) are
+		m_walls[m_wallStart[r * S + c], m_wallStart[r * S + c + 1])
+	with S = LINE_CLASS_NUM + 1, in wall order; its vertices are
+	m_vertices[m_vertexStart[r], m_vertexStart[r + 1]) and its portals
+	m_roomPortals[m_portalStart[r], m_portalStart[r + 1]).
+	The room bounds only serve to find the room a ball starts in
+ */
+/******************************************************************************/
+template <typename T>
+struct RoomSetT
+{
+	unsigned int			m_roomNum;
+	CSD1130::Vector2DT<T>	*m_boxMin;
+	CSD1130::Vector2DT<T>	*m_boxMax;
+	unsigned int			*m_wallStart;
+	unsigned int			*m_walls;
+	unsigned int			*m_vertexStart;
+	unsigned int			*m_vertices;
+	PortalT<T>				*m_portals;
+	unsigned int			m_portalNum;
+	unsigned int			*m_portalStart;
+	unsigned int			*m_roomPortals;
+};
+
+typedef RoomSetT<float>				RoomSet;
+typedef RoomSetT<double>			RoomSetd;
+typedef RoomSetT<CSD1130::Fixed>	RoomSetx;
+
+// Builds the rooms out of the walls of each one: room r holds walls
+// pRoomWalls[pRoomWallStart[r], pRoomWallStart[r + 1]), in any order, as
+// indices into pWalls (grouped by class). A vertex belongs to the rooms of
+// the walls it ends
+template <typename T>
+void BuildRoomSet(RoomSetT<T> &set,											//Rooms - output
+				unsigned int roomNum,										//Number of rooms - input
+				const CSD1130::Vector2DT<T> *pBoxMin,						//Bottom left of each room - input
+				const CSD1130::Vector2DT<T> *pBoxMax,						//Top right of each room - input
+				const unsigned int *pRoomWallStart,							//Start of the walls of each room, roomNum + 1 - input
+				const unsigned int *pRoomWalls,								//Walls of the rooms - input
+				const LineSegmentT<T> *pWalls,								//Walls - input
+				const unsigned int *pClassStart,							//Start of each class group, LINE_CLASS_NUM + 1 - input
+				const LineVertexT<T> *pVertices,							//Wall vertices - input
+				unsigned int vertexNum,										//Number of vertices - input
+				const PortalT<T> *pPortals,									//Portals - input
+				unsigned int portalNum);									//Number of portals - input
+
+// Releases what BuildRoomSet allocated and empties the set
+template <typename T>
+void FreeRoomSet(RoomSetT<T> &set);											//Rooms - input/output
+
+// First room whose bounds hold pt, ROOM_NONE if none does
+template <typename T>
+unsigned int FindRoom(const RoomSetT<T> &set,								//Rooms - input
+					const CSD1130::Vector2DT<T> &pt);						//Point - input
+
+// Room of a ball that was in room and went from ptStart to ptEnd
+template <typename T>
+unsigned int CrossPortals(const RoomSetT<T> &set,							//Rooms - input
+						unsigned int room,										//Room at ptStart - input
+						const CSD1130::Vector2DT<T> &ptStart,					//Start of the step - input
+						const CSD1130::Vector2DT<T> &ptEnd);					//End of the step - input
+
+// Walls and vertices of room, and of the rooms past its portals within
+// reach of center, merged in wall (vertex) order. pWalls and pVertices
+// must have room for all of them. Returns the number of vertices
+template <typename T>
+unsigned int GatherRoomWalls(const RoomSetT<T> &set,						//Rooms - input
+							unsigned int room,									//Room - input
+							const CSD1130::Vector2DT<T> &center,				//Ball center - input
+							T reach,											//Distance to the portals - input
+							unsigned int *pWalls,								//Walls - output
+							unsigned int *pClassStart,							//Start of each class, LINE_CLASS_NUM + 1 - output
+							unsigned int *pVertices);							//Vertices - output
+
+
+#endif // CSD1130_ROOMS_H_
@@ -0,0 +1,33 @@
+/******************************************************************************/
+/*!
+\file		Scalar.h
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	March 29, 2023
+\brief
+	Scalar types the math and collision templates are instantiated with,
+	and the handful of scalar functions they need, overloaded per type.
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#pragma once
+
+#include "Fixed.h"
+#include <math.h>
+
+namespace CSD1130
+{
+	// float:	speed (default)
+	// double:	long runs / very large cages where float drifts
+	// Fixed:	bit exact determinism
+
+	inline float	ScalarSqrt(float x)		{ return sqrtf(x); }
+	inline double	ScalarSqrt(double x)	{ return sqrt(x); }
+
+	inline float	ScalarAbs(float x)		{ return fabsf(x); }
+	inline double	ScalarAbs(double x)		{ return fabs(x); }
+}
@@ -0,0 +1,49 @@
+/******************************************************************************/
+/*!
+\file		SharedMemory.h
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 25, 2023
+\brief
+	Named shared memory, for the processes of one machine: a file mapping
+	on Windows, shm_open/mmap elsewhere.
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef CSD1130_SHARED_MEMORY_H_
+#define CSD1130_SHARED_MEMORY_H_
+
+
+enum class SHARED_ACCESS
+{
+	ACCESS_CREATE,		//0: made anew, zeroed (replacing one of the same name), read/write
+	ACCESS_READ,		//1: one made by another process, read only
+	ACCESS_WRITE,		//2: one made by another process, read/write
+
+	ACCESS_NUM
+};
+
+// Maps the shared memory called name. bytes is its size: input with
+// ACCESS_CREATE, output otherwise. Returns 0 if it can't, or the address and
+// in pHandle what UnmapSharedMemory needs besides
+void *MapSharedMemory(const char *name,										//Name - input
+						size_t &bytes,										//Size - input/output
+						SHARED_ACCESS access,								//Access - input
+						void *&pHandle);									//Handle - output
+
+// Undoes MapSharedMemory
+void UnmapSharedMemory(const void *pAddress,								//Address - input
+						size_t bytes,										//Size - input
+						void *pHandle);										//Handle - input
+
+// Takes the name away, for the creator once it is done with it. The
+// processes that mapped it keep it until they unmap it (nothing to do on
+// Windows, where it goes with the last handle)
+void RemoveSharedMemory(const char *name);									//Name - input
+
+
+#endif // CSD1130_SHARED_MEMORY_H_
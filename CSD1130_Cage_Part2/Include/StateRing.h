@@ -0,0 +1,155 @@
+/******************************************************************************/
+/*!
+\file		StateRing.h
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 24, 2023
+\brief
+	The state of a world, step by step, for other processes of the same
+	machine (analysis, visualisation). Each step goes into the next slot of
+	a ring in shared memory: the ball positions and velocities, and the
+	bounces of the step. Every slot has a sequence number, odd while the
+	slot is written, so the one writer never waits for anyone, and a
+	reader reads a slot where it is and checks afterwards that it was not
+	written over meanwhile (a seqlock).
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef CSD1130_STATE_RING_H_
+#define CSD1130_STATE_RING_H_
+
+#include <atomic>
+
+
+/******************************************************************************/
+/*!
+	Shared memory: the header, then m_slotNum slots of m_slotBytes, a slot
+	being a StateSlotHeader, m_ballMax positions, m_ballMax velocities and
+	m_eventMax events. Step s is in slot s & (m_slotNum - 1), m_published
+	is the number of steps written in full so far. The counters are 32 bit
+	so they can be read with a plain load from a read-only mapping
+ */
+/******************************************************************************/
+struct StateRingHeader
+{
+	char						m_tag[4];			// "CSTA", written last
+	unsigned int				m_version;
+	unsigned int				m_slotNum;			// power of 2
+	unsigned int				m_ballMax;
+	unsigned int				m_eventMax;
+	unsigned int				m_slotBytes;
+	std::atomic<unsigned int>	m_published;
+	unsigned int				m_pad;
+};
+
+struct StateSlotHeader
+{
+	std::atomic<unsigned int>	m_seq;				// odd while the slot is written
+	unsigned int				m_step;
+	unsigned int				m_ballNum;
+	unsigned int				m_eventNum;
+	unsigned int				m_eventLost;		// bounces past m_eventMax, left out
+	unsigned int				m_pad;
+};
+
+// a ball whose velocity changed during the step (off a wall, a pillar, a
+// kinematic wall or another ball), as it is at the end of the step
+struct StateEvent
+{
+	unsigned int				m_ball;				// ball of the level
+	CSD1130::Vec2				m_pos;
+	CSD1130::Vec2				m_vel;
+};
+
+/******************************************************************************/
+/*!
+	Writing end. Balls are published in the order of the level (see
+	CageWorld::m_ballId); m_lastVel is the velocity of each at the last
+	publish, to find the bounces
+ */
+/******************************************************************************/
+struct StatePublisher
+{
+	StateRingHeader				*m_header;
+	unsigned char				*m_slots;
+	size_t						m_bytes;			// mapped
+	void						*m_handle;			// of the mapping (Windows)
+	char						m_name[64];
+
+	CSD1130::Vec2				*m_lastVel;
+	bool						m_first;			// nothing published yet
+	unsigned int				m_step;
+};
+
+// Reading end
+struct StateReader
+{
+	const StateRingHeader		*m_header;
+	const unsigned char			*m_slots;
+	size_t						m_bytes;
+	void						*m_handle;
+};
+
+// A slot as a reader sees it, pointers into the shared memory: only good
+// while StateViewValid says so
+struct StateView
+{
+	unsigned int				m_step;
+	unsigned int				m_ballNum;
+	unsigned int				m_eventNum;
+	unsigned int				m_eventLost;
+	const CSD1130::Vec2			*m_pos;
+	const CSD1130::Vec2			*m_vel;
+	const StateEvent			*m_events;
+
+	const StateSlotHeader		*m_slot;
+	unsigned int				m_seq;				// of the slot when the view was taken
+};
+
+// Creates the shared memory (replacing one of the same name) for worlds of
+// ballMax balls at most. slotNum is rounded up to a power of 2. Returns
+// false if it can't be created
+bool OpenStatePublisher(StatePublisher &publisher,							//Publisher - output
+						const char *name,									//Name of the shared memory - input
+						unsigned int ballMax,								//Balls published at most - input
+						unsigned int eventMax,								//Bounces published per step at most - input
+						unsigned int slotNum);								//Steps kept - input
+
+// Writes the balls of the world, and its bounces since the last call, in
+// the next slot. Never waits. Returns false, and writes nothing, if the
+// world has a ball past the ballMax of the ring (open a bigger one; the
+// readers have to open it again)
+bool PublishCageWorld(StatePublisher &publisher,							//Publisher - input/output
+						const CageWorld &world);							//World - input
+
+// Releases the shared memory (the readers keep what they mapped)
+void FreeStatePublisher(StatePublisher &publisher);							//Publisher - input/output
+
+// Maps the shared memory of a publisher, read only. Returns false if there
+// is none (yet) or it is not a state ring
+bool OpenStateReader(StateReader &reader,									//Reader - output
+						const char *name);									//Name of the shared memory - input
+
+// Points the view at the latest step published. Returns false if nothing
+// is published yet, or the slot is already being written over
+bool ReadLatestState(const StateReader &reader,								//Reader - input
+						StateView &view);									//View - output
+
+// Points the view at step, if the ring still has it. Returns false if not
+bool ReadState(const StateReader &reader,									//Reader - input
+				unsigned int step,											//Step - input
+				StateView &view);											//View - output
+
+// True if the slot of the view was not written over since it was taken:
+// what was read through the view is the step it says
+bool StateViewValid(const StateView &view);									//View - input
+
+// Unmaps the shared memory
+void CloseStateReader(StateReader &reader);									//Reader - input/output
+
+
+#endif // CSD1130_STATE_RING_H_
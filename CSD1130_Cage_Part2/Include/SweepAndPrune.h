@@ -0,0 +1,92 @@
+/******************************************************************************/
+/*!
+\file		SweepAndPrune.h
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 3, 2023
+\brief
+	Sort and sweep broadphase for the balls. Every step each ball gets a
+	box around the path it can take; the boxes are kept sorted along x,
+	and a sweep only pairs up the boxes that overlap on both axes.
+	The boxes are sorted by row first (horizontal bands of the level), then
+	along x: a sweep along x over the whole level would meet every ball
+	above and below, a sweep over one row only meets the ones next to it.
+	The order is kept from one step to the next: the balls barely move in a
+	step, so an insertion sort puts it back in order in close to linear time.
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef CSD1130_SWEEP_AND_PRUNE_H_
+#define CSD1130_SWEEP_AND_PRUNE_H_
+
+
+/******************************************************************************/
+/*!
+	Box around the path of one ball, filed in the row holding its bottom
+ */
+/******************************************************************************/
+template <typename T>
+struct SweepAndPruneBoxT
+{
+	T				m_minX;
+	T				m_maxX;
+	T				m_minY;
+	T				m_maxY;
+	int				m_row;
+	unsigned int	m_ball;				// index of the ball
+};
+
+/******************************************************************************/
+/*!
+	The boxes themselves are kept sorted (not indices to them), so the
+	sweep reads them in memory order
+ */
+/******************************************************************************/
+template <typename T>
+struct SweepAndPruneT
+{
+	SweepAndPruneBoxT<T>	*m_boxes;		// sorted by m_row, then m_minX
+	unsigned int			m_num;
+
+	T						m_originY;		// bottom of row 0
+	T						m_rowHeight;
+	T						m_maxWidth;		// widest box of the last update
+
+	unsigned int			*m_pairs;		// overlapping pairs of the last update, 2 ball indices each
+	unsigned int			m_pairNum;
+	unsigned int			m_pairMax;		// room in m_pairs, grown when needed
+};
+
+typedef SweepAndPruneT<float>			SweepAndPrune;
+typedef SweepAndPruneT<double>			SweepAndPruned;
+typedef SweepAndPruneT<CSD1130::Fixed>	SweepAndPrunex;
+
+// Allocates the arrays and sorts the balls (at rest) once, from scratch
+template <typename T>
+void InitSweepAndPrune(SweepAndPruneT<T> &sap,								//Broadphase - output
+						const CircleT<T> *pBalls,									//Balls - input
+						unsigned int ballNum);										//Number of balls - input
+
+// Releases what InitSweepAndPrune allocated
+template <typename T>
+void FreeSweepAndPrune(SweepAndPruneT<T> &sap);								//Broadphase - input/output
+
+// Refreshes the boxes with this step's paths, restores the order and finds
+// the pairs of balls whose boxes overlap. Returns the number of pairs
+template <typename T>
+unsigned int UpdateSweepAndPrune(SweepAndPruneT<T> &sap,					//Broadphase - input/output
+								const CircleT<T> *pBalls,						//Balls, at the start of the step - input
+								const CSD1130::Vector2DT<T> *pPosNext);			//Ball positions at the end of the step - input
+
+// Renumbers the balls of the boxes after the balls were moved around in
+// memory (ball i is now ball pNewIndex[i]); the boxes keep their order
+template <typename T>
+void RemapSweepAndPrune(SweepAndPruneT<T> &sap,								//Broadphase - input/output
+						const unsigned int *pNewIndex);								//New index of each ball - input
+
+
+#endif // CSD1130_SWEEP_AND_PRUNE_H_
@@ -0,0 +1,35 @@
+/******************************************************************************/
+/*!
+\file		Tiling.h
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 18, 2023
+\brief
+	Block sizes for loops over every pair of two arrays (the balls and the
+	walls): a block of each that fits in the L1 data cache together is
+	gone over pair by pair before moving on, so each wall is read from
+	memory once per block of balls, and not once per ball.
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef CSD1130_TILING_H_
+#define CSD1130_TILING_H_
+
+
+// Size of the L1 data cache in bytes, asked once (a common size if the
+// system can't tell)
+unsigned int CacheSizeL1(void);
+
+// Items of each array in a block: the inner array (read over and over) gets
+// half of the L1 cache, the outer one a quarter, at least 1 item each
+void ChooseTileSizes(unsigned int outerBytes,								//Size of an outer item - input
+					unsigned int innerBytes,								//Size of an inner item - input
+					unsigned int &outerTile,								//Outer items in a block - output
+					unsigned int &innerTile);								//Inner items in a block - output
+
+
+#endif // CSD1130_TILING_H_
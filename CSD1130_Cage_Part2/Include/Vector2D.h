@@ -14,6 +14,8 @@ prior written consent of DigiPen Institute of Technology is prohibited.
 
 #pragma once
 
+#include "Scalar.h"
+
 namespace CSD1130
 {
 	#ifdef _MSC_VER
@@ -23,36 +25,41 @@ namespace CSD1130
 
 	/**************************************************************************/
 	/*!
-
+		T is the scalar type: float, double or Fixed (see Scalar.h)
 	 */
 	/**************************************************************************/
-	typedef union Vector2D
+	template <typename T>
+	union Vector2DT
 	{
 		struct
 		{
-			float x, y;
+			T x, y;
 		};
 
-		float m[2];
+		T m[2];
 
 		// Constructors
-		Vector2D() : x(0.0f), y(0.0f) {}
-		Vector2D(float _x, float _y);
+		Vector2DT() : x(T(0)), y(T(0)) {}
+		Vector2DT(T _x, T _y);
 
 		//Do not change the following
-		Vector2D& operator=(const Vector2D& rhs) = default;
-		Vector2D(const Vector2D & rhs) = default;
+		Vector2DT& operator=(const Vector2DT& rhs) = default;
+		Vector2DT(const Vector2DT & rhs) = default;
 
 		// Assignment operators
-		Vector2D& operator += (const Vector2D &rhs);
-		Vector2D& operator -= (const Vector2D &rhs);
-		Vector2D& operator *= (float rhs);
-		Vector2D& operator /= (float rhs);
+		Vector2DT& operator += (const Vector2DT &rhs);
+		Vector2DT& operator -= (const Vector2DT &rhs);
+		Vector2DT& operator *= (T rhs);
+		Vector2DT& operator /= (T rhs);
 
 		// Unary operators
-		Vector2D operator -() const;
+		Vector2DT operator -() const;
+
+	};
 
-	} Vector2D, Vec2, Point2D, Pt2;
+	typedef Vector2DT<float>	Vector2D, Vec2, Point2D, Pt2;
+	typedef Vector2DT<double>	Vector2Dd, Vec2d;
+	typedef Vector2DT<Fixed>	Vector2Dx, Vec2x;
 
 
 	#ifdef _MSC_VER
@@ -61,32 +68,35 @@ namespace CSD1130
 	#endif
 
 	// Binary operators
-	Vector2D operator + (const Vector2D &lhs, const Vector2D &rhs);
-	Vector2D operator - (const Vector2D &lhs, const Vector2D &rhs);
-	Vector2D operator * (const Vector2D &lhs, float rhs);
-	Vector2D operator * (float lhs, const Vector2D &rhs);
-	Vector2D operator / (const Vector2D &lhs, float rhs);
+	template <typename T> Vector2DT<T> operator + (const Vector2DT<T> &lhs, const Vector2DT<T> &rhs);
+	template <typename T> Vector2DT<T> operator - (const Vector2DT<T> &lhs, const Vector2DT<T> &rhs);
+	template <typename T> Vector2DT<T> operator * (const Vector2DT<T> &lhs, T rhs);
+	template <typename T> Vector2DT<T> operator * (T lhs, const Vector2DT<T> &rhs);
+	template <typename T> Vector2DT<T> operator / (const Vector2DT<T> &lhs, T rhs);
 
 	/**************************************************************************/
 	/*!
 		In this function, pResult will be the unit vector of pVec0
 	 */
 	/**************************************************************************/
-	void	Vector2DNormalize(Vector2D &pResult, const Vector2D &pVec0);
+	template <typename T>
+	void	Vector2DNormalize(Vector2DT<T> &pResult, const Vector2DT<T> &pVec0);
 	
 	/**************************************************************************/
 	/*!
 		This function returns the length of the vector pVec0 
 	 */
 	/**************************************************************************/
-	float	Vector2DLength(const Vector2D &pVec0);
+	template <typename T>
+	T		Vector2DLength(const Vector2DT<T> &pVec0);
 	
 	/**************************************************************************/
 	/*!
 		This function returns the square of pVec0's length. Avoid the square root 
 	 */
 	/**************************************************************************/
-	float	Vector2DSquareLength(const Vector2D &pVec0);
+	template <typename T>
+	T		Vector2DSquareLength(const Vector2DT<T> &pVec0);
 	
 	/**************************************************************************/
 	/*!
@@ -94,7 +104,8 @@ namespace CSD1130
 		The distance between these 2 2D points is returned
 	 */
 	/**************************************************************************/
-	float	Vector2DDistance(const Vector2D &pVec0, const Vector2D &pVec1);
+	template <typename T>
+	T		Vector2DDistance(const Vector2DT<T> &pVec0, const Vector2DT<T> &pVec1);
 	
 	/**************************************************************************/
 	/*!
@@ -103,14 +114,16 @@ namespace CSD1130
 		Avoid the square root
 	 */
 	/**************************************************************************/
-	float	Vector2DSquareDistance(const Vector2D &pVec0, const Vector2D &pVec1);
+	template <typename T>
+	T		Vector2DSquareDistance(const Vector2DT<T> &pVec0, const Vector2DT<T> &pVec1);
 	
 	/**************************************************************************/
 	/*!
 		This function returns the dot product between pVec0 and pVec1
 	 */
 	/**************************************************************************/
-	float	Vector2DDotProduct(const Vector2D &pVec0, const Vector2D &pVec1);
+	template <typename T>
+	T		Vector2DDotProduct(const Vector2DT<T> &pVec0, const Vector2DT<T> &pVec1);
 	
 	/**************************************************************************/
 	/*!
@@ -118,5 +131,21 @@ namespace CSD1130
 		between pVec0 and pVec1
 	 */
 	/**************************************************************************/
-	float	Vector2DCrossProductMag(const Vector2D &pVec0, const Vector2D &pVec1);
+	template <typename T>
+	T		Vector2DCrossProductMag(const Vector2DT<T> &pVec0, const Vector2DT<T> &pVec1);
+
+	/**************************************************************************/
+	/*!
+		This function returns |V.x| + |V.y|, a bound of the length of V
+		(never less) without the square root.
+		For the step V of a ball: bouncing off the cage doesn't make its
+		path longer, so everywhere the ball goes this step is within
+		StepReach(V) of where it started
+	 */
+	/**************************************************************************/
+	template <typename T>
+	inline T	StepReach(const Vector2DT<T> &V)
+	{
+		return ScalarAbs(V.x) + ScalarAbs(V.y);
+	}
 }
\ No newline at end of file
@@ -0,0 +1,183 @@
+/******************************************************************************/
+/*!
+\file		WallStream.h
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 22, 2023
+\brief
+	Levels with more walls than are worth keeping in memory. The walls are
+	cut into square tiles, stored one after the other in a pack file, and
+	only the tiles with balls in them, or on their way, are read in. A
+	tile comes in with the grid of cells the balls are tested through, so
+	the parts of the level nobody is in take no memory, walls or
+	broadphase.
+	A thread reads the tiles ahead of the balls. A tile needed before it is
+	in is read right away, on the spot, so the collisions never depend on
+	how fast the disk is. Past the memory budget, the tiles used the
+	longest ago are dropped.
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef CSD1130_WALL_STREAM_H_
+#define CSD1130_WALL_STREAM_H_
+
+
+/******************************************************************************/
+/*!
+	Pack file: the header, m_tilesX * m_tilesY tile entries (row by row),
+	then the walls of each tile. A wall is in every tile its bounding box
+	overlaps, under the same id (its index in the level once the walls are
+	grouped by class, as the world keeps them), and the walls of a tile
+	are in id order. Everything is little endian
+ */
+/******************************************************************************/
+struct WallPackHeader
+{
+	char			m_tag[4];			// "CWAL"
+	unsigned int	m_version;
+	float			m_minX;				// bottom left corner of tile (0, 0)
+	float			m_minY;
+	float			m_tileSize;
+	unsigned int	m_tilesX;
+	unsigned int	m_tilesY;
+	unsigned int	m_wallNum;			// walls of the level, each counted once
+};
+
+struct WallPackTile
+{
+	unsigned long long	m_offset;		// of its first wall, from the start of the file
+	unsigned int		m_wallNum;
+	unsigned int		m_pad;
+};
+
+struct WallPackWall
+{
+	unsigned int	m_id;
+	float			m_x0;
+	float			m_y0;
+	float			m_x1;
+	float			m_y1;
+};
+
+/******************************************************************************/
+/*!
+	Tile in memory. Cell (x, y) of its grid holds the walls
+	m_walls[m_cellWalls[k]], k in [m_cellStart[c], m_cellStart[c + 1]) with
+	c = y * WALL_TILE_CELLS + x
+ */
+/******************************************************************************/
+const unsigned int	WALL_TILE_CELLS		= 8;
+
+template <typename T>
+struct WallTileT
+{
+	LineSegmentT<T>	*m_walls;
+	unsigned int	*m_ids;
+	unsigned int	m_num;
+	unsigned int	*m_cellStart;
+	unsigned int	*m_cellWalls;
+	size_t			m_bytes;			// all of the above
+};
+
+// the reading thread, and what it shares with the simulation (WallStream.cpp)
+template <typename T>
+struct WallStreamWorkerT;
+
+/******************************************************************************/
+/*!
+	m_tiles[t] is tile t when m_state[t] says it is in memory, and
+	m_lastUse[t] the last step a ball needed it (or was headed for it).
+	m_gathered holds the walls of the last GatherStreamedWalls, and
+	m_gatheredVertices their end points (GatherStreamedVertices)
+ */
+/******************************************************************************/
+template <typename T>
+struct WallStreamT
+{
+	WallPackHeader			m_header;
+	WallPackTile			*m_entries;
+	unsigned int			m_tileNum;			// 0 when the level has no pack
+
+	WallTileT<T>			**m_tiles;
+	unsigned char			*m_state;
+	unsigned int			*m_lastUse;
+	unsigned int			*m_resident;		// tiles in memory, in no order
+	unsigned int			m_residentNum;
+	size_t					m_budget;			// bytes
+	size_t					m_bytes;			// of the tiles in memory
+	size_t					m_pendingBytes;		// of the tiles the thread is asked for
+	unsigned int			m_clock;			// steps so far
+
+	LineSegmentT<T>			*m_gathered;
+	LineVertexT<T>			*m_gatheredVertices;	// room for 2 * m_foundMax
+	unsigned long long		*m_found;			// id << 32 | k of the walls found, k into m_foundWalls
+	const LineSegmentT<T>	**m_foundWalls;
+	unsigned int			m_foundMax;			// room in the other four arrays
+
+	unsigned int			m_loadNum;			// tiles read in
+	unsigned int			m_missNum;			// read when a ball already needed them
+	unsigned int			m_dropNum;
+	unsigned int			m_failNum;			// reads that failed, the tile is read again when needed
+
+	WallStreamWorkerT<T>	*m_worker;
+};
+
+typedef WallStreamT<float>			WallStream;
+typedef WallStreamT<double>			WallStreamd;
+typedef WallStreamT<CSD1130::Fixed>	WallStreamx;
+
+// Cuts the walls into tiles of tileSize a side and writes the pack
+// (offline, the level is in memory). Returns false if it can't be written
+bool WriteWallPack(const char *path,										//Pack file - input
+					const LineSegment *pWalls,									//Walls - input
+					unsigned int wallNum,										//Number of walls - input
+					float tileSize);											//Side of a tile - input
+
+// Reads the tile entries of the pack and starts the reading thread, with
+// no tile in memory yet. Returns false (and leaves the stream empty) if the
+// file is not a pack
+template <typename T>
+bool OpenWallStream(WallStreamT<T> &stream,									//Stream - output
+					const char *path,											//Pack file - input
+					size_t budget);												//Memory for the tiles, in bytes - input
+
+// Stops the thread and releases the tiles and the stream
+template <typename T>
+void FreeWallStream(WallStreamT<T> &stream);								//Stream - input/output
+
+// Starts a step: takes in the tiles the thread has read since the last one
+template <typename T>
+void BeginWallStreamStep(WallStreamT<T> &stream);							//Stream - input/output
+
+// Asks the thread for the tiles overlapping the box, while the budget
+// allows. The ones in memory are kept in for this step
+template <typename T>
+void PrefetchWallTiles(WallStreamT<T> &stream,								//Stream - input/output
+						const CSD1130::Vector2DT<T> &boxMin,					//Box bottom left - input
+						const CSD1130::Vector2DT<T> &boxMax);					//Box top right - input
+
+// Walls in the cells overlapping the box, once each, in id order, in
+// stream.m_gathered. The tiles not in memory are read first, the ones that
+// can't be read are left out (see m_failNum). Returns how many
+template <typename T>
+unsigned int GatherStreamedWalls(WallStreamT<T> &stream,					//Stream - input/output
+								const CSD1130::Vector2DT<T> &boxMin,			//Box bottom left - input
+								const CSD1130::Vector2DT<T> &boxMax);			//Box top right - input
+
+// End points of the walls gathered last, merged where walls meet as
+// BuildLineVertices does, in stream.m_gatheredVertices. Returns how many
+template <typename T>
+unsigned int GatherStreamedVertices(WallStreamT<T> &stream,					//Stream - input/output
+									unsigned int wallNum);						//Walls gathered last - input
+
+// Ends a step: drops the tiles used the longest ago while past the budget,
+// never one used this step
+template <typename T>
+void EndWallStreamStep(WallStreamT<T> &stream);								//Stream - input/output
+
+
+#endif // CSD1130_WALL_STREAM_H_
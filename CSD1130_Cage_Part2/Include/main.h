@@ -28,18 +28,44 @@ extern double	g_appTime;
 //#include "AEEngine.h"
 #include "Vector2D.h"
 #include "Matrix3x3.h"
-#include "Math.h"
+#include "FastMath.h"
+#include <math.h>
 
 #include <iostream>
 #include <fstream>
 #include <string>
 
+// the headless tools (see Tools) build the simulation without the engine
+#ifndef CSD1130_HEADLESS
 #include "GameStateMgr.h"
 #include "GameState_Cage.h"
+#else
+#define	PI		3.1415926f		// as the engine has it
+#endif
 #include "Collision.h"
-
-
+#include "PillarGrid.h"
+#include "ContactCache.h"
+#include "Rooms.h"
+#include "KinematicWalls.h"
+#include "WallStream.h"
+#include "DistanceField.h"
+#include "SweepAndPrune.h"
+#include "BallHash.h"
+#include "Particles.h"
+#include "EventQueue.h"
+#include "Orbit.h"
+#include "Tiling.h"
+#include "Morton.h"
+#include "CageWorld.h"
+#include "CageBatch.h"
+#include "SharedMemory.h"
+#include "StateRing.h"
+#include "CageShard.h"
+
+
+#ifndef CSD1130_HEADLESS
 extern s8	fontId;
+#endif
 
 
 #endif // CSD1130_MAIN_H_
@@ -0,0 +1,409 @@
+/******************************************************************************/
+/*!
+\file		BallHash.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 5, 2023
+\brief
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+namespace
+{
+	// Slots per ball (rounded up to a power of 2)
+	const unsigned int	SLOTS_PER_BALL	= 2;
+
+	// Cells further than this from cell 0 are merged (a ball lost far away).
+	// Small enough for the difference of two cell coordinates to fit an int
+	const double		CELL_MAX		= 1 << 28;
+
+	/**************************************************************************/
+	/*!
+		Cell coordinate of v along one axis. Done in double: every scalar
+		type converts to it exactly enough, and the cell only decides which
+		balls get tested
+	 */
+	/**************************************************************************/
+	template <typename T>
+	int CellOf(const BallHashT<T> &hash, T v)
+	{
+		double c = floor((double)v / (double)hash.m_cellSize);
+
+		if (c < -CELL_MAX)
+			return -(int)CELL_MAX;
+		if (c > CELL_MAX)
+			return (int)CELL_MAX;
+		return (int)c;
+	}
+
+	/**************************************************************************/
+	/*!
+		Slot of cell (x, y)
+	 */
+	/**************************************************************************/
+	template <typename T>
+	unsigned int SlotOf(const BallHashT<T> &hash, int x, int y)
+	{
+		return (((unsigned int)x * 73856093u) ^ ((unsigned int)y * 19349663u)) & (hash.m_tableSize - 1);
+	}
+
+	/**************************************************************************/
+	/*!
+		Calls visit(e) for every entry e in cell (x, y)
+	 */
+	/**************************************************************************/
+	template <typename T, typename F>
+	void VisitCell(const BallHashT<T> &hash, int x, int y, F &visit)
+	{
+		unsigned int s = SlotOf(hash, x, y);
+
+		for (unsigned int e = hash.m_slotStart[s]; e < hash.m_slotStart[s + 1]; ++e)
+			if (hash.m_entries[e].m_cellX == x && hash.m_entries[e].m_cellY == y)
+				visit(e);
+	}
+
+	/**************************************************************************/
+	/*!
+		Calls visit(e) for every entry with its center in the cells covering
+		[minX, maxX] x [minY, maxY], and maybe a few more. A box over more
+		cells than there are balls is cheaper to answer by going over all of
+		them
+	 */
+	/**************************************************************************/
+	template <typename T, typename F>
+	void VisitBox(const BallHashT<T> &hash, T minX, T minY, T maxX, T maxY, F &visit)
+	{
+		if (hash.m_num == 0)
+			return;
+
+		int x0 = CellOf(hash, minX), y0 = CellOf(hash, minY);
+		int x1 = CellOf(hash, maxX), y1 = CellOf(hash, maxY);
+
+		if (x0 < hash.m_minCellX)	x0 = hash.m_minCellX;
+		if (y0 < hash.m_minCellY)	y0 = hash.m_minCellY;
+		if (x1 > hash.m_maxCellX)	x1 = hash.m_maxCellX;
+		if (y1 > hash.m_maxCellY)	y1 = hash.m_maxCellY;
+
+		if (x0 > x1 || y0 > y1)
+			return;
+
+		if ((double)(x1 - x0 + 1) * (double)(y1 - y0 + 1) > (double)hash.m_num)
+		{
+			for (unsigned int e = 0; e < hash.m_num; ++e)
+				visit(e);
+			return;
+		}
+
+		for (int y = y0; y <= y1; ++y)
+			for (int x = x0; x <= x1; ++x)
+				VisitCell(hash, x, y, visit);
+	}
+}
+
+/******************************************************************************/
+/*!
+* \brief Allocates the hash
+* \param hash:		output - hash, empty
+* \param ballNum:	input - number of balls it will hold
+* \param cellSize:	input - side of a cell
+ */
+/******************************************************************************/
+template <typename T>
+void InitBallHash(BallHashT<T> &hash,
+				unsigned int ballNum,
+				T cellSize)
+{
+	hash.m_cellSize		= cellSize > T(0) ? cellSize : T(1);
+	hash.m_maxRadius	= T(0);
+
+	hash.m_tableSize = 1;
+	while (hash.m_tableSize < ballNum * SLOTS_PER_BALL)
+		hash.m_tableSize *= 2;
+
+	hash.m_slotStart	= new unsigned int[hash.m_tableSize + 1];
+	hash.m_entries		= new BallHashEntryT<T>[ballNum];
+	hash.m_slotOf		= new unsigned int[ballNum];
+	hash.m_num			= ballNum;
+
+	for (unsigned int s = 0; s <= hash.m_tableSize; ++s)
+		hash.m_slotStart[s] = 0;
+
+	// nothing is filed yet: no cell is occupied
+	hash.m_minCellX = hash.m_minCellY = 1;
+	hash.m_maxCellX = hash.m_maxCellY = 0;
+}
+
+/******************************************************************************/
+/*!
+* \brief Releases the hash
+* \param hash:	input/output - hash, empty afterwards
+ */
+/******************************************************************************/
+template <typename T>
+void FreeBallHash(BallHashT<T> &hash)
+{
+	delete []hash.m_slotStart;
+	delete []hash.m_entries;
+	delete []hash.m_slotOf;
+
+	hash.m_slotStart	= 0;
+	hash.m_entries		= 0;
+	hash.m_slotOf		= 0;
+	hash.m_tableSize	= 0;
+	hash.m_num			= 0;
+}
+
+/******************************************************************************/
+/*!
+* \brief Files the balls by cell (counting sort by slot)
+* \param hash:		input/output - hash
+* \param pBalls:	input - balls
+ */
+/******************************************************************************/
+template <typename T>
+void BuildBallHash(BallHashT<T> &hash,
+					const CircleT<T> *pBalls)
+{
+	unsigned int n = hash.m_num;
+
+	for (unsigned int s = 0; s <= hash.m_tableSize; ++s)
+		hash.m_slotStart[s] = 0;
+
+	hash.m_maxRadius = T(0);
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		int x = CellOf(hash, pBalls[i].m_center.x);
+		int y = CellOf(hash, pBalls[i].m_center.y);
+
+		if (i == 0 || x < hash.m_minCellX)	hash.m_minCellX = x;
+		if (i == 0 || y < hash.m_minCellY)	hash.m_minCellY = y;
+		if (i == 0 || x > hash.m_maxCellX)	hash.m_maxCellX = x;
+		if (i == 0 || y > hash.m_maxCellY)	hash.m_maxCellY = y;
+		if (pBalls[i].m_radius > hash.m_maxRadius)
+			hash.m_maxRadius = pBalls[i].m_radius;
+
+		hash.m_slotOf[i] = SlotOf(hash, x, y);
+		++hash.m_slotStart[hash.m_slotOf[i] + 1];
+	}
+
+	for (unsigned int s = 0; s < hash.m_tableSize; ++s)
+		hash.m_slotStart[s + 1] += hash.m_slotStart[s];
+
+	// m_slotStart[s] is the next free entry of slot s while filling, and
+	// ends up as the start of slot s + 1; shift it back afterwards
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		BallHashEntryT<T> &entry = hash.m_entries[hash.m_slotStart[hash.m_slotOf[i]]++];
+
+		entry.m_x		= pBalls[i].m_center.x;
+		entry.m_y		= pBalls[i].m_center.y;
+		entry.m_radius	= pBalls[i].m_radius;
+		entry.m_cellX	= CellOf(hash, entry.m_x);
+		entry.m_cellY	= CellOf(hash, entry.m_y);
+		entry.m_ball	= i;
+	}
+
+	for (unsigned int s = hash.m_tableSize; s > 0; --s)
+		hash.m_slotStart[s] = hash.m_slotStart[s - 1];
+	hash.m_slotStart[0] = 0;
+}
+
+/******************************************************************************/
+/*!
+* \brief Finds the balls touching a box
+* \param hash:		input - hash
+* \param boxMin:	input - bottom left corner of the box
+* \param boxMax:	input - top right corner of the box
+* \param pOut:		output - ball indices
+* \param outMax:	input - room in pOut
+* \return unsigned int: number of balls touching the box
+ */
+/******************************************************************************/
+template <typename T>
+unsigned int QueryBallHashRegion(const BallHashT<T> &hash,
+								const CSD1130::Vector2DT<T> &boxMin,
+								const CSD1130::Vector2DT<T> &boxMax,
+								unsigned int *pOut,
+								unsigned int outMax)
+{
+	unsigned int found = 0;
+
+	auto visit = [&](unsigned int e)
+	{
+		const BallHashEntryT<T> &entry = hash.m_entries[e];
+
+		// distance from the center to the box, along each axis
+		T x = entry.m_x, y = entry.m_y;
+		T dx = x < boxMin.x ? boxMin.x - x : (x > boxMax.x ? x - boxMax.x : T(0));
+		T dy = y < boxMin.y ? boxMin.y - y : (y > boxMax.y ? y - boxMax.y : T(0));
+
+		if (dx * dx + dy * dy <= entry.m_radius * entry.m_radius)
+		{
+			if (found < outMax)
+				pOut[found] = entry.m_ball;
+			++found;
+		}
+	};
+
+	VisitBox(hash, boxMin.x - hash.m_maxRadius, boxMin.y - hash.m_maxRadius,
+		boxMax.x + hash.m_maxRadius, boxMax.y + hash.m_maxRadius, visit);
+
+	return found;
+}
+
+/******************************************************************************/
+/*!
+* \brief Finds the balls touching a circle
+* \param hash:		input - hash
+* \param center:	input - center of the circle
+* \param radius:	input - radius of the circle
+* \param pOut:		output - ball indices
+* \param outMax:	input - room in pOut
+* \return unsigned int: number of balls touching the circle
+ */
+/******************************************************************************/
+template <typename T>
+unsigned int QueryBallHashRadius(const BallHashT<T> &hash,
+								const CSD1130::Vector2DT<T> &center,
+								T radius,
+								unsigned int *pOut,
+								unsigned int outMax)
+{
+	unsigned int found = 0;
+
+	auto visit = [&](unsigned int e)
+	{
+		const BallHashEntryT<T> &entry = hash.m_entries[e];
+
+		T dx = entry.m_x - center.x, dy = entry.m_y - center.y;
+		T reach = radius + entry.m_radius;
+
+		if (dx * dx + dy * dy <= reach * reach)
+		{
+			if (found < outMax)
+				pOut[found] = entry.m_ball;
+			++found;
+		}
+	};
+
+	T reach = radius + hash.m_maxRadius;
+	VisitBox(hash, center.x - reach, center.y - reach, center.x + reach, center.y + reach, visit);
+
+	return found;
+}
+
+/******************************************************************************/
+/*!
+* \brief Finds the balls closest to a point, searching the cells around it
+*		one ring at a time
+* \param hash:		input - hash
+* \param pt:		input - point
+* \param k:			input - number of balls wanted
+* \param pOut:		output - ball indices, closest first
+* \param pDistSq:	output - squared distance from pt to their center
+* \return unsigned int: number of balls found
+ */
+/******************************************************************************/
+template <typename T>
+unsigned int QueryBallHashNearest(const BallHashT<T> &hash,
+								const CSD1130::Vector2DT<T> &pt,
+								unsigned int k,
+								unsigned int *pOut,
+								T *pDistSq)
+{
+	unsigned int found = 0;
+
+	if (hash.m_num == 0 || k == 0)
+		return 0;
+
+	// kept sorted by insertion, k is small
+	auto visit = [&](unsigned int e)
+	{
+		const BallHashEntryT<T> &entry = hash.m_entries[e];
+
+		T dx = entry.m_x - pt.x, dy = entry.m_y - pt.y;
+		T distSq = dx * dx + dy * dy;
+
+		if (found == k && !(distSq < pDistSq[k - 1]))
+			return;
+
+		unsigned int j = found < k ? found++ : k - 1;
+		for (; j > 0 && distSq < pDistSq[j - 1]; --j)
+		{
+			pOut[j]		= pOut[j - 1];
+			pDistSq[j]	= pDistSq[j - 1];
+		}
+
+		pOut[j]		= entry.m_ball;
+		pDistSq[j]	= distSq;
+	};
+
+	int cx = CellOf(hash, pt.x), cy = CellOf(hash, pt.y);
+
+	// rings before the first occupied cell are empty, rings after the last
+	// one add nothing
+	int ringFirst = 0, ringLast = 0;
+	int gap[4] = { hash.m_minCellX - cx, cx - hash.m_maxCellX, hash.m_minCellY - cy, cy - hash.m_maxCellY };
+	int span[4] = { cx - hash.m_minCellX, hash.m_maxCellX - cx, cy - hash.m_minCellY, hash.m_maxCellY - cy };
+	for (int i = 0; i < 4; ++i)
+	{
+		if (gap[i] > ringFirst)		ringFirst	= gap[i];
+		if (span[i] > ringLast)		ringLast	= span[i];
+	}
+
+	for (int ring = ringFirst; ring <= ringLast; ++ring)
+	{
+		int y0 = cy - ring > hash.m_minCellY ? cy - ring : hash.m_minCellY;
+		int y1 = cy + ring < hash.m_maxCellY ? cy + ring : hash.m_maxCellY;
+		int x0 = cx - ring > hash.m_minCellX ? cx - ring : hash.m_minCellX;
+		int x1 = cx + ring < hash.m_maxCellX ? cx + ring : hash.m_maxCellX;
+
+		for (int y = y0; y <= y1; ++y)
+		{
+			// whole row on the top and bottom of the ring, only its two ends
+			// in between
+			if (y == cy - ring || y == cy + ring)
+			{
+				for (int x = x0; x <= x1; ++x)
+					VisitCell(hash, x, y, visit);
+			}
+			else
+			{
+				if (cx - ring >= hash.m_minCellX)
+					VisitCell(hash, cx - ring, y, visit);
+				if (ring > 0 && cx + ring <= hash.m_maxCellX)
+					VisitCell(hash, cx + ring, y, visit);
+			}
+		}
+
+		// the balls left are in the next rings, at least ring cells away
+		T reach = hash.m_cellSize * T(ring);
+		if (found == k && pDistSq[k - 1] <= reach * reach)
+			break;
+	}
+
+	return found;
+}
+
+#define CSD1130_INSTANTIATE_BALL_HASH(T)																				\
+	template void InitBallHash<T>(BallHashT<T>&, unsigned int, T);														\
+	template void FreeBallHash<T>(BallHashT<T>&);																		\
+	template void BuildBallHash<T>(BallHashT<T>&, const CircleT<T>*);													\
+	template unsigned int QueryBallHashRegion<T>(const BallHashT<T>&, const CSD1130::Vector2DT<T>&,						\
+		const CSD1130::Vector2DT<T>&, unsigned int*, unsigned int);														\
+	template unsigned int QueryBallHashRadius<T>(const BallHashT<T>&, const CSD1130::Vector2DT<T>&, T,					\
+		unsigned int*, unsigned int);																					\
+	template unsigned int QueryBallHashNearest<T>(const BallHashT<T>&, const CSD1130::Vector2DT<T>&, unsigned int,		\
+		unsigned int*, T*);
+
+CSD1130_INSTANTIATE_BALL_HASH(float)
+CSD1130_INSTANTIATE_BALL_HASH(double)
+CSD1130_INSTANTIATE_BALL_HASH(CSD1130::Fixed)
+
+#undef CSD1130_INSTANTIATE_BALL_HASH
@@ -0,0 +1,230 @@
+/******************************************************************************/
+/*!
+\file		CageBatch.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 23, 2023
+\brief
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/******************************************************************************/
+/*!
+	The threads wait for m_round to change, then take worlds from m_next
+	until there are none left. m_round, m_busy, m_stepNum and m_quit are
+	shared, under m_lock; the arrays are the batch's
+ */
+/******************************************************************************/
+struct CageBatchPool
+{
+	CageWorld					*m_worlds;
+	unsigned int				m_worldNum;
+	const unsigned int			*m_ballStart;
+	CSD1130::Vec2				*m_pos;
+	CSD1130::Vec2				*m_vel;
+
+	std::vector<std::thread>	m_threads;
+	std::mutex					m_lock;
+	std::condition_variable		m_wake;			// a batch step was started, or time to quit
+	std::condition_variable		m_done;			// a thread ran out of worlds
+	unsigned int				m_round;		// batch steps started so far
+	unsigned int				m_busy;			// threads still on the current one
+	unsigned int				m_stepNum;
+	std::atomic<unsigned int>	m_next;			// next world to hand out
+	bool						m_quit;
+};
+
+namespace
+{
+	/**************************************************************************/
+	/*!
+		Writes the balls of the world, in the order of the level
+	 */
+	/**************************************************************************/
+	void WriteWorldBalls(const CageWorld &world, CSD1130::Vec2 *pPos, CSD1130::Vec2 *pVel)
+	{
+		for (unsigned int i = 0; i < world.m_ballNum; ++i)
+		{
+			unsigned int k = world.m_ballId[i];
+
+			pPos[k] = world.m_ballData[i].m_center;
+			pVel[k] = world.m_ballVel[i];
+		}
+	}
+
+	/**************************************************************************/
+	/*!
+		Steps the worlds not handed out yet, one at a time, until there are
+		none left
+	 */
+	/**************************************************************************/
+	void StepWorlds(CageBatchPool &pool, unsigned int stepNum)
+	{
+		for (;;)
+		{
+			unsigned int w = pool.m_next.fetch_add(1);
+			if (w >= pool.m_worldNum)
+				return;
+
+			CageWorld &world = pool.m_worlds[w];
+			for (unsigned int s = 0; s < stepNum; ++s)
+				StepCageWorld(world);
+
+			WriteWorldBalls(world, pool.m_pos + pool.m_ballStart[w], pool.m_vel + pool.m_ballStart[w]);
+		}
+	}
+
+	/**************************************************************************/
+	/*!
+		Body of a thread of the pool: steps worlds every batch step, until
+		told to quit
+	 */
+	/**************************************************************************/
+	void RunBatchThread(CageBatchPool *pPool)
+	{
+		std::unique_lock<std::mutex> lock(pPool->m_lock);
+		unsigned int round = 0;					// m_round when the pool was made
+
+		for (;;)
+		{
+			pPool->m_wake.wait(lock, [pPool, &round]() { return pPool->m_quit || pPool->m_round != round; });
+			if (pPool->m_quit)
+				return;
+
+			round = pPool->m_round;
+			unsigned int stepNum = pPool->m_stepNum;
+
+			lock.unlock();
+			StepWorlds(*pPool, stepNum);
+			lock.lock();
+
+			if (--pPool->m_busy == 0)
+				pPool->m_done.notify_all();
+		}
+	}
+}
+
+/******************************************************************************/
+/*!
+* \brief Sizes the output of a batch, writes the balls there and starts the
+*		threads
+* \param batch:		output - batch
+* \param pWorlds:	input - worlds, stepped by the batch from now on
+* \param worldNum:	input - number of worlds
+* \param threadNum:	input - threads stepping them (the caller included), 0 for all
+ */
+/******************************************************************************/
+void InitCageBatch(CageBatch &batch,
+					CageWorld *pWorlds,
+					unsigned int worldNum,
+					unsigned int threadNum)
+{
+	batch = CageBatch{};
+	batch.m_worlds		= pWorlds;
+	batch.m_worldNum	= worldNum;
+	batch.m_ballStart	= new unsigned int[worldNum + 1];
+
+	batch.m_ballStart[0] = 0;
+	for (unsigned int w = 0; w < worldNum; ++w)
+		batch.m_ballStart[w + 1] = batch.m_ballStart[w] + pWorlds[w].m_ballNum;
+
+	batch.m_pos = new CSD1130::Vec2[batch.m_ballStart[worldNum]];
+	batch.m_vel = new CSD1130::Vec2[batch.m_ballStart[worldNum]];
+
+	for (unsigned int w = 0; w < worldNum; ++w)
+		WriteWorldBalls(pWorlds[w], batch.m_pos + batch.m_ballStart[w], batch.m_vel + batch.m_ballStart[w]);
+
+	if (threadNum == 0)
+		threadNum = std::thread::hardware_concurrency();
+	if (threadNum > worldNum)
+		threadNum = worldNum;
+	if (threadNum == 0)
+		threadNum = 1;
+
+	CageBatchPool *pPool = new CageBatchPool;
+	pPool->m_worlds		= pWorlds;
+	pPool->m_worldNum	= worldNum;
+	pPool->m_ballStart	= batch.m_ballStart;
+	pPool->m_pos		= batch.m_pos;
+	pPool->m_vel		= batch.m_vel;
+	pPool->m_round		= 0;
+	pPool->m_busy		= 0;
+	pPool->m_stepNum	= 0;
+	pPool->m_next		= worldNum;
+	pPool->m_quit		= false;
+
+	// the caller steps worlds too
+	for (unsigned int t = 1; t < threadNum; ++t)
+		pPool->m_threads.push_back(std::thread(RunBatchThread, pPool));
+
+	batch.m_pool = pPool;
+}
+
+/******************************************************************************/
+/*!
+* \brief Steps every world of a batch, then writes their balls to the output
+* \param batch:		input/output - batch
+* \param stepNum:	input - steps of each world
+ */
+/******************************************************************************/
+void StepCageBatch(CageBatch &batch,
+					unsigned int stepNum)
+{
+	CageBatchPool &pool = *batch.m_pool;
+
+	{
+		std::lock_guard<std::mutex> lock(pool.m_lock);
+		pool.m_stepNum	= stepNum;
+		pool.m_next		= 0;
+		pool.m_busy		= (unsigned int)pool.m_threads.size();
+		++pool.m_round;
+	}
+	pool.m_wake.notify_all();
+
+	StepWorlds(pool, stepNum);
+
+	std::unique_lock<std::mutex> lock(pool.m_lock);
+	pool.m_done.wait(lock, [&pool]() { return pool.m_busy == 0; });
+}
+
+/******************************************************************************/
+/*!
+* \brief Stops the threads of a batch and releases its output
+* \param batch:		input/output - batch, empty afterwards (not the worlds)
+ */
+/******************************************************************************/
+void FreeCageBatch(CageBatch &batch)
+{
+	if (batch.m_pool)
+	{
+		CageBatchPool *pPool = batch.m_pool;
+		{
+			std::lock_guard<std::mutex> lock(pPool->m_lock);
+			pPool->m_quit = true;
+		}
+		pPool->m_wake.notify_all();
+
+		for (std::thread &thread : pPool->m_threads)
+			thread.join();
+
+		delete pPool;
+	}
+
+	delete []batch.m_ballStart;
+	delete []batch.m_pos;
+	delete []batch.m_vel;
+
+	batch = CageBatch{};
+}
@@ -0,0 +1,514 @@
+/******************************************************************************/
+/*!
+\file		CageShard.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 25, 2023
+\brief
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+#include <algorithm>
+#include <chrono>
+#include <float.h>
+#include <new>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	const char			SHARD_SPACE_TAG[4]		= { 'C', 'S', 'H', 'D' };
+	const unsigned int	SHARD_SPACE_VERSION		= 2;
+
+	// The halo covers balls this many times faster than the fastest at the
+	// start (collisions trade speed)
+	const float			SHARD_HALO_SPEED		= 2.0f;
+
+	/**************************************************************************/
+	/*!
+		Where the parts of the space are, past the header
+	 */
+	/**************************************************************************/
+	size_t StatsOffset()
+	{
+		return (sizeof(ShardSpaceHeader) + 63) & ~(size_t)63;
+	}
+
+	size_t ExportBytes(unsigned int ballNum)
+	{
+		size_t bytes = offsetof(ShardExport, m_balls) + (size_t)(ballNum ? ballNum : 1) * sizeof(CageWorldBall);
+		return (bytes + 63) & ~(size_t)63;
+	}
+
+	size_t ExportsOffset(unsigned int shardNum)
+	{
+		return StatsOffset() + ((shardNum * sizeof(ShardStats) + 63) & ~(size_t)63);
+	}
+
+	size_t OutputOffset(unsigned int shardNum, unsigned int ballNum)
+	{
+		return ExportsOffset(shardNum) + 2 * (size_t)shardNum * ExportBytes(ballNum);
+	}
+
+	size_t SpaceBytes(unsigned int shardNum, unsigned int ballNum)
+	{
+		return OutputOffset(shardNum, ballNum) + 2 * (size_t)ballNum * sizeof(CSD1130::Vec2);
+	}
+
+	/**************************************************************************/
+	/*!
+		Points the space at its parts, mapped at pAddress
+	 */
+	/**************************************************************************/
+	void SetSpaceParts(ShardSpace &space, unsigned char *pAddress)
+	{
+		const ShardSpaceHeader &header = *(const ShardSpaceHeader*)pAddress;
+
+		space.m_header		= (ShardSpaceHeader*)pAddress;
+		space.m_stats		= (ShardStats*)(pAddress + StatsOffset());
+		space.m_exports		= pAddress + ExportsOffset(header.m_shardNum);
+		space.m_exportBytes	= ExportBytes(header.m_ballNum);
+		space.m_pos			= (CSD1130::Vec2*)(pAddress + OutputOffset(header.m_shardNum, header.m_ballNum));
+		space.m_vel			= space.m_pos + header.m_ballNum;
+	}
+
+	/**************************************************************************/
+	/*!
+		Export buffer of shard s for the steps of parity buffer
+	 */
+	/**************************************************************************/
+	ShardExport &Export(const ShardSpace &space, unsigned int s, unsigned int buffer)
+	{
+		return *(ShardExport*)(space.m_exports + (2 * s + buffer) * space.m_exportBytes);
+	}
+
+	/**************************************************************************/
+	/*!
+		Strip x is in
+	 */
+	/**************************************************************************/
+	unsigned int StripOf(const ShardSpaceHeader &header, float x)
+	{
+		const float *pFirst	= header.m_cut + 1;
+		const float *pLast	= header.m_cut + header.m_shardNum;
+
+		return (unsigned int)(std::upper_bound(pFirst, pLast, x) - pFirst);
+	}
+
+	/**************************************************************************/
+	/*!
+		Waits for every shard to get there. The last one in lets the others
+		go. Returns false if they don't all get there within m_timeout
+		seconds, or another shard already gave up: m_failed then tells
+		every shard still waiting to stop
+	 */
+	/**************************************************************************/
+	bool ShardBarrier(ShardSpaceHeader &header)
+	{
+		unsigned int round = header.m_round.load(std::memory_order_acquire);
+
+		if (header.m_failed.load(std::memory_order_acquire) != 0)
+			return false;
+
+		if (header.m_arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == header.m_shardNum)
+		{
+			header.m_arrived.store(0, std::memory_order_relaxed);
+			header.m_round.store(round + 1, std::memory_order_release);
+			return true;
+		}
+
+		std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() +
+			std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(header.m_timeout));
+
+		while (header.m_round.load(std::memory_order_acquire) == round)
+		{
+			if (header.m_failed.load(std::memory_order_relaxed) != 0 || std::chrono::steady_clock::now() > deadline)
+			{
+				header.m_failed.store(1, std::memory_order_release);
+				return false;
+			}
+
+			std::this_thread::yield();
+		}
+		return true;
+	}
+
+	/**************************************************************************/
+	/*!
+		The ball as a world gets it
+	 */
+	/**************************************************************************/
+	CageWorldBall WorldBall(const CageWorld &world, unsigned int i)
+	{
+		return CageWorldBall{ world.m_ballId[i], world.m_ballData[i], world.m_ballVel[i], world.m_ballSpeed[i] };
+	}
+
+	bool BallIdLess(const CageWorldBall &lhs, const CageWorldBall &rhs)
+	{
+		return lhs.m_id < rhs.m_id;
+	}
+}
+
+/******************************************************************************/
+/*!
+* \brief Creates the shared memory of the shards of a level
+* \param space:		output - space
+* \param name:		input - name of the shared memory
+* \param level:		input - level
+* \param shardNum:	input - number of shards, SHARD_NUM_MAX at most
+* \param dt:		input - step of every shard
+* \return bool: false if it can't be created
+ */
+/******************************************************************************/
+bool CreateShardSpace(ShardSpace &space,
+						const char *name,
+						const CageLevel &level,
+						unsigned int shardNum,
+						float dt)
+{
+	space = ShardSpace{};
+
+	if (shardNum == 0 || shardNum > SHARD_NUM_MAX || strlen(name) >= sizeof(space.m_name))
+		return false;
+
+	// the balls, particles left out, as the worlds number them
+	std::vector<float> ballX;
+	float maxRadius = 0.0f, maxSpeed = 0.0f;
+
+	for (unsigned int j = 0; j < level.m_ballNum; ++j)
+	{
+		const CageLevelBall &ball = level.m_balls[j];
+		if (ball.m_radius == 0.0f)
+			continue;
+
+		ballX.push_back(ball.m_pos.x);
+		maxRadius	= std::max(maxRadius, ball.m_radius);
+		maxSpeed	= std::max(maxSpeed, fabsf(ball.m_speed));
+	}
+
+	unsigned int ballNum = (unsigned int)ballX.size();
+	size_t bytes = SpaceBytes(shardNum, ballNum);
+
+	void *pHandle;
+	unsigned char *pAddress = (unsigned char*)MapSharedMemory(name, bytes, SHARED_ACCESS::ACCESS_CREATE, pHandle);
+	if (pAddress == 0)
+		return false;
+
+	// the tag goes in last: a shard that maps the memory before that
+	// doesn't take it for a space
+	ShardSpaceHeader *pHeader = new (pAddress) ShardSpaceHeader;
+	memset(pHeader->m_tag, 0, sizeof(pHeader->m_tag));
+	pHeader->m_version	= SHARD_SPACE_VERSION;
+	pHeader->m_shardNum	= shardNum;
+	pHeader->m_ballNum	= ballNum;
+	pHeader->m_dt		= dt;
+	pHeader->m_halo		= 2.0f * maxRadius + 2.0f * SHARD_HALO_SPEED * maxSpeed * dt;
+	pHeader->m_timeout	= SHARD_TIMEOUT;
+	pHeader->m_arrived.store(0, std::memory_order_relaxed);
+	pHeader->m_round.store(0, std::memory_order_relaxed);
+	pHeader->m_failed.store(0, std::memory_order_relaxed);
+
+	// as many balls in each strip
+	std::sort(ballX.begin(), ballX.end());
+
+	pHeader->m_cut[0]			= -FLT_MAX;
+	pHeader->m_cut[shardNum]	= FLT_MAX;
+	for (unsigned int s = 1; s < shardNum; ++s)
+	{
+		size_t k = (size_t)ballNum * s / shardNum;
+		pHeader->m_cut[s] = (k == 0 || k >= ballNum) ? pHeader->m_cut[s - 1] : 0.5f * (ballX[k - 1] + ballX[k]);
+	}
+
+	SetSpaceParts(space, pAddress);
+	for (unsigned int s = 0; s < shardNum; ++s)
+		space.m_stats[s] = ShardStats{};
+
+	std::atomic_thread_fence(std::memory_order_release);
+	memcpy(pHeader->m_tag, SHARD_SPACE_TAG, sizeof(SHARD_SPACE_TAG));
+
+	space.m_bytes	= bytes;
+	space.m_handle	= pHandle;
+	space.m_creator	= true;
+	strcpy(space.m_name, name);
+
+	return true;
+}
+
+/******************************************************************************/
+/*!
+* \brief Maps the shared memory of the shards, in a shard process
+* \param space:		output - space
+* \param name:		input - name of the shared memory
+* \return bool: false if there is no space of that name
+ */
+/******************************************************************************/
+bool OpenShardSpace(ShardSpace &space,
+					const char *name)
+{
+	space = ShardSpace{};
+
+	if (strlen(name) >= sizeof(space.m_name))
+		return false;
+
+	size_t bytes = 0;
+	void *pHandle;
+	unsigned char *pAddress = (unsigned char*)MapSharedMemory(name, bytes, SHARED_ACCESS::ACCESS_WRITE, pHandle);
+	if (pAddress == 0)
+		return false;
+
+	const ShardSpaceHeader *pHeader = (const ShardSpaceHeader*)pAddress;
+
+	if (bytes < sizeof(ShardSpaceHeader) || memcmp(pHeader->m_tag, SHARD_SPACE_TAG, sizeof(SHARD_SPACE_TAG)) != 0)
+	{
+		UnmapSharedMemory(pAddress, bytes, pHandle);
+		return false;
+	}
+
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	if (pHeader->m_version != SHARD_SPACE_VERSION || pHeader->m_shardNum == 0 || pHeader->m_shardNum > SHARD_NUM_MAX ||
+		bytes < SpaceBytes(pHeader->m_shardNum, pHeader->m_ballNum))
+	{
+		UnmapSharedMemory(pAddress, bytes, pHandle);
+		return false;
+	}
+
+	SetSpaceParts(space, pAddress);
+	space.m_bytes	= bytes;
+	space.m_handle	= pHandle;
+	space.m_creator	= false;
+	strcpy(space.m_name, name);
+
+	return true;
+}
+
+/******************************************************************************/
+/*!
+* \brief Unmaps the shared memory of the shards
+* \param space:		input/output - space, empty afterwards
+ */
+/******************************************************************************/
+void FreeShardSpace(ShardSpace &space)
+{
+	if (space.m_header)
+	{
+		UnmapSharedMemory(space.m_header, space.m_bytes, space.m_handle);
+
+		if (space.m_creator)
+			RemoveSharedMemory(space.m_name);
+	}
+
+	space = ShardSpace{};
+}
+
+/******************************************************************************/
+/*!
+* \brief Builds the world of a shard, with the balls of its strip and the
+*		ghosts around it
+* \param shard:			output - shard
+* \param space:			input - space made for the level
+* \param level:			input - level
+* \param index:			input - shard
+* \param extraCredits:	input - collision policy (see EXTRA_CREDITS)
+ */
+/******************************************************************************/
+void BuildCageShard(CageShard &shard,
+					ShardSpace &space,
+					const CageLevel &level,
+					unsigned int index,
+					int extraCredits)
+{
+	shard = CageShard{};
+	shard.m_space	= &space;
+	shard.m_index	= index;
+
+	const ShardSpaceHeader &header = *space.m_header;
+
+	// every shard has every ball at first (so the walls are banded for
+	// every radius), the particles only go to shard 0
+	CageLevel shardLevel = level;
+	CageLevelBall *pLevelBalls = new CageLevelBall[level.m_ballNum];
+
+	shardLevel.m_balls		= pLevelBalls;
+	shardLevel.m_ballNum	= 0;
+	for (unsigned int j = 0; j < level.m_ballNum; ++j)
+	{
+		if (index == 0 || level.m_balls[j].m_radius != 0.0f)
+			pLevelBalls[shardLevel.m_ballNum++] = level.m_balls[j];
+	}
+
+	CageWorld &world = shard.m_world;
+	BuildCageWorld(world, shardLevel, extraCredits, 0);
+	delete []pLevelBalls;
+
+	// the shards are stepped every step, in the same time
+	world.m_dt			= header.m_dt;
+	world.m_eventDriven	= 0;
+
+	shard.m_owned = new unsigned char[header.m_ballNum]();
+	shard.m_balls = new CageWorldBall[header.m_ballNum];
+
+	float x0 = header.m_cut[index] - header.m_halo;
+	float x1 = header.m_cut[index + 1] + header.m_halo;
+	unsigned int num = 0, ghostNum = 0;
+
+	for (unsigned int i = 0; i < world.m_ballNum; ++i)
+	{
+		float x = world.m_ballData[i].m_center.x;
+
+		if (StripOf(header, x) == index)
+		{
+			shard.m_owned[world.m_ballId[i]] = 1;
+			shard.m_balls[num++] = WorldBall(world, i);
+		}
+		else if (x >= x0 && x < x1)
+		{
+			shard.m_balls[num++] = WorldBall(world, i);
+			++ghostNum;
+		}
+	}
+
+	ReplaceCageWorldBalls(world, shard.m_balls, num);
+	shard.m_ghostNum = ghostNum;
+
+	ShardStats &stats = space.m_stats[index];
+	stats.m_owned		= num - ghostNum;
+	stats.m_ghostNum	= ghostNum;
+}
+
+/******************************************************************************/
+/*!
+* \brief Steps a shard, then trades balls with its neighbours
+* \param shard:		input/output - shard
+* \return bool: false if the shards didn't all get to the barrier in time
+ */
+/******************************************************************************/
+bool StepCageShard(CageShard &shard)
+{
+	ShardSpace			&space	= *shard.m_space;
+	ShardSpaceHeader	&header	= *space.m_header;
+	ShardStats			&stats	= space.m_stats[shard.m_index];
+	CageWorld			&world	= shard.m_world;
+	unsigned int		s		= shard.m_index;
+	unsigned int		buffer	= shard.m_step++ & 1;
+	float				halo	= header.m_halo;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	StepCageWorld(world);
+	std::chrono::steady_clock::time_point stepped = std::chrono::steady_clock::now();
+
+	// what the shard owns: to the output, and to the neighbours if it is
+	// near them. The balls that went to a neighbour are only ghosts now
+	ShardExport		&out		= Export(space, s, buffer);
+	unsigned int	num			= 0;
+	unsigned int	ghostNum	= 0;
+	unsigned int	migrateNum	= 0;
+
+	out.m_num = 0;
+	for (unsigned int i = 0; i < world.m_ballNum; ++i)
+	{
+		unsigned int id = world.m_ballId[i];
+		if (!shard.m_owned[id])
+			continue;
+
+		CageWorldBall	ball	= WorldBall(world, i);
+		float			x		= ball.m_ball.m_center.x;
+		unsigned int	strip	= StripOf(header, x);
+
+		space.m_pos[id] = ball.m_ball.m_center;
+		space.m_vel[id] = ball.m_vel;
+
+		if (x < header.m_cut[s] + halo || x >= header.m_cut[s + 1] - halo)
+			out.m_balls[out.m_num++] = ball;
+
+		if (strip + 1 == s || strip == s + 1)
+		{
+			shard.m_owned[id] = 0;
+			++migrateNum;
+
+			if (x >= header.m_cut[s] - halo && x < header.m_cut[s + 1] + halo)
+			{
+				shard.m_balls[num++] = ball;
+				++ghostNum;
+			}
+			continue;
+		}
+
+		// past the next strip: kept, the neighbours only look at theirs
+		if (strip != s)
+			++stats.m_strayNum;
+
+		shard.m_balls[num++] = ball;
+	}
+
+	bool together = ShardBarrier(header);
+	std::chrono::steady_clock::time_point met = std::chrono::steady_clock::now();
+
+	stats.m_stepTime	+= std::chrono::duration<double>(stepped - start).count();
+	stats.m_waitTime	+= std::chrono::duration<double>(met - stepped).count();
+
+	// the neighbours' exports may be half written, or of another step
+	if (!together)
+		return false;
+
+	// from the neighbours: the balls now in the strip, and the ghosts
+	for (unsigned int n = (s > 0) ? s - 1 : s + 1; n <= s + 1 && n < header.m_shardNum; n += 2)
+	{
+		const ShardExport &in = Export(space, n, buffer);
+
+		for (unsigned int k = 0; k < in.m_num; ++k)
+		{
+			const CageWorldBall &ball = in.m_balls[k];
+			float x = ball.m_ball.m_center.x;
+
+			if (StripOf(header, x) == s)
+			{
+				shard.m_owned[ball.m_id] = 1;
+				shard.m_balls[num++] = ball;
+				++stats.m_migrateNum;
+			}
+			else if (x >= header.m_cut[s] - halo && x < header.m_cut[s + 1] + halo)
+			{
+				shard.m_balls[num++] = ball;
+				++ghostNum;
+			}
+		}
+	}
+
+	// nothing came or went: the world carries on as it is. Only the ghosts
+	// moved: it sets them again in place, without starting over
+	if (migrateNum != 0 || ghostNum != 0 || shard.m_ghostNum != 0 || num != world.m_ballNum)
+	{
+		std::sort(shard.m_balls, shard.m_balls + num, BallIdLess);
+		ReplaceCageWorldBalls(world, shard.m_balls, num);
+	}
+
+	shard.m_ghostNum = ghostNum;
+
+	stats.m_owned		= num - ghostNum;
+	stats.m_ghostNum	= ghostNum;
+	return true;
+}
+
+/******************************************************************************/
+/*!
+* \brief Releases what BuildCageShard allocated
+* \param shard:		input/output - shard, empty afterwards (not its space)
+ */
+/******************************************************************************/
+void FreeCageShard(CageShard &shard)
+{
+	FreeCageWorld(shard.m_world);
+
+	delete []shard.m_owned;
+	delete []shard.m_balls;
+
+	shard = CageShard{};
+}
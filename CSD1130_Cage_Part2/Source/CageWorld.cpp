@@ -0,0 +1,2612 @@
+/******************************************************************************/
+/*!
+\file		CageWorld.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 23, 2023
+\brief
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+#include <algorithm>
+#include <vector>
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const float			PI_OVER_180				= PI/180.0f;
+const int			PILLAR_BOUNCE_MAX		= 4;	//Pillar bounces a ball can take in one step
+const int			BALL_PASS_MAX			= 8;	//Passes over the ball pairs in one step
+const int			WALL_PASS_MAX			= 2;	//Passes over the walls, when the first one bounced the ball
+const unsigned int	BAND_RADIUS_MAX			= 16;	//Distinct ball radii the walls are expanded by at load
+const unsigned int	BAND_NONE				= 0xFFFFFFFF;
+const unsigned int	BALL_NONE				= 0xFFFFFFFF;	//A ball the world doesn't have
+const float			CLEARANCE_MAX			= 128.0f;	//Furthest the cage is looked for around a ball
+const float			CLEARANCE_MARGIN		= 1.0f;	//Taken off the distance to the cage, for rounding
+const float			FIELD_CELL_SIZE			= 4.0f;	//Distance between the samples of the distance field of the cage
+const unsigned int	FIELD_THREAD_NUM		= 0;	//Threads sampling it at load, 0: one per hardware thread
+const float			EVENT_HORIZON			= 4.0f;	//Seconds ahead the next impact of a ball is looked for
+const float			EVENT_MARGIN			= 1.0f;	//Balls are stepped from this far off the cage, for rounding
+const double		EVENT_STEP				= 1.0 / 60.0;	//Step of the balls due during a time jump
+const float			ORBIT_TOLERANCE			= 0.05f;	//Bounces this close (hit point and velocity) repeat each other
+const float			CONTACT_REACH			= 24.0f;	//Distance a ball can go before its contact cache is rebuilt
+const int			WALL_BOUNCE_MAX			= 4;	//Wall bounces a ball can take in one step, tiled
+const unsigned int	BALL_SORT_PERIOD		= 30;	//Steps between two sorts of the balls along the Z-order curve
+const int			KINEMATIC_BOUNCE_MAX	= 2;	//Kinematic wall bounces a ball can take in one step
+const float			STREAM_LOOKAHEAD		= 0.5f;	//Seconds ahead of the balls the wall tiles are read for
+const float			DEFAULT_DT				= 0.01667f;	//Float step a world starts with
+
+const CSD1130::Fixed	FIXED_DT				{ 0.01667f };			//Constant step of the fixed-point simulation
+const CSD1130::Fixed	FIXED_PI_OVER_180		{ 0.017453292519943 };
+
+// walls and vertices a ball is tested against, when not all of them: the walls
+// of class c are m_walls[m_classStart[c], m_classStart[c + 1]), in wall order
+struct WallSubset
+{
+	const unsigned int	*m_walls;
+	const unsigned int	*m_classStart;
+	const unsigned int	*m_vertices;
+	unsigned int		m_vertexNum;
+};
+
+template <COLLISION_POLICY P> static void UpdateBallsFloat(CageWorld &);
+template <COLLISION_POLICY P> static void UpdateBallsFixed(CageWorld &);
+template <COLLISION_POLICY P> static void AdvanceBallEvents(CageWorld &, double);
+
+/******************************************************************************/
+/*!
+	Tests one ball against a group of walls that all have class C, and
+	reflects it off every wall it hits, using collision policy P. pBands
+	holds the walls expanded by the ball radius (or is 0). With pIndex, only
+	walls pWalls[pIndex[0 .. wallNum)] are tested. Returns true if it hit
+	any
+*/
+/******************************************************************************/
+template <COLLISION_POLICY P, LINE_CLASS C, typename T>
+bool CollideBallWithWalls(const CircleT<T> &ballData,
+						CSD1130::Vector2DT<T> &posNext,
+						CSD1130::Vector2DT<T> &velCurr,
+						T speed,
+						const LineSegmentT<T> *pWalls,
+						const LineSegmentBandT<T> *pBands,
+						unsigned int wallNum,
+						const unsigned int *pIndex = 0)
+{
+	CSD1130::Vector2DT<T>	interPtA;
+	CSD1130::Vector2DT<T>	normalAtCollision;
+	T						interTime{};
+	bool					hit = false;
+
+	for (unsigned int j = 0; j < wallNum; ++j)
+	{
+		unsigned int w = pIndex ? pIndex[j] : j;
+		const LineSegmentT<T> &lineSegData = pWalls[w];
+
+		if (LineNormal<C>::Dot(velCurr, lineSegData.m_normal) < T(0))
+		{
+			int collided = pBands ?
+				CollisionIntersection_CircleLineSegment<T, C, P>(ballData,
+					posNext,
+					lineSegData,
+					pBands[w],
+					interPtA,
+					normalAtCollision,
+					interTime) :
+				CollisionIntersection_CircleLineSegment<T, C, P>(ballData,
+					posNext,
+					lineSegData,
+					interPtA,
+					normalAtCollision,
+					interTime);
+
+			if (collided)
+			{
+				CSD1130::Vector2DT<T> reflectedVec;
+
+				CollisionResponse_CircleLineSegment(interPtA,
+					normalAtCollision,
+					velCurr,
+					posNext,
+					reflectedVec);
+
+				velCurr = reflectedVec * speed;
+				hit		= true;
+			}
+		}
+	}
+
+	return hit;
+}
+
+/******************************************************************************/
+/*!
+	Tests one ball against the arcs and reflects it off every arc it hits
+*/
+/******************************************************************************/
+template <typename T>
+void CollideBallWithArcs(const CircleT<T> &ballData,
+						CSD1130::Vector2DT<T> &posNext,
+						CSD1130::Vector2DT<T> &velCurr,
+						T speed,
+						const ArcT<T> *pArcs,
+						unsigned int arcNum)
+{
+	CSD1130::Vector2DT<T>	interPtA;
+	CSD1130::Vector2DT<T>	normalAtCollision;
+	T						interTime{};
+
+	for (unsigned int j = 0; j < arcNum; ++j)
+	{
+		if (CollisionIntersection_CircleArc(ballData,
+			posNext,
+			pArcs[j],
+			interPtA,
+			normalAtCollision,
+			interTime))
+		{
+			CSD1130::Vector2DT<T> reflectedVec;
+
+			CollisionResponse_CircleLineSegment(interPtA,
+				normalAtCollision,
+				velCurr,
+				posNext,
+				reflectedVec);
+
+			velCurr = reflectedVec * speed;
+		}
+	}
+}
+
+/******************************************************************************/
+/*!
+	Tests one ball against the pillars in the grid cells it can reach this
+	step, one row of cells (one contiguous range of pillars) at a time, and
+	reflects it off the pillars it hits, in the order it hits them
+*/
+/******************************************************************************/
+template <typename T>
+void CollideBallWithPillars(const CircleT<T> &ballData,
+							CSD1130::Vector2DT<T> &posNext,
+							CSD1130::Vector2DT<T> &velCurr,
+							T speed,
+							const PillarGridT<T> &grid)
+{
+	CSD1130::Vector2DT<T>	interPtA;
+	CSD1130::Vector2DT<T>	normalAtCollision;
+	T						interTime{};
+
+	// this box holds the whole step
+	T reach = CSD1130::StepReach(posNext - ballData.m_center) + ballData.m_radius;
+
+	CSD1130::Vector2DT<T> boxMin{ ballData.m_center.x - reach, ballData.m_center.y - reach };
+	CSD1130::Vector2DT<T> boxMax{ ballData.m_center.x + reach, ballData.m_center.y + reach };
+
+	int x0, y0, x1, y1;
+	if (!PillarGridCellRange(grid, boxMin, boxMax, x0, y0, x1, y1))
+		return;
+
+	// Bounce off the pillar hit first (over all the rows), then go on from the
+	// contact point (from the start position, the new path would cut back
+	// through the pillar), a few times at most
+	CircleT<T> sweep = ballData;
+
+	for (int bounce = 0; ; ++bounce)
+	{
+		bool hit = false;
+
+		for (int y = y0; y <= y1; ++y)
+		{
+			CSD1130::Vector2DT<T>	rowInterPt, rowNormal;
+			T						rowInterTime;
+
+			unsigned int last = grid.m_cellStart[y * grid.m_cellsX + x1 + 1];
+			if (CollisionIntersection_CircleCircleSet(sweep,
+				posNext,
+				grid.m_pillars,
+				grid.m_cellStart[y * grid.m_cellsX + x0],
+				last,
+				rowInterPt,
+				rowNormal,
+				rowInterTime) < last && (!hit || rowInterTime < interTime))
+			{
+				hit					= true;
+				interPtA			= rowInterPt;
+				normalAtCollision	= rowNormal;
+				interTime			= rowInterTime;
+			}
+		}
+
+		if (!hit)
+			break;
+
+		// wedged between pillars: stay at the last contact, the only
+		// position known to be free
+		if (bounce == PILLAR_BOUNCE_MAX)
+		{
+			posNext = sweep.m_center;
+			break;
+		}
+
+		CSD1130::Vector2DT<T> reflectedVec;
+
+		CollisionResponse_CircleLineSegment(interPtA,
+			normalAtCollision,
+			velCurr,
+			posNext,
+			reflectedVec);
+
+		velCurr = reflectedVec * speed;
+		sweep.m_center = interPtA;
+	}
+}
+
+/******************************************************************************/
+/*!
+	Tests one ball against the wall vertices, each one once no matter how
+	many walls meet there, and reflects it off every vertex it hits.
+	With pIndex, only vertices pVertices[pIndex[0 .. indexNum)] are tested.
+	Only the POLICY_SEGMENT_AND_EDGES instantiation does any work.
+*/
+/******************************************************************************/
+template <COLLISION_POLICY P>
+struct CollideBallWithVertices
+{
+	template <typename T>
+	static void Run(const CircleT<T> &, CSD1130::Vector2DT<T> &, CSD1130::Vector2DT<T> &, T,
+					const LineVertexT<T> *, unsigned int)
+	{
+	}
+
+	template <typename T>
+	static void Run(const CircleT<T> &, CSD1130::Vector2DT<T> &, CSD1130::Vector2DT<T> &, T,
+					const LineVertexT<T> *, const unsigned int *, unsigned int)
+	{
+	}
+};
+
+template <>
+struct CollideBallWithVertices<COLLISION_POLICY::POLICY_SEGMENT_AND_EDGES>
+{
+	template <typename T>
+	static void Run(const CircleT<T> &ballData,
+					CSD1130::Vector2DT<T> &posNext,
+					CSD1130::Vector2DT<T> &velCurr,
+					T speed,
+					const LineVertexT<T> *pVertices,
+					unsigned int vertexNum)
+	{
+		CSD1130::Vector2DT<T>	interPtA;
+		CSD1130::Vector2DT<T>	normalAtCollision;
+		T						interTime{};
+
+		for (unsigned int j = 0; (j = CollisionIntersection_CircleVertices(ballData,
+			posNext,
+			velCurr,
+			pVertices,
+			j,
+			vertexNum,
+			interPtA,
+			normalAtCollision,
+			interTime)) < vertexNum; ++j)
+		{
+			CSD1130::Vector2DT<T> reflectedVec;
+
+			CollisionResponse_CircleLineSegment(interPtA,
+				normalAtCollision,
+				velCurr,
+				posNext,
+				reflectedVec);
+
+			velCurr = reflectedVec * speed;
+		}
+	}
+
+	template <typename T>
+	static void Run(const CircleT<T> &ballData,
+					CSD1130::Vector2DT<T> &posNext,
+					CSD1130::Vector2DT<T> &velCurr,
+					T speed,
+					const LineVertexT<T> *pVertices,
+					const unsigned int *pIndex,
+					unsigned int indexNum)
+	{
+		CSD1130::Vector2DT<T>	interPtA;
+		CSD1130::Vector2DT<T>	normalAtCollision;
+		T						interTime{};
+
+		// one vertex at a time, in the same order as above
+		for (unsigned int k = 0; k < indexNum; ++k)
+		{
+			unsigned int v = pIndex[k];
+
+			if (CollisionIntersection_CircleVertices(ballData,
+				posNext,
+				velCurr,
+				pVertices,
+				v,
+				v + 1,
+				interPtA,
+				normalAtCollision,
+				interTime) == v)
+			{
+				CSD1130::Vector2DT<T> reflectedVec;
+
+				CollisionResponse_CircleLineSegment(interPtA,
+					normalAtCollision,
+					velCurr,
+					posNext,
+					reflectedVec);
+
+				velCurr = reflectedVec * speed;
+			}
+		}
+	}
+};
+
+/******************************************************************************/
+/*!
+	Walls expanded by the radius of ball i, out of pWallBands (m_wallBands of the world or
+	its fixed-point copy), or 0 if its radius didn't get any
+*/
+/******************************************************************************/
+template <typename T>
+const LineSegmentBandT<T> *BallBands(const CageWorld &world, const LineSegmentBandT<T> *pWallBands, unsigned int i)
+{
+	return (world.m_ballBand[i] == BAND_NONE) ? 0 : pWallBands + world.m_ballBand[i] * world.m_wallNum;
+}
+
+/******************************************************************************/
+/*!
+	Stream of the walls of the level pack, for the simulation in T
+*/
+/******************************************************************************/
+template <typename T>
+WallStreamT<T> &CageStream(CageWorld &world);
+
+template <>
+WallStream &CageStream<float>(CageWorld &world)
+{
+	return world.m_wallStream;
+}
+
+template <>
+WallStreamx &CageStream<CSD1130::Fixed>(CageWorld &world)
+{
+	return world.m_wallStreamX;
+}
+
+/******************************************************************************/
+/*!
+	Gathers the streamed walls a ball can hit on its way to posNext, in
+	CageStream<T>(world).m_gathered (reading in the tiles it needs). Returns how
+	many
+*/
+/******************************************************************************/
+template <typename T>
+unsigned int GatherBallStreamedWalls(CageWorld &world,
+									const CircleT<T> &ballData,
+									const CSD1130::Vector2DT<T> &posNext)
+{
+	WallStreamT<T> &stream = CageStream<T>(world);
+
+	if (stream.m_tileNum == 0)
+		return 0;
+
+	T reach = CSD1130::StepReach(posNext - ballData.m_center) + ballData.m_radius + T(CLEARANCE_MARGIN);
+
+	return GatherStreamedWalls(stream, CSD1130::Vector2DT<T>{ ballData.m_center.x - reach, ballData.m_center.y - reach },
+		CSD1130::Vector2DT<T>{ ballData.m_center.x + reach, ballData.m_center.y + reach });
+}
+
+/******************************************************************************/
+/*!
+	Tests one ball against the end points of the streamed walls gathered
+	for it last (streamedNum of them), merged where walls meet, as
+	CollideBallWithVertices does the static ones. Only the
+	POLICY_SEGMENT_AND_EDGES instantiation merges them
+*/
+/******************************************************************************/
+template <COLLISION_POLICY P, typename T>
+void CollideBallWithStreamedVertices(CageWorld &world,
+									const CircleT<T> &ballData,
+									CSD1130::Vector2DT<T> &posNext,
+									CSD1130::Vector2DT<T> &velCurr,
+									T speed,
+									unsigned int streamedNum)
+{
+	if (P != COLLISION_POLICY::POLICY_SEGMENT_AND_EDGES || streamedNum == 0)
+		return;
+
+	WallStreamT<T> &stream = CageStream<T>(world);
+
+	CollideBallWithVertices<P>::Run(ballData, posNext, velCurr, speed, stream.m_gatheredVertices,
+		GatherStreamedVertices(stream, streamedNum));
+}
+
+/******************************************************************************/
+/*!
+	Tests one ball against all the walls, one class group at a time
+	(pWalls is m_wallData or its fixed-point copy, both grouped the same way,
+	pBands the walls expanded by the ball radius, or 0).
+	The arcs and pillars go first: next to a wall they can bounce the ball
+	toward it, and the wall test that follows catches that. The shared
+	vertices go last, so the wall kernels themselves never look at the end
+	points.
+	With pSubset, only the walls and vertices it holds are tested: the
+	others are too far to be hit (see BallWalls).
+	The streamed walls around the ball go with the other groups, in the
+	order the static ones would be in (see WriteWallPack), and their end
+	points, merged as the static ones are, after the static vertices: a
+	level runs the same streamed or not.
+*/
+/******************************************************************************/
+template <COLLISION_POLICY P, typename T>
+void CollideBallWithCage(CageWorld &world,
+						const CircleT<T> &ballData,
+						CSD1130::Vector2DT<T> &posNext,
+						CSD1130::Vector2DT<T> &velCurr,
+						T speed,
+						const LineSegmentT<T> *pWalls,
+						const LineSegmentBandT<T> *pBands,
+						const ArcT<T> *pArcs,
+						const PillarGridT<T> &pillarGrid,
+						const LineVertexT<T> *pVertices,
+						unsigned int vertexNum,
+						const WallSubset *pSubset = 0)
+{
+	const COLLISION_POLICY	SEGMENT	= COLLISION_POLICY::POLICY_SEGMENT_ONLY;
+	const unsigned int		*start	= world.m_wallClassStart;
+
+	CollideBallWithArcs(ballData, posNext, velCurr, speed, pArcs, world.m_arcNum);
+	CollideBallWithPillars(ballData, posNext, velCurr, speed, pillarGrid);
+
+	unsigned int			streamedNum		= GatherBallStreamedWalls(world, ballData, posNext);
+	const LineSegmentT<T>	*streamed		= CageStream<T>(world).m_gathered;
+
+	if (pSubset)
+	{
+		const unsigned int *cached	= pSubset->m_walls;
+		const unsigned int *at		= pSubset->m_classStart;
+
+		for (int pass = 0; pass < WALL_PASS_MAX; ++pass)
+		{
+			bool hit = false;
+
+			hit |= CollideBallWithWalls<SEGMENT, LINE_CLASS::LINE_HORIZONTAL>(ballData, posNext, velCurr, speed,
+				pWalls, pBands, at[1] - at[0], cached + at[0]);
+			hit |= CollideBallWithWalls<SEGMENT, LINE_CLASS::LINE_VERTICAL>(ballData, posNext, velCurr, speed,
+				pWalls, pBands, at[2] - at[1], cached + at[1]);
+			hit |= CollideBallWithWalls<SEGMENT, LINE_CLASS::LINE_GENERAL>(ballData, posNext, velCurr, speed,
+				pWalls, pBands, at[3] - at[2], cached + at[2]);
+			hit |= CollideBallWithWalls<SEGMENT, LINE_CLASS::LINE_GENERAL, T>(ballData, posNext, velCurr, speed,
+				streamed, 0, streamedNum);
+
+			if (!hit)
+				break;
+		}
+
+		CollideBallWithVertices<P>::Run(ballData, posNext, velCurr, speed, pVertices, pSubset->m_vertices, pSubset->m_vertexNum);
+		CollideBallWithStreamedVertices<P>(world, ballData, posNext, velCurr, speed, streamedNum);
+		return;
+	}
+
+	// a reflection off a later group can send the ball into a wall of an
+	// earlier one (a fast ball in a corner), so go over them again then
+	for (int pass = 0; pass < WALL_PASS_MAX; ++pass)
+	{
+		bool hit = false;
+
+		hit |= CollideBallWithWalls<SEGMENT, LINE_CLASS::LINE_HORIZONTAL>(ballData, posNext, velCurr, speed,
+			pWalls + start[0], pBands ? pBands + start[0] : 0, start[1] - start[0]);
+		hit |= CollideBallWithWalls<SEGMENT, LINE_CLASS::LINE_VERTICAL>(ballData, posNext, velCurr, speed,
+			pWalls + start[1], pBands ? pBands + start[1] : 0, start[2] - start[1]);
+		hit |= CollideBallWithWalls<SEGMENT, LINE_CLASS::LINE_GENERAL>(ballData, posNext, velCurr, speed,
+			pWalls + start[2], pBands ? pBands + start[2] : 0, start[3] - start[2]);
+		hit |= CollideBallWithWalls<SEGMENT, LINE_CLASS::LINE_GENERAL, T>(ballData, posNext, velCurr, speed,
+			streamed, 0, streamedNum);
+
+		if (!hit)
+			break;
+	}
+
+	CollideBallWithVertices<P>::Run(ballData, posNext, velCurr, speed, pVertices, vertexNum);
+	CollideBallWithStreamedVertices<P>(world, ballData, posNext, velCurr, speed, streamedNum);
+}
+
+/******************************************************************************/
+/*!
+	Earliest hit of each ball of a block (pBlock[0 .. blockNum)) against
+	walls [first, last), all of class C, kept in pHits if it is earlier
+	than the one found so far
+*/
+/******************************************************************************/
+template <LINE_CLASS C, typename T>
+void FindWallHits(const CageWorld &world,
+				const unsigned int *pBlock,
+				unsigned int blockNum,
+				const CSD1130::Vector2DT<T> *pPosNext,
+				const CSD1130::Vector2DT<T> *pVel,
+				const LineSegmentT<T> *pWalls,
+				const LineSegmentBandT<T> *pWallBands,
+				unsigned int first,
+				unsigned int last,
+				WallHitT<T> *pHits)
+{
+	const COLLISION_POLICY SEGMENT = COLLISION_POLICY::POLICY_SEGMENT_ONLY;
+
+	CSD1130::Vector2DT<T>	interPtA;
+	CSD1130::Vector2DT<T>	normalAtCollision;
+	T						interTime{};
+
+	for (unsigned int k = 0; k < blockNum; ++k)
+	{
+		unsigned int				i		= pBlock[k];
+		WallHitT<T>					&hit	= pHits[i];
+		const LineSegmentBandT<T>	*pBands	= BallBands(world, pWallBands, i);
+
+		for (unsigned int w = first; w < last; ++w)
+		{
+			if (LineNormal<C>::Dot(pVel[i], pWalls[w].m_normal) >= T(0))
+				continue;
+
+			int collided = pBands ?
+				CollisionIntersection_CircleLineSegment<T, C, SEGMENT>(hit.m_sweep, pPosNext[i], pWalls[w], pBands[w],
+					interPtA, normalAtCollision, interTime) :
+				CollisionIntersection_CircleLineSegment<T, C, SEGMENT>(hit.m_sweep, pPosNext[i], pWalls[w],
+					interPtA, normalAtCollision, interTime);
+
+			// a ball just bounced off a two sided wall touches its back at
+			// time 0, moving away from it: that is no hit
+			if (!collided || CSD1130::Vector2DDotProduct(pVel[i], normalAtCollision) >= T(0))
+				continue;
+
+			if (!hit.m_hit || interTime < hit.m_time)
+			{
+				hit.m_interPt	= interPtA;
+				hit.m_normal	= normalAtCollision;
+				hit.m_time		= interTime;
+				hit.m_hit		= true;
+			}
+		}
+	}
+}
+
+/******************************************************************************/
+/*!
+	Walls of class C against a block of balls, one block of wallTile walls
+	at a time
+*/
+/******************************************************************************/
+template <LINE_CLASS C, typename T>
+void FindWallHitsTiled(const CageWorld &world,
+					const unsigned int *pBlock,
+					unsigned int blockNum,
+					const CSD1130::Vector2DT<T> *pPosNext,
+					const CSD1130::Vector2DT<T> *pVel,
+					const LineSegmentT<T> *pWalls,
+					const LineSegmentBandT<T> *pWallBands,
+					WallHitT<T> *pHits,
+					unsigned int wallTile)
+{
+	unsigned int first	= world.m_wallClassStart[(int)C];
+	unsigned int last	= world.m_wallClassStart[(int)C + 1];
+
+	for (unsigned int w = first; w < last; w += wallTile)
+		FindWallHits<C>(world, pBlock, blockNum, pPosNext, pVel, pWalls, pWallBands, w,
+			(last - w > wallTile) ? w + wallTile : last, pHits);
+}
+
+/******************************************************************************/
+/*!
+	Tests the balls pBallList[0 .. ballListNum) against all the walls, in
+	blocks: a block of balls against every block of walls, with both in the
+	L1 cache, then the next block of balls. Each ball keeps the wall it hit
+	first over all the blocks, and is bounced off it once every block is
+	done; the balls that bounced go again from their contact point, a few
+	times at most.
+	The walls are not tested in turn, so the bounces can differ from
+	CollideBallWithWalls when a ball hits two walls in one step. Even off
+	a single wall the end point rounds differently: after a bounce this
+	sweeps again from the contact point, CollideBallWithWalls goes on from
+	where the ball started the step. The ball collisions that follow test
+	the same pairs in the same order either way, but from positions a few
+	ulps apart, and each bounce grows that (a level of 300 balls and 600
+	random walls ends some balls hundreds of units apart after 600 steps)
+*/
+/******************************************************************************/
+template <typename T>
+void CollideBallsWithWallsTiled(CageWorld &world,
+								const unsigned int *pBallList,
+								unsigned int ballListNum,
+								const CircleT<T> *pBalls,
+								CSD1130::Vector2DT<T> *pPosNext,
+								CSD1130::Vector2DT<T> *pVel,
+								const T *pSpeed,
+								const LineSegmentT<T> *pWalls,
+								const LineSegmentBandT<T> *pWallBands,
+								WallHitT<T> *pHits)
+{
+	// what a ball block keeps reading: its hits, end points and velocities;
+	// the wall block: the walls and, for most balls, their bands
+	unsigned int ballTile, wallTile;
+	ChooseTileSizes(sizeof(WallHitT<T>) + 2 * sizeof(CSD1130::Vector2DT<T>),
+		sizeof(LineSegmentT<T>) + (pWallBands ? sizeof(LineSegmentBandT<T>) : 0), ballTile, wallTile);
+
+	unsigned int *pActive	= world.m_tileActive;
+	unsigned int activeNum	= ballListNum;
+
+	for (unsigned int k = 0; k < ballListNum; ++k)
+	{
+		pActive[k]					= pBallList[k];
+		pHits[pBallList[k]].m_sweep	= pBalls[pBallList[k]];
+	}
+
+	for (int bounce = 0; activeNum > 0; ++bounce)
+	{
+		for (unsigned int k = 0; k < activeNum; ++k)
+			pHits[pActive[k]].m_hit = false;
+
+		for (unsigned int b = 0; b < activeNum; b += ballTile)
+		{
+			const unsigned int	*pBlock		= pActive + b;
+			unsigned int		blockNum	= (activeNum - b > ballTile) ? ballTile : activeNum - b;
+
+			FindWallHitsTiled<LINE_CLASS::LINE_HORIZONTAL>(world, pBlock, blockNum, pPosNext, pVel, pWalls, pWallBands, pHits,
+				wallTile);
+			FindWallHitsTiled<LINE_CLASS::LINE_VERTICAL>(world, pBlock, blockNum, pPosNext, pVel, pWalls, pWallBands, pHits,
+				wallTile);
+			FindWallHitsTiled<LINE_CLASS::LINE_GENERAL>(world, pBlock, blockNum, pPosNext, pVel, pWalls, pWallBands, pHits,
+				wallTile);
+		}
+
+		// bounce the balls that hit a wall, the others are done
+		unsigned int hitNum = 0;
+		for (unsigned int k = 0; k < activeNum; ++k)
+		{
+			unsigned int	i	= pActive[k];
+			WallHitT<T>		&hit	= pHits[i];
+
+			if (!hit.m_hit)
+				continue;
+
+			// wedged between walls: stay at the last contact, the only
+			// position known to be free
+			if (bounce == WALL_BOUNCE_MAX)
+			{
+				pPosNext[i] = hit.m_sweep.m_center;
+				continue;
+			}
+
+			CSD1130::Vector2DT<T> reflectedVec;
+
+			CollisionResponse_CircleLineSegment(hit.m_interPt,
+				hit.m_normal,
+				pVel[i],
+				pPosNext[i],
+				reflectedVec);
+
+			pVel[i]					= reflectedVec * pSpeed[i];
+			hit.m_sweep.m_center	= hit.m_interPt;
+			pActive[hitNum++]		= i;
+		}
+
+		activeNum = hitNum;
+	}
+}
+
+/******************************************************************************/
+/*!
+	CollideBallWithCage for the balls pBallList[0 .. ballListNum), with the
+	walls tested tiled: the arcs and pillars first, then the walls, then
+	the vertices, as there. The streamed walls, around each ball, come last
+*/
+/******************************************************************************/
+template <COLLISION_POLICY P, typename T>
+void CollideBallsWithCageTiled(CageWorld &world,
+								const unsigned int *pBallList,
+								unsigned int ballListNum,
+								const CircleT<T> *pBalls,
+								CSD1130::Vector2DT<T> *pPosNext,
+								CSD1130::Vector2DT<T> *pVel,
+								const T *pSpeed,
+								const LineSegmentT<T> *pWalls,
+								const LineSegmentBandT<T> *pWallBands,
+								const ArcT<T> *pArcs,
+								const PillarGridT<T> &pillarGrid,
+								const LineVertexT<T> *pVertices,
+								unsigned int vertexNum,
+								WallHitT<T> *pHits)
+{
+	for (unsigned int k = 0; k < ballListNum; ++k)
+	{
+		unsigned int i = pBallList[k];
+
+		CollideBallWithArcs(pBalls[i], pPosNext[i], pVel[i], pSpeed[i], pArcs, world.m_arcNum);
+		CollideBallWithPillars(pBalls[i], pPosNext[i], pVel[i], pSpeed[i], pillarGrid);
+	}
+
+	CollideBallsWithWallsTiled(world, pBallList, ballListNum, pBalls, pPosNext, pVel, pSpeed, pWalls, pWallBands, pHits);
+
+	for (unsigned int k = 0; k < ballListNum; ++k)
+	{
+		unsigned int i = pBallList[k];
+
+		unsigned int streamedNum = GatherBallStreamedWalls(world, pBalls[i], pPosNext[i]);
+		for (int pass = 0; pass < WALL_PASS_MAX; ++pass)
+		{
+			if (!CollideBallWithWalls<COLLISION_POLICY::POLICY_SEGMENT_ONLY, LINE_CLASS::LINE_GENERAL, T>(pBalls[i],
+				pPosNext[i], pVel[i], pSpeed[i], CageStream<T>(world).m_gathered, 0, streamedNum))
+				break;
+		}
+
+		CollideBallWithVertices<P>::Run(pBalls[i], pPosNext[i], pVel[i], pSpeed[i], pVertices, vertexNum);
+		CollideBallWithStreamedVertices<P>(world, pBalls[i], pPosNext[i], pVel[i], pSpeed[i], streamedNum);
+	}
+}
+
+/******************************************************************************/
+/*!
+	Distance from a ball to the closest wall, arc or pillar, less its radius
+	and CLEARANCE_MARGIN: the ball can go that far, any way, without
+	touching the cage. The cage isn't looked for past CLEARANCE_MAX.
+	An arc is never closer than its whole circle, which is what is used.
+	Inside the distance field it is read from there instead, in constant
+	time (a little short of the real distance)
+*/
+/******************************************************************************/
+template <typename T>
+T CageClearance(const CageWorld &world,
+				const CircleT<T> &ballData,
+				const LineSegmentT<T> *pWalls,
+				const ArcT<T> *pArcs,
+				const PillarGridT<T> &grid,
+				const DistanceFieldT<T> &field)
+{
+	const CSD1130::Vector2DT<T> &pt = ballData.m_center;
+
+	T dist;
+	if (SampleDistanceField(field, pt, dist))
+		return dist - field.m_slack - ballData.m_radius - T(CLEARANCE_MARGIN);
+
+	T distSq = T(CLEARANCE_MAX * CLEARANCE_MAX);
+	for (unsigned int w = 0; w < world.m_wallNum; ++w)
+	{
+		T wallDistSq = DistanceSquared_PointLineSegment(pt, pWalls[w]);
+		if (wallDistSq < distSq)
+			distSq = wallDistSq;
+	}
+
+	dist = CSD1130::ScalarSqrt(distSq);
+
+	for (unsigned int a = 0; a < world.m_arcNum; ++a)
+	{
+		T arcDist = CSD1130::ScalarAbs(CSD1130::Vector2DDistance(pt, pArcs[a].m_center) - pArcs[a].m_radius);
+		if (arcDist < dist)
+			dist = arcDist;
+	}
+
+	// only the pillars closer than that matter, they are in the cells around
+	CSD1130::Vector2DT<T> boxMin{ pt.x - dist, pt.y - dist };
+	CSD1130::Vector2DT<T> boxMax{ pt.x + dist, pt.y + dist };
+
+	int x0, y0, x1, y1;
+	if (PillarGridCellRange(grid, boxMin, boxMax, x0, y0, x1, y1))
+	{
+		for (int y = y0; y <= y1; ++y)
+		{
+			unsigned int last = grid.m_cellStart[y * grid.m_cellsX + x1 + 1];
+			for (unsigned int p = grid.m_cellStart[y * grid.m_cellsX + x0]; p < last; ++p)
+			{
+				T dx		= grid.m_pillars.m_x[p] - pt.x;
+				T dy		= grid.m_pillars.m_y[p] - pt.y;
+				T reach		= dist + grid.m_pillars.m_radius[p];
+				T centerSq	= dx * dx + dy * dy;
+
+				if (centerSq < reach * reach)
+					dist = CSD1130::ScalarSqrt(centerSq) - grid.m_pillars.m_radius[p];
+			}
+		}
+	}
+
+	return dist - ballData.m_radius - T(CLEARANCE_MARGIN);
+}
+
+/******************************************************************************/
+/*!
+	Walls and vertices a ball can hit on its step to posNext, in subset, or
+	0 for all of them. A ball in a room gets the walls of its room, and of
+	the rooms past the portals it can reach. Otherwise it gets its contact
+	cache, rebuilt around it first if the step leaves the cached region
+	(out to the whole step, if that is longer than CONTACT_REACH)
+*/
+/******************************************************************************/
+template <typename T>
+const WallSubset *BallWalls(CageWorld &world,
+							const CircleT<T> &ballData,
+							const CSD1130::Vector2DT<T> &posNext,
+							unsigned int room,
+							const RoomSetT<T> &rooms,
+							ContactCacheT<T> &cache,
+							const LineSegmentT<T> *pWalls,
+							const LineVertexT<T> *pVertices,
+							unsigned int vertexNum,
+							WallSubset &subset)
+{
+	if (room != ROOM_NONE)
+	{
+		T reach = CSD1130::StepReach(posNext - ballData.m_center) + ballData.m_radius + T(CLEARANCE_MARGIN);
+
+		subset.m_walls		= world.m_roomWalls;
+		subset.m_classStart	= world.m_roomClassStart;
+		subset.m_vertices	= world.m_roomVertices;
+		subset.m_vertexNum	= GatherRoomWalls(rooms, room, ballData.m_center, reach, world.m_roomWalls,
+									world.m_roomClassStart, world.m_roomVertices);
+		return &subset;
+	}
+
+	++world.m_cacheLookupNum;
+
+	if (ContactCacheCovers(cache, ballData.m_center, posNext))
+		++world.m_cacheHitNum;
+	else
+	{
+		// a step longer than CONTACT_REACH still has to be covered
+		T reach = CSD1130::StepReach(posNext - ballData.m_center);
+		if (reach < T(CONTACT_REACH))
+			reach = T(CONTACT_REACH);
+
+		BuildContactCache(cache, ballData.m_center, reach, ballData.m_radius, pWalls, world.m_wallClassStart, pVertices,
+			vertexNum);
+	}
+
+	if (cache.m_full)
+		return 0;
+
+	subset.m_walls		= cache.m_walls;
+	subset.m_classStart	= cache.m_classStart;
+	subset.m_vertices	= cache.m_vertices;
+	subset.m_vertexNum	= cache.m_vertexNum;
+	return &subset;
+}
+
+/******************************************************************************/
+/*!
+	True if the ball can reach the cage on its way to posNext
+*/
+/******************************************************************************/
+template <typename T>
+bool BallNearCage(const CircleT<T> &ballData,
+				const CSD1130::Vector2DT<T> &posNext,
+				T clearance,
+				T travel)
+{
+	return !(travel + CSD1130::StepReach(posNext - ballData.m_center) < clearance);
+}
+
+/******************************************************************************/
+/*!
+	Updates the clearance of a ball at the end of the step: worked out
+	again where it ended up if it was near the cage, otherwise the step is
+	added to its travel
+*/
+/******************************************************************************/
+template <typename T>
+void TrackClearance(const CageWorld &world,
+					const CircleT<T> &ballData,
+					const CSD1130::Vector2DT<T> &posNext,
+					bool near,
+					T &clearance,
+					T &travel,
+					const LineSegmentT<T> *pWalls,
+					const ArcT<T> *pArcs,
+					const PillarGridT<T> &grid,
+					const DistanceFieldT<T> &field)
+{
+	if (near)
+	{
+		clearance	= CageClearance(world, CircleT<T>{ posNext, ballData.m_radius }, pWalls, pArcs, grid, field);
+		travel		= T(0);
+		return;
+	}
+
+	travel += CSD1130::StepReach(posNext - ballData.m_center);
+}
+
+/******************************************************************************/
+/*!
+	Bounces the balls off each other (elastic collisions, mass from the
+	area), testing only the pairs the broadphase finds. A bounce changes
+	the path of both balls, so the pairs are gone over again (a few times
+	at most) until none bounces, found again from the new paths: a bounce
+	can send a ball further than the box it was found in reaches.
+	Runs after the cage tests, on paths that stay in the cage. Both balls
+	of a bounce get the cage tested again right away, from their contact
+	points (the new path starts there), so the next pairs are tested on
+	paths that stay in the cage too.
+*/
+/******************************************************************************/
+template <COLLISION_POLICY P, typename T>
+void CollideBalls(CageWorld &world,
+					const CircleT<T> *pBalls,
+					CSD1130::Vector2DT<T> *pPosNext,
+					CSD1130::Vector2DT<T> *pVel,
+					T *pSpeed,
+					SweepAndPruneT<T> &sap,
+					T dt,
+					const LineSegmentT<T> *pWalls,
+					const LineSegmentBandT<T> *pWallBands,
+					const ArcT<T> *pArcs,
+					const PillarGridT<T> &pillarGrid,
+					const LineVertexT<T> *pVertices,
+					unsigned int vertexNum)
+{
+	CSD1130::Vector2DT<T>	interPtA, interPtB;
+	CSD1130::Vector2DT<T>	normalAtCollision;
+	T						interTime{};
+
+	unsigned int pairNum = UpdateSweepAndPrune(sap, pBalls, pPosNext);
+
+	for (int pass = 0; pass < BALL_PASS_MAX; ++pass)
+	{
+		bool bounced = false;
+
+		for (unsigned int p = 0; p < pairNum; ++p)
+		{
+			unsigned int a = sap.m_pairs[p * 2];
+			unsigned int b = sap.m_pairs[p * 2 + 1];
+
+			if (CollisionIntersection_CircleCircleMoving(pBalls[a],
+				pPosNext[a],
+				pBalls[b],
+				pPosNext[b],
+				interPtA,
+				interPtB,
+				normalAtCollision,
+				interTime) &&
+				CollisionResponse_CircleCircle(normalAtCollision,
+				interTime,
+				dt,
+				pBalls[a].m_radius * pBalls[a].m_radius,
+				interPtA,
+				pVel[a],
+				pPosNext[a],
+				pBalls[b].m_radius * pBalls[b].m_radius,
+				interPtB,
+				pVel[b],
+				pPosNext[b]))
+			{
+				// the walls reflect at constant speed, keep it in sync
+				pSpeed[a]	= CSD1130::Vector2DLength(pVel[a]);
+				pSpeed[b]	= CSD1130::Vector2DLength(pVel[b]);
+				bounced		= true;
+
+				const CircleT<T> fromA{ interPtA, pBalls[a].m_radius };
+				const CircleT<T> fromB{ interPtB, pBalls[b].m_radius };
+
+				CollideBallWithCage<P>(world, fromA, pPosNext[a], pVel[a], pSpeed[a], pWalls, BallBands(world, pWallBands, a), pArcs,
+					pillarGrid, pVertices, vertexNum);
+				CollideBallWithCage<P>(world, fromB, pPosNext[b], pVel[b], pSpeed[b], pWalls, BallBands(world, pWallBands, b), pArcs,
+					pillarGrid, pVertices, vertexNum);
+			}
+		}
+
+		if (!bounced || pass + 1 == BALL_PASS_MAX)
+			break;
+
+		pairNum = UpdateSweepAndPrune(sap, pBalls, pPosNext);
+	}
+}
+
+/******************************************************************************/
+/*!
+	Bounces the balls off the kinematic walls, after the cage and each
+	other, on the paths those left them on. The walls that can be hit come
+	out of the tree of the set, queried with the box around what is left
+	of the step. A ball pushed by a wall gets the cage tested again right
+	away, from where it was hit, as after a bounce off another ball. Last,
+	the ball is pushed out of where the walls end up
+*/
+/******************************************************************************/
+template <COLLISION_POLICY P, typename T>
+void CollideBallsWithKinematicWalls(CageWorld &world,
+									const CircleT<T> *pBalls,
+									CSD1130::Vector2DT<T> *pPosNext,
+									CSD1130::Vector2DT<T> *pVel,
+									T *pSpeed,
+									const KinematicWallSetT<T> &set,
+									T dt,
+									const LineSegmentT<T> *pWalls,
+									const LineSegmentBandT<T> *pWallBands,
+									const ArcT<T> *pArcs,
+									const PillarGridT<T> &pillarGrid,
+									const LineVertexT<T> *pVertices,
+									unsigned int vertexNum)
+{
+	CSD1130::Vector2DT<T>	interPt, normalAtCollision, wallMove;
+	T						interTime{};
+
+	if (set.m_num == 0)
+		return;
+
+	for (unsigned int i = 0; i < world.m_ballNum; ++i)
+	{
+		CircleT<T>	from		= pBalls[i];
+		T			timeFrom	= T(0);
+
+		for (int bounce = 0; bounce < KINEMATIC_BOUNCE_MAX; ++bounce)
+		{
+			const CSD1130::Vector2DT<T> &posNext = pPosNext[i];
+			CSD1130::Vector2DT<T> boxMin{ ((from.m_center.x < posNext.x) ? from.m_center.x : posNext.x) - from.m_radius,
+										((from.m_center.y < posNext.y) ? from.m_center.y : posNext.y) - from.m_radius };
+			CSD1130::Vector2DT<T> boxMax{ ((from.m_center.x > posNext.x) ? from.m_center.x : posNext.x) + from.m_radius,
+										((from.m_center.y > posNext.y) ? from.m_center.y : posNext.y) + from.m_radius };
+
+			unsigned int num = QueryKinematicWalls(set, boxMin, boxMax, world.m_kinematicQuery);
+
+			// the first one hit
+			CSD1130::Vector2DT<T>	hitPt, hitNormal, hitMove;
+			T						hitTime	= T(1);
+			bool					hit		= false;
+
+			for (unsigned int k = 0; k < num; ++k)
+			{
+				if (CollisionIntersection_CircleKinematicWall(from,
+					posNext,
+					timeFrom,
+					set.m_walls[world.m_kinematicQuery[k]],
+					interPt,
+					normalAtCollision,
+					wallMove,
+					interTime) && (!hit || interTime < hitTime))
+				{
+					hitPt		= interPt;
+					hitNormal	= normalAtCollision;
+					hitMove		= wallMove;
+					hitTime		= interTime;
+					hit			= true;
+				}
+			}
+
+			if (!hit)
+				break;
+
+			pSpeed[i] = CollisionResponse_CircleKinematicWall(hitPt, hitNormal, hitMove, hitTime, dt, pVel[i], pPosNext[i]);
+
+			from.m_center	= hitPt;
+			timeFrom		= hitTime;
+
+			CollideBallWithCage<P>(world, from, pPosNext[i], pVel[i], pSpeed[i], pWalls, BallBands(world, pWallBands, i), pArcs,
+				pillarGrid, pVertices, vertexNum);
+		}
+
+		// out of where the walls end the step
+		const CSD1130::Vector2DT<T> &posNext = pPosNext[i];
+		CSD1130::Vector2DT<T> boxMin{ posNext.x - from.m_radius, posNext.y - from.m_radius };
+		CSD1130::Vector2DT<T> boxMax{ posNext.x + from.m_radius, posNext.y + from.m_radius };
+
+		unsigned int num	= QueryKinematicWalls(set, boxMin, boxMax, world.m_kinematicQuery);
+		bool pushed			= false;
+
+		for (unsigned int k = 0; k < num; ++k)
+			if (CollisionResolve_CircleKinematicWall(from.m_radius, set.m_walls[world.m_kinematicQuery[k]], dt, pVel[i],
+				pPosNext[i]))
+				pushed = true;
+
+		if (pushed)
+		{
+			pSpeed[i] = CSD1130::Vector2DLength(pVel[i]);
+
+			CollideBallWithCage<P>(world, from, pPosNext[i], pVel[i], pSpeed[i], pWalls, BallBands(world, pWallBands, i), pArcs,
+				pillarGrid, pVertices, vertexNum);
+		}
+	}
+}
+
+/******************************************************************************/
+/*!
+	Starts a step of the wall stream: the tiles read since the last step
+	are taken in, and the tiles each ball goes over in the next
+	STREAM_LOOKAHEAD seconds are asked for
+*/
+/******************************************************************************/
+template <typename T>
+void PrefetchBallTiles(CageWorld &world,
+						WallStreamT<T> &stream,
+						const CircleT<T> *pBalls,
+						const CSD1130::Vector2DT<T> *pVel)
+{
+	if (stream.m_tileNum == 0)
+		return;
+
+	BeginWallStreamStep(stream);
+
+	for (unsigned int i = 0; i < world.m_ballNum; ++i)
+	{
+		const CircleT<T> &ball = pBalls[i];
+		CSD1130::Vector2DT<T> ahead = ball.m_center + pVel[i] * T(STREAM_LOOKAHEAD);
+
+		CSD1130::Vector2DT<T> boxMin{ ((ball.m_center.x < ahead.x) ? ball.m_center.x : ahead.x) - ball.m_radius,
+									((ball.m_center.y < ahead.y) ? ball.m_center.y : ahead.y) - ball.m_radius };
+		CSD1130::Vector2DT<T> boxMax{ ((ball.m_center.x > ahead.x) ? ball.m_center.x : ahead.x) + ball.m_radius,
+									((ball.m_center.y > ahead.y) ? ball.m_center.y : ahead.y) + ball.m_radius };
+
+		PrefetchWallTiles(stream, boxMin, boxMax);
+	}
+}
+
+/******************************************************************************/
+/*!
+	How long until the ball gets within EVENT_MARGIN of the cage, going
+	straight at velCurr: against both sides and both ends of every wall,
+	and either side of the arcs and pillars, so it never comes too late.
+	EVENT_HORIZON if not before then
+*/
+/******************************************************************************/
+template <typename T>
+T CageImpactTime(const CageWorld &world,
+				const CircleT<T> &ballData,
+				const CSD1130::Vector2DT<T> &velCurr,
+				const LineSegmentT<T> *pWalls,
+				const ArcT<T> *pArcs,
+				const PillarGridT<T> &grid)
+{
+	const CSD1130::Vector2DT<T> &pt	= ballData.m_center;
+	CSD1130::Vector2DT<T> ptEnd		= pt + velCurr * T(EVENT_HORIZON);
+	T reach							= ballData.m_radius + T(EVENT_MARGIN);
+	T best							= T(1);
+	T t;
+
+	for (unsigned int w = 0; w < world.m_wallNum && best > T(0); ++w)
+		if (CollisionIntersection_PointCapsule(pt, ptEnd, pWalls[w], reach, t) && t < best)
+			best = t;
+
+	for (unsigned int a = 0; a < world.m_arcNum && best > T(0); ++a)
+	{
+		T dist = CSD1130::Vector2DDistance(pt, pArcs[a].m_center);
+
+		if (dist < pArcs[a].m_radius - reach)
+		{
+			if (CollisionIntersection_PointCircle(pt, ptEnd, pArcs[a].m_center, pArcs[a].m_radius - reach, t) && t < best)
+				best = t;
+		}
+		else if (dist > pArcs[a].m_radius + reach)
+		{
+			if (CollisionIntersection_PointCircle(pt, ptEnd, pArcs[a].m_center, pArcs[a].m_radius + reach, t) && t < best)
+				best = t;
+		}
+		else
+			best = T(0);
+	}
+
+	// pillars around the whole path
+	CSD1130::Vector2DT<T> boxMin{ (pt.x < ptEnd.x ? pt.x : ptEnd.x) - reach, (pt.y < ptEnd.y ? pt.y : ptEnd.y) - reach };
+	CSD1130::Vector2DT<T> boxMax{ (pt.x > ptEnd.x ? pt.x : ptEnd.x) + reach, (pt.y > ptEnd.y ? pt.y : ptEnd.y) + reach };
+
+	int x0, y0, x1, y1;
+	if (best > T(0) && PillarGridCellRange(grid, boxMin, boxMax, x0, y0, x1, y1))
+	{
+		for (int y = y0; y <= y1; ++y)
+		{
+			unsigned int last = grid.m_cellStart[y * grid.m_cellsX + x1 + 1];
+			for (unsigned int p = grid.m_cellStart[y * grid.m_cellsX + x0]; p < last; ++p)
+			{
+				CSD1130::Vector2DT<T> center{ grid.m_pillars.m_x[p], grid.m_pillars.m_y[p] };
+				T radius = grid.m_pillars.m_radius[p] + reach;
+
+				if (CSD1130::Vector2DSquareDistance(pt, center) <= radius * radius)
+					best = T(0);
+				else if (CollisionIntersection_PointCircle(pt, ptEnd, center, radius, t) && t < best)
+					best = t;
+			}
+		}
+	}
+
+	return best * T(EVENT_HORIZON);
+}
+
+/******************************************************************************/
+/*!
+	Event driven simulation: steps ball i over [tStart, tEnd] from its
+	straight line position, like UpdateBallsFloat would, and queues its
+	next impact. With orbits on (m_eventDriven == 2), a bounce is
+	recorded, and the ball isn't queued anymore once it is on an orbit
+*/
+/******************************************************************************/
+template <COLLISION_POLICY P>
+void StepBallEvent(CageWorld &world, unsigned int i, double tStart, double tEnd)
+{
+	Circle &ballData			= world.m_ballData[i];
+	CSD1130::Vec2 &velCurr		= world.m_ballVel[i];
+	CSD1130::Vec2 &posNext		= world.m_ballNext[i];
+	CSD1130::Vec2 velStart		= velCurr;
+	float duration				= (float)(tEnd - tStart);
+
+	ballData.m_center	= world.m_ballAnchor[i] + velCurr * (float)(tStart - world.m_ballAnchorTime[i]);
+	posNext				= ballData.m_center + velCurr * duration;
+
+	CSD1130::Vec2 posStart = ballData.m_center;
+
+	CollideBallWithCage<P>(world, ballData, posNext, velCurr, world.m_ballSpeed[i], world.m_wallData,
+		BallBands(world, world.m_wallBands, i), world.m_arcData, world.m_pillarGrid, world.m_wallVertices,
+		world.m_wallVertexNum);
+
+	ballData.m_center			= posNext;
+	world.m_ballAnchor[i]		= posNext;
+	world.m_ballAnchorTime[i]	= tEnd;
+
+	if (world.m_eventDriven == 2 && (velCurr.x != velStart.x || velCurr.y != velStart.y))
+	{
+		// where the path turned: Start + Vs a = H, H + Ve (duration - a) = End
+		CSD1130::Vec2 dV	= velStart - velCurr;
+		float a				= CSD1130::Vector2DDotProduct(posNext - posStart - velCurr * duration, dV) /
+								CSD1130::Vector2DSquareLength(dV);
+
+		if (a < 0.0f)
+			a = 0.0f;
+		if (a > duration)
+			a = duration;
+
+		if (AddBounce(world.m_orbits, i, posStart + velStart * a, velCurr, tStart + (double)a))
+		{
+			++world.m_orbitNum;
+			++world.m_eventNum;
+			return;
+		}
+	}
+
+	PushEvent(world.m_ballEvents, i, tEnd + (double)CageImpactTime(world, ballData, velCurr, world.m_wallData, world.m_arcData,
+		world.m_pillarGrid));
+	++world.m_eventNum;
+}
+
+/******************************************************************************/
+/*!
+	Event driven simulation up to time target: the balls due are stepped
+	in the order of their impacts, a step (EVENT_STEP at most) each, until
+	no impact is left before target. Then every ball is put where its
+	straight line (or its orbit) is at target
+*/
+/******************************************************************************/
+template <COLLISION_POLICY P>
+void AdvanceBallEvents(CageWorld &world, double target)
+{
+	unsigned int	i;
+	double			time;
+
+	while (PeekEvent(world.m_ballEvents, i, time) && time < target)
+	{
+		PopEvent(world.m_ballEvents);
+
+		// the next impact is queued at tEnd or later, so this ends
+		double tEnd = time + EVENT_STEP;
+		if (tEnd > target)
+			tEnd = target;
+
+		StepBallEvent<P>(world, i, time, tEnd);
+	}
+
+	world.m_eventClock = target;
+
+	for (unsigned int b = 0; b < world.m_ballNum; ++b)
+		if (!OrbitState(world.m_orbits, b, target, world.m_ballData[b].m_center, world.m_ballVel[b]))
+			world.m_ballData[b].m_center = world.m_ballAnchor[b] +
+											world.m_ballVel[b] * (float)(target - world.m_ballAnchorTime[b]);
+}
+
+/******************************************************************************/
+/*!
+	Event driven simulation step (see m_eventDriven). Switching to it
+	anchors every ball where it is and queues its next impact; switching
+	back only needs the clearances to be worked out again
+*/
+/******************************************************************************/
+static void UpdateBallsEvents(CageWorld &world)
+{
+	if (!world.m_eventsOn)
+	{
+		for (unsigned int i = 0; i < world.m_ballNum; ++i)
+		{
+			world.m_ballAnchor[i]		= world.m_ballData[i].m_center;
+			world.m_ballAnchorTime[i]	= world.m_eventClock;
+
+			PushEvent(world.m_ballEvents, i, world.m_eventClock + (double)CageImpactTime(world, world.m_ballData[i],
+				world.m_ballVel[i], world.m_wallData, world.m_arcData, world.m_pillarGrid));
+		}
+
+		world.m_eventsOn = true;
+	}
+
+	world.m_eventNum = 0;
+	world.m_advanceBallEvents(world, world.m_eventClock + (double)world.m_dt);
+
+	StepParticles(world.m_particles, world.m_wallData, world.m_wallNum, world.m_dt);
+}
+
+/******************************************************************************/
+/*!
+	Back to stepping every ball (the event driven positions are up to date,
+	those on an orbit included)
+*/
+/******************************************************************************/
+static void StopBallEvents(CageWorld &world)
+{
+	ClearEventQueue(world.m_ballEvents);
+
+	// the balls went straight through the portals
+	for (unsigned int i = 0; i < world.m_ballNum; ++i)
+	{
+		world.m_ballClearance[i] = world.m_ballTravel[i] = 0.0f;
+		world.m_ballRoom[i] = FindRoom(world.m_rooms, world.m_ballData[i].m_center);
+		ResetOrbit(world.m_orbits, i);
+	}
+
+	world.m_orbitNum = 0;
+	world.m_eventsOn = false;
+}
+
+/******************************************************************************/
+/*!
+	Puts the balls of pData (if allocated) in the order of pOrder: the ball
+	at pData[pOrder[k].m_item] goes to pData[k]
+*/
+/******************************************************************************/
+template <typename T>
+void ReorderBalls(T *pData, const MortonEntry *pOrder, unsigned int ballNum)
+{
+	if (!pData)
+		return;
+
+	T *pOld = new T[ballNum];
+	for (unsigned int i = 0; i < ballNum; ++i)
+		pOld[i] = pData[i];
+
+	for (unsigned int k = 0; k < ballNum; ++k)
+		pData[k] = pOld[pOrder[k].m_item];
+
+	delete []pOld;
+}
+
+/******************************************************************************/
+/*!
+	Square the Z-order keys are taken on, once at load: it holds the cage,
+	the wall pack and the balls, so the keys of the balls don't shift when
+	the ones at the edge move
+*/
+/******************************************************************************/
+static void SetBallSortBox(CageWorld &world)
+{
+	bool	empty	= true;
+	float	minX	= 0.0f, minY = 0.0f, maxX = 0.0f, maxY = 0.0f;
+
+	auto grow = [&](float x0, float y0, float x1, float y1)
+	{
+		if (empty || x0 < minX)	minX = x0;
+		if (empty || y0 < minY)	minY = y0;
+		if (empty || x1 > maxX)	maxX = x1;
+		if (empty || y1 > maxY)	maxY = y1;
+		empty = false;
+	};
+
+	const DistanceField &field = world.m_cageField;
+	if (field.m_samplesX > 0)
+		grow(field.m_minX, field.m_minY, field.m_minX + (field.m_samplesX - 1) * field.m_cellSize,
+			field.m_minY + (field.m_samplesY - 1) * field.m_cellSize);
+
+	const WallPackHeader &pack = (world.m_fixedPoint == 1) ? world.m_wallStreamX.m_header : world.m_wallStream.m_header;
+	if (world.m_wallStream.m_tileNum != 0 || world.m_wallStreamX.m_tileNum != 0)
+		grow(pack.m_minX, pack.m_minY, pack.m_minX + pack.m_tilesX * pack.m_tileSize,
+			pack.m_minY + pack.m_tilesY * pack.m_tileSize);
+
+	for (unsigned int i = 0; i < world.m_ballNum; ++i)
+	{
+		const Circle &ball = world.m_ballData[i];
+		grow(ball.m_center.x - ball.m_radius, ball.m_center.y - ball.m_radius,
+			ball.m_center.x + ball.m_radius, ball.m_center.y + ball.m_radius);
+	}
+
+	world.m_ballSortMin		= { minX, minY };
+	world.m_ballSortSide	= (maxX - minX > maxY - minY) ? maxX - minX : maxY - minY;
+}
+
+/******************************************************************************/
+/*!
+	Every BALL_SORT_PERIOD steps, sorts the ball state along the Z-order
+	curve of the positions, and renumbers the broadphase order (what refers
+	to a ball from outside the world goes by m_ballNewIndex). The state
+	worked out again every step (end points) is left alone. The keys are
+	taken on a fixed square, and the balls were in order after the last
+	sort, so the entries start close to sorted, and nothing moves at all
+	if they still are
+*/
+/******************************************************************************/
+static void SortBalls(CageWorld &world)
+{
+	if (world.m_ballSort == 0 || ++world.m_ballSortClock < BALL_SORT_PERIOD)
+		return;
+
+	world.m_ballSortClock = 0;
+
+	unsigned int	ballNum	= world.m_ballNum;
+	MortonEntry		*pOrder	= world.m_ballOrder;
+
+	if (world.m_fixedPoint == 1)
+		MortonKeys(world.m_ballDataX, ballNum, CSD1130::Vec2x{ CSD1130::Fixed(world.m_ballSortMin.x),
+			CSD1130::Fixed(world.m_ballSortMin.y) }, CSD1130::Fixed(world.m_ballSortSide), pOrder);
+	else
+		MortonKeys(world.m_ballData, ballNum, world.m_ballSortMin, world.m_ballSortSide, pOrder);
+
+	if (SortMortonEntries(pOrder, ballNum) == 0)
+		return;
+
+	for (unsigned int k = 0; k < ballNum; ++k)
+		world.m_ballNewIndex[pOrder[k].m_item] = k;
+
+	ReorderBalls(world.m_ballData, pOrder, ballNum);
+	ReorderBalls(world.m_ballVel, pOrder, ballNum);
+	ReorderBalls(world.m_ballSpeed, pOrder, ballNum);
+	ReorderBalls(world.m_ballClearance, pOrder, ballNum);
+	ReorderBalls(world.m_ballTravel, pOrder, ballNum);
+	ReorderBalls(world.m_ballBand, pOrder, ballNum);
+	ReorderBalls(world.m_contactCache, pOrder, ballNum);
+	ReorderBalls(world.m_ballRoom, pOrder, ballNum);
+	ReorderBalls(world.m_ballId, pOrder, ballNum);
+
+	ReorderBalls(world.m_ballDataX, pOrder, ballNum);
+	ReorderBalls(world.m_ballVelX, pOrder, ballNum);
+	ReorderBalls(world.m_ballSpeedX, pOrder, ballNum);
+	ReorderBalls(world.m_ballClearanceX, pOrder, ballNum);
+	ReorderBalls(world.m_ballTravelX, pOrder, ballNum);
+	ReorderBalls(world.m_contactCacheX, pOrder, ballNum);
+
+	RemapSweepAndPrune(world.m_ballSap, world.m_ballNewIndex);
+	RemapSweepAndPrune(world.m_ballSapX, world.m_ballNewIndex);
+
+	world.m_sorted = true;
+}
+
+/******************************************************************************/
+/*!
+	Float simulation step
+*/
+/******************************************************************************/
+template <COLLISION_POLICY P>
+void UpdateBallsFloat(CageWorld &world)
+{
+	// only the cage changes the paths of the balls, and it keeps still:
+	// they can go event driven (the impacts are looked for far ahead, not
+	// in the tiles of the wall pack read in)
+	if (world.m_eventDriven != 0 && world.m_ballCollisions == 0 && world.m_kinematicWalls.m_num == 0 &&
+		world.m_wallStream.m_tileNum == 0)
+	{
+		UpdateBallsEvents(world);
+		return;
+	}
+
+	if (world.m_eventsOn)
+		StopBallEvents(world);
+
+	SortBalls(world);
+
+	Circle					*pBalls		= world.m_ballData;
+	CSD1130::Vec2			*pVel		= world.m_ballVel;
+	float					*pSpeed		= world.m_ballSpeed;
+	CSD1130::Vec2			*pNext		= world.m_ballNext;
+	const LineSegment		*pWalls		= world.m_wallData;
+	const LineSegmentBand	*pBands		= world.m_wallBands;
+	const LineVertex		*pVertices	= world.m_wallVertices;
+	unsigned int			vertexNum	= world.m_wallVertexNum;
+	float					dt			= world.m_dt;
+
+	StepKinematicWalls(world.m_kinematicWalls, dt);
+
+	PrefetchBallTiles(world, world.m_wallStream, pBalls, pVel);
+
+	// Where the balls get without collisions
+	for (unsigned int i = 0; i < world.m_ballNum; ++i)
+	{
+		pNext[i].x = pBalls[i].m_center.x + pVel[i].x * dt;
+		pNext[i].y = pBalls[i].m_center.y + pVel[i].y * dt;
+	}
+
+	// Check collision with walls, for the balls that can reach them
+	WallSubset subset;
+
+	world.m_ballNearNum		= 0;
+	world.m_cacheHitNum		= 0;
+	world.m_cacheLookupNum	= 0;
+	for (unsigned int i = 0; i < world.m_ballNum; ++i)
+	{
+		// the clearances don't know the streamed walls
+		world.m_ballNear[i] = world.m_wallStream.m_tileNum != 0 ||
+								BallNearCage(pBalls[i], pNext[i], world.m_ballClearance[i], world.m_ballTravel[i]);
+		if (!world.m_ballNear[i])
+			continue;
+
+		if (world.m_tiledWalls == 1)
+		{
+			world.m_tileBalls[world.m_ballNearNum++] = i;
+			continue;
+		}
+
+		++world.m_ballNearNum;
+		CollideBallWithCage<P>(world, pBalls[i], pNext[i], pVel[i], pSpeed[i], pWalls, BallBands(world, pBands, i),
+			world.m_arcData, world.m_pillarGrid, pVertices, vertexNum,
+			BallWalls(world, pBalls[i], pNext[i], world.m_ballRoom[i], world.m_rooms, world.m_contactCache[i], pWalls,
+				pVertices, vertexNum, subset));
+	}
+
+	if (world.m_tiledWalls == 1)
+		CollideBallsWithCageTiled<P>(world, world.m_tileBalls, world.m_ballNearNum, pBalls, pNext, pVel, pSpeed, pWalls, pBands,
+			world.m_arcData, world.m_pillarGrid, pVertices, vertexNum, world.m_tileHits);
+
+	// Check collision between balls
+	if (world.m_ballCollisions == 1)
+		CollideBalls<P>(world, pBalls, pNext, pVel, pSpeed, world.m_ballSap, dt, pWalls, pBands, world.m_arcData,
+			world.m_pillarGrid, pVertices, vertexNum);
+
+	// Check collision with the walls moved by their scripts
+	CollideBallsWithKinematicWalls<P>(world, pBalls, pNext, pVel, pSpeed, world.m_kinematicWalls, dt, pWalls, pBands,
+		world.m_arcData, world.m_pillarGrid, pVertices, vertexNum);
+
+	for (unsigned int i = 0; i < world.m_ballNum; ++i)
+	{
+		TrackClearance(world, pBalls[i], pNext[i], world.m_ballNear[i] != 0, world.m_ballClearance[i], world.m_ballTravel[i],
+			pWalls, world.m_arcData, world.m_pillarGrid, world.m_cageField);
+
+		world.m_ballRoom[i] = CrossPortals(world.m_rooms, world.m_ballRoom[i], pBalls[i].m_center, pNext[i]);
+		pBalls[i].m_center = pNext[i];
+	}
+
+	StepParticles(world.m_particles, pWalls, world.m_wallNum, dt);
+
+	EndWallStreamStep(world.m_wallStream);
+}
+
+/******************************************************************************/
+/*!
+	Fixed-point simulation step. Only integer arithmetic is used from here
+	on (including the sqrt of the edge checks), the float state is only
+	written back for drawing.
+*/
+/******************************************************************************/
+template <COLLISION_POLICY P>
+void UpdateBallsFixed(CageWorld &world)
+{
+	SortBalls(world);
+
+	Circlex					*pBalls		= world.m_ballDataX;
+	CSD1130::Vec2x			*pVel		= world.m_ballVelX;
+	CSD1130::Fixed			*pSpeed		= world.m_ballSpeedX;
+	CSD1130::Vec2x			*pNext		= world.m_ballNextX;
+	const LineSegmentx		*pWalls		= world.m_wallDataX;
+	const LineSegmentBandx	*pBands		= world.m_wallBandsX;
+	const LineVertexx		*pVertices	= world.m_wallVerticesX;
+	unsigned int			vertexNum	= world.m_wallVertexNumX;
+
+	StepKinematicWalls(world.m_kinematicWallsX, FIXED_DT);
+
+	PrefetchBallTiles(world, world.m_wallStreamX, pBalls, pVel);
+
+	for (unsigned int i = 0; i < world.m_ballNum; ++i)
+		pNext[i] = pBalls[i].m_center + pVel[i] * FIXED_DT;
+
+	// Check collision with walls, for the balls that can reach them
+	WallSubset subset;
+
+	world.m_ballNearNum		= 0;
+	world.m_cacheHitNum		= 0;
+	world.m_cacheLookupNum	= 0;
+	for (unsigned int i = 0; i < world.m_ballNum; ++i)
+	{
+		world.m_ballNear[i] = world.m_wallStreamX.m_tileNum != 0 ||
+								BallNearCage(pBalls[i], pNext[i], world.m_ballClearanceX[i], world.m_ballTravelX[i]);
+		if (!world.m_ballNear[i])
+			continue;
+
+		if (world.m_tiledWalls == 1)
+		{
+			world.m_tileBalls[world.m_ballNearNum++] = i;
+			continue;
+		}
+
+		++world.m_ballNearNum;
+		CollideBallWithCage<P>(world, pBalls[i], pNext[i], pVel[i], pSpeed[i], pWalls, BallBands(world, pBands, i),
+			world.m_arcDataX, world.m_pillarGridX, pVertices, vertexNum,
+			BallWalls(world, pBalls[i], pNext[i], world.m_ballRoom[i], world.m_roomsX, world.m_contactCacheX[i], pWalls,
+				pVertices, vertexNum, subset));
+	}
+
+	if (world.m_tiledWalls == 1)
+		CollideBallsWithCageTiled<P>(world, world.m_tileBalls, world.m_ballNearNum, pBalls, pNext, pVel, pSpeed, pWalls, pBands,
+			world.m_arcDataX, world.m_pillarGridX, pVertices, vertexNum, world.m_tileHitsX);
+
+	// Check collision between balls
+	if (world.m_ballCollisions == 1)
+		CollideBalls<P>(world, pBalls, pNext, pVel, pSpeed, world.m_ballSapX, FIXED_DT, pWalls, pBands, world.m_arcDataX,
+			world.m_pillarGridX, pVertices, vertexNum);
+
+	// Check collision with the walls moved by their scripts
+	CollideBallsWithKinematicWalls<P>(world, pBalls, pNext, pVel, pSpeed, world.m_kinematicWallsX, FIXED_DT, pWalls, pBands,
+		world.m_arcDataX, world.m_pillarGridX, pVertices, vertexNum);
+
+	for (unsigned int i = 0; i < world.m_ballNum; ++i)
+	{
+		Circlex &ballData		= pBalls[i];
+		CSD1130::Vec2x &velCurr	= pVel[i];
+		CSD1130::Vec2x &posNext	= pNext[i];
+
+		TrackClearance(world, ballData, posNext, world.m_ballNear[i] != 0, world.m_ballClearanceX[i], world.m_ballTravelX[i],
+			pWalls, world.m_arcDataX, world.m_pillarGridX, world.m_cageFieldX);
+
+		world.m_ballRoom[i] = CrossPortals(world.m_roomsX, world.m_ballRoom[i], ballData.m_center, posNext);
+		ballData.m_center = posNext;
+
+		// FNV-1a over the raw state
+		const int64_t state[4] = { posNext.x.raw, posNext.y.raw, velCurr.x.raw, velCurr.y.raw };
+		for (int k = 0; k < 4; ++k)
+		{
+			world.m_simChecksum ^= (unsigned long long)state[k];
+			world.m_simChecksum *= 1099511628211ull;
+		}
+
+		// float copy for drawing
+		world.m_ballData[i].m_center	= { (float)posNext.x, (float)posNext.y };
+		world.m_ballVel[i]				= { (float)velCurr.x, (float)velCurr.y };
+		world.m_ballSpeed[i]			= (float)pSpeed[i];
+	}
+
+	ParticleSetx &particlesX = world.m_particlesX;
+
+	StepParticles(particlesX, pWalls, world.m_wallNum, FIXED_DT);
+
+	for (unsigned int i = 0; i < particlesX.m_num; ++i)
+	{
+		const int64_t state[4] = { particlesX.m_x[i].raw, particlesX.m_y[i].raw,
+									particlesX.m_vx[i].raw, particlesX.m_vy[i].raw };
+		for (int k = 0; k < 4; ++k)
+		{
+			world.m_simChecksum ^= (unsigned long long)state[k];
+			world.m_simChecksum *= 1099511628211ull;
+		}
+
+		world.m_particles.m_x[i] = (float)particlesX.m_x[i];
+		world.m_particles.m_y[i] = (float)particlesX.m_y[i];
+	}
+
+	EndWallStreamStep(world.m_wallStreamX);
+}
+
+/******************************************************************************/
+/*!
+	Reads a count of records, tokenNum tokens each, into count. False if
+	there is none, it is negative, or the file is too short to hold that
+	many records (a token takes 2 bytes at least, with its separator): a
+	count is never trusted with an allocation before that
+*/
+/******************************************************************************/
+static bool ReadLevelCount(std::ifstream &inFile, unsigned int &count, unsigned int tokenNum, long long fileBytes)
+{
+	long long num = -1;
+
+	if (!(inFile>>num) || num < 0 || num > fileBytes || num * tokenNum * 2 > fileBytes)
+		return false;
+
+	count = (unsigned int)num;
+	return true;
+}
+
+/******************************************************************************/
+/*!
+	Same for the count of an optional section: 0 if the file ends before
+	it, false if something else than a count is there
+*/
+/******************************************************************************/
+static bool ReadLevelOptionalCount(std::ifstream &inFile, unsigned int &count, unsigned int tokenNum, long long fileBytes)
+{
+	count = 0;
+
+	if ((inFile>>std::ws).eof())
+		return true;
+
+	return ReadLevelCount(inFile, count, tokenNum, fileBytes);
+}
+
+/******************************************************************************/
+/*!
+	Reads the sections of a level file into level, allocating as it goes.
+	Stops, returning false, at the first count, record or value that
+	doesn't make sense (what is allocated by then is in level)
+*/
+/******************************************************************************/
+static bool ReadCageLevelSections(CageLevel &level, std::ifstream &inFile, long long fileBytes)
+{
+	std::string str;
+
+	// read ball data (radius 0: a particle)
+	if (!ReadLevelCount(inFile, level.m_ballNum, 10, fileBytes))
+		return false;
+
+	level.m_balls = new CageLevelBall[level.m_ballNum];
+
+	for (unsigned int j = 0; j < level.m_ballNum; ++j)
+	{
+		CageLevelBall &ball = level.m_balls[j];
+
+		// read pos
+		inFile>>str>>ball.m_pos.x;
+		inFile>>str>>ball.m_pos.y;
+		// read direction
+		inFile>>str>>ball.m_dir;
+		// read speed
+		inFile>>str>>ball.m_speed;
+		// read radius
+		inFile>>str>>ball.m_radius;
+
+		if (!inFile || !(ball.m_radius >= 0.0f))
+			return false;
+	}
+
+	// read wall data
+	if (!ReadLevelCount(inFile, level.m_wallNum, 8, fileBytes))
+		return false;
+
+	level.m_wallPts = new CSD1130::Vec2[level.m_wallNum * 2];
+
+	for (unsigned int i = 0; i < level.m_wallNum; ++i)
+	{
+		CSD1130::Vec2 &P0 = level.m_wallPts[i * 2];
+		CSD1130::Vec2 &P1 = level.m_wallPts[i * 2 + 1];
+
+		inFile>>str>>P0.x;
+		inFile>>str>>P0.y;
+		inFile>>str>>P1.x;
+		inFile>>str>>P1.y;
+
+		// a wall without length has no normal
+		if (!inFile || (P0.x == P1.x && P0.y == P1.y))
+			return false;
+	}
+
+	// read arc data (optional section, older levels end after the walls)
+	if (!ReadLevelOptionalCount(inFile, level.m_arcNum, 10, fileBytes))
+		return false;
+
+	level.m_arcs = new CageLevelArc[level.m_arcNum];
+	for (unsigned int i = 0; i < level.m_arcNum; ++i)
+	{
+		CageLevelArc &arc = level.m_arcs[i];
+
+		inFile>>str>>arc.m_pos.x;
+		inFile>>str>>arc.m_pos.y;
+		inFile>>str>>arc.m_radius;
+		// angles in degree, counter clockwise from the first one
+		inFile>>str>>arc.m_angle0;
+		inFile>>str>>arc.m_angle1;
+
+		if (!inFile || !(arc.m_radius > 0.0f))
+			return false;
+	}
+
+	// read pillar data (optional section, after the arcs)
+	if (!ReadLevelOptionalCount(inFile, level.m_pillarNum, 6, fileBytes))
+		return false;
+
+	level.m_pillars = new Circle[level.m_pillarNum];
+	for (unsigned int i = 0; i < level.m_pillarNum; ++i)
+	{
+		inFile>>str>>level.m_pillars[i].m_center.x;
+		inFile>>str>>level.m_pillars[i].m_center.y;
+		inFile>>str>>level.m_pillars[i].m_radius;
+
+		if (!inFile || !(level.m_pillars[i].m_radius > 0.0f))
+			return false;
+	}
+
+	// read room data (optional section, after the pillars): the bounds of
+	// each room and its walls (indices in the file), then the portals
+	if (!ReadLevelOptionalCount(inFile, level.m_roomNum, 10, fileBytes))
+		return false;
+
+	unsigned int roomNum = level.m_roomNum;
+	std::vector<unsigned int> roomWalls;
+
+	level.m_roomMin			= new CSD1130::Vec2[roomNum];
+	level.m_roomMax			= new CSD1130::Vec2[roomNum];
+	level.m_roomWallStart	= new unsigned int[roomNum + 1];
+
+	level.m_roomWallStart[0] = 0;
+	for (unsigned int r = 0; r < roomNum; ++r)
+	{
+		inFile>>str>>level.m_roomMin[r].x;
+		inFile>>str>>level.m_roomMin[r].y;
+		inFile>>str>>level.m_roomMax[r].x;
+		inFile>>str>>level.m_roomMax[r].y;
+		inFile>>str;
+
+		unsigned int roomWallNum = 0;
+		if (!inFile || !ReadLevelCount(inFile, roomWallNum, 1, fileBytes))
+			return false;
+
+		for (unsigned int k = 0; k < roomWallNum; ++k)
+		{
+			long long i = -1;
+			if (!(inFile>>i) || i < 0 || i >= level.m_wallNum)
+				return false;
+
+			roomWalls.push_back((unsigned int)i);
+		}
+
+		level.m_roomWallStart[r + 1] = level.m_roomWallStart[r] + roomWallNum;
+	}
+
+	level.m_roomWalls = new unsigned int[roomWalls.size()];
+	std::copy(roomWalls.begin(), roomWalls.end(), level.m_roomWalls);
+
+	if (roomNum > 0 && !ReadLevelOptionalCount(inFile, level.m_portalNum, 12, fileBytes))
+		return false;
+
+	level.m_portals = new Portal[level.m_portalNum];
+	for (unsigned int i = 0; i < level.m_portalNum; ++i)
+	{
+		CSD1130::Vec2 P0, P1;
+
+		inFile>>str>> P0.x;
+		inFile>>str>> P0.y;
+		inFile>>str>> P1.x;
+		inFile>>str>> P1.y;
+		inFile>>str>> level.m_portals[i].m_front;
+		inFile>>str>> level.m_portals[i].m_back;
+
+		if (!inFile || (P0.x == P1.x && P0.y == P1.y) ||
+			level.m_portals[i].m_front >= roomNum || level.m_portals[i].m_back >= roomNum)
+			return false;
+
+		BuildLineSegment(level.m_portals[i].m_line, P0, P1);
+	}
+
+	// read kinematic wall data (optional section, after the rooms, a level
+	// without rooms has a 0 there): the wall at rest, the pivot it turns
+	// about, the pivot velocity, the turn rate (degree per second) and
+	// the time the pivot goes one way (0: no turning back)
+	if (!ReadLevelOptionalCount(inFile, level.m_kinematicNum, 20, fileBytes))
+		return false;
+
+	level.m_kinematic = new CageLevelKinematic[level.m_kinematicNum];
+	for (unsigned int i = 0; i < level.m_kinematicNum; ++i)
+	{
+		CageLevelKinematic &wall = level.m_kinematic[i];
+
+		inFile>>str>> wall.m_pt0.x;
+		inFile>>str>> wall.m_pt0.y;
+		inFile>>str>> wall.m_pt1.x;
+		inFile>>str>> wall.m_pt1.y;
+		inFile>>str>> wall.m_pivot.x;
+		inFile>>str>> wall.m_pivot.y;
+		inFile>>str>> wall.m_pivotVel.x;
+		inFile>>str>> wall.m_pivotVel.y;
+		inFile>>str>> wall.m_spin;
+		inFile>>str>> wall.m_period;
+
+		if (!inFile || (wall.m_pt0.x == wall.m_pt1.x && wall.m_pt0.y == wall.m_pt1.y) || !(wall.m_period >= 0.0f))
+			return false;
+	}
+
+	// read the wall pack (optional section, after the kinematic walls, 1
+	// if there is one): the file of the walls cut into tiles (see
+	// WriteWallPack), and the memory the tiles can take, in KB
+	unsigned int packNum = 0;
+
+	if (!ReadLevelOptionalCount(inFile, packNum, 4, fileBytes))
+		return false;
+
+	if (packNum > 0)
+	{
+		inFile>>str>>level.m_packPath;
+		inFile>>str>>level.m_packBudget;
+
+		if (!inFile)
+			return false;
+	}
+
+	return true;
+}
+
+/******************************************************************************/
+/*!
+* \brief Reads a level file
+* \param level:	output - level, empty if the file can't be read
+* \param path:	input - level file
+* \return bool: false if the file can't be opened, or is malformed: a count
+*				missing or negative, or more records than the file holds, a
+*				section cut short, a negative ball radius, a pillar or arc
+*				without one, a wall (static or kinematic) without length,
+*				a room wall or portal room that isn't there
+ */
+/******************************************************************************/
+bool ReadCageLevel(CageLevel &level, const char *path)
+{
+	level = CageLevel();
+
+	std::ifstream inFile(path);
+
+	if (!inFile.is_open())
+		return false;
+
+	inFile.seekg(0, std::ios::end);
+	long long fileBytes = (long long)inFile.tellg();
+	inFile.seekg(0, std::ios::beg);
+
+	if (fileBytes < 0 || !ReadCageLevelSections(level, inFile, fileBytes))
+	{
+		FreeCageLevel(level);
+		return false;
+	}
+
+	return true;
+}
+
+/******************************************************************************/
+/*!
+* \brief Releases a level read by ReadCageLevel
+* \param level:	input/output - level, empty afterwards
+ */
+/******************************************************************************/
+void FreeCageLevel(CageLevel &level)
+{
+	delete []level.m_balls;
+	delete []level.m_wallPts;
+	delete []level.m_arcs;
+	delete []level.m_pillars;
+	delete []level.m_roomMin;
+	delete []level.m_roomMax;
+	delete []level.m_roomWallStart;
+	delete []level.m_roomWalls;
+	delete []level.m_portals;
+	delete []level.m_kinematic;
+
+	level = CageLevel();
+}
+
+/******************************************************************************/
+/*!
+* \brief Builds a world out of a level
+* \param world:			output - world
+* \param level:			input - level
+* \param extraCredits:	input - collision policy (see EXTRA_CREDITS)
+* \param fixedPoint:	input - 1 for the fixed-point simulation
+ */
+/******************************************************************************/
+void BuildCageWorld(CageWorld &world, const CageLevel &level, int extraCredits, int fixedPoint)
+{
+	world = CageWorld();
+
+	world.m_fixedPoint		= fixedPoint;
+	world.m_ballCollisions	= 1;
+	world.m_dt				= DEFAULT_DT;
+
+	// ball data
+	unsigned int ballNum = level.m_ballNum;
+	world.m_ballData	= new Circle[ballNum];
+	world.m_ballId		= new unsigned int[ballNum];
+	world.m_ballNum		= 0;
+
+	world.m_ballVel		= new CSD1130::Vec2[ballNum];
+	world.m_ballSpeed	= new float[ballNum];
+	world.m_ballNext	= new CSD1130::Vec2[ballNum];
+
+	// nothing is known about the cage yet: every ball gets tested first
+	world.m_ballClearance	= new float[ballNum]();
+	world.m_ballTravel		= new float[ballNum]();
+	world.m_ballNear		= new unsigned char[ballNum]();
+	world.m_contactCache	= new ContactCache[ballNum]();
+	world.m_tileBalls		= new unsigned int[ballNum];
+	world.m_tileActive		= new unsigned int[ballNum];
+	world.m_tileHits		= new WallHitT<float>[ballNum];
+
+	world.m_ballAnchor		= new CSD1130::Vec2[ballNum];
+	world.m_ballAnchorTime	= new double[ballNum];
+	InitEventQueue(world.m_ballEvents, ballNum);
+	InitOrbitSet(world.m_orbits, ballNum, ORBIT_TOLERANCE);
+
+	if (fixedPoint == 1)
+	{
+		world.m_ballDataX		= new Circlex[ballNum];
+		world.m_ballVelX		= new CSD1130::Vec2x[ballNum];
+		world.m_ballSpeedX		= new CSD1130::Fixed[ballNum];
+		world.m_ballNextX		= new CSD1130::Vec2x[ballNum];
+		world.m_ballClearanceX	= new CSD1130::Fixed[ballNum]();
+		world.m_ballTravelX		= new CSD1130::Fixed[ballNum]();
+		world.m_contactCacheX	= new ContactCachex[ballNum]();
+		world.m_tileHitsX		= new WallHitT<CSD1130::Fixed>[ballNum];
+	}
+
+	// zero radius balls are tracer particles, kept out of the ball arrays
+	InitParticleSet(world.m_particles, ballNum);
+
+	if (fixedPoint == 1)
+		InitParticleSet(world.m_particlesX, ballNum);
+
+	for (unsigned int j = 0; j < ballNum; ++j)
+	{
+		const CageLevelBall &levelBall = level.m_balls[j];
+
+		Circle ball{ levelBall.m_pos, levelBall.m_radius };
+		float dir	= levelBall.m_dir;
+		float speed	= levelBall.m_speed;
+
+		CSD1130::Vec2 vel{ cos(dir * PI_OVER_180) * speed, sin(dir * PI_OVER_180) * speed };
+
+		// velocity from the fixed-point sin/cos, so it doesn't depend on the CRT
+		CSD1130::Fixed s, c;
+		if (fixedPoint == 1)
+			CSD1130::FastSinCos(CSD1130::Fixed(dir) * FIXED_PI_OVER_180, s, c);
+
+		CSD1130::Vec2x posX{ CSD1130::Fixed(ball.m_center.x), CSD1130::Fixed(ball.m_center.y) };
+		CSD1130::Fixed speedX{ speed };
+
+		if (ball.m_radius == 0.0f)
+		{
+			AddParticle(world.m_particles, ball.m_center, vel);
+
+			if (fixedPoint == 1)
+				AddParticle(world.m_particlesX, posX, CSD1130::Vec2x{ c * speedX, s * speedX });
+			continue;
+		}
+
+		unsigned int i = world.m_ballNum++;
+		world.m_ballData[i]		= ball;
+		world.m_ballId[i]		= i;
+		world.m_ballVel[i]		= vel;
+		world.m_ballSpeed[i]	= speed;
+
+		if (fixedPoint == 1)
+		{
+			world.m_ballDataX[i].m_center	= posX;
+			world.m_ballDataX[i].m_radius	= CSD1130::Fixed(ball.m_radius);
+			world.m_ballSpeedX[i]			= speedX;
+			world.m_ballVelX[i]				= { c * speedX, s * speedX };
+		}
+	}
+
+	InitSweepAndPrune(world.m_ballSap, world.m_ballData, world.m_ballNum);
+
+	world.m_ballOrder		= new MortonEntry[world.m_ballNum];
+	world.m_ballNewIndex	= new unsigned int[world.m_ballNum];
+
+	if (fixedPoint == 1)
+		InitSweepAndPrune(world.m_ballSapX, world.m_ballDataX, world.m_ballNum);
+
+	// wall data
+	unsigned int wallNum = level.m_wallNum;
+	LineSegment *fileWalls = new LineSegment[wallNum];
+
+	unsigned int classCount[(int)LINE_CLASS::LINE_CLASS_NUM] = { 0 };
+
+	for (unsigned int i = 0; i < wallNum; ++i)
+	{
+		BuildLineSegment(fileWalls[i], level.m_wallPts[i * 2], level.m_wallPts[i * 2 + 1]);
+
+		++classCount[(int)fileWalls[i].m_class];
+	}
+
+	// group the walls by class (keeping the file order inside a class),
+	// so the update loop runs each class through its own kernel
+	world.m_wallData	= new LineSegment[wallNum];
+	world.m_wallNum		= wallNum;
+
+	if (fixedPoint == 1)
+		world.m_wallDataX = new LineSegmentx[wallNum];
+
+	unsigned int classNext[(int)LINE_CLASS::LINE_CLASS_NUM];
+	unsigned int *wallOfFile = new unsigned int[wallNum];	// where each wall of the file went
+	world.m_wallClassStart[0] = 0;
+	for (int c = 0; c < (int)LINE_CLASS::LINE_CLASS_NUM; ++c)
+	{
+		classNext[c]					= world.m_wallClassStart[c];
+		world.m_wallClassStart[c + 1]	= world.m_wallClassStart[c] + classCount[c];
+	}
+
+	for (unsigned int i = 0; i < wallNum; ++i)
+	{
+		unsigned int w = classNext[(int)fileWalls[i].m_class]++;
+		world.m_wallData[w] = fileWalls[i];
+		wallOfFile[i] = w;
+
+		const CSD1130::Vec2 &P0 = world.m_wallData[w].m_pt0;
+		const CSD1130::Vec2 &P1 = world.m_wallData[w].m_pt1;
+
+		if (fixedPoint == 1)
+			BuildLineSegment(world.m_wallDataX[w],
+							CSD1130::Vec2x{ CSD1130::Fixed(P0.x), CSD1130::Fixed(P0.y) },
+							CSD1130::Vec2x{ CSD1130::Fixed(P1.x), CSD1130::Fixed(P1.y) });
+	}
+
+	delete []fileWalls;
+
+	// expand the walls by the ball radii, the few distinct ones levels
+	// use; the balls with a radius past the first BAND_RADIUS_MAX test
+	// the walls as they are
+	float			bandRadius[BAND_RADIUS_MAX];
+	unsigned int	bandNum = 0;
+
+	world.m_ballBand = new unsigned int[world.m_ballNum];
+	for (unsigned int i = 0; i < world.m_ballNum; ++i)
+	{
+		unsigned int b = 0;
+		while (b < bandNum && bandRadius[b] != world.m_ballData[i].m_radius)
+			++b;
+
+		if (b == bandNum && bandNum < BAND_RADIUS_MAX)
+			bandRadius[bandNum++] = world.m_ballData[i].m_radius;
+
+		world.m_ballBand[i] = (b < bandNum) ? b : BAND_NONE;
+	}
+
+	world.m_bandRadius	= new float[bandNum];
+	world.m_bandNum		= bandNum;
+	for (unsigned int b = 0; b < bandNum; ++b)
+		world.m_bandRadius[b] = bandRadius[b];
+
+	world.m_wallBands = new LineSegmentBand[bandNum * wallNum];
+
+	if (fixedPoint == 1)
+		world.m_wallBandsX = new LineSegmentBandx[bandNum * wallNum];
+
+	for (unsigned int b = 0; b < bandNum; ++b)
+	{
+		for (unsigned int w = 0; w < wallNum; ++w)
+		{
+			BuildLineSegmentBand(world.m_wallBands[b * wallNum + w], world.m_wallData[w], bandRadius[b]);
+
+			if (fixedPoint == 1)
+				BuildLineSegmentBand(world.m_wallBandsX[b * wallNum + w], world.m_wallDataX[w], CSD1130::Fixed(bandRadius[b]));
+		}
+	}
+
+	// arc data
+	unsigned int arcNum = level.m_arcNum;
+
+	world.m_arcData	= new Arc[arcNum];
+	world.m_arcNum	= arcNum;
+
+	if (fixedPoint == 1)
+		world.m_arcDataX = new Arcx[arcNum];
+
+	for (unsigned int i = 0; i < arcNum; ++i)
+	{
+		const CageLevelArc &arc = level.m_arcs[i];
+
+		BuildArc(world.m_arcData[i], arc.m_pos, arc.m_radius, arc.m_angle0 * PI_OVER_180, arc.m_angle1 * PI_OVER_180);
+
+		if (fixedPoint == 1)
+			BuildArc(world.m_arcDataX[i],
+					CSD1130::Vec2x{ CSD1130::Fixed(arc.m_pos.x), CSD1130::Fixed(arc.m_pos.y) },
+					CSD1130::Fixed(arc.m_radius),
+					CSD1130::Fixed(arc.m_angle0) * FIXED_PI_OVER_180,
+					CSD1130::Fixed(arc.m_angle1) * FIXED_PI_OVER_180);
+	}
+
+	// pillar data
+	unsigned int pillarNum = level.m_pillarNum;
+
+	BuildPillarGrid(world.m_pillarGrid, level.m_pillars, pillarNum);
+
+	if (fixedPoint == 1)
+	{
+		Circlex *pillarsX = new Circlex[pillarNum];
+		for (unsigned int i = 0; i < pillarNum; ++i)
+		{
+			pillarsX[i].m_center	= { CSD1130::Fixed(level.m_pillars[i].m_center.x), CSD1130::Fixed(level.m_pillars[i].m_center.y) };
+			pillarsX[i].m_radius	= CSD1130::Fixed(level.m_pillars[i].m_radius);
+		}
+
+		BuildPillarGrid(world.m_pillarGridX, pillarsX, pillarNum);
+		delete []pillarsX;
+	}
+
+	BuildDistanceField(world.m_cageField, world.m_wallData, wallNum, world.m_arcData, arcNum, world.m_pillarGrid.m_pillars,
+		FIELD_CELL_SIZE, FIELD_THREAD_NUM);
+
+	if (fixedPoint == 1)
+		BuildDistanceField(world.m_cageFieldX, world.m_wallDataX, wallNum, world.m_arcDataX, arcNum,
+			world.m_pillarGridX.m_pillars, CSD1130::Fixed(FIELD_CELL_SIZE), FIELD_THREAD_NUM);
+
+	// merge the shared end points (polygon corners)
+	world.m_wallVertices	= new LineVertex[wallNum * 2];
+	world.m_wallVertexNum	= BuildLineVertices(world.m_wallData, wallNum, world.m_wallVertices);
+
+	if (fixedPoint == 1)
+	{
+		world.m_wallVerticesX	= new LineVertexx[wallNum * 2];
+		world.m_wallVertexNumX	= BuildLineVertices(world.m_wallDataX, wallNum, world.m_wallVerticesX);
+	}
+
+	// rooms, their walls renumbered to the grouped walls
+	unsigned int roomNum	= level.m_roomNum;
+	unsigned int portalNum	= level.m_portalNum;
+
+	unsigned int *roomWalls = new unsigned int[roomNum ? level.m_roomWallStart[roomNum] : 0];
+	for (unsigned int k = 0; k < (roomNum ? level.m_roomWallStart[roomNum] : 0); ++k)
+		roomWalls[k] = (level.m_roomWalls[k] < wallNum) ? wallOfFile[level.m_roomWalls[k]] : wallNum;
+
+	BuildRoomSet(world.m_rooms, roomNum, level.m_roomMin, level.m_roomMax, level.m_roomWallStart, roomWalls,
+		world.m_wallData, world.m_wallClassStart, world.m_wallVertices, world.m_wallVertexNum, level.m_portals, portalNum);
+
+	if (fixedPoint == 1)
+	{
+		CSD1130::Vec2x	*roomMinX	= new CSD1130::Vec2x[roomNum];
+		CSD1130::Vec2x	*roomMaxX	= new CSD1130::Vec2x[roomNum];
+		Portalx			*portalsX	= new Portalx[portalNum];
+
+		for (unsigned int r = 0; r < roomNum; ++r)
+		{
+			roomMinX[r] = { CSD1130::Fixed(level.m_roomMin[r].x), CSD1130::Fixed(level.m_roomMin[r].y) };
+			roomMaxX[r] = { CSD1130::Fixed(level.m_roomMax[r].x), CSD1130::Fixed(level.m_roomMax[r].y) };
+		}
+
+		for (unsigned int i = 0; i < portalNum; ++i)
+		{
+			const LineSegment &line = level.m_portals[i].m_line;
+
+			BuildLineSegment(portalsX[i].m_line,
+							CSD1130::Vec2x{ CSD1130::Fixed(line.m_pt0.x), CSD1130::Fixed(line.m_pt0.y) },
+							CSD1130::Vec2x{ CSD1130::Fixed(line.m_pt1.x), CSD1130::Fixed(line.m_pt1.y) });
+			portalsX[i].m_front	= level.m_portals[i].m_front;
+			portalsX[i].m_back	= level.m_portals[i].m_back;
+		}
+
+		BuildRoomSet(world.m_roomsX, roomNum, roomMinX, roomMaxX, level.m_roomWallStart, roomWalls, world.m_wallDataX,
+			world.m_wallClassStart, world.m_wallVerticesX, world.m_wallVertexNumX, portalsX, portalNum);
+
+		delete []roomMinX;
+		delete []roomMaxX;
+		delete []portalsX;
+	}
+
+	delete []roomWalls;
+	delete []wallOfFile;
+
+	// the room each ball starts in
+	world.m_ballRoom		= new unsigned int[world.m_ballNum];
+	world.m_roomWalls		= new unsigned int[wallNum];
+	world.m_roomVertices	= new unsigned int[world.m_wallVertexNum];
+
+	for (unsigned int i = 0; i < world.m_ballNum; ++i)
+		world.m_ballRoom[i] = (fixedPoint == 1) ? FindRoom(world.m_roomsX, world.m_ballDataX[i].m_center) :
+													FindRoom(world.m_rooms, world.m_ballData[i].m_center);
+
+	// kinematic walls
+	unsigned int kinematicNum = level.m_kinematicNum;
+
+	KinematicWall	*kinematic	= new KinematicWall[kinematicNum];
+	KinematicWallx	*kinematicX	= new KinematicWallx[kinematicNum];
+
+	for (unsigned int i = 0; i < kinematicNum; ++i)
+	{
+		const CageLevelKinematic &levelWall = level.m_kinematic[i];
+		const CSD1130::Vec2 &P0		= levelWall.m_pt0;
+		const CSD1130::Vec2 &P1		= levelWall.m_pt1;
+		const CSD1130::Vec2 &pivot	= levelWall.m_pivot;
+
+		KinematicWall &wall = kinematic[i];
+		wall.m_pivot	= pivot;
+		wall.m_arm0		= P0 - pivot;
+		wall.m_arm1		= P1 - pivot;
+		wall.m_vel		= levelWall.m_pivotVel;
+		wall.m_spin		= levelWall.m_spin * PI_OVER_180;
+		wall.m_period	= levelWall.m_period;
+
+		KinematicWallx &wallX = kinematicX[i];
+		wallX.m_pivot	= { CSD1130::Fixed(pivot.x), CSD1130::Fixed(pivot.y) };
+		wallX.m_arm0	= CSD1130::Vec2x{ CSD1130::Fixed(P0.x), CSD1130::Fixed(P0.y) } - wallX.m_pivot;
+		wallX.m_arm1	= CSD1130::Vec2x{ CSD1130::Fixed(P1.x), CSD1130::Fixed(P1.y) } - wallX.m_pivot;
+		wallX.m_vel		= { CSD1130::Fixed(levelWall.m_pivotVel.x), CSD1130::Fixed(levelWall.m_pivotVel.y) };
+		wallX.m_spin	= CSD1130::Fixed(levelWall.m_spin) * FIXED_PI_OVER_180;
+		wallX.m_period	= CSD1130::Fixed(levelWall.m_period);
+	}
+
+	BuildKinematicWallSet(world.m_kinematicWalls, kinematic, kinematicNum);
+
+	if (fixedPoint == 1)
+		BuildKinematicWallSet(world.m_kinematicWallsX, kinematicX, kinematicNum);
+
+	delete []kinematic;
+	delete []kinematicX;
+
+	world.m_kinematicQuery = new unsigned int[kinematicNum];
+
+	// the wall pack: its walls are read in around the balls as they go,
+	// the particles go through them
+	if (!level.m_packPath.empty())
+	{
+		size_t budget = (size_t)level.m_packBudget * 1024;
+		bool opened = (fixedPoint == 1) ? OpenWallStream(world.m_wallStreamX, level.m_packPath.c_str(), budget) :
+											OpenWallStream(world.m_wallStream, level.m_packPath.c_str(), budget);
+		if (!opened)
+			printf("Failed to open the wall pack %s", level.m_packPath.c_str());
+	}
+
+	SetBallSortBox(world);
+
+	// pick the ball update instantiation for this level
+	if (fixedPoint == 1)
+		world.m_updateBalls = (extraCredits == 1) ? UpdateBallsFixed<COLLISION_POLICY::POLICY_SEGMENT_AND_EDGES>
+													: UpdateBallsFixed<COLLISION_POLICY::POLICY_SEGMENT_ONLY>;
+	else
+		world.m_updateBalls = (extraCredits == 1) ? UpdateBallsFloat<COLLISION_POLICY::POLICY_SEGMENT_AND_EDGES>
+													: UpdateBallsFloat<COLLISION_POLICY::POLICY_SEGMENT_ONLY>;
+
+	world.m_advanceBallEvents = (extraCredits == 1) ? AdvanceBallEvents<COLLISION_POLICY::POLICY_SEGMENT_AND_EDGES>
+													: AdvanceBallEvents<COLLISION_POLICY::POLICY_SEGMENT_ONLY>;
+}
+
+/******************************************************************************/
+/*!
+* \brief Releases what BuildCageWorld allocated
+* \param world:	input/output - world, empty afterwards
+ */
+/******************************************************************************/
+void FreeCageWorld(CageWorld &world)
+{
+	delete []world.m_ballData;
+	delete []world.m_wallData;
+	delete []world.m_ballId;
+
+	delete []world.m_wallBands;
+	delete []world.m_ballBand;
+	delete []world.m_bandRadius;
+	delete []world.m_wallVertices;
+	delete []world.m_arcData;
+
+	FreePillarGrid(world.m_pillarGrid);
+
+	FreeRoomSet(world.m_rooms);
+	delete []world.m_ballRoom;
+	delete []world.m_roomWalls;
+	delete []world.m_roomVertices;
+
+	FreeKinematicWallSet(world.m_kinematicWalls);
+	delete []world.m_kinematicQuery;
+
+	FreeWallStream(world.m_wallStream);
+	FreeDistanceField(world.m_cageField);
+
+	delete []world.m_ballVel;
+	delete []world.m_ballSpeed;
+	delete []world.m_ballNext;
+	delete []world.m_ballClearance;
+	delete []world.m_ballTravel;
+	delete []world.m_ballNear;
+	delete []world.m_contactCache;
+	delete []world.m_tileBalls;
+	delete []world.m_tileActive;
+	delete []world.m_tileHits;
+
+	FreeEventQueue(world.m_ballEvents);
+	delete []world.m_ballAnchor;
+	delete []world.m_ballAnchorTime;
+	FreeOrbitSet(world.m_orbits);
+	FreeSweepAndPrune(world.m_ballSap);
+
+	delete []world.m_ballOrder;
+	delete []world.m_ballNewIndex;
+
+	FreeParticleSet(world.m_particles);
+
+	delete []world.m_ballDataX;
+	delete []world.m_ballVelX;
+	delete []world.m_ballSpeedX;
+	delete []world.m_ballNextX;
+	delete []world.m_ballClearanceX;
+	delete []world.m_ballTravelX;
+	delete []world.m_contactCacheX;
+	delete []world.m_tileHitsX;
+	FreeSweepAndPrune(world.m_ballSapX);
+	FreeParticleSet(world.m_particlesX);
+
+	delete []world.m_wallDataX;
+	delete []world.m_wallVerticesX;
+	delete []world.m_arcDataX;
+	FreePillarGrid(world.m_pillarGridX);
+	FreeRoomSet(world.m_roomsX);
+	FreeKinematicWallSet(world.m_kinematicWallsX);
+	FreeWallStream(world.m_wallStreamX);
+	FreeDistanceField(world.m_cageFieldX);
+	delete []world.m_wallBandsX;
+
+	world = CageWorld();
+}
+
+/******************************************************************************/
+/*!
+* \brief Steps a world
+* \param world:	input/output - world
+ */
+/******************************************************************************/
+void StepCageWorld(CageWorld &world)
+{
+	world.m_sorted = false;
+
+	if (world.m_updateBalls)
+		world.m_updateBalls(world);
+}
+
+/******************************************************************************/
+/*!
+* \brief Replaces the balls of a float world
+* \param world:	input/output - world
+* \param pBalls:	input - balls, in the order the world gets them (unless
+*					it has the same balls already)
+* \param ballNum:	input - number of balls
+ */
+/******************************************************************************/
+void ReplaceCageWorldBalls(CageWorld &world, const CageWorldBall *pBalls, unsigned int ballNum)
+{
+	if (world.m_fixedPoint == 1)
+		return;
+
+	// the balls the world has, by id, and where each of the new ones is in it
+	std::vector<std::pair<unsigned int, unsigned int>> oldIndex(world.m_ballNum);
+	for (unsigned int i = 0; i < world.m_ballNum; ++i)
+		oldIndex[i] = { world.m_ballId[i], i };
+
+	std::sort(oldIndex.begin(), oldIndex.end());
+
+	std::vector<unsigned int> where(ballNum);
+	bool same = (ballNum == world.m_ballNum) && !world.m_eventsOn;
+
+	for (unsigned int j = 0; j < ballNum; ++j)
+	{
+		std::vector<std::pair<unsigned int, unsigned int>>::const_iterator it =
+			std::lower_bound(oldIndex.begin(), oldIndex.end(), std::make_pair(pBalls[j].m_id, 0u));
+
+		where[j] = (it != oldIndex.end() && it->first == pBalls[j].m_id) ? it->second : BALL_NONE;
+		same = same && where[j] != BALL_NONE;
+	}
+
+	// the same balls: they stay where they are in the world (and in the
+	// broadphase), and only the ones that moved start afresh
+	if (same)
+	{
+		for (unsigned int j = 0; j < ballNum; ++j)
+		{
+			const CageWorldBall &ball	= pBalls[j];
+			unsigned int i				= where[j];
+			Circle &data				= world.m_ballData[i];
+
+			world.m_ballVel[i]		= ball.m_vel;
+			world.m_ballSpeed[i]	= ball.m_speed;
+
+			if (data.m_center.x == ball.m_ball.m_center.x && data.m_center.y == ball.m_ball.m_center.y &&
+				data.m_radius == ball.m_ball.m_radius)
+				continue;
+
+			data						= ball.m_ball;
+			world.m_ballClearance[i]	= 0.0f;
+			world.m_ballTravel[i]		= 0.0f;
+			world.m_contactCache[i]		= ContactCache{};
+			world.m_ballRoom[i]			= FindRoom(world.m_rooms, ball.m_ball.m_center);
+
+			unsigned int b = 0;
+			while (b < world.m_bandNum && world.m_bandRadius[b] != ball.m_ball.m_radius)
+				++b;
+			world.m_ballBand[i] = (b < world.m_bandNum) ? b : BAND_NONE;
+		}
+
+		return;
+	}
+
+	Circle			*pData			= new Circle[ballNum];
+	unsigned int	*pId			= new unsigned int[ballNum];
+	CSD1130::Vec2	*pVel			= new CSD1130::Vec2[ballNum];
+	float			*pSpeed			= new float[ballNum];
+	float			*pClearance		= new float[ballNum]();
+	float			*pTravel		= new float[ballNum]();
+	ContactCache	*pCache			= new ContactCache[ballNum]();
+	unsigned int	*pBand			= new unsigned int[ballNum];
+	unsigned int	*pRoom			= new unsigned int[ballNum];
+
+	for (unsigned int j = 0; j < ballNum; ++j)
+	{
+		const CageWorldBall &ball = pBalls[j];
+
+		pData[j]	= ball.m_ball;
+		pId[j]		= ball.m_id;
+		pVel[j]		= ball.m_vel;
+		pSpeed[j]	= ball.m_speed;
+
+		unsigned int b = 0;
+		while (b < world.m_bandNum && world.m_bandRadius[b] != ball.m_ball.m_radius)
+			++b;
+		pBand[j] = (b < world.m_bandNum) ? b : BAND_NONE;
+
+		// the clearance, cache and room only hold for a ball that is still
+		// where the world left it
+		unsigned int i		= where[j];
+		const Circle *pOld	= (i != BALL_NONE) ? &world.m_ballData[i] : 0;
+
+		if (pOld && pOld->m_center.x == ball.m_ball.m_center.x && pOld->m_center.y == ball.m_ball.m_center.y &&
+			pOld->m_radius == ball.m_ball.m_radius)
+		{
+			pClearance[j]	= world.m_ballClearance[i];
+			pTravel[j]		= world.m_ballTravel[i];
+			pCache[j]		= world.m_contactCache[i];
+			pRoom[j]		= world.m_ballRoom[i];
+		}
+		else
+			pRoom[j]		= FindRoom(world.m_rooms, ball.m_ball.m_center);
+	}
+
+	delete []world.m_ballData;
+	delete []world.m_ballId;
+	delete []world.m_ballVel;
+	delete []world.m_ballSpeed;
+	delete []world.m_ballClearance;
+	delete []world.m_ballTravel;
+	delete []world.m_contactCache;
+	delete []world.m_ballBand;
+	delete []world.m_ballRoom;
+
+	world.m_ballData		= pData;
+	world.m_ballId			= pId;
+	world.m_ballVel			= pVel;
+	world.m_ballSpeed		= pSpeed;
+	world.m_ballClearance	= pClearance;
+	world.m_ballTravel		= pTravel;
+	world.m_contactCache	= pCache;
+	world.m_ballBand		= pBand;
+	world.m_ballRoom		= pRoom;
+	world.m_ballNum			= ballNum;
+
+	// the rest is worked out every step, or starts over
+	delete []world.m_ballNext;
+	delete []world.m_ballNear;
+	delete []world.m_tileBalls;
+	delete []world.m_tileActive;
+	delete []world.m_tileHits;
+	delete []world.m_ballAnchor;
+	delete []world.m_ballAnchorTime;
+	delete []world.m_ballOrder;
+	delete []world.m_ballNewIndex;
+
+	world.m_ballNext		= new CSD1130::Vec2[ballNum];
+	world.m_ballNear		= new unsigned char[ballNum]();
+	world.m_tileBalls		= new unsigned int[ballNum];
+	world.m_tileActive		= new unsigned int[ballNum];
+	world.m_tileHits		= new WallHitT<float>[ballNum];
+	world.m_ballAnchor		= new CSD1130::Vec2[ballNum];
+	world.m_ballAnchorTime	= new double[ballNum];
+	world.m_ballOrder		= new MortonEntry[ballNum];
+	world.m_ballNewIndex	= new unsigned int[ballNum];
+
+	FreeEventQueue(world.m_ballEvents);
+	InitEventQueue(world.m_ballEvents, ballNum);
+	FreeOrbitSet(world.m_orbits);
+	InitOrbitSet(world.m_orbits, ballNum, ORBIT_TOLERANCE);
+	world.m_orbitNum = 0;
+	world.m_eventsOn = false;
+
+	FreeSweepAndPrune(world.m_ballSap);
+	InitSweepAndPrune(world.m_ballSap, world.m_ballData, ballNum);
+}
+
+/******************************************************************************/
+/*!
+* \brief Jumps the event driven simulation ahead, if it is running
+* \param world:		input/output - world
+* \param seconds:	input - time skipped
+ */
+/******************************************************************************/
+void SkipCageWorldTime(CageWorld &world, double seconds)
+{
+	if (world.m_eventsOn)
+		world.m_advanceBallEvents(world, world.m_eventClock + seconds);
+}
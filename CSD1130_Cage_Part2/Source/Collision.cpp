@@ -13,6 +13,13 @@ prior written consent of DigiPen Institute of Technology is prohibited.
  /******************************************************************************/
 
 #include "main.h"
+#include <algorithm>
+
+// SSE2 is always there on x64, and on x86 when the compiler is allowed to use it
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define CSD1130_SSE2
+#include <emmintrin.h>
+#endif
 
 /******************************************************************************/
 /*!
@@ -22,19 +29,114 @@ prior written consent of DigiPen Institute of Technology is prohibited.
 * \param p1:			input - pt1 of line segment
  */
 /******************************************************************************/
-void BuildLineSegment(LineSegment &lineSegment,
-					const CSD1130::Vec2& p0,
-					const CSD1130::Vec2& p1)
+template <typename T>
+void BuildLineSegment(LineSegmentT<T> &lineSegment,
+					const CSD1130::Vector2DT<T>& p0,
+					const CSD1130::Vector2DT<T>& p1)
 {
 	lineSegment.m_pt0 = p0;
 	lineSegment.m_pt1 = p1;
 
-	CSD1130::Vec2 line{ p1 - p0 };					// Create line => p1 - p0
+	CSD1130::Vector2DT<T> line{ p1 - p0 };					// Create line => p1 - p0
 	lineSegment.m_normal = { line.y, -line.x };		// Calculate normal => y, -x
 
 	CSD1130::Vector2DNormalize(lineSegment.m_normal, lineSegment.m_normal); // Normalize normal
+
+	// Classify, so the update loop can use the axis aligned kernels
+	if (line.y == T(0))
+		lineSegment.m_class = LINE_CLASS::LINE_HORIZONTAL;
+	else if (line.x == T(0))
+		lineSegment.m_class = LINE_CLASS::LINE_VERTICAL;
+	else
+		lineSegment.m_class = LINE_CLASS::LINE_GENERAL;
+}
+
+/******************************************************************************/
+/*!
+* \brief Expands a line segment by a ball radius
+* \param band:		output
+* \param lineSeg:	input - line segment
+* \param radius:	input - ball radius
+ */
+/******************************************************************************/
+template <typename T, LINE_CLASS C>
+void BuildLineSegmentBand(LineSegmentBandT<T> &band,
+						const LineSegmentT<T> &lineSeg,
+						T radius)
+{
+	band.m_NP0			= LineNormal<C>::Dot(lineSeg.m_pt0, lineSeg.m_normal);
+	band.m_pt0Back		= LineNormal<C>::Against(lineSeg.m_pt0, radius, lineSeg.m_normal);
+	band.m_pt1Back		= LineNormal<C>::Against(lineSeg.m_pt1, radius, lineSeg.m_normal);
+	band.m_pt0Front		= LineNormal<C>::Along(lineSeg.m_pt0, radius, lineSeg.m_normal);
+	band.m_pt1Front		= LineNormal<C>::Along(lineSeg.m_pt1, radius, lineSeg.m_normal);
+}
+
+/******************************************************************************/
+/*!
+* \brief Builds an arc
+* \param arc:		output - arc
+* \param center:	input - center of the circle
+* \param radius:	input - radius of the circle
+* \param angle0:	input - start angle (radian)
+* \param angle1:	input - end angle (radian), counter clockwise from angle0
+ */
+/******************************************************************************/
+template <typename T>
+void BuildArc(ArcT<T> &arc,
+				const CSD1130::Vector2DT<T> &center,
+				T radius,
+				T angle0,
+				T angle1)
+{
+	const T PI_T	= T(3.14159265358979323846);
+	T span			= angle1 - angle0;
+
+	arc.m_center = center;
+	arc.m_radius = radius;
+
+	CSD1130::FastSinCos(angle0, arc.m_dir0.y, arc.m_dir0.x);
+	CSD1130::FastSinCos(angle1, arc.m_dir1.y, arc.m_dir1.x);
+
+	// Classify, so the span test knows how to combine its two half planes
+	if (span >= PI_T + PI_T)
+		arc.m_span = ARC_SPAN::ARC_FULL;
+	else if (span > PI_T)
+		arc.m_span = ARC_SPAN::ARC_MAJOR;
+	else
+		arc.m_span = ARC_SPAN::ARC_MINOR;
 }
 
+/******************************************************************************/
+/*!
+	Edge (end point) test selected by the collision policy. The segment only
+	policy never reaches the end points.
+ */
+/******************************************************************************/
+template <COLLISION_POLICY P>
+struct EdgeCheck;
+
+template <>
+struct EdgeCheck<COLLISION_POLICY::POLICY_SEGMENT_ONLY>
+{
+	template <typename T>
+	static int Run(bool, const CircleT<T> &, const CSD1130::Vector2DT<T> &, const LineSegmentT<T> &,
+					CSD1130::Vector2DT<T> &, CSD1130::Vector2DT<T> &, T &)
+	{
+		return 0;
+	}
+};
+
+template <>
+struct EdgeCheck<COLLISION_POLICY::POLICY_SEGMENT_AND_EDGES>
+{
+	template <typename T>
+	static int Run(bool withinBothLines, const CircleT<T> &circle, const CSD1130::Vector2DT<T> &ptEnd, const LineSegmentT<T> &lineSeg,
+					CSD1130::Vector2DT<T> &interPt, CSD1130::Vector2DT<T> &normalAtCollision, T &interTime)
+	{
+		return CheckMovingCircleToLineEdge(withinBothLines, circle, ptEnd, lineSeg, interPt, normalAtCollision, interTime);
+	}
+};
+
 /******************************************************************************/
 /*!
 * \brief Checks if circle intersects a line
@@ -44,73 +146,300 @@ void BuildLineSegment(LineSegment &lineSegment,
 * \param interPt:			output - Bi
 * \param normalAtCollision:	output - reflection vector
 * \param interTime:			output - ti
-* \param checkLineEdges:	output
 * \return int: returns 1 if there is collision, 0 if there is none
  */
 /******************************************************************************/
-int CollisionIntersection_CircleLineSegment(const Circle &circle,
-											const CSD1130::Vec2 &ptEnd,
-											const LineSegment &lineSeg,
-											CSD1130::Vec2 &interPt,
-											CSD1130::Vec2 &normalAtCollision,
-											float &interTime,
-											bool & checkLineEdges)
+template <typename T, LINE_CLASS C, COLLISION_POLICY P>
+int CollisionIntersection_CircleLineSegment(const CircleT<T> &circle,
+											const CSD1130::Vector2DT<T> &ptEnd,
+											const LineSegmentT<T> &lineSeg,
+											CSD1130::Vector2DT<T> &interPt,
+											CSD1130::Vector2DT<T> &normalAtCollision,
+											T &interTime)
 {
-	float NBs = CSD1130::Vector2DDotProduct(circle.m_center, lineSeg.m_normal);
-	float NP0 = CSD1130::Vector2DDotProduct(lineSeg.m_pt0, lineSeg.m_normal);
+	LineSegmentBandT<T> band;
+	BuildLineSegmentBand<T, C>(band, lineSeg, circle.m_radius);
 
-	CSD1130::Vec2 BsP0{};
-	CSD1130::Vec2 BsP1{};
+	return CollisionIntersection_CircleLineSegment<T, C, P>(circle, ptEnd, lineSeg, band, interPt, normalAtCollision, interTime);
+}
 
-	CSD1130::Vec2 V = ptEnd - circle.m_center;			// Velocity vector
-	CSD1130::Vec2 M = { V.y, -V.x };					// Normal to velocity vector
+/******************************************************************************/
+/*!
+* \brief Checks if circle intersects a line expanded by its radius
+* \param circle:			input - R, Bs
+* \param ptEnd:				input - Be
+* \param lineSeg:			input - n, p0, p1
+* \param band:				input - n.p0, p0 +/- R n, p1 +/- R n
+* \param interPt:			output - Bi
+* \param normalAtCollision:	output - reflection vector
+* \param interTime:			output - ti
+* \return int: returns 1 if there is collision, 0 if there is none
+ */
+/******************************************************************************/
+template <typename T, LINE_CLASS C, COLLISION_POLICY P>
+int CollisionIntersection_CircleLineSegment(const CircleT<T> &circle,
+											const CSD1130::Vector2DT<T> &ptEnd,
+											const LineSegmentT<T> &lineSeg,
+											const LineSegmentBandT<T> &band,
+											CSD1130::Vector2DT<T> &interPt,
+											CSD1130::Vector2DT<T> &normalAtCollision,
+											T &interTime)
+{
+	T NBs = LineNormal<C>::Dot(circle.m_center, lineSeg.m_normal);
+	T NP0 = band.m_NP0;
+
+	CSD1130::Vector2DT<T> BsP0{};
+	CSD1130::Vector2DT<T> BsP1{};
 
-	CSD1130::Vector2DNormalize(M, M);					// normalize velocity vector's normal
+	CSD1130::Vector2DT<T> V = ptEnd - circle.m_center;			// Velocity vector
+	CSD1130::Vector2DT<T> M = { V.y, -V.x };					// Normal to velocity vector
+														// (not normalized: only the sign of M.BsP0 * M.BsP1 is used)
 	
 	if (NBs - NP0 <= -circle.m_radius)
 	{
 		// Line vector from circle center to P'
-		BsP0 = (lineSeg.m_pt0 - circle.m_radius * lineSeg.m_normal) - circle.m_center;
-		BsP1 = (lineSeg.m_pt1 - circle.m_radius * lineSeg.m_normal) - circle.m_center;
+		BsP0 = band.m_pt0Back - circle.m_center;
+		BsP1 = band.m_pt1Back - circle.m_center;
 
-		if (CSD1130::Vector2DDotProduct(M, BsP0) * CSD1130::Vector2DDotProduct(M, BsP1) < 0.f)
+		if (CSD1130::Vector2DDotProduct(M, BsP0) * CSD1130::Vector2DDotProduct(M, BsP1) < T(0))
 		{
-			interTime = (CSD1130::Vector2DDotProduct(lineSeg.m_normal, lineSeg.m_pt0) - CSD1130::Vector2DDotProduct(lineSeg.m_normal, circle.m_center) - circle.m_radius) / CSD1130::Vector2DDotProduct(lineSeg.m_normal, V);
-			if (0.f <= interTime  && interTime <= 1.f)
+			interTime = (NP0 - NBs - circle.m_radius) / LineNormal<C>::Dot(V, lineSeg.m_normal);
+			if (T(0) <= interTime  && interTime <= T(1))
 			{
 				interPt				= circle.m_center + V * interTime;
 				normalAtCollision	= -lineSeg.m_normal;
 				return 1;
 			}
 		}
-		else if (checkLineEdges)
-			return CheckMovingCircleToLineEdge(false, circle, ptEnd, lineSeg, interPt, normalAtCollision, interTime);
+		else
+			return EdgeCheck<P>::Run(false, circle, ptEnd, lineSeg, interPt, normalAtCollision, interTime);
 	}
 	else if (NBs - NP0 >= circle.m_radius)
 	{
 		// Line vector from circle center to P'
-		BsP0 = (lineSeg.m_pt0 + circle.m_radius * lineSeg.m_normal) - circle.m_center;
-		BsP1 = (lineSeg.m_pt1 + circle.m_radius * lineSeg.m_normal) - circle.m_center;
+		BsP0 = band.m_pt0Front - circle.m_center;
+		BsP1 = band.m_pt1Front - circle.m_center;
 
-		if (CSD1130::Vector2DDotProduct(M, BsP0) * CSD1130::Vector2DDotProduct(M, BsP1) < 0.f)
+		if (CSD1130::Vector2DDotProduct(M, BsP0) * CSD1130::Vector2DDotProduct(M, BsP1) < T(0))
 		{
-			interTime = (CSD1130::Vector2DDotProduct(lineSeg.m_normal, lineSeg.m_pt0) - CSD1130::Vector2DDotProduct(lineSeg.m_normal, circle.m_center) + circle.m_radius) / CSD1130::Vector2DDotProduct(lineSeg.m_normal, V);
-			if (0.f <= interTime && interTime <= 1.f)
+			interTime = (NP0 - NBs + circle.m_radius) / LineNormal<C>::Dot(V, lineSeg.m_normal);
+			if (T(0) <= interTime && interTime <= T(1))
 			{
 				interPt				= circle.m_center + V * interTime;
 				normalAtCollision	= lineSeg.m_normal;
 				return 1;
 			}
 		}
-		else if (checkLineEdges)
-			return CheckMovingCircleToLineEdge(false, circle, ptEnd, lineSeg, interPt, normalAtCollision, interTime);
+		else
+			return EdgeCheck<P>::Run(false, circle, ptEnd, lineSeg, interPt, normalAtCollision, interTime);
 	}
-	else if (checkLineEdges) 
-		return CheckMovingCircleToLineEdge(true, circle, ptEnd, lineSeg, interPt, normalAtCollision, interTime);
+	else
+		return EdgeCheck<P>::Run(true, circle, ptEnd, lineSeg, interPt, normalAtCollision, interTime);
 
 	return 0;
 }
 
+/******************************************************************************/
+/*!
+* \brief Checks if circle intersects a line, edge checking picked at runtime
+* \param checkLineEdges:	input - true => check collision with line segment edges
+* \return int: returns 1 if there is collision, 0 if there is none
+ */
+/******************************************************************************/
+template <typename T>
+int CollisionIntersection_CircleLineSegment(const CircleT<T> &circle,
+											const CSD1130::Vector2DT<T> &ptEnd,
+											const LineSegmentT<T> &lineSeg,
+											CSD1130::Vector2DT<T> &interPt,
+											CSD1130::Vector2DT<T> &normalAtCollision,
+											T &interTime,
+											bool checkLineEdges)
+{
+	if (checkLineEdges)
+		return CollisionIntersection_CircleLineSegment<T, LINE_CLASS::LINE_GENERAL, COLLISION_POLICY::POLICY_SEGMENT_AND_EDGES>(
+			circle, ptEnd, lineSeg, interPt, normalAtCollision, interTime);
+
+	return CollisionIntersection_CircleLineSegment<T, LINE_CLASS::LINE_GENERAL, COLLISION_POLICY::POLICY_SEGMENT_ONLY>(
+		circle, ptEnd, lineSeg, interPt, normalAtCollision, interTime);
+}
+
+/******************************************************************************/
+/*!
+* \brief Checks if a moving point crosses a line segment from its front
+*		(P = Ps + t V against P = P0 + u E, t and u in [0, 1])
+* \param ptStart:		input - Ps
+* \param ptEnd:		input - Pe
+* \param lineSeg:		input - p0, p1
+* \param interTime:	output - ti
+* \return int: returns 1 if there is collision, 0 if there is none
+ */
+/******************************************************************************/
+template <typename T>
+int CollisionIntersection_PointLineSegment(const CSD1130::Vector2DT<T> &ptStart,
+											const CSD1130::Vector2DT<T> &ptEnd,
+											const LineSegmentT<T> &lineSeg,
+											T &interTime)
+{
+	CSD1130::Vector2DT<T> V		= ptEnd - ptStart;
+	CSD1130::Vector2DT<T> E		= lineSeg.m_pt1 - lineSeg.m_pt0;
+	CSD1130::Vector2DT<T> PsP0	= lineSeg.m_pt0 - ptStart;
+
+	// V x E is V.n |E|: negative when moving against the normal
+	T VxE = V.x * E.y - V.y * E.x;
+	if (!(VxE < T(0)))
+		return 0;
+
+	// t = (PsP0 x E) / (V x E) and u = (PsP0 x V) / (V x E), compared
+	// without dividing (VxE < 0 flips the inequalities)
+	T tNum = PsP0.x * E.y - PsP0.y * E.x;
+	T uNum = PsP0.x * V.y - PsP0.y * V.x;
+	if (tNum > T(0) || tNum < VxE || uNum > T(0) || uNum < VxE)
+		return 0;
+
+	interTime = tNum / VxE;
+	return 1;
+}
+
+/******************************************************************************/
+/*!
+* \brief Squared distance from a point to a line segment
+* \param pt:		input - P
+* \param lineSeg:	input - p0, p1
+* \return T: squared distance from P to the closest point of [p0, p1]
+ */
+/******************************************************************************/
+template <typename T>
+T DistanceSquared_PointLineSegment(const CSD1130::Vector2DT<T> &pt,
+									const LineSegmentT<T> &lineSeg)
+{
+	CSD1130::Vector2DT<T> E		= lineSeg.m_pt1 - lineSeg.m_pt0;
+	CSD1130::Vector2DT<T> P0P	= pt - lineSeg.m_pt0;
+
+	// closest point P0 + u E, u clamped to the segment
+	T P0PE	= CSD1130::Vector2DDotProduct(P0P, E);
+	T EE	= CSD1130::Vector2DSquareLength(E);
+
+	if (P0PE <= T(0))
+		return CSD1130::Vector2DSquareLength(P0P);
+	if (P0PE >= EE)
+		return CSD1130::Vector2DSquareDistance(pt, lineSeg.m_pt1);
+
+	return CSD1130::Vector2DSquareLength(P0P - E * (P0PE / EE));
+}
+
+/******************************************************************************/
+/*!
+* \brief First time a moving point is on a circle, going in or out
+* \param ptStart:		input - Ps
+* \param ptEnd:		input - Pe
+* \param center:		input - C
+* \param radius:		input - R
+* \param interTime:	output - ti, in [0, 1]
+* \return int: 1 if the point gets on the circle, 0 otherwise
+ */
+/******************************************************************************/
+template <typename T>
+int CollisionIntersection_PointCircle(const CSD1130::Vector2DT<T> &ptStart,
+									const CSD1130::Vector2DT<T> &ptEnd,
+									const CSD1130::Vector2DT<T> &center,
+									T radius,
+									T &interTime)
+{
+	CSD1130::Vector2DT<T> CPs	= ptStart - center;
+	CSD1130::Vector2DT<T> V		= ptEnd - ptStart;
+
+	// |CPs + V t|^2 = R^2 => a t^2 + 2 b t + c = 0
+	T a = CSD1130::Vector2DSquareLength(V);
+	T b = CSD1130::Vector2DDotProduct(CPs, V);
+	T c = CSD1130::Vector2DSquareLength(CPs) - radius * radius;
+
+	if (a == T(0))
+		return 0;
+
+	T disc = b * b - a * c;
+	if (disc < T(0))
+		return 0;
+
+	// inside it leaves at the larger root, outside it comes in at the smaller one if it moves toward C
+	T t;
+	if (c < T(0))
+		t = (CSD1130::ScalarSqrt(disc) - b) / a;
+	else if (b < T(0))
+		t = (-b - CSD1130::ScalarSqrt(disc)) / a;
+	else
+		return 0;
+
+	if (t > T(1))
+		return 0;
+
+	interTime = (t < T(0)) ? T(0) : t;
+	return 1;
+}
+
+/******************************************************************************/
+/*!
+* \brief First time a moving point gets within a distance of a line segment,
+*	on either side or past either end (0 if it starts there)
+* \param ptStart:		input - Ps
+* \param ptEnd:		input - Pe
+* \param lineSeg:		input - p0, p1 and the unit normal
+* \param radius:		input - R
+* \param interTime:	output - ti, in [0, 1]
+* \return int: 1 if the point gets within R of the segment, 0 otherwise
+ */
+/******************************************************************************/
+template <typename T>
+int CollisionIntersection_PointCapsule(const CSD1130::Vector2DT<T> &ptStart,
+									const CSD1130::Vector2DT<T> &ptEnd,
+									const LineSegmentT<T> &lineSeg,
+									T radius,
+									T &interTime)
+{
+	if (DistanceSquared_PointLineSegment(ptStart, lineSeg) <= radius * radius)
+	{
+		interTime = T(0);
+		return 1;
+	}
+
+	// starting outside, it comes in through one of the sides or one of the end caps
+	T best = T(2);
+	T t;
+
+	if (CollisionIntersection_PointCircle(ptStart, ptEnd, lineSeg.m_pt0, radius, t) && t < best)
+		best = t;
+	if (CollisionIntersection_PointCircle(ptStart, ptEnd, lineSeg.m_pt1, radius, t) && t < best)
+		best = t;
+
+	CSD1130::Vector2DT<T> V		= ptEnd - ptStart;
+	CSD1130::Vector2DT<T> E		= lineSeg.m_pt1 - lineSeg.m_pt0;
+	CSD1130::Vector2DT<T> P0Ps	= ptStart - lineSeg.m_pt0;
+
+	T distStart	= CSD1130::Vector2DDotProduct(P0Ps, lineSeg.m_normal);
+	T distV		= CSD1130::Vector2DDotProduct(V, lineSeg.m_normal);
+	T EE		= CSD1130::Vector2DSquareLength(E);
+
+	if (distV != T(0))
+	{
+		for (int side = 0; side < 2; ++side)
+		{
+			t = ((side ? radius : -radius) - distStart) / distV;
+			if (t < T(0) || t >= best)
+				continue;
+
+			// between the ends?
+			T u = CSD1130::Vector2DDotProduct(P0Ps + V * t, E);
+			if (u >= T(0) && u <= EE)
+				best = t;
+		}
+	}
+
+	if (best > T(1))
+		return 0;
+
+	interTime = best;
+	return 1;
+}
+
 /******************************************************************************/
 /*
 * \brief Checks if circle will collide with line
@@ -124,42 +453,42 @@ int CollisionIntersection_CircleLineSegment(const Circle &circle,
 * \return int: returns 1 if there is collision, 0 if there is none
 */
 /******************************************************************************/
+template <typename T>
 int CheckMovingCircleToLineEdge(bool withinBothLines,
-								const Circle &circle,
-								const CSD1130::Vec2 &ptEnd,
-								const LineSegment &lineSeg,
-								CSD1130::Vec2 &interPt,
-								CSD1130::Vec2 &normalAtCollision,
-								float &interTime)
+								const CircleT<T> &circle,
+								const CSD1130::Vector2DT<T> &ptEnd,
+								const LineSegmentT<T> &lineSeg,
+								CSD1130::Vector2DT<T> &interPt,
+								CSD1130::Vector2DT<T> &normalAtCollision,
+								T &interTime)
 {
-	float dist0{}, dist1{}, s{}, m{};
-	CSD1130::Vec2 BsP0	= lineSeg.m_pt0 - circle.m_center;	// Shortest distance from point to line segment
-	CSD1130::Vec2 BsP1	= lineSeg.m_pt1 - circle.m_center;
+	T dist0{}, dist1{}, s{}, m{};
+	CSD1130::Vector2DT<T> BsP0	= lineSeg.m_pt0 - circle.m_center;	// Shortest distance from point to line segment
+	CSD1130::Vector2DT<T> BsP1	= lineSeg.m_pt1 - circle.m_center;
 
-	CSD1130::Vec2 P0P1	= lineSeg.m_pt1 - lineSeg.m_pt0;	// Line vector
-	CSD1130::Vec2 V		= ptEnd - circle.m_center;			// Velocity vector
-	CSD1130::Vec2 M		= { V.y, -V.x };					// Normal to velocity vector
-	CSD1130::Vec2 Vnorm;
+	CSD1130::Vector2DT<T> P0P1	= lineSeg.m_pt1 - lineSeg.m_pt0;	// Line vector
+	CSD1130::Vector2DT<T> V		= ptEnd - circle.m_center;			// Velocity vector
+	CSD1130::Vector2DT<T> Vnorm;
 
-	CSD1130::Vector2DNormalize(M, M);						// normalize velocity vector's normal
-	CSD1130::Vector2DNormalize(Vnorm, V);					// normalize velocity vector
+	T lenV			= CSD1130::Vector2DNormalizeLength(Vnorm, V);	// normalize velocity vector, keep its length
+	CSD1130::Vector2DT<T> M		= { Vnorm.y, -Vnorm.x };					// Normal to velocity vector (already normalized)
 
 	if (withinBothLines) // If ball falls within P0' and P1'
 	{
-		if (CSD1130::Vector2DDotProduct(BsP0, P0P1) > 0.f) // BsP0.V > 0
+		if (CSD1130::Vector2DDotProduct(BsP0, P0P1) > T(0)) // BsP0.V > 0
 		{
 			m = CSD1130::Vector2DDotProduct(BsP0, Vnorm);
-			if (m > 0.f)
+			if (m > T(0))
 			{
 				dist0 = CSD1130::Vector2DDotProduct(BsP0, M);
 
-				if (abs(dist0) > circle.m_radius)
+				if (CSD1130::ScalarAbs(dist0) > circle.m_radius)
 					return 0; // no collision, edge of circle not touching line edge
 
-				s			= sqrt(circle.m_radius * circle.m_radius - dist0 * dist0);
-				interTime	= (m - s) / CSD1130::Vector2DLength(V);
+				s			= CSD1130::ScalarSqrt(circle.m_radius * circle.m_radius - dist0 * dist0);
+				interTime	= (m - s) / lenV;
 
-				if (interTime <= 1.f)
+				if (interTime <= T(1))
 				{
 					interPt				= circle.m_center + V * interTime; // Bi = Bs + V *ti
 					normalAtCollision	= interPt - lineSeg.m_pt0;
@@ -172,17 +501,17 @@ int CheckMovingCircleToLineEdge(bool withinBothLines,
 		else // (BsP1.P0P1 < 0)
 		{
 			m = CSD1130::Vector2DDotProduct(BsP1, Vnorm);
-			if (m > 0.f)
+			if (m > T(0))
 			{
 				dist1 = CSD1130::Vector2DDotProduct(BsP1, M);
 
-				if (abs(dist1) > circle.m_radius)
+				if (CSD1130::ScalarAbs(dist1) > circle.m_radius)
 					return 0;
 
-				s			= sqrt(circle.m_radius * circle.m_radius - dist1 * dist1);
-				interTime	= (m - s) / CSD1130::Vector2DLength(V);
+				s			= CSD1130::ScalarSqrt(circle.m_radius * circle.m_radius - dist1 * dist1);
+				interTime	= (m - s) / lenV;
 
-				if (interTime <= 1.f)
+				if (interTime <= T(1))
 				{
 					interPt				= circle.m_center + V * interTime; // Bi = Bs + V *ti
 					normalAtCollision	= interPt - lineSeg.m_pt1;
@@ -199,19 +528,19 @@ int CheckMovingCircleToLineEdge(bool withinBothLines,
 		dist0 = CSD1130::Vector2DDotProduct(BsP0, M);
 		dist1 = CSD1130::Vector2DDotProduct(BsP1, M);
 
-		float dist0Abs = abs(dist0);
-		float dist1Abs = abs(dist1);
+		T dist0Abs = CSD1130::ScalarAbs(dist0);
+		T dist1Abs = CSD1130::ScalarAbs(dist1);
 
 		if (dist0Abs > circle.m_radius && dist1Abs > circle.m_radius) // Ball not touching/intersecting
 			return 0;
 
 		else if (dist0Abs <= circle.m_radius && dist1Abs <= circle.m_radius)
 		{
-			float m0 = CSD1130::Vector2DDotProduct(BsP0, V);
-			float m1 = CSD1130::Vector2DDotProduct(BsP1, V);
+			T m0 = CSD1130::Vector2DDotProduct(BsP0, V);
+			T m1 = CSD1130::Vector2DDotProduct(BsP1, V);
 
-			float m0Abs = abs(m0);
-			float m1Abs = abs(m1);
+			T m0Abs = CSD1130::ScalarAbs(m0);
+			T m1Abs = CSD1130::ScalarAbs(m1);
 
 			P0Side = m0Abs < m1Abs ? true : false;
 		}
@@ -224,13 +553,13 @@ int CheckMovingCircleToLineEdge(bool withinBothLines,
 		if (P0Side)
 		{
 			m = CSD1130::Vector2DDotProduct(BsP0, Vnorm);
-			if (m < 0.f)
+			if (m < T(0))
 				return 0;
 			else
 			{
-				s			= sqrt(circle.m_radius * circle.m_radius - dist0 * dist0);
-				interTime	= (m - s) / CSD1130::Vector2DLength(V);
-				if (interTime <= 1.f)
+				s			= CSD1130::ScalarSqrt(circle.m_radius * circle.m_radius - dist0 * dist0);
+				interTime	= (m - s) / lenV;
+				if (interTime <= T(1))
 				{
 					interPt				= circle.m_center + V * interTime; // Bi = Bs + V *ti
 					normalAtCollision	= interPt - lineSeg.m_pt0;
@@ -242,13 +571,13 @@ int CheckMovingCircleToLineEdge(bool withinBothLines,
 		else
 		{
 			m = CSD1130::Vector2DDotProduct(BsP1, Vnorm);
-			if (m < 0.f)
+			if (m < T(0))
 				return 0;
 			else
 			{
-				s = sqrt(circle.m_radius * circle.m_radius - dist1 * dist1);
-				interTime = (m - s) / CSD1130::Vector2DLength(V);
-				if (interTime <= 1.f)
+				s = CSD1130::ScalarSqrt(circle.m_radius * circle.m_radius - dist1 * dist1);
+				interTime = (m - s) / lenV;
+				if (interTime <= T(1))
 				{
 					interPt				= circle.m_center + V * interTime; // Bi = Bs + V *ti
 					normalAtCollision	= interPt - lineSeg.m_pt1;
@@ -268,23 +597,642 @@ int CheckMovingCircleToLineEdge(bool withinBothLines,
 
 
 
+/******************************************************************************/
+/*!
+* \brief Merges the shared end points of line segments into unique vertices
+* \param pLines:		input - line segments
+* \param lineNum:		input - number of line segments
+* \param pVertices:	output - unique vertices (room for 2 * lineNum)
+* \return unsigned int: number of vertices
+ */
+/******************************************************************************/
+template <typename T>
+unsigned int BuildLineVertices(const LineSegmentT<T> *pLines,
+								unsigned int lineNum,
+								LineVertexT<T> *pVertices)
+{
+	// end point i is pt0 of line i / 2 when i is even, pt1 otherwise
+	auto endPoint = [pLines](unsigned int i) -> const CSD1130::Vector2DT<T>&
+	{
+		return (i & 1) ? pLines[i >> 1].m_pt1 : pLines[i >> 1].m_pt0;
+	};
+
+	// sort the end points so identical ones are next to each other
+	unsigned int *order = new unsigned int[lineNum * 2];
+	for (unsigned int i = 0; i < lineNum * 2; ++i)
+		order[i] = i;
+
+	std::sort(order, order + lineNum * 2, [&endPoint](unsigned int a, unsigned int b)
+	{
+		const CSD1130::Vector2DT<T> &pa = endPoint(a);
+		const CSD1130::Vector2DT<T> &pb = endPoint(b);
+		return pa.x < pb.x || (pa.x == pb.x && pa.y < pb.y);
+	});
+
+	unsigned int vertexNum = 0;
+	for (unsigned int i = 0; i < lineNum * 2; ++i)
+	{
+		const CSD1130::Vector2DT<T> &pt = endPoint(order[i]);
+
+		// new vertex unless it is the same point as the previous one
+		if (vertexNum == 0 || pt.x != pVertices[vertexNum - 1].m_pt.x || pt.y != pVertices[vertexNum - 1].m_pt.y)
+		{
+			pVertices[vertexNum].m_pt			= pt;
+			pVertices[vertexNum].m_normalNum	= 0;
+			++vertexNum;
+		}
+
+		// keep the normal of every segment meeting at the vertex, one past the
+		// capacity marks a vertex that has to be tested regardless
+		LineVertexT<T> &vertex = pVertices[vertexNum - 1];
+		if (vertex.m_normalNum < LINE_VERTEX_NORMAL_MAX)
+			vertex.m_normal[vertex.m_normalNum++] = pLines[order[i] >> 1].m_normal;
+		else
+			vertex.m_normalNum = LINE_VERTEX_NORMAL_MAX + 1;
+	}
+
+	for (unsigned int i = 0; i < vertexNum; ++i)
+		if (pVertices[i].m_normalNum > LINE_VERTEX_NORMAL_MAX)
+			pVertices[i].m_normalNum = 0;
+
+	delete []order;
+	return vertexNum;
+}
+
+namespace
+{
+	/**************************************************************************/
+	/*!
+		Moving circle against a static point, with the velocity V (Be - Bs)
+		and its square length VV computed by the caller. radius is the
+		distance between the circle center and the point at contact (the
+		circle radius, or the sum of both radii for a static circle).
+		The rejections are written per component: they run for almost every
+		vertex/pillar of the sweeps
+	 */
+	/**************************************************************************/
+	template <typename T>
+	int MovingCircleToPoint(const CircleT<T> &circle,
+							T radius,
+							const CSD1130::Vector2DT<T> &V,
+							T VV,
+							const CSD1130::Vector2DT<T> &pt,
+							CSD1130::Vector2DT<T> &interPt,
+							CSD1130::Vector2DT<T> &normalAtCollision,
+							T &interTime)
+	{
+		T BsPx	= pt.x - circle.m_center.x;
+		T BsPy	= pt.y - circle.m_center.y;
+
+		T BsPV	= BsPx * V.x + BsPy * V.y;
+		if (BsPV <= T(0))
+			return 0; // moving away from the point (or not moving)
+
+		T BsPsq	= BsPx * BsPx + BsPy * BsPy;
+		T RR	= radius * radius;
+
+		// squared distance from P to the path, scaled by |V|^2
+		if (BsPsq * VV - BsPV * BsPV > RR * VV)
+			return 0; // edge of circle not touching the point
+
+		T lenV	= CSD1130::ScalarSqrt(VV);
+		T m		= BsPV / lenV;										// distance along the path to the closest approach
+		T s		= CSD1130::ScalarSqrt(RR - (BsPsq - m * m));		// back off to where the circle first touches P
+
+		interTime = (m - s) / lenV;
+		if (interTime < T(0))
+			interTime = T(0); // already overlapping (and moving in): bounce from where it is
+		if (interTime <= T(1))
+		{
+			interPt				= circle.m_center + V * interTime;		// Bi = Bs + V *ti
+			normalAtCollision	= interPt - pt;
+			CSD1130::Vector2DNormalize(normalAtCollision, normalAtCollision);
+			return 1;
+		}
+
+		return 0;
+	}
+
+	/**************************************************************************/
+	/*!
+		Exact test of the moving circle against set[j]; keeps it as the hit
+		(in hit, interPt, normalAtCollision, interTime) if it is earlier
+		than the current one
+	 */
+	/**************************************************************************/
+	template <typename T>
+	void SweepCircleSetOne(const CircleT<T> &circle,
+							const CSD1130::Vector2DT<T> &V,
+							T VV,
+							const CircleSetT<T> &set,
+							unsigned int j,
+							unsigned int &hit,
+							unsigned int last,
+							CSD1130::Vector2DT<T> &interPt,
+							CSD1130::Vector2DT<T> &normalAtCollision,
+							T &interTime)
+	{
+		CSD1130::Vector2DT<T>	pt{ set.m_x[j], set.m_y[j] };
+		CSD1130::Vector2DT<T>	jInterPt, jNormal;
+		T						jInterTime;
+
+		if (MovingCircleToPoint(circle, circle.m_radius + set.m_radius[j], V, VV, pt,
+			jInterPt, jNormal, jInterTime) && (hit == last || jInterTime < interTime))
+		{
+			hit					= j;
+			interPt				= jInterPt;
+			normalAtCollision	= jNormal;
+			interTime			= jInterTime;
+		}
+	}
+
+	/**************************************************************************/
+	/*!
+		Sweep of a moving circle over set[first, last), one static circle at
+		a time. Returns the index of the earliest one hit (last if none)
+	 */
+	/**************************************************************************/
+	template <typename T>
+	unsigned int SweepCircleSetScalar(const CircleT<T> &circle,
+									const CSD1130::Vector2DT<T> &V,
+									T VV,
+									const CircleSetT<T> &set,
+									unsigned int first,
+									unsigned int last,
+									CSD1130::Vector2DT<T> &interPt,
+									CSD1130::Vector2DT<T> &normalAtCollision,
+									T &interTime)
+	{
+		unsigned int hit = last;
+
+		for (unsigned int j = first; j < last; ++j)
+			SweepCircleSetOne(circle, V, VV, set, j, hit, last, interPt, normalAtCollision, interTime);
+
+		return hit;
+	}
+
+	/**************************************************************************/
+	/*!
+		Same sweep, picked per scalar type (see the float version below)
+	 */
+	/**************************************************************************/
+	template <typename T>
+	struct SweepCircleSet
+	{
+		static unsigned int Run(const CircleT<T> &circle,
+								const CSD1130::Vector2DT<T> &V,
+								T VV,
+								const CircleSetT<T> &set,
+								unsigned int first,
+								unsigned int last,
+								CSD1130::Vector2DT<T> &interPt,
+								CSD1130::Vector2DT<T> &normalAtCollision,
+								T &interTime)
+		{
+			return SweepCircleSetScalar(circle, V, VV, set, first, last, interPt, normalAtCollision, interTime);
+		}
+	};
+
+#ifdef CSD1130_SSE2
+	/**************************************************************************/
+	/*!
+		float version: the two rejections of MovingCircleToPoint are done 4
+		static circles at a time, only the survivors go through the exact
+		(scalar) test
+	 */
+	/**************************************************************************/
+	template <>
+	struct SweepCircleSet<float>
+	{
+		static unsigned int Run(const Circle &circle,
+								const CSD1130::Vec2 &V,
+								float VV,
+								const CircleSet &set,
+								unsigned int first,
+								unsigned int last,
+								CSD1130::Vec2 &interPt,
+								CSD1130::Vec2 &normalAtCollision,
+								float &interTime)
+		{
+			const __m128 cx		= _mm_set1_ps(circle.m_center.x);
+			const __m128 cy		= _mm_set1_ps(circle.m_center.y);
+			const __m128 cr		= _mm_set1_ps(circle.m_radius);
+			const __m128 vx		= _mm_set1_ps(V.x);
+			const __m128 vy		= _mm_set1_ps(V.y);
+			const __m128 vv		= _mm_set1_ps(VV);
+			const __m128 zero	= _mm_setzero_ps();
+
+			unsigned int hit	= last;
+			unsigned int j		= first;
+			for (; j + 4 <= last; j += 4)
+			{
+				__m128 BsPx		= _mm_sub_ps(_mm_loadu_ps(set.m_x + j), cx);
+				__m128 BsPy		= _mm_sub_ps(_mm_loadu_ps(set.m_y + j), cy);
+				__m128 r		= _mm_add_ps(_mm_loadu_ps(set.m_radius + j), cr);
+
+				__m128 BsPV		= _mm_add_ps(_mm_mul_ps(BsPx, vx), _mm_mul_ps(BsPy, vy));
+				__m128 BsPsq	= _mm_add_ps(_mm_mul_ps(BsPx, BsPx), _mm_mul_ps(BsPy, BsPy));
+
+				// moving toward it, and close enough to the path
+				__m128 toward	= _mm_cmpgt_ps(BsPV, zero);
+				__m128 close	= _mm_cmple_ps(_mm_sub_ps(_mm_mul_ps(BsPsq, vv), _mm_mul_ps(BsPV, BsPV)),
+												_mm_mul_ps(_mm_mul_ps(r, r), vv));
+
+				int lanes = _mm_movemask_ps(_mm_and_ps(toward, close));
+				for (unsigned int k = 0; lanes != 0; ++k, lanes >>= 1)
+					if (lanes & 1)
+						SweepCircleSetOne(circle, V, VV, set, j + k, hit, last, interPt, normalAtCollision, interTime);
+			}
+
+			// the last (up to 3) ones
+			for (; j < last; ++j)
+				SweepCircleSetOne(circle, V, VV, set, j, hit, last, interPt, normalAtCollision, interTime);
+
+			return hit;
+		}
+	};
+#endif
+}
+
+/******************************************************************************/
+/*!
+* \brief Checks if a moving circle hits a static point
+* \param circle:			input - R, Bs
+* \param ptEnd:				input - Be
+* \param pt:				input - P
+* \param interPt:			output - Bi
+* \param normalAtCollision:	output - reflection vector
+* \param interTime:			output - ti
+* \return int: returns 1 if there is collision, 0 if there is none
+ */
+/******************************************************************************/
+template <typename T>
+int CollisionIntersection_CirclePoint(const CircleT<T> &circle,
+									const CSD1130::Vector2DT<T> &ptEnd,
+									const CSD1130::Vector2DT<T> &pt,
+									CSD1130::Vector2DT<T> &interPt,
+									CSD1130::Vector2DT<T> &normalAtCollision,
+									T &interTime)
+{
+	CSD1130::Vector2DT<T> V = ptEnd - circle.m_center;			// Velocity vector
+
+	return MovingCircleToPoint(circle, circle.m_radius, V, CSD1130::Vector2DSquareLength(V), pt, interPt, normalAtCollision, interTime);
+}
+
+/******************************************************************************/
+/*!
+* \brief Finds the first vertex a moving circle hits
+* \param circle:			input - R, Bs
+* \param ptEnd:				input - Be
+* \param velCurr:			input - circle velocity, for the facing test
+* \param pVertices:			input - vertices
+* \param first:				input - index of the first vertex to test
+* \param vertexNum:			input - number of vertices
+* \param interPt:			output - Bi
+* \param normalAtCollision:	output - reflection vector
+* \param interTime:			output - ti
+* \return unsigned int: index of the vertex hit, vertexNum if none
+ */
+/******************************************************************************/
+template <typename T>
+unsigned int CollisionIntersection_CircleVertices(const CircleT<T> &circle,
+												const CSD1130::Vector2DT<T> &ptEnd,
+												const CSD1130::Vector2DT<T> &velCurr,
+												const LineVertexT<T> *pVertices,
+												unsigned int first,
+												unsigned int vertexNum,
+												CSD1130::Vector2DT<T> &interPt,
+												CSD1130::Vector2DT<T> &normalAtCollision,
+												T &interTime)
+{
+	CSD1130::Vector2DT<T> V	= ptEnd - circle.m_center;			// Velocity vector, the same for every vertex
+	T VV					= CSD1130::Vector2DSquareLength(V);
+
+	for (unsigned int j = first; j < vertexNum; ++j)
+	{
+		const LineVertexT<T> &vertex = pVertices[j];
+
+		// same facing test as the walls: moving toward the front of one of them
+		bool facing = (vertex.m_normalNum == 0);
+		for (unsigned int k = 0; k < vertex.m_normalNum && !facing; ++k)
+			facing = velCurr.x * vertex.m_normal[k].x + velCurr.y * vertex.m_normal[k].y < T(0);
+
+		if (facing && MovingCircleToPoint(circle, circle.m_radius, V, VV, vertex.m_pt, interPt, normalAtCollision, interTime))
+			return j;
+	}
+
+	return vertexNum;
+}
+
+/******************************************************************************/
+/*!
+* \brief Checks if a moving circle hits a static circle
+* \param circle:			input - R, Bs
+* \param ptEnd:				input - Be
+* \param other:				input - static circle
+* \param interPt:			output - Bi
+* \param normalAtCollision:	output - reflection vector
+* \param interTime:			output - ti
+* \return int: returns 1 if there is collision, 0 if there is none
+ */
+/******************************************************************************/
+template <typename T>
+int CollisionIntersection_CircleCircle(const CircleT<T> &circle,
+									const CSD1130::Vector2DT<T> &ptEnd,
+									const CircleT<T> &other,
+									CSD1130::Vector2DT<T> &interPt,
+									CSD1130::Vector2DT<T> &normalAtCollision,
+									T &interTime)
+{
+	CSD1130::Vector2DT<T> V = ptEnd - circle.m_center;			// Velocity vector
+
+	// the circle touches the other one when its center is R + r away from the other center
+	return MovingCircleToPoint(circle, circle.m_radius + other.m_radius, V, CSD1130::Vector2DSquareLength(V),
+		other.m_center, interPt, normalAtCollision, interTime);
+}
+
+/******************************************************************************/
+/*!
+* \brief Finds the static circle of a set a moving circle hits first
+* \param circle:			input - R, Bs
+* \param ptEnd:				input - Be
+* \param set:				input - static circles
+* \param first:				input - index of the first static circle to test
+* \param last:				input - one past the last static circle to test
+* \param interPt:			output - Bi
+* \param normalAtCollision:	output - reflection vector
+* \param interTime:			output - ti
+* \return unsigned int: index of the earliest static circle hit, last if none
+ */
+/******************************************************************************/
+template <typename T>
+unsigned int CollisionIntersection_CircleCircleSet(const CircleT<T> &circle,
+												const CSD1130::Vector2DT<T> &ptEnd,
+												const CircleSetT<T> &set,
+												unsigned int first,
+												unsigned int last,
+												CSD1130::Vector2DT<T> &interPt,
+												CSD1130::Vector2DT<T> &normalAtCollision,
+												T &interTime)
+{
+	CSD1130::Vector2DT<T> V	= ptEnd - circle.m_center;			// Velocity vector, the same for every static circle
+	T VV					= CSD1130::Vector2DSquareLength(V);
+
+	return SweepCircleSet<T>::Run(circle, V, VV, set, first, last, interPt, normalAtCollision, interTime);
+}
+
+/******************************************************************************/
+/*!
+* \brief Checks if two moving circles hit each other
+* \param circleA:			input - RA, BsA
+* \param ptEndA:			input - BeA
+* \param circleB:			input - RB, BsB
+* \param ptEndB:			input - BeB
+* \param interPtA:			output - BiA
+* \param interPtB:			output - BiB
+* \param normalAtCollision:	output - unit vector from BiB to BiA
+* \param interTime:			output - ti
+* \return int: returns 1 if there is collision, 0 if there is none
+ */
+/******************************************************************************/
+template <typename T>
+int CollisionIntersection_CircleCircleMoving(const CircleT<T> &circleA,
+											const CSD1130::Vector2DT<T> &ptEndA,
+											const CircleT<T> &circleB,
+											const CSD1130::Vector2DT<T> &ptEndB,
+											CSD1130::Vector2DT<T> &interPtA,
+											CSD1130::Vector2DT<T> &interPtB,
+											CSD1130::Vector2DT<T> &normalAtCollision,
+											T &interTime)
+{
+	CSD1130::Vector2DT<T> VA	= ptEndA - circleA.m_center;
+	CSD1130::Vector2DT<T> VB	= ptEndB - circleB.m_center;
+	CSD1130::Vector2DT<T> V		= VA - VB;						// Velocity of A seen from B
+
+	// seen from B, A moves by V toward a static circle
+	if (!MovingCircleToPoint(circleA, circleA.m_radius + circleB.m_radius, V, CSD1130::Vector2DSquareLength(V),
+		circleB.m_center, interPtA, normalAtCollision, interTime))
+		return 0;
+
+	interPtA = circleA.m_center + VA * interTime;
+	interPtB = circleB.m_center + VB * interTime;
+	return 1;
+}
+
+/******************************************************************************/
+/*!
+* \brief Checks if a moving circle inside an arc hits it
+* \param circle:			input - R, Bs
+* \param ptEnd:				input - Be
+* \param arc:				input - arc
+* \param interPt:			output - Bi
+* \param normalAtCollision:	output - reflection vector (toward the center)
+* \param interTime:			output - ti
+* \return int: returns 1 if there is collision, 0 if there is none
+ */
+/******************************************************************************/
+template <typename T>
+int CollisionIntersection_CircleArc(const CircleT<T> &circle,
+									const CSD1130::Vector2DT<T> &ptEnd,
+									const ArcT<T> &arc,
+									CSD1130::Vector2DT<T> &interPt,
+									CSD1130::Vector2DT<T> &normalAtCollision,
+									T &interTime)
+{
+	// the ball center touches the arc on the circle of radius Rc = R - r
+	T Rc = arc.m_radius - circle.m_radius;
+	if (Rc <= T(0))
+		return 0; // ball bigger than the arc
+
+	CSD1130::Vector2DT<T> CBs	= circle.m_center - arc.m_center;
+	CSD1130::Vector2DT<T> V		= ptEnd - circle.m_center;			// Velocity vector
+	CSD1130::Vector2DT<T> CBe	= CBs + V;
+
+	T RcRc	= Rc * Rc;
+	T CBsSq	= CSD1130::Vector2DSquareLength(CBs);
+	T c		= CBsSq - RcRc;
+	T b		= CSD1130::Vector2DDotProduct(CBs, V);
+	T t;
+
+	if (c >= T(0))
+	{
+		// Already overlapping the arc at the start (a wall next to it bounced the ball
+		// there): bounce back now if it keeps moving out, unless its center is past the arc
+		if (b <= T(0) || CBsSq >= arc.m_radius * arc.m_radius)
+			return 0;
+		t = T(0);
+	}
+	else
+	{
+		if (CSD1130::Vector2DSquareLength(CBe) <= RcRc)
+			return 0; // still inside at the end, the common case
+
+		// |CBs + V t|^2 = Rc^2 => a t^2 + 2 b t + c = 0, the ball leaves at the larger root.
+		// c < 0 so the discriminant is positive and the root is in (0, 1]
+		T a = CSD1130::Vector2DSquareLength(V);
+		t	= (CSD1130::ScalarSqrt(b * b - a * c) - b) / a;
+	}
+
+	CSD1130::Vector2DT<T> Bi	= circle.m_center + V * t;			// Bi = Bs + V *ti
+	CSD1130::Vector2DT<T> CBi	= Bi - arc.m_center;
+
+	// is the contact inside the arc? (cross products with the end directions)
+	bool afterDir0	= arc.m_dir0.x * CBi.y - arc.m_dir0.y * CBi.x >= T(0);
+	bool beforeDir1	= CBi.x * arc.m_dir1.y - CBi.y * arc.m_dir1.x >= T(0);
+
+	if ((arc.m_span == ARC_SPAN::ARC_MINOR && !(afterDir0 && beforeDir1)) ||
+		(arc.m_span == ARC_SPAN::ARC_MAJOR && !(afterDir0 || beforeDir1)))
+		return 0; // through the opening
+
+	interTime			= t;
+	interPt				= Bi;
+	normalAtCollision	= -CBi;
+	CSD1130::Vector2DNormalize(normalAtCollision, normalAtCollision);
+	return 1;
+}
+
 /******************************************************************************/
 /*!
 * \brief Collision response for collision between line and circle
 * \param ptInter::	input - point of intersection
 * \param normal:	input - normal at collision
+* \param velocity:	input - velocity of the circle before the collision
 * \param ptEnd:		output - new end point of circle after collision
 * \param reflected:	output - reflection vector
  */
 /******************************************************************************/
-void CollisionResponse_CircleLineSegment(const CSD1130::Vec2 &ptInter,
-										const CSD1130::Vec2 &normal,
-										CSD1130::Vec2 &ptEnd,
-										CSD1130::Vec2 &reflected)
+template <typename T>
+void CollisionResponse_CircleLineSegment(const CSD1130::Vector2DT<T> &ptInter,
+										const CSD1130::Vector2DT<T> &normal,
+										const CSD1130::Vector2DT<T> &velocity,
+										CSD1130::Vector2DT<T> &ptEnd,
+										CSD1130::Vector2DT<T> &reflected)
 {
-	CSD1130::Vec2 penetration	= ptEnd - ptInter;																// Penetration vector (BiBe)
-	reflected					= penetration - 2 * CSD1130::Vector2DDotProduct(penetration, normal) * normal;	// Reflection vector
-	ptEnd						= ptInter + reflected;															// Point after reflection
+	CSD1130::Vector2DT<T> penetration	= ptEnd - ptInter;																// Penetration vector (BiBe)
+
+	ptEnd						= ptInter + penetration - T(2) * CSD1130::Vector2DDotProduct(penetration, normal) * normal;	// Point after reflection
+
+	// the new direction is the incoming one mirrored, not the penetration's:
+	// a circle ending a hair past the contact has a penetration made mostly
+	// of rounding (of the bits of a Fixed), pointing anywhere. Only a circle
+	// at rest goes by the penetration (by the normal without one either)
+	if (velocity.x != T(0) || velocity.y != T(0))
+		reflected				= velocity - T(2) * CSD1130::Vector2DDotProduct(velocity, normal) * normal;	// Reflection vector
+	else if (penetration.x != T(0) || penetration.y != T(0))
+		reflected				= ptEnd - ptInter;
+	else
+	{
+		reflected				= normal;
+		return;
+	}
 
 	CSD1130::Vector2DNormalize(reflected, reflected);
 }
+
+/******************************************************************************/
+/*!
+* \brief Elastic collision response between two circles
+* \param normal:	input - normal at collision, from B to A
+* \param interTime:	input - ti
+* \param dt:		input - step duration
+* \param massA:		input - mass of A
+* \param ptInterA:	input - point of intersection of A
+* \param velA:		input/output - velocity of A
+* \param ptEndA:	output - new end point of A after collision
+* \param massB:		input - mass of B
+* \param ptInterB:	input - point of intersection of B
+* \param velB:		input/output - velocity of B
+* \param ptEndB:	output - new end point of B after collision
+* \return int: returns 1 if they bounced, 0 if they were already moving apart
+ */
+/******************************************************************************/
+template <typename T>
+int CollisionResponse_CircleCircle(const CSD1130::Vector2DT<T> &normal,
+									T interTime,
+									T dt,
+									T massA,
+									const CSD1130::Vector2DT<T> &ptInterA,
+									CSD1130::Vector2DT<T> &velA,
+									CSD1130::Vector2DT<T> &ptEndA,
+									T massB,
+									const CSD1130::Vector2DT<T> &ptInterB,
+									CSD1130::Vector2DT<T> &velB,
+									CSD1130::Vector2DT<T> &ptEndB)
+{
+	T approach = CSD1130::Vector2DDotProduct(velA - velB, normal);		// Closing speed along the normal
+
+	// already separating (bounced off each other earlier in the step): leave them be
+	if (approach >= T(0))
+		return 0;
+
+	T impulse	= T(2) * approach / (massA + massB);
+
+	velA		= velA - (impulse * massB) * normal;
+	velB		= velB + (impulse * massA) * normal;
+
+	T timeLeft	= (T(1) - interTime) * dt;
+
+	ptEndA		= ptInterA + velA * timeLeft;
+	ptEndB		= ptInterB + velB * timeLeft;
+
+	return 1;
+}
+
+
+// explicit instantiations for the supported scalar types (see Scalar.h) and line classes
+#define CSD1130_INSTANTIATE_COLLISION_POLICY(T, C, P)																	\
+	template int CollisionIntersection_CircleLineSegment<T, C, P>(const CircleT<T>&, const CSD1130::Vector2DT<T>&,		\
+		const LineSegmentT<T>&, CSD1130::Vector2DT<T>&, CSD1130::Vector2DT<T>&, T&);									\
+	template int CollisionIntersection_CircleLineSegment<T, C, P>(const CircleT<T>&, const CSD1130::Vector2DT<T>&,		\
+		const LineSegmentT<T>&, const LineSegmentBandT<T>&, CSD1130::Vector2DT<T>&, CSD1130::Vector2DT<T>&, T&);
+
+#define CSD1130_INSTANTIATE_COLLISION_CLASS(T, C)																		\
+	template void BuildLineSegmentBand<T, C>(LineSegmentBandT<T>&, const LineSegmentT<T>&, T);							\
+	CSD1130_INSTANTIATE_COLLISION_POLICY(T, C, COLLISION_POLICY::POLICY_SEGMENT_ONLY)									\
+	CSD1130_INSTANTIATE_COLLISION_POLICY(T, C, COLLISION_POLICY::POLICY_SEGMENT_AND_EDGES)
+
+#define CSD1130_INSTANTIATE_COLLISION(T)																				\
+	template void BuildLineSegment<T>(LineSegmentT<T>&, const CSD1130::Vector2DT<T>&, const CSD1130::Vector2DT<T>&);	\
+	CSD1130_INSTANTIATE_COLLISION_CLASS(T, LINE_CLASS::LINE_HORIZONTAL)													\
+	CSD1130_INSTANTIATE_COLLISION_CLASS(T, LINE_CLASS::LINE_VERTICAL)														\
+	CSD1130_INSTANTIATE_COLLISION_CLASS(T, LINE_CLASS::LINE_GENERAL)														\
+	template int CollisionIntersection_CircleLineSegment<T>(const CircleT<T>&, const CSD1130::Vector2DT<T>&,			\
+		const LineSegmentT<T>&, CSD1130::Vector2DT<T>&, CSD1130::Vector2DT<T>&, T&, bool);								\
+	template int CollisionIntersection_CircleCircle<T>(const CircleT<T>&, const CSD1130::Vector2DT<T>&,					\
+		const CircleT<T>&, CSD1130::Vector2DT<T>&, CSD1130::Vector2DT<T>&, T&);										\
+	template unsigned int CollisionIntersection_CircleCircleSet<T>(const CircleT<T>&, const CSD1130::Vector2DT<T>&,	\
+		const CircleSetT<T>&, unsigned int, unsigned int, CSD1130::Vector2DT<T>&, CSD1130::Vector2DT<T>&, T&);		\
+	template int CollisionIntersection_CircleCircleMoving<T>(const CircleT<T>&, const CSD1130::Vector2DT<T>&,			\
+		const CircleT<T>&, const CSD1130::Vector2DT<T>&, CSD1130::Vector2DT<T>&, CSD1130::Vector2DT<T>&,			\
+		CSD1130::Vector2DT<T>&, T&);																				\
+	template void BuildArc<T>(ArcT<T>&, const CSD1130::Vector2DT<T>&, T, T, T);											\
+	template int CollisionIntersection_CircleArc<T>(const CircleT<T>&, const CSD1130::Vector2DT<T>&,					\
+		const ArcT<T>&, CSD1130::Vector2DT<T>&, CSD1130::Vector2DT<T>&, T&);											\
+	template unsigned int BuildLineVertices<T>(const LineSegmentT<T>*, unsigned int, LineVertexT<T>*);					\
+	template int CollisionIntersection_CirclePoint<T>(const CircleT<T>&, const CSD1130::Vector2DT<T>&,					\
+		const CSD1130::Vector2DT<T>&, CSD1130::Vector2DT<T>&, CSD1130::Vector2DT<T>&, T&);								\
+	template unsigned int CollisionIntersection_CircleVertices<T>(const CircleT<T>&, const CSD1130::Vector2DT<T>&,		\
+		const CSD1130::Vector2DT<T>&, const LineVertexT<T>*, unsigned int, unsigned int,								\
+		CSD1130::Vector2DT<T>&, CSD1130::Vector2DT<T>&, T&);															\
+	template int CollisionIntersection_PointLineSegment<T>(const CSD1130::Vector2DT<T>&, const CSD1130::Vector2DT<T>&,		\
+		const LineSegmentT<T>&, T&);																					\
+	template T DistanceSquared_PointLineSegment<T>(const CSD1130::Vector2DT<T>&, const LineSegmentT<T>&);				\
+	template int CollisionIntersection_PointCircle<T>(const CSD1130::Vector2DT<T>&, const CSD1130::Vector2DT<T>&,		\
+		const CSD1130::Vector2DT<T>&, T, T&);																			\
+	template int CollisionIntersection_PointCapsule<T>(const CSD1130::Vector2DT<T>&, const CSD1130::Vector2DT<T>&,		\
+		const LineSegmentT<T>&, T, T&);																					\
+	template int CheckMovingCircleToLineEdge<T>(bool, const CircleT<T>&, const CSD1130::Vector2DT<T>&,					\
+		const LineSegmentT<T>&, CSD1130::Vector2DT<T>&, CSD1130::Vector2DT<T>&, T&);									\
+	template void CollisionResponse_CircleLineSegment<T>(const CSD1130::Vector2DT<T>&, const CSD1130::Vector2DT<T>&,	\
+		const CSD1130::Vector2DT<T>&, CSD1130::Vector2DT<T>&, CSD1130::Vector2DT<T>&);								\
+	template int CollisionResponse_CircleCircle<T>(const CSD1130::Vector2DT<T>&, T, T, T, const CSD1130::Vector2DT<T>&,	\
+		CSD1130::Vector2DT<T>&, CSD1130::Vector2DT<T>&, T, const CSD1130::Vector2DT<T>&, CSD1130::Vector2DT<T>&,		\
+		CSD1130::Vector2DT<T>&);
+
+CSD1130_INSTANTIATE_COLLISION(float)
+CSD1130_INSTANTIATE_COLLISION(double)
+CSD1130_INSTANTIATE_COLLISION(CSD1130::Fixed)
+
+#undef CSD1130_INSTANTIATE_COLLISION
+#undef CSD1130_INSTANTIATE_COLLISION_CLASS
+#undef CSD1130_INSTANTIATE_COLLISION_POLICY
\ No newline at end of file
@@ -0,0 +1,114 @@
+/******************************************************************************/
+/*!
+\file		ContactCache.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 17, 2023
+\brief
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+namespace
+{
+	// Added to the distance a wall is kept within, for rounding
+	const float		CONTACT_MARGIN	= 1.0f;
+}
+
+/******************************************************************************/
+/*!
+* \brief Builds the cache of the walls and vertices around a ball
+* \param cache:			output - cache
+* \param center:		input - center of the cached region (the ball)
+* \param reach:			input - radius of the cached region
+* \param radius:		input - ball radius
+* \param pWalls:		input - walls, grouped by class
+* \param pClassStart:	input - class c is pWalls[pClassStart[c], pClassStart[c + 1])
+* \param pVertices:		input - wall vertices
+* \param vertexNum:		input - number of vertices
+ */
+/******************************************************************************/
+template <typename T>
+void BuildContactCache(ContactCacheT<T> &cache,
+						const CSD1130::Vector2DT<T> &center,
+						T reach,
+						T radius,
+						const LineSegmentT<T> *pWalls,
+						const unsigned int *pClassStart,
+						const LineVertexT<T> *pVertices,
+						unsigned int vertexNum)
+{
+	// anything the ball can touch from inside the region
+	T range		= reach + radius + T(CONTACT_MARGIN);
+	T rangeSq	= range * range;
+
+	cache.m_center		= center;
+	cache.m_reach		= reach;
+	cache.m_full		= false;
+	cache.m_vertexNum	= 0;
+
+	unsigned int wallNum = 0;
+	for (int c = 0; c < (int)LINE_CLASS::LINE_CLASS_NUM; ++c)
+	{
+		cache.m_classStart[c] = wallNum;
+
+		for (unsigned int w = pClassStart[c]; w < pClassStart[c + 1] && !cache.m_full; ++w)
+		{
+			if (DistanceSquared_PointLineSegment(center, pWalls[w]) > rangeSq)
+				continue;
+
+			if (wallNum == CONTACT_WALL_MAX)
+				cache.m_full = true;
+			else
+				cache.m_walls[wallNum++] = w;
+		}
+	}
+	cache.m_classStart[(int)LINE_CLASS::LINE_CLASS_NUM] = wallNum;
+
+	for (unsigned int v = 0; v < vertexNum && !cache.m_full; ++v)
+	{
+		if (CSD1130::Vector2DSquareDistance(center, pVertices[v].m_pt) > rangeSq)
+			continue;
+
+		if (cache.m_vertexNum == CONTACT_VERTEX_MAX)
+			cache.m_full = true;
+		else
+			cache.m_vertices[cache.m_vertexNum++] = v;
+	}
+}
+
+/******************************************************************************/
+/*!
+* \brief Checks that a step stays in the cached region
+* \param cache:		input - cache
+* \param ptStart:	input - start of the step
+* \param ptEnd:		input - end of the step
+* \return bool: true if every point the ball goes through (bounces included,
+*	they don't make the path longer) is within the reach of the cache
+ */
+/******************************************************************************/
+template <typename T>
+bool ContactCacheCovers(const ContactCacheT<T> &cache,
+						const CSD1130::Vector2DT<T> &ptStart,
+						const CSD1130::Vector2DT<T> &ptEnd)
+{
+	// both legs, from the center of the cache to the start and on to the end
+	return CSD1130::StepReach(ptStart - cache.m_center) + CSD1130::StepReach(ptEnd - ptStart) <= cache.m_reach;
+}
+
+#define CSD1130_INSTANTIATE_CONTACT_CACHE(T)																			\
+	template void BuildContactCache<T>(ContactCacheT<T>&, const CSD1130::Vector2DT<T>&, T, T, const LineSegmentT<T>*,	\
+		const unsigned int*, const LineVertexT<T>*, unsigned int);														\
+	template bool ContactCacheCovers<T>(const ContactCacheT<T>&, const CSD1130::Vector2DT<T>&,							\
+		const CSD1130::Vector2DT<T>&);
+
+CSD1130_INSTANTIATE_CONTACT_CACHE(float)
+CSD1130_INSTANTIATE_CONTACT_CACHE(double)
+CSD1130_INSTANTIATE_CONTACT_CACHE(CSD1130::Fixed)
+
+#undef CSD1130_INSTANTIATE_CONTACT_CACHE
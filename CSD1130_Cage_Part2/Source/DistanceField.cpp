@@ -0,0 +1,354 @@
+/******************************************************************************/
+/*!
+\file		DistanceField.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 11, 2023
+\brief
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// Cap on the number of samples; past it the cells get bigger
+	const double		SAMPLE_NUM_MAX	= 1 << 21;
+
+	/**************************************************************************/
+	/*!
+		Signed distance from pt to the cage. The closest wall gives the sign;
+		at an end point shared by several walls, the one pt is the most in
+		front of or behind decides, and a point in front of a wall and behind
+		its reverse (both sides are walls) is in front. Arcs are only solid
+		from the inside, pillars from the outside
+	 */
+	/**************************************************************************/
+	template <typename T>
+	T CageDistance(const CSD1130::Vector2DT<T> &pt,
+					const LineSegmentT<T> *pWalls,
+					unsigned int wallNum,
+					const ArcT<T> *pArcs,
+					unsigned int arcNum,
+					const CircleSetT<T> &pillars,
+					T farDist)
+	{
+		T dist = farDist;
+
+		T bestSq	= farDist * farDist;
+		T bestSide	= T(0);
+		for (unsigned int w = 0; w < wallNum; ++w)
+		{
+			T distSq	= DistanceSquared_PointLineSegment(pt, pWalls[w]);
+			T side		= CSD1130::Vector2DDotProduct(pt - pWalls[w].m_pt0, pWalls[w].m_normal);
+
+			if (distSq < bestSq ||
+				(distSq == bestSq && (CSD1130::ScalarAbs(side) > CSD1130::ScalarAbs(bestSide) ||
+									(CSD1130::ScalarAbs(side) == CSD1130::ScalarAbs(bestSide) && side > bestSide))))
+			{
+				bestSq		= distSq;
+				bestSide	= side;
+			}
+		}
+
+		if (bestSq < farDist * farDist)
+		{
+			dist = CSD1130::ScalarSqrt(bestSq);
+			if (bestSide < T(0))
+				dist = -dist;
+		}
+
+		for (unsigned int a = 0; a < arcNum; ++a)
+		{
+			const ArcT<T> &arc = pArcs[a];
+
+			CSD1130::Vector2DT<T> CP	= pt - arc.m_center;
+			T arcDist					= arc.m_radius - CSD1130::Vector2DLength(CP);
+
+			// outside the circle, only behind the arc itself is negative
+			if (arcDist < T(0))
+			{
+				bool afterDir0	= arc.m_dir0.x * CP.y - arc.m_dir0.y * CP.x >= T(0);
+				bool beforeDir1	= CP.x * arc.m_dir1.y - CP.y * arc.m_dir1.x >= T(0);
+
+				if ((arc.m_span == ARC_SPAN::ARC_MINOR && !(afterDir0 && beforeDir1)) ||
+					(arc.m_span == ARC_SPAN::ARC_MAJOR && !(afterDir0 || beforeDir1)))
+					arcDist = -arcDist;
+			}
+
+			if (arcDist < dist)
+				dist = arcDist;
+		}
+
+		for (unsigned int p = 0; p < pillars.m_num; ++p)
+		{
+			CSD1130::Vector2DT<T> CP	= { pt.x - pillars.m_x[p], pt.y - pillars.m_y[p] };
+			T pillarDist				= CSD1130::Vector2DLength(CP) - pillars.m_radius[p];
+
+			if (pillarDist < dist)
+				dist = pillarDist;
+		}
+
+		return dist;
+	}
+
+	/**************************************************************************/
+	/*!
+		Samples rows first, first + step, ... of the field
+	 */
+	/**************************************************************************/
+	template <typename T>
+	void SampleRows(DistanceFieldT<T> &field,
+					const LineSegmentT<T> *pWalls,
+					unsigned int wallNum,
+					const ArcT<T> *pArcs,
+					unsigned int arcNum,
+					const CircleSetT<T> &pillars,
+					T farDist,
+					int first,
+					int step)
+	{
+		for (int y = first; y < field.m_samplesY; y += step)
+		{
+			T *pRow = field.m_dist + y * field.m_samplesX;
+
+			for (int x = 0; x < field.m_samplesX; ++x)
+			{
+				CSD1130::Vector2DT<T> pt{ field.m_minX + T(x) * field.m_cellSize, field.m_minY + T(y) * field.m_cellSize };
+
+				pRow[x] = CageDistance(pt, pWalls, wallNum, pArcs, arcNum, pillars, farDist);
+			}
+		}
+	}
+
+	/**************************************************************************/
+	/*!
+		Cell holding pt, and where pt is in it (0 to 1 on each axis). The cell
+		is picked in double, like in PillarGrid.cpp
+	 */
+	/**************************************************************************/
+	template <typename T>
+	bool FieldCell(const DistanceFieldT<T> &field,
+					const CSD1130::Vector2DT<T> &pt,
+					const T *&pCell,
+					T &fx,
+					T &fy)
+	{
+		if (!field.m_dist)
+			return false;
+
+		double cx = floor((double)(pt.x - field.m_minX) / (double)field.m_cellSize);
+		double cy = floor((double)(pt.y - field.m_minY) / (double)field.m_cellSize);
+
+		if (cx < 0.0 || cy < 0.0 || cx >= (double)(field.m_samplesX - 1) || cy >= (double)(field.m_samplesY - 1))
+			return false;
+
+		int x = (int)cx;
+		int y = (int)cy;
+
+		pCell	= field.m_dist + y * field.m_samplesX + x;
+		fx		= (pt.x - (field.m_minX + T(x) * field.m_cellSize)) / field.m_cellSize;
+		fy		= (pt.y - (field.m_minY + T(y) * field.m_cellSize)) / field.m_cellSize;
+		return true;
+	}
+}
+
+/******************************************************************************/
+/*!
+* \brief Samples the signed distance to the cage on a grid
+* \param field:		output - distance field
+* \param pWalls:	input - walls
+* \param wallNum:	input - number of walls
+* \param pArcs:		input - arcs
+* \param arcNum:	input - number of arcs
+* \param pillars:	input - pillars
+* \param cellSize:	input - distance between samples, grown to fit SAMPLE_NUM_MAX
+* \param threadNum:	input - threads sampling it, 0 for the hardware thread count
+ */
+/******************************************************************************/
+template <typename T>
+void BuildDistanceField(DistanceFieldT<T> &field,
+						const LineSegmentT<T> *pWalls,
+						unsigned int wallNum,
+						const ArcT<T> *pArcs,
+						unsigned int arcNum,
+						const CircleSetT<T> &pillars,
+						T cellSize,
+						unsigned int threadNum)
+{
+	field.m_samplesX	= 0;
+	field.m_samplesY	= 0;
+	field.m_dist		= 0;
+
+	// bounding box of the cage
+	bool	empty	= true;
+	double	minX	= 0.0, minY = 0.0, maxX = 0.0, maxY = 0.0;
+
+	auto grow = [&](double x0, double y0, double x1, double y1)
+	{
+		if (empty || x0 < minX)	minX = x0;
+		if (empty || y0 < minY)	minY = y0;
+		if (empty || x1 > maxX)	maxX = x1;
+		if (empty || y1 > maxY)	maxY = y1;
+		empty = false;
+	};
+
+	for (unsigned int w = 0; w < wallNum; ++w)
+	{
+		grow((double)pWalls[w].m_pt0.x, (double)pWalls[w].m_pt0.y, (double)pWalls[w].m_pt0.x, (double)pWalls[w].m_pt0.y);
+		grow((double)pWalls[w].m_pt1.x, (double)pWalls[w].m_pt1.y, (double)pWalls[w].m_pt1.x, (double)pWalls[w].m_pt1.y);
+	}
+	for (unsigned int a = 0; a < arcNum; ++a)
+	{
+		double x = (double)pArcs[a].m_center.x, y = (double)pArcs[a].m_center.y, r = (double)pArcs[a].m_radius;
+		grow(x - r, y - r, x + r, y + r);
+	}
+	for (unsigned int p = 0; p < pillars.m_num; ++p)
+	{
+		double x = (double)pillars.m_x[p], y = (double)pillars.m_y[p], r = (double)pillars.m_radius[p];
+		grow(x - r, y - r, x + r, y + r);
+	}
+
+	double cell = (double)cellSize;
+	if (empty || cell <= 0.0)
+		return;
+
+	// one cell of room around it
+	minX -= cell;
+	minY -= cell;
+	maxX += cell;
+	maxY += cell;
+
+	while ((floor((maxX - minX) / cell) + 2.0) * (floor((maxY - minY) / cell) + 2.0) > SAMPLE_NUM_MAX)
+		cell *= 2.0;
+
+	field.m_minX		= T(minX);
+	field.m_minY		= T(minY);
+	field.m_cellSize	= T(cell);
+	field.m_samplesX	= (int)floor((maxX - minX) / cell) + 2;
+	field.m_samplesY	= (int)floor((maxY - minY) / cell) + 2;
+	field.m_dist		= new T[field.m_samplesX * field.m_samplesY];
+
+	// a bilinear blend of samples from a function that changes by at most the distance
+	// moved is off by less than the distance to the farthest corner of the cell
+	field.m_slack		= field.m_cellSize;
+
+	// further than anything in the field
+	T farDist = T((maxX - minX) + (maxY - minY));
+
+	if (threadNum == 0)
+		threadNum = std::thread::hardware_concurrency();
+	if (threadNum == 0)
+		threadNum = 1;
+	if (threadNum > (unsigned int)field.m_samplesY)
+		threadNum = (unsigned int)field.m_samplesY;
+
+	// rows interleaved between the threads, this one included
+	int step = (int)threadNum;
+	std::vector<std::thread> threads;
+	for (int t = 1; t < step; ++t)
+		threads.push_back(std::thread([&, t]() { SampleRows(field, pWalls, wallNum, pArcs, arcNum, pillars, farDist, t, step); }));
+
+	SampleRows(field, pWalls, wallNum, pArcs, arcNum, pillars, farDist, 0, step);
+
+	for (std::thread &thread : threads)
+		thread.join();
+}
+
+/******************************************************************************/
+/*!
+* \brief Releases the distance field
+* \param field:	input/output - distance field, empty afterwards
+ */
+/******************************************************************************/
+template <typename T>
+void FreeDistanceField(DistanceFieldT<T> &field)
+{
+	delete []field.m_dist;
+
+	field.m_dist		= 0;
+	field.m_samplesX	= 0;
+	field.m_samplesY	= 0;
+}
+
+/******************************************************************************/
+/*!
+* \brief Interpolates the distance field
+* \param field:	input - distance field
+* \param pt:	input - point
+* \param dist:	output - distance, at most field.m_slack above the real one
+* \return bool: false if pt is outside the field
+ */
+/******************************************************************************/
+template <typename T>
+bool SampleDistanceField(const DistanceFieldT<T> &field,
+						const CSD1130::Vector2DT<T> &pt,
+						T &dist)
+{
+	const T *p;
+	T fx, fy;
+
+	if (!FieldCell(field, pt, p, fx, fy))
+		return false;
+
+	int sx = field.m_samplesX;
+
+	T d0 = p[0] + (p[1] - p[0]) * fx;
+	T d1 = p[sx] + (p[sx + 1] - p[sx]) * fx;
+
+	dist = d0 + (d1 - d0) * fy;
+	return true;
+}
+
+/******************************************************************************/
+/*!
+* \brief Gradient of the distance field, pointing away from the cage
+* \param field:		input - distance field
+* \param pt:		input - point
+* \param normal:	output - unit gradient
+* \return bool: false if pt is outside the field or the field is flat there
+ */
+/******************************************************************************/
+template <typename T>
+bool DistanceFieldGradient(const DistanceFieldT<T> &field,
+							const CSD1130::Vector2DT<T> &pt,
+							CSD1130::Vector2DT<T> &normal)
+{
+	const T *p;
+	T fx, fy;
+
+	if (!FieldCell(field, pt, p, fx, fy))
+		return false;
+
+	int sx = field.m_samplesX;
+
+	// derivatives of the bilinear blend, in samples (the cell size goes away once normalized)
+	CSD1130::Vector2DT<T> grad{ (p[1] - p[0]) * (T(1) - fy) + (p[sx + 1] - p[sx]) * fy,
+								(p[sx] - p[0]) * (T(1) - fx) + (p[sx + 1] - p[1]) * fx };
+
+	if (grad.x == T(0) && grad.y == T(0))
+		return false;
+
+	CSD1130::Vector2DNormalize(normal, grad);
+	return true;
+}
+
+#define CSD1130_INSTANTIATE_DISTANCE_FIELD(T)																			\
+	template void BuildDistanceField<T>(DistanceFieldT<T>&, const LineSegmentT<T>*, unsigned int, const ArcT<T>*,		\
+		unsigned int, const CircleSetT<T>&, T, unsigned int);															\
+	template void FreeDistanceField<T>(DistanceFieldT<T>&);																\
+	template bool SampleDistanceField<T>(const DistanceFieldT<T>&, const CSD1130::Vector2DT<T>&, T&);					\
+	template bool DistanceFieldGradient<T>(const DistanceFieldT<T>&, const CSD1130::Vector2DT<T>&, CSD1130::Vector2DT<T>&);
+
+CSD1130_INSTANTIATE_DISTANCE_FIELD(float)
+CSD1130_INSTANTIATE_DISTANCE_FIELD(double)
+CSD1130_INSTANTIATE_DISTANCE_FIELD(CSD1130::Fixed)
+
+#undef CSD1130_INSTANTIATE_DISTANCE_FIELD
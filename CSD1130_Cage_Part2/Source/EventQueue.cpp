@@ -0,0 +1,203 @@
+/******************************************************************************/
+/*!
+\file		EventQueue.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 13, 2023
+\brief
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+namespace
+{
+	/**************************************************************************/
+	/*!
+		Puts id in heap slot s
+	 */
+	/**************************************************************************/
+	void Place(EventQueue &queue, unsigned int s, unsigned int id)
+	{
+		queue.m_heap[s]		= id;
+		queue.m_slot[id]	= s;
+	}
+
+	/**************************************************************************/
+	/*!
+		Moves the id of slot s up while it is earlier than its parent
+	 */
+	/**************************************************************************/
+	void SiftUp(EventQueue &queue, unsigned int s)
+	{
+		unsigned int	id		= queue.m_heap[s];
+		double			time	= queue.m_time[id];
+
+		while (s > 0)
+		{
+			unsigned int parent = (s - 1) / 2;
+			if (!(time < queue.m_time[queue.m_heap[parent]]))
+				break;
+
+			Place(queue, s, queue.m_heap[parent]);
+			s = parent;
+		}
+
+		Place(queue, s, id);
+	}
+
+	/**************************************************************************/
+	/*!
+		Moves the id of slot s down while one of its children is earlier
+	 */
+	/**************************************************************************/
+	void SiftDown(EventQueue &queue, unsigned int s)
+	{
+		unsigned int	id		= queue.m_heap[s];
+		double			time	= queue.m_time[id];
+
+		for (;;)
+		{
+			unsigned int child = 2 * s + 1;
+			if (child >= queue.m_num)
+				break;
+
+			if (child + 1 < queue.m_num && queue.m_time[queue.m_heap[child + 1]] < queue.m_time[queue.m_heap[child]])
+				++child;
+
+			if (!(queue.m_time[queue.m_heap[child]] < time))
+				break;
+
+			Place(queue, s, queue.m_heap[child]);
+			s = child;
+		}
+
+		Place(queue, s, id);
+	}
+}
+
+/******************************************************************************/
+/*!
+* \brief Allocates an empty event queue
+* \param queue:	output - queue
+* \param idNum:	input - number of ids
+ */
+/******************************************************************************/
+void InitEventQueue(EventQueue &queue,
+					unsigned int idNum)
+{
+	queue.m_time	= new double[idNum];
+	queue.m_heap	= new unsigned int[idNum];
+	queue.m_slot	= new unsigned int[idNum];
+	queue.m_num		= 0;
+	queue.m_idNum	= idNum;
+
+	for (unsigned int i = 0; i < idNum; ++i)
+		queue.m_slot[i] = EVENT_NOT_QUEUED;
+}
+
+/******************************************************************************/
+/*!
+* \brief Releases the event queue
+* \param queue:	input/output - queue, empty afterwards
+ */
+/******************************************************************************/
+void FreeEventQueue(EventQueue &queue)
+{
+	delete []queue.m_time;
+	delete []queue.m_heap;
+	delete []queue.m_slot;
+
+	queue.m_time	= 0;
+	queue.m_heap	= 0;
+	queue.m_slot	= 0;
+	queue.m_num		= 0;
+	queue.m_idNum	= 0;
+}
+
+/******************************************************************************/
+/*!
+* \brief Queues an event, or moves it if its id is queued already
+* \param queue:	input/output - queue
+* \param id:	input - id
+* \param time:	input - time it is due
+ */
+/******************************************************************************/
+void PushEvent(EventQueue &queue,
+				unsigned int id,
+				double time)
+{
+	unsigned int s = queue.m_slot[id];
+
+	if (s == EVENT_NOT_QUEUED)
+	{
+		queue.m_time[id] = time;
+		Place(queue, queue.m_num, id);
+		SiftUp(queue, queue.m_num++);
+		return;
+	}
+
+	bool earlier		= time < queue.m_time[id];
+	queue.m_time[id]	= time;
+
+	if (earlier)
+		SiftUp(queue, s);
+	else
+		SiftDown(queue, s);
+}
+
+/******************************************************************************/
+/*!
+* \brief Reads the earliest event
+* \param queue:	input - queue
+* \param id:	output - its id
+* \param time:	output - its time
+* \return bool: false if the queue is empty
+ */
+/******************************************************************************/
+bool PeekEvent(const EventQueue &queue,
+				unsigned int &id,
+				double &time)
+{
+	if (queue.m_num == 0)
+		return false;
+
+	id		= queue.m_heap[0];
+	time	= queue.m_time[id];
+	return true;
+}
+
+/******************************************************************************/
+/*!
+* \brief Takes the earliest event out of the queue
+* \param queue:	input/output - queue, not empty
+ */
+/******************************************************************************/
+void PopEvent(EventQueue &queue)
+{
+	queue.m_slot[queue.m_heap[0]] = EVENT_NOT_QUEUED;
+
+	if (--queue.m_num == 0)
+		return;
+
+	Place(queue, 0, queue.m_heap[queue.m_num]);
+	SiftDown(queue, 0);
+}
+
+/******************************************************************************/
+/*!
+* \brief Empties the queue
+* \param queue:	input/output - queue
+ */
+/******************************************************************************/
+void ClearEventQueue(EventQueue &queue)
+{
+	for (unsigned int s = 0; s < queue.m_num; ++s)
+		queue.m_slot[queue.m_heap[s]] = EVENT_NOT_QUEUED;
+
+	queue.m_num = 0;
+}
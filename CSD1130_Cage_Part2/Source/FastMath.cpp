@@ -0,0 +1,183 @@
+/******************************************************************************/
+/*!
+\file		FastMath.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	March 28, 2023
+\brief
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#include "FastMath.h"
+#include <math.h>
+#include <string.h>
+
+namespace CSD1130
+{
+	// PI/2 split in a high part (exact in float) and a low part (the rest),
+	// so that angle - q * PI/2 keeps its precision for large q
+	constexpr float TWO_OVER_PI	= 0.636619772367581f;
+	constexpr float PIO2_HI		= 1.5703125f;
+	constexpr float PIO2_LO		= 4.83826794897e-4f;
+
+	// Taylor coefficients, accurate enough on [-PI/4, PI/4]
+	constexpr float SIN_C3		= -1.66666667e-1f;
+	constexpr float SIN_C5		= 8.33333333e-3f;
+	constexpr float SIN_C7		= -1.98412698e-4f;
+	constexpr float COS_C2		= -5.0e-1f;
+	constexpr float COS_C4		= 4.16666667e-2f;
+	constexpr float COS_C6		= -1.38888889e-3f;
+	constexpr float COS_C8		= 2.48015873e-5f;
+
+	void FastSinCos(float angle, float& pSin, float& pCos)
+	{
+#ifdef CSD1130_FAST_MATH
+		// quadrant of the angle, rounded to the nearest multiple of PI/2
+		float k = angle * TWO_OVER_PI;
+		int q = (int)(k >= 0.f ? k + 0.5f : k - 0.5f);
+
+		// remainder in [-PI/4, PI/4]
+		float r		= (angle - (float)q * PIO2_HI) - (float)q * PIO2_LO;
+		float r2	= r * r;
+
+		float s = r + r * r2 * (SIN_C3 + r2 * (SIN_C5 + r2 * SIN_C7));
+		float c = 1.f + r2 * (COS_C2 + r2 * (COS_C4 + r2 * (COS_C6 + r2 * COS_C8)));
+
+		// rotate the result back into the original quadrant
+		switch (q & 3)
+		{
+		case 0: pSin = s;	pCos = c;	break;
+		case 1: pSin = c;	pCos = -s;	break;
+		case 2: pSin = -s;	pCos = -c;	break;
+		default: pSin = -c;	pCos = s;	break;
+		}
+#else
+		pSin = sinf(angle);
+		pCos = cosf(angle);
+#endif
+	}
+
+	float FastRSqrt(float x)
+	{
+#ifdef CSD1130_FAST_MATH
+		// initial guess from the float bit pattern (halves the exponent)
+		unsigned int bits;
+		memcpy(&bits, &x, sizeof(bits));
+		bits = 0x5f375a86u - (bits >> 1);
+
+		float y;
+		memcpy(&y, &bits, sizeof(y));
+
+		// each Newton-Raphson step roughly squares the relative error
+		float halfX = 0.5f * x;
+		y = y * (1.5f - halfX * y * y);
+		y = y * (1.5f - halfX * y * y);
+		return y;
+#else
+		return 1.f / sqrtf(x);
+#endif
+	}
+
+	void FastSinCos(double angle, double& pSin, double& pCos)
+	{
+		pSin = sin(angle);
+		pCos = cos(angle);
+	}
+
+	void FastSinCos(Fixed angle, Fixed& pSin, Fixed& pCos)
+	{
+		// same reduction and polynomial as the float version, in integer arithmetic
+		static const Fixed FX_TWO_OVER_PI	{ 0.636619772367581 };
+		// PI/2 with 32 fractional bits, so q * PI/2 stays exact to Q.16 for large q
+		constexpr int64_t PIO2_Q32			= 6746518852;
+		static const Fixed FX_SIN_C3		{ (double)SIN_C3 };
+		static const Fixed FX_SIN_C5		{ (double)SIN_C5 };
+		static const Fixed FX_SIN_C7		{ (double)SIN_C7 };
+		static const Fixed FX_COS_C2		{ (double)COS_C2 };
+		static const Fixed FX_COS_C4		{ (double)COS_C4 };
+		static const Fixed FX_COS_C6		{ (double)COS_C6 };
+		static const Fixed FX_COS_C8		{ (double)COS_C8 };
+
+		// quadrant of the angle, rounded to the nearest multiple of PI/2
+		Fixed k		= angle * FX_TWO_OVER_PI;
+		int64_t q	= (k.raw + Fixed::ONE / 2) >> Fixed::FRAC_BITS;
+
+		// remainder in [-PI/4, PI/4]
+		Fixed r		= angle - Fixed::FromRaw((q * PIO2_Q32 + (int64_t(1) << 15)) >> 16);
+		Fixed r2	= r * r;
+
+		Fixed s = r + r * r2 * (FX_SIN_C3 + r2 * (FX_SIN_C5 + r2 * FX_SIN_C7));
+		Fixed c = Fixed(1) + r2 * (FX_COS_C2 + r2 * (FX_COS_C4 + r2 * (FX_COS_C6 + r2 * FX_COS_C8)));
+
+		// rotate the result back into the original quadrant
+		switch (q & 3)
+		{
+		case 0: pSin = s;	pCos = c;	break;
+		case 1: pSin = c;	pCos = -s;	break;
+		case 2: pSin = -s;	pCos = -c;	break;
+		default: pSin = -c;	pCos = s;	break;
+		}
+	}
+
+	template <typename T>
+	T Vector2DNormalizeLength(Vector2DT<T>& pResult, const Vector2DT<T>& pVec0)
+	{
+		T len		= ScalarSqrt(Vector2DSquareLength(pVec0));
+
+		pResult.x = pVec0.x / len;
+		pResult.y = pVec0.y / len;
+		return len;
+	}
+
+	template <>
+	float Vector2DNormalizeLength<float>(Vector2D& pResult, const Vector2D& pVec0)
+	{
+		float sqLen = Vector2DSquareLength(pVec0);
+
+#ifdef CSD1130_FAST_MATH
+		float invLen	= FastRSqrt(sqLen);
+		float len		= sqLen * invLen;
+
+		pResult.x = pVec0.x * invLen;
+		pResult.y = pVec0.y * invLen;
+#else
+		float len		= sqrtf(sqLen);
+
+		pResult.x = pVec0.x / len;
+		pResult.y = pVec0.y / len;
+#endif
+		return len;
+	}
+
+	template <>
+	Fixed Vector2DNormalizeLength<Fixed>(Vector2Dx& pResult, const Vector2Dx& pVec0)
+	{
+		int64_t big = ScalarAbs(pVec0.x).raw > ScalarAbs(pVec0.y).raw ? ScalarAbs(pVec0.x).raw : ScalarAbs(pVec0.y).raw;
+
+		// the zero vector has no direction, keep it (instead of dividing by 0)
+		if (big == 0)
+		{
+			pResult = pVec0;
+			return Fixed::FromRaw(0);
+		}
+
+		// a short vector squared in Q.16 loses most of its bits, so scale it
+		// up by a power of 2 first (exact) and scale the length back down
+		int shift = 0;
+		while ((big << shift) < (int64_t(1) << 24))
+			++shift;
+
+		Vector2Dx v{ Fixed::FromRaw(pVec0.x.raw << shift), Fixed::FromRaw(pVec0.y.raw << shift) };
+		Fixed len	= ScalarSqrt(Vector2DSquareLength(v));
+
+		pResult.x = v.x / len;
+		pResult.y = v.y / len;
+		return Fixed::FromRaw(len.raw >> shift);
+	}
+
+	template double	Vector2DNormalizeLength<double>(Vector2Dd&, const Vector2Dd&);
+}
@@ -0,0 +1,48 @@
+/******************************************************************************/
+/*!
+\file		Fixed.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	March 29, 2023
+\brief
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#include "Fixed.h"
+
+namespace CSD1130
+{
+	Fixed ScalarSqrt(Fixed x)
+	{
+		if (x.raw <= 0)
+			return Fixed::FromRaw(0);
+
+		// sqrt(raw * 2^16) = sqrt(value) * 2^16, so the result is already in Q.16
+		uint64_t n		= (uint64_t)x.raw << Fixed::FRAC_BITS;
+		uint64_t res	= 0;
+		uint64_t bit	= uint64_t(1) << 62;
+
+		// highest power of 4 <= n
+		while (bit > n)
+			bit >>= 2;
+
+		// digit by digit (base 4) square root
+		while (bit != 0)
+		{
+			if (n >= res + bit)
+			{
+				n	-= res + bit;
+				res	= (res >> 1) + bit;
+			}
+			else
+				res >>= 1;
+			bit >>= 2;
+		}
+
+		return Fixed::FromRaw((int64_t)res);
+	}
+}
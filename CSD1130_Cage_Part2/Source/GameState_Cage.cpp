@@ -28,7 +28,16 @@ const unsigned int	FLAG_VISIBLE			= 0x00000002;
 const unsigned int	FLAG_NON_COLLIDABLE		= 0x00000004;
 
 const float			PI_OVER_180				= PI/180.0f;
-bool pause = false;
+const float			ARC_DRAW_STEP			= 10.0f * PI_OVER_180;	//Angle covered by one drawn chord of an arc
+const float			PICK_NEIGHBOUR_RADIUS	= 60.0f;	//Balls this close to the picked one are highlighted too
+const unsigned int	PARTICLE_DRAW_MAX		= 8192;	//Particles drawn (they all move, drawing them all can take longer)
+const float			PARTICLE_DRAW_SIZE		= 1.5f;
+const double		EVENT_JUMP				= 60.0;	//Seconds skipped with J
+const unsigned int	STREAM_DRAW_MAX			= 8192;	//Streamed walls drawn
+const char			STATE_RING_NAME[]		= "CSD1130_Cage_State";	//Shared memory the steps are published in
+const unsigned int	STATE_SLOT_NUM			= 16;	//Steps kept there for the readers
+const unsigned int	STATE_EVENT_MAX			= 4096;	//Bounces published per step
+
 
 //values: 0,1,2,3
 //0: original: no extra credits
@@ -36,7 +45,54 @@ bool pause = false;
 
 int EXTRA_CREDITS = 1;
 
+//values: 0,1
+//0: float simulation
+//1: deterministic fixed-point simulation: ball positions/velocities and all collision
+//   math in CSD1130::Fixed with a constant time step => bit identical trajectories
+//   across compilers, optimization levels and builds (M toggles it and restarts)
+
+int FIXED_POINT_SIM = 0;
+
+//values: 0,1
+//0: balls go through each other
+//1: balls bounce off each other (elastic, mass from the area) (B toggles it)
+
+int BALL_COLLISIONS = 0;
+
+//values: 0,1,2
+//0: every ball is stepped every frame
+//1: event driven: the next impact of each ball with the cage is queued, only the balls
+//   due are stepped and the others move in a straight line from where they last were
+//2: event driven, and the balls whose bounces repeat are put on their orbit: their
+//   position comes from their last bounces, they aren't stepped anymore
+//   (1 and 2: float simulation without ball collisions only; E cycles through the
+//   values, J skips EVENT_JUMP seconds)
+
+int EVENT_DRIVEN_SIM = 0;
+
+//values: 0,1
+//0: each ball is tested against the walls on its own, in turn
+//1: tiled: blocks of balls against blocks of walls that fit in the L1 cache together;
+//   each ball bounces off the wall it hits first, then goes on from there (T toggles it)
+//   the balls round differently than with 0 from the first bounce off a wall, and the
+//   difference grows with every bounce after; the ball collisions are the same pairs in
+//   the same order
 
+int TILED_WALLS = 0;
+
+//values: 0,1
+//0: the balls stay in memory in the order they were loaded in
+//1: every BALL_SORT_PERIOD steps the ball state is reordered along a Z-order curve of the
+//   positions, so that balls close to each other are close in memory (Z toggles it)
+
+int BALL_SORT = 0;
+
+//values: 0,1
+//0: the balls are only drawn
+//1: every step is also published in shared memory (STATE_RING_NAME), for other processes
+//   to read with a StateReader while the simulation runs (P toggles it)
+
+int PUBLISH_STATE = 0;
 
 enum class TYPE_OBJECT
 {
@@ -97,8 +153,33 @@ GameObjInst*		gameObjInstCreate (TYPE_OBJECT type,
 										   float dir);
 void				gameObjInstDestroy(GameObjInst* pInst);
 
-static Circle		*sBallData = 0;
-static LineSegment	*sWallData = 0;
+// the simulation; the ball instances point into sWorld.m_ballData and only
+// get a copy of the state for drawing
+static CageWorld		sWorld{};
+
+// pillars are drawn straight from the grid (there can be more pillars than
+// object instances), with transforms computed once
+static CSD1130::Mtx33	*sPillarTransform = 0;
+
+// instances of the kinematic walls
+static GameObjInst		**sKinematicInst = 0;
+
+// ball positions filed by cell, rebuilt every frame for picking and culling
+static BallHash			sBallHash{};
+static unsigned int		*sBallQuery = 0;	// output of the queries, room for every ball
+static unsigned char	*sBallMark = 0;		// 1 in view, 2 picked or next to the picked ball
+static int				sBallPicked = -1;
+
+static double			sSimTime = 0.0;		// time spent updating the balls last frame, in seconds
+
+// the steps for other processes (PUBLISH_STATE == 1)
+static StatePublisher	sPublisher{};
+
+static void MarkBalls(void);
+static void WriteBallsToInstances(void);
+static void RenumberBallInstances(void);
+template <typename T> static void WriteKinematicWallsToInstances(const KinematicWallSetT<T> &);
+template <typename T> static void DrawStreamedWalls(const WallStreamT<T> &);
 
 
 
@@ -112,6 +193,8 @@ void GameStateCageLoad(void)
 	//validating
 	if (EXTRA_CREDITS > 1 || EXTRA_CREDITS < 0)
 		EXTRA_CREDITS = 0;
+	if (FIXED_POINT_SIM > 1 || FIXED_POINT_SIM < 0)
+		FIXED_POINT_SIM = 0;
 
 	sGameObjList = (GameObj *)calloc(GAME_OBJ_NUM_MAX, sizeof(GameObj));
 	sGameObjInstList = (GameObjInst *)calloc(GAME_OBJ_INST_NUM_MAX, sizeof(GameObjInst));
@@ -163,6 +246,25 @@ void GameStateCageLoad(void)
 
 	//------------------------------------------
 
+	// Creating the pillar object
+	pObj		= sGameObjList + sGameObjNum++;
+	pObj->type	= TYPE_OBJECT::TYPE_OBJECT_PILLAR;
+
+	AEGfxMeshStart();
+
+	//Creating the pillar shape (same as the ball, in grey)
+	for(float i = 0; i < Parts; ++i)
+	{
+		AEGfxTriAdd(
+		0.0f, 0.0f, 0xFF808080, 0.0f, 0.0f,
+		cosf(i*2*PI/Parts)*1.0f,  sinf(i*2*PI/Parts)*1.0f, 0xFF808080, 0.0f, 0.0f,
+		cosf((i+1)*2*PI/Parts)*1.0f,  sinf((i+1)*2*PI/Parts)*1.0f, 0xFF808080, 0.0f, 0.0f);
+	}
+
+	pObj->pMesh = AEGfxMeshEnd();
+
+	//------------------------------------------
+
 	
 
 	AEGfxSetBackgroundColor(0.2f, 0.2f, 0.2f);
@@ -170,6 +272,7 @@ void GameStateCageLoad(void)
 	
 }
 
+
 /******************************************************************************/
 /*!
 
@@ -178,96 +281,121 @@ void GameStateCageLoad(void)
 void GameStateCageInit(void)
 {
 	GameObjInst *pInst;
-	std::string str;
-	std::ifstream inFile;
+	CageLevel level;
 
-	if(EXTRA_CREDITS == 0)
-		inFile.open("..\\Bin\\Resources\\LevelData - Original.txt");
-	else if (EXTRA_CREDITS == 1)
-		inFile.open("..\\Bin\\Resources\\LevelData - Extra Credits.txt");
-	
-	
-	if(inFile.is_open())
+	const char *path = (EXTRA_CREDITS == 0) ? "..\\Bin\\Resources\\LevelData - Original.txt" :
+												"..\\Bin\\Resources\\LevelData - Extra Credits.txt";
+
+	if (!ReadCageLevel(level, path))
 	{
-		// read ball data
-		float dir, speed, scale;
-		unsigned int ballNum = 0;
-		inFile>>ballNum;
-		sBallData = new Circle[ballNum];
+		//AE_ASSERT_MESG(inFile, "Failed to open the text file");
+		printf("Failed to read the level %s", path);
+		return;
+	}
 
-		for(unsigned int i = 0; i < ballNum; ++i)
-		{
-			// read pos
-			inFile>>str>>sBallData[i].m_center.x;
-			inFile>>str>>sBallData[i].m_center.y;
-			// read direction
-			inFile>>str>>dir;
-			// read speed
-			inFile>>str>>speed;
-			// read radius
-			inFile>>str>>sBallData[i].m_radius;
-			
-			// create ball instance
-			CSD1130::Vec2 vel{ cos(dir * PI_OVER_180) * speed, sin(dir * PI_OVER_180) * speed };
-			//AEVec2Set(&vel, cos(dir*PI_OVER_180)*speed, 
-			//				sin(dir*PI_OVER_180)*speed);
-			pInst = gameObjInstCreate(TYPE_OBJECT::TYPE_OBJECT_BALL, sBallData[i].m_radius,
-										&sBallData[i].m_center, &vel, 0.0f);
-			AE_ASSERT(pInst);
-			pInst->speed = speed;
-			pInst->pUserData = &sBallData[i];
-		}
+	BuildCageWorld(sWorld, level, EXTRA_CREDITS, FIXED_POINT_SIM);
+
+	// create the ball instances (the particles are drawn straight from the world)
+	for (unsigned int i = 0; i < sWorld.m_ballNum; ++i)
+	{
+		pInst = gameObjInstCreate(TYPE_OBJECT::TYPE_OBJECT_BALL, sWorld.m_ballData[i].m_radius,
+									&sWorld.m_ballData[i].m_center, &sWorld.m_ballVel[i], 0.0f);
+		AE_ASSERT(pInst);
+		pInst->speed = sWorld.m_ballSpeed[i];
+		pInst->pUserData = &sWorld.m_ballData[i];
+	}
 
-		// read wall data
-		unsigned int wallNum = 0;
-		CSD1130::Vec2 P0 = CSD1130::Vec2(), P1 = CSD1130::Vec2();
-		CSD1130::Vec2 pos = CSD1130::Vec2(), e = CSD1130::Vec2();
+	// cells about a ball across
+	float maxRadius = 0.0f;
+	for (unsigned int i = 0; i < sWorld.m_ballNum; ++i)
+		if (sWorld.m_ballData[i].m_radius > maxRadius)
+			maxRadius = sWorld.m_ballData[i].m_radius;
 
-		inFile>>wallNum;
-		sWallData = new LineSegment[wallNum];
+	InitBallHash(sBallHash, sWorld.m_ballNum, 2.0f * maxRadius);
+	sBallQuery	= new unsigned int[sWorld.m_ballNum];
+	sBallMark	= new unsigned char[sWorld.m_ballNum];
+	sBallPicked	= -1;
 
-		for(unsigned int i = 0; i < wallNum; ++i)
-		{
-			inFile>>str>> P0.x;
-			inFile>>str>> P0.y;
-			inFile>>str>> P1.x;
-			inFile>>str>> P1.y;
+	// create the wall instances, in the order of the file
+	CSD1130::Vec2 P0 = CSD1130::Vec2(), P1 = CSD1130::Vec2();
+	CSD1130::Vec2 pos = CSD1130::Vec2(), e = CSD1130::Vec2();
+	float scale;
 
-			//stupid work
-			pos.x = (P0.x + P1.x) * 0.5f;
-			pos.y = (P0.y + P1.y) * 0.5f;
-			e.x = P1.x - P0.x;
-			e.y = P1.y - P0.y;
-			scale = sqrtf((e.x * e.x) + (e.y * e.y));
-			//a.b = |a|*|b|*cos(a,b)
-			float cosine = (e.x/* * 1.0f + e.y * 0.0f*/) / (scale);//assuming scale is non-zero (controlling our data input!)
-			float acosine = acos(cosine);
-			if (e.y < 0.0f)
-				acosine = 2*PI - acosine;
+	for (unsigned int i = 0; i < level.m_wallNum; ++i)
+	{
+		P0 = level.m_wallPts[i * 2];
+		P1 = level.m_wallPts[i * 2 + 1];
+
+		//stupid work
+		pos.x = (P0.x + P1.x) * 0.5f;
+		pos.y = (P0.y + P1.y) * 0.5f;
+		e.x = P1.x - P0.x;
+		e.y = P1.y - P0.y;
+		scale = sqrtf((e.x * e.x) + (e.y * e.y));
+		//a.b = |a|*|b|*cos(a,b)
+		float cosine = (e.x/* * 1.0f + e.y * 0.0f*/) / (scale);//assuming scale is non-zero (controlling our data input!)
+		float acosine = acos(cosine);
+		if (e.y < 0.0f)
+			acosine = 2*PI - acosine;
+
+		pInst = gameObjInstCreate(TYPE_OBJECT::TYPE_OBJECT_WALL, scale, &pos, 0, acosine);
+		AE_ASSERT(pInst);
+	}
 
+	// the arcs are drawn as chords (wall instances without collision data)
+	for (unsigned int i = 0; i < level.m_arcNum; ++i)
+	{
+		const CageLevelArc &arc = level.m_arcs[i];
 
+		pos		= arc.m_pos;
+		scale	= arc.m_radius;
 
-			//NOTE to student: When using your own build line segment function, comment out this next line, and uncomment the line after
-			//AEBuildLineSegment(sWallData[i], pos, scale, acosine);
-			BuildLineSegment(sWallData[i], P0, P1);
+		float span = (arc.m_angle1 - arc.m_angle0) * PI_OVER_180;
+		if (span > 2 * PI)
+			span = 2 * PI;
 
+		int parts = (int)ceilf(span / ARC_DRAW_STEP);
+		for (int k = 0; k < parts; ++k)
+		{
+			float a0 = arc.m_angle0 * PI_OVER_180 + span * k / parts;
+			float a1 = arc.m_angle0 * PI_OVER_180 + span * (k + 1) / parts;
 
+			P0 = { pos.x + cosf(a0) * scale, pos.y + sinf(a0) * scale };
+			P1 = { pos.x + cosf(a1) * scale, pos.y + sinf(a1) * scale };
 
-			pInst = gameObjInstCreate(TYPE_OBJECT::TYPE_OBJECT_WALL, scale, &pos, 0, acosine);
+			CSD1130::Vec2 mid{ (P0.x + P1.x) * 0.5f, (P0.y + P1.y) * 0.5f };
+			pInst = gameObjInstCreate(TYPE_OBJECT::TYPE_OBJECT_WALL, CSD1130::Vector2DDistance(P0, P1), &mid, 0,
+										atan2f(P1.y - P0.y, P1.x - P0.x));
 			AE_ASSERT(pInst);
-			pInst->pUserData = &sWallData[i];
 		}
+	}
 
-		
+	const PillarGrid &pillarGrid = sWorld.m_pillarGrid;
 
-		inFile.clear();
-		inFile.close();
+	sPillarTransform = new CSD1130::Mtx33[pillarGrid.m_pillars.m_num];
+	for (unsigned int i = 0; i < pillarGrid.m_pillars.m_num; ++i)
+	{
+		CSD1130::Matrix3x3 scale, trans;
+		float r = pillarGrid.m_pillars.m_radius[i];
+
+		CSD1130::Mtx33Scale(scale, r, r);
+		CSD1130::Mtx33Translate(trans, pillarGrid.m_pillars.m_x[i], pillarGrid.m_pillars.m_y[i]);
+		sPillarTransform[i] = trans * scale;
 	}
-	else
+
+	// the kinematic walls are drawn like the walls, moved to where the walls
+	// are every step
+	unsigned int kinematicNum = sWorld.m_kinematicWalls.m_num;
+
+	sKinematicInst = new GameObjInst*[kinematicNum];
+	for (unsigned int i = 0; i < kinematicNum; ++i)
 	{
-		//AE_ASSERT_MESG(inFile, "Failed to open the text file");
-		printf("Failed to open the text file");
+		sKinematicInst[i] = gameObjInstCreate(TYPE_OBJECT::TYPE_OBJECT_WALL, 0.0f, 0, 0, 0.0f);
+		AE_ASSERT(sKinematicInst[i]);
 	}
+	WriteKinematicWallsToInstances(sWorld.m_kinematicWalls);
+
+	FreeCageLevel(level);
 }
 
 
@@ -286,82 +414,48 @@ void GameStateCageUpdate(void)
 		AEToogleFullScreen(full_screen_me);
 	}
 
-	
-	CSD1130::Vec2		interPtA;
-	CSD1130::Vec2      normalAtCollision;
-	float		interTime = 0.0f;
 
-	//f32 fpsT = (f32)AEFrameRateControllerGetFrameTime();
+	// Update the balls (timed, to compare the float and fixed-point paths),
+	// with the options as they are now
+	sWorld.m_ballCollisions	= BALL_COLLISIONS;
+	sWorld.m_eventDriven	= EVENT_DRIVEN_SIM;
+	sWorld.m_tiledWalls		= TILED_WALLS;
+	sWorld.m_ballSort		= BALL_SORT;
+	sWorld.m_dt				= g_dt;
 
-	//Update object instances positions
-	for(unsigned int i = 0; i < GAME_OBJ_INST_NUM_MAX; ++i)
-	{
-		GameObjInst *pBallInst = sGameObjInstList + i;
+	double simStart = AEGetTime(nullptr);
 
-		// skip non-active object
-		if (0 == (pBallInst->flag & FLAG_ACTIVE) ||
-			pBallInst->pObject->type != TYPE_OBJECT::TYPE_OBJECT_BALL)
-			continue;
+	StepCageWorld(sWorld);
 
-		CSD1130::Vec2 posNext;
-		posNext.x = pBallInst->posCurr.x + pBallInst->velCurr.x * g_dt;
-		posNext.y = pBallInst->posCurr.y + pBallInst->velCurr.y * g_dt;
+	sSimTime = AEGetTime(nullptr) - simStart;
 
-		// Update the latest ball data with the lastest ball's position
-		Circle &ballData = *((Circle*)pBallInst->pUserData);
-		ballData.m_center.x = pBallInst->posCurr.x;
-		ballData.m_center.y = pBallInst->posCurr.y;
+	if (PUBLISH_STATE == 1 && sPublisher.m_header == 0 &&
+		!OpenStatePublisher(sPublisher, STATE_RING_NAME, sWorld.m_ballNum,
+			(sWorld.m_ballNum < STATE_EVENT_MAX) ? sWorld.m_ballNum : STATE_EVENT_MAX, STATE_SLOT_NUM))
+	{
+		printf("Failed to open the shared memory %s", STATE_RING_NAME);
+		PUBLISH_STATE = 0;
+	}
+	else if (PUBLISH_STATE == 0 && sPublisher.m_header != 0)
+		FreeStatePublisher(sPublisher);
 
-		// Check collision with walls
-		for(unsigned int j = 0; j < GAME_OBJ_INST_NUM_MAX; ++j)
-		{
-			GameObjInst *pInst = sGameObjInstList + j;
+	// a ring too small for the balls (another level) is made again at their
+	// number at the next step
+	if (PUBLISH_STATE == 1 && !PublishCageWorld(sPublisher, sWorld))
+		FreeStatePublisher(sPublisher);
 
-			if (0 == (pInst->flag & FLAG_ACTIVE))
-				continue;
+	if (sWorld.m_sorted)
+		RenumberBallInstances();
 
-			switch(pInst->pObject->type)
-			{
-				case TYPE_OBJECT::TYPE_OBJECT_WALL:
-				{
-					LineSegment &lineSegData = *((LineSegment*)pInst->pUserData);
-
-					bool checkLineEdges = false;
-					if (EXTRA_CREDITS == 1)
-						checkLineEdges = true;
-					
-					if ((pBallInst->velCurr.x * lineSegData.m_normal.x + pBallInst->velCurr.y * lineSegData.m_normal.y) < 0.0f)
-					{
-						if (CollisionIntersection_CircleLineSegment(ballData,
-							posNext,
-							lineSegData,
-							interPtA,
-							normalAtCollision,
-							interTime,
-							checkLineEdges))
-						{
-							CSD1130::Vec2 reflectedVec;
-
-							CollisionResponse_CircleLineSegment(interPtA,
-								normalAtCollision,
-								posNext,
-								reflectedVec);
-
-							pBallInst->velCurr.x = reflectedVec.x * pBallInst->speed;
-							pBallInst->velCurr.y = reflectedVec.y * pBallInst->speed;
-						}
-					}
-				}
-				break;
-				
-				
+	WriteBallsToInstances();
 
-			}
-		}
+	if (FIXED_POINT_SIM == 1)
+		WriteKinematicWallsToInstances(sWorld.m_kinematicWallsX);
+	else
+		WriteKinematicWallsToInstances(sWorld.m_kinematicWalls);
+
+	MarkBalls();
 
-		pBallInst->posCurr.x = posNext.x;
-		pBallInst->posCurr.y = posNext.y;
-	}
 
 	
 	//Computing the transformation matrices of the game object instances
@@ -386,8 +480,197 @@ void GameStateCageUpdate(void)
 
 	if(AEInputCheckTriggered(AEVK_R))
 		gGameStateNext = GS_STATE::GS_RESTART;
+
+	if (AEInputCheckTriggered(AEVK_B))
+		BALL_COLLISIONS = 1 - BALL_COLLISIONS;
+
+	if (AEInputCheckTriggered(AEVK_E))
+		EVENT_DRIVEN_SIM = (EVENT_DRIVEN_SIM + 1) % 3;
+
+	if (AEInputCheckTriggered(AEVK_T))
+		TILED_WALLS = 1 - TILED_WALLS;
+
+	if (AEInputCheckTriggered(AEVK_Z))
+		BALL_SORT = 1 - BALL_SORT;
+
+	if (AEInputCheckTriggered(AEVK_P))
+		PUBLISH_STATE = 1 - PUBLISH_STATE;
+
+	// straight to a later time: only the impacts on the way cost anything
+	if (AEInputCheckTriggered(AEVK_J))
+	{
+		SkipCageWorldTime(sWorld, EVENT_JUMP);
+		WriteBallsToInstances();
+	}
+
+	// switching between float/fixed-point needs the level to be reloaded
+	if (AEInputCheckTriggered(AEVK_M))
+	{
+		FIXED_POINT_SIM = 1 - FIXED_POINT_SIM;
+		gGameStateNext = GS_STATE::GS_RESTART;
+	}
 }
 
+/******************************************************************************/
+/*!
+	Moves the instances of the kinematic walls to where the walls are at
+	the end of the step
+*/
+/******************************************************************************/
+template <typename T>
+static void WriteKinematicWallsToInstances(const KinematicWallSetT<T> &set)
+{
+	for (unsigned int i = 0; i < set.m_num; ++i)
+	{
+		const KinematicWallT<T> &wall = set.m_walls[i];
+		CSD1130::Vector2DT<T> P0 = wall.m_line.m_pt0 + wall.m_move0;
+		CSD1130::Vector2DT<T> P1 = wall.m_line.m_pt1 + wall.m_move1;
+
+		CSD1130::Vec2 pt0{ (float)P0.x, (float)P0.y };
+		CSD1130::Vec2 pt1{ (float)P1.x, (float)P1.y };
+
+		GameObjInst *pInst = sKinematicInst[i];
+		pInst->posCurr	= { (pt0.x + pt1.x) * 0.5f, (pt0.y + pt1.y) * 0.5f };
+		pInst->scale	= CSD1130::Vector2DDistance(pt0, pt1);
+		pInst->dirCurr	= atan2f(pt1.y - pt0.y, pt1.x - pt0.x);
+	}
+}
+
+/******************************************************************************/
+/*!
+	Draws the walls of the tiles of the pack in memory (a wall across tiles
+	once per tile), STREAM_DRAW_MAX at most
+*/
+/******************************************************************************/
+template <typename T>
+static void DrawStreamedWalls(const WallStreamT<T> &stream)
+{
+	unsigned int drawn = 0;
+
+	AEGfxSetTintColor(1.0f, 1.0f, 1.0f, 1.0f);
+	for (unsigned int k = 0; k < stream.m_residentNum; ++k)
+	{
+		const WallTileT<T> *pTile = stream.m_tiles[stream.m_resident[k]];
+
+		for (unsigned int w = 0; w < pTile->m_num && drawn < STREAM_DRAW_MAX; ++w, ++drawn)
+		{
+			CSD1130::Vec2 pt0{ (float)pTile->m_walls[w].m_pt0.x, (float)pTile->m_walls[w].m_pt0.y };
+			CSD1130::Vec2 pt1{ (float)pTile->m_walls[w].m_pt1.x, (float)pTile->m_walls[w].m_pt1.y };
+
+			CSD1130::Matrix3x3 scale, rot, trans, transform;
+			float length = CSD1130::Vector2DDistance(pt0, pt1);
+
+			CSD1130::Mtx33Scale(scale, length, length);
+			CSD1130::Mtx33RotRad(rot, atan2f(pt1.y - pt0.y, pt1.x - pt0.x));
+			CSD1130::Mtx33Translate(trans, (pt0.x + pt1.x) * 0.5f, (pt0.y + pt1.y) * 0.5f);
+			transform = trans * (scale * rot);
+
+			AEGfxSetTransform(transform.m2);
+			AEGfxMeshDraw(sGameObjList[(int)TYPE_OBJECT::TYPE_OBJECT_WALL].pMesh, AE_GFX_MDM_LINES_STRIP);
+		}
+	}
+}
+
+/******************************************************************************/
+/*!
+	Copies the ball state to the instances for drawing
+*/
+/******************************************************************************/
+static void WriteBallsToInstances(void)
+{
+	for (unsigned int i = 0; i < GAME_OBJ_INST_NUM_MAX; ++i)
+	{
+		GameObjInst *pBallInst = sGameObjInstList + i;
+
+		if (0 == (pBallInst->flag & FLAG_ACTIVE) ||
+			pBallInst->pObject->type != TYPE_OBJECT::TYPE_OBJECT_BALL)
+			continue;
+
+		unsigned int ballIdx = (unsigned int)((Circle*)pBallInst->pUserData - sWorld.m_ballData);
+
+		pBallInst->posCurr	= sWorld.m_ballData[ballIdx].m_center;
+		pBallInst->velCurr	= sWorld.m_ballVel[ballIdx];
+		pBallInst->speed	= sWorld.m_ballSpeed[ballIdx];
+	}
+}
+
+
+/******************************************************************************/
+/*!
+	Points the ball instances, and the picked ball, at where the balls went
+	in the sort of this step
+*/
+/******************************************************************************/
+static void RenumberBallInstances(void)
+{
+	for (unsigned int i = 0; i < GAME_OBJ_INST_NUM_MAX; ++i)
+	{
+		GameObjInst *pBallInst = sGameObjInstList + i;
+
+		if (0 == (pBallInst->flag & FLAG_ACTIVE) ||
+			pBallInst->pObject->type != TYPE_OBJECT::TYPE_OBJECT_BALL)
+			continue;
+
+		unsigned int ballIdx = (unsigned int)((Circle*)pBallInst->pUserData - sWorld.m_ballData);
+
+		pBallInst->pUserData = sWorld.m_ballData + sWorld.m_ballNewIndex[ballIdx];
+	}
+
+	if (sBallPicked >= 0)
+		sBallPicked = (int)sWorld.m_ballNewIndex[sBallPicked];
+}
+
+
+/******************************************************************************/
+/*!
+	Rebuilds the ball hash and marks the balls in view, and the ball picked
+	with a left click along with the balls around it
+*/
+/******************************************************************************/
+static void MarkBalls(void)
+{
+	BuildBallHash(sBallHash, sWorld.m_ballData);
+
+	for (unsigned int i = 0; i < sWorld.m_ballNum; ++i)
+		sBallMark[i] = 0;
+
+	// the view is the window, centered on the camera
+	float camX, camY;
+	AEGfxGetCamPosition(&camX, &camY);
+
+	float halfW = 0.5f * (float)AEGetWindowWidth();
+	float halfH = 0.5f * (float)AEGetWindowHeight();
+
+	unsigned int num = QueryBallHashRegion(sBallHash, { camX - halfW, camY - halfH }, { camX + halfW, camY + halfH },
+		sBallQuery, sWorld.m_ballNum);
+	for (unsigned int k = 0; k < num; ++k)
+		sBallMark[sBallQuery[k]] = 1;
+
+	// the ball under the cursor, if any
+	if (AEInputCheckTriggered(AEVK_LBUTTON))
+	{
+		s32 cursorX, cursorY;
+		AEInputGetCursorPosition(&cursorX, &cursorY);
+
+		CSD1130::Vec2	cursor{ camX - halfW + (float)cursorX, camY + halfH - (float)cursorY };
+		unsigned int	nearest;
+		float			distSq;
+
+		sBallPicked = -1;
+		if (QueryBallHashNearest(sBallHash, cursor, 1, &nearest, &distSq) &&
+			distSq <= sWorld.m_ballData[nearest].m_radius * sWorld.m_ballData[nearest].m_radius)
+			sBallPicked = (int)nearest;
+	}
+
+	if (sBallPicked >= 0)
+	{
+		num = QueryBallHashRadius(sBallHash, sWorld.m_ballData[sBallPicked].m_center, PICK_NEIGHBOUR_RADIUS, sBallQuery, sWorld.m_ballNum);
+		for (unsigned int k = 0; k < num; ++k)
+			sBallMark[sBallQuery[k]] = 2;
+	}
+}
+
+
 /******************************************************************************/
 /*!
 
@@ -416,6 +699,12 @@ void GameStateCageDraw(void)
 
 		if (pInst->pObject->type == TYPE_OBJECT::TYPE_OBJECT_BALL)
 		{
+			unsigned int ballIdx = (unsigned int)((Circle*)pInst->pUserData - sWorld.m_ballData);
+
+			// outside the view
+			if (sBallMark[ballIdx] == 0)
+				continue;
+
 			int ttiimmee = (int)timeGetTime();
 			ttiimmee %= 5;
 
@@ -428,6 +717,9 @@ void GameStateCageDraw(void)
 			{
 				AEGfxSetTintColor(1.0f, 0.2f, 0.2f, 1.0f);
 			}
+
+			if (sBallMark[ballIdx] == 2)
+				AEGfxSetTintColor(0.2f, 0.6f, 1.0f, 1.0f);
 			AEGfxMeshDraw(pInst->pObject->pMesh, AE_GFX_MDM_TRIANGLES);
 		}
 		else if (pInst->pObject->type == TYPE_OBJECT::TYPE_OBJECT_WALL)
@@ -437,6 +729,34 @@ void GameStateCageDraw(void)
 		}
 	}
 	
+	//Drawing the particles
+	AEGfxSetTintColor(0.6f, 0.9f, 1.0f, 1.0f);
+	for (unsigned int i = 0; i < sWorld.m_particles.m_num && i < PARTICLE_DRAW_MAX; ++i)
+	{
+		CSD1130::Matrix3x3 scale, trans, transform;
+
+		CSD1130::Mtx33Scale(scale, PARTICLE_DRAW_SIZE, PARTICLE_DRAW_SIZE);
+		CSD1130::Mtx33Translate(trans, sWorld.m_particles.m_x[i], sWorld.m_particles.m_y[i]);
+		transform = trans * scale;
+
+		AEGfxSetTransform(transform.m2);
+		AEGfxMeshDraw(sGameObjList[(int)TYPE_OBJECT::TYPE_OBJECT_BALL].pMesh, AE_GFX_MDM_TRIANGLES);
+	}
+
+	//Drawing the walls of the pack read in
+	if (FIXED_POINT_SIM == 1)
+		DrawStreamedWalls(sWorld.m_wallStreamX);
+	else
+		DrawStreamedWalls(sWorld.m_wallStream);
+
+	//Drawing the pillars
+	AEGfxSetTintColor(1.0f, 1.0f, 1.0f, 1.0f);
+	for (unsigned int i = 0; i < sWorld.m_pillarGrid.m_pillars.m_num; ++i)
+	{
+		AEGfxSetTransform(sPillarTransform[i].m2);
+		AEGfxMeshDraw(sGameObjList[(int)TYPE_OBJECT::TYPE_OBJECT_PILLAR].pMesh, AE_GFX_MDM_TRIANGLES);
+	}
+
 	char strBuffer[100];
 	memset(strBuffer, 0, 100*sizeof(char));
 	sprintf_s(strBuffer, "FPS:  %.6f", 1.0f / AEFrameRateControllerGetFrameTime());
@@ -449,8 +769,38 @@ void GameStateCageDraw(void)
 	
 	//AEGfxPrint(fontId, strBuffer, -0.95f, -0.95f, 2.0f, 1.f, 0.f, 1.f);
 	AEGfxPrint(fontId, strBuffer, (270.0f) / (float)(AEGetWindowWidth() / 2), (350.0f) / (float)(AEGetWindowHeight() / 2), 1.0f, 1.f, 0.f, 0.f);
+
+	// Simulation step cost, and the state hash in fixed-point mode
+	memset(strBuffer, 0, 100*sizeof(char));
+	unsigned int cacheRate = sWorld.m_cacheLookupNum ? sWorld.m_cacheHitNum * 100 / sWorld.m_cacheLookupNum : 0;
+	if (FIXED_POINT_SIM == 1)
+		sprintf_s(strBuffer, "Fixed: %.3f ms %016llX near %u/%u cache %u%%", sSimTime * 1000.0, sWorld.m_simChecksum, sWorld.m_ballNearNum,
+			sWorld.m_ballNum, cacheRate);
+	else if (sWorld.m_eventsOn)
+		sprintf_s(strBuffer, "Float: %.3f ms events %u/%u orbits %u", sSimTime * 1000.0, sWorld.m_eventNum, sWorld.m_ballNum, sWorld.m_orbitNum);
+	else
+		sprintf_s(strBuffer, "Float: %.3f ms near %u/%u cache %u%%", sSimTime * 1000.0, sWorld.m_ballNearNum, sWorld.m_ballNum, cacheRate);
+
+	AEGfxPrint(fontId, strBuffer, (270.0f) / (float)(AEGetWindowWidth() / 2), (320.0f) / (float)(AEGetWindowHeight() / 2), 1.0f, 1.f, 0.f, 0.f);
+
+	// Tiles of the wall pack in memory, and how they got there
+	const WallStream &stream = sWorld.m_wallStream;
+	const WallStreamx &streamX = sWorld.m_wallStreamX;
+	if (stream.m_tileNum != 0 || streamX.m_tileNum != 0)
+	{
+		bool fixed = (streamX.m_tileNum != 0);
+
+		memset(strBuffer, 0, 100*sizeof(char));
+		sprintf_s(strBuffer, "Tiles: %u/%u %u KB read %u late %u dropped %u",
+			fixed ? streamX.m_residentNum : stream.m_residentNum, fixed ? streamX.m_tileNum : stream.m_tileNum,
+			(unsigned int)((fixed ? streamX.m_bytes : stream.m_bytes) / 1024), fixed ? streamX.m_loadNum : stream.m_loadNum,
+			fixed ? streamX.m_missNum : stream.m_missNum, fixed ? streamX.m_dropNum : stream.m_dropNum);
+
+		AEGfxPrint(fontId, strBuffer, (270.0f) / (float)(AEGetWindowWidth() / 2), (290.0f) / (float)(AEGetWindowHeight() / 2), 1.0f, 1.f, 0.f, 0.f);
+	}
 }
 
+
 /******************************************************************************/
 /*!
 
@@ -462,14 +812,27 @@ void GameStateCageFree(void)
 	for (unsigned int i = 0; i < GAME_OBJ_INST_NUM_MAX; i++)
 		gameObjInstDestroy(sGameObjInstList + i);
 
-	delete []sBallData;
-	sBallData = NULL;
-	
-	delete []sWallData;
-	sWallData = NULL;
+	FreeCageWorld(sWorld);
+	FreeStatePublisher(sPublisher);
 
+	FreeBallHash(sBallHash);
+
+	delete []sBallQuery;
+	sBallQuery = NULL;
+
+	delete []sBallMark;
+	sBallMark = NULL;
+
+	delete []sKinematicInst;
+	sKinematicInst = NULL;
+
+	delete []sPillarTransform;
+	sPillarTransform = NULL;
+
+	sBallPicked = -1;
 }
 
+
 /******************************************************************************/
 /*!
 
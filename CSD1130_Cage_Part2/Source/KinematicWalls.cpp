@@ -0,0 +1,539 @@
+/******************************************************************************/
+/*!
+\file		KinematicWalls.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 21, 2023
+\brief
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+namespace
+{
+	// Walls in a leaf of the tree
+	const unsigned int	KINEMATIC_LEAF_MAX		= 2;
+
+	// Deepest a query goes (the tree is balanced, so it holds 2^32 walls)
+	const int			KINEMATIC_STACK_MAX		= 64;
+
+	// Steps of the conservative advancement. Past that the circle is taken
+	// as missing the wall (it only gets there grazing it): if it still ends
+	// the step in the wall, it is pushed out then
+	const int			KINEMATIC_ADVANCE_MAX	= 32;
+
+	// Gap under which the circle touches the wall
+	const double		KINEMATIC_CONTACT		= 0.01;
+
+	const double		KINEMATIC_PI			= 3.14159265358979323846;
+
+	/**************************************************************************/
+	/*!
+		Ends of the wall at the given phase and angle
+	 */
+	/**************************************************************************/
+	template <typename T>
+	void KinematicWallEnds(const KinematicWallT<T> &wall,
+							T phase,
+							T angle,
+							CSD1130::Vector2DT<T> &pt0,
+							CSD1130::Vector2DT<T> &pt1)
+	{
+		// back and forth: out for m_period, then back for as long
+		T along = (wall.m_period > T(0) && phase > wall.m_period) ? wall.m_period * T(2) - phase : phase;
+		CSD1130::Vector2DT<T> pivot = wall.m_pivot + wall.m_vel * along;
+
+		T s, c;
+		CSD1130::FastSinCos(angle, s, c);
+
+		pt0 = pivot + CSD1130::Vector2DT<T>{ c * wall.m_arm0.x - s * wall.m_arm0.y, s * wall.m_arm0.x + c * wall.m_arm0.y };
+		pt1 = pivot + CSD1130::Vector2DT<T>{ c * wall.m_arm1.x - s * wall.m_arm1.y, s * wall.m_arm1.x + c * wall.m_arm1.y };
+	}
+
+	/**************************************************************************/
+	/*!
+		Builds the subtree over set.m_order[first, first + num), splitting
+		at the median of the wall centers along the longest side of their
+		box. Returns the index of its root
+	 */
+	/**************************************************************************/
+	template <typename T>
+	unsigned int BuildKinematicNode(KinematicWallSetT<T> &set,
+									unsigned int first,
+									unsigned int num)
+	{
+		unsigned int node = set.m_nodeNum++;
+
+		set.m_nodes[node].m_first	= first;
+		set.m_nodes[node].m_num		= num;
+
+		if (num <= KINEMATIC_LEAF_MAX)
+			return node;
+
+		CSD1130::Vector2DT<T> centerMin, centerMax;
+		for (unsigned int k = first; k < first + num; ++k)
+		{
+			const LineSegmentT<T> &line = set.m_walls[set.m_order[k]].m_line;
+			CSD1130::Vector2DT<T> center = (line.m_pt0 + line.m_pt1) * T(0.5);
+
+			if (k == first || center.x < centerMin.x)	centerMin.x = center.x;
+			if (k == first || center.y < centerMin.y)	centerMin.y = center.y;
+			if (k == first || center.x > centerMax.x)	centerMax.x = center.x;
+			if (k == first || center.y > centerMax.y)	centerMax.y = center.y;
+		}
+
+		bool alongX = (centerMax.x - centerMin.x) >= (centerMax.y - centerMin.y);
+
+		// insertion sort by center (the sets are small)
+		for (unsigned int k = first + 1; k < first + num; ++k)
+		{
+			unsigned int item = set.m_order[k];
+			const LineSegmentT<T> &line = set.m_walls[item].m_line;
+			T key = alongX ? line.m_pt0.x + line.m_pt1.x : line.m_pt0.y + line.m_pt1.y;
+
+			unsigned int j = k;
+			for (; j > first; --j)
+			{
+				const LineSegmentT<T> &prev = set.m_walls[set.m_order[j - 1]].m_line;
+				T prevKey = alongX ? prev.m_pt0.x + prev.m_pt1.x : prev.m_pt0.y + prev.m_pt1.y;
+
+				if (!(key < prevKey))
+					break;
+
+				set.m_order[j] = set.m_order[j - 1];
+			}
+			set.m_order[j] = item;
+		}
+
+		unsigned int half = num / 2;
+
+		BuildKinematicNode(set, first, half);
+		set.m_nodes[node].m_first	= BuildKinematicNode(set, first + half, num - half);
+		set.m_nodes[node].m_num		= 0;
+
+		return node;
+	}
+
+	/**************************************************************************/
+	/*!
+		Fits the boxes of the tree to what the walls sweep over the step,
+		children first
+	 */
+	/**************************************************************************/
+	template <typename T>
+	void RefitKinematicNodes(KinematicWallSetT<T> &set)
+	{
+		for (unsigned int n = set.m_nodeNum; n-- > 0; )
+		{
+			KinematicNodeT<T> &node = set.m_nodes[n];
+
+			if (node.m_num == 0)
+			{
+				const KinematicNodeT<T> &a = set.m_nodes[n + 1];
+				const KinematicNodeT<T> &b = set.m_nodes[node.m_first];
+
+				node.m_boxMin.x = (a.m_boxMin.x < b.m_boxMin.x) ? a.m_boxMin.x : b.m_boxMin.x;
+				node.m_boxMin.y = (a.m_boxMin.y < b.m_boxMin.y) ? a.m_boxMin.y : b.m_boxMin.y;
+				node.m_boxMax.x = (a.m_boxMax.x > b.m_boxMax.x) ? a.m_boxMax.x : b.m_boxMax.x;
+				node.m_boxMax.y = (a.m_boxMax.y > b.m_boxMax.y) ? a.m_boxMax.y : b.m_boxMax.y;
+				continue;
+			}
+
+			for (unsigned int k = node.m_first; k < node.m_first + node.m_num; ++k)
+			{
+				const KinematicWallT<T> &wall = set.m_walls[set.m_order[k]];
+				const CSD1130::Vector2DT<T> ends[4] = { wall.m_line.m_pt0, wall.m_line.m_pt1,
+														wall.m_line.m_pt0 + wall.m_move0, wall.m_line.m_pt1 + wall.m_move1 };
+
+				for (int e = 0; e < 4; ++e)
+				{
+					bool firstEnd = (k == node.m_first && e == 0);
+
+					if (firstEnd || ends[e].x < node.m_boxMin.x)	node.m_boxMin.x = ends[e].x;
+					if (firstEnd || ends[e].y < node.m_boxMin.y)	node.m_boxMin.y = ends[e].y;
+					if (firstEnd || ends[e].x > node.m_boxMax.x)	node.m_boxMax.x = ends[e].x;
+					if (firstEnd || ends[e].y > node.m_boxMax.y)	node.m_boxMax.y = ends[e].y;
+				}
+			}
+		}
+	}
+
+	/**************************************************************************/
+	/*!
+		Turns around the part of the velocity going into the wall, as seen
+		from the wall, then gives the velocity the speed it had. If that
+		leaves it slower along the normal than the wall point pushes, it
+		gets the normal velocity of the wall point (only: a paddle sliding
+		or turning along the ball doesn't speed it up). Returns the speed
+	 */
+	/**************************************************************************/
+	template <typename T>
+	T BounceOffKinematicWall(const CSD1130::Vector2DT<T> &normal,
+							const CSD1130::Vector2DT<T> &wallMove,
+							T dt,
+							CSD1130::Vector2DT<T> &velCurr)
+	{
+		CSD1130::Vector2DT<T> wallVel = wallMove / dt;
+
+		T speedIn	= CSD1130::Vector2DLength(velCurr);
+		T into		= CSD1130::Vector2DDotProduct(velCurr - wallVel, normal);
+
+		if (into < T(0))
+			velCurr -= normal * (into * T(2));
+
+		T speedOut = CSD1130::Vector2DLength(velCurr);
+		if (speedOut > T(0))
+			velCurr = velCurr * (speedIn / speedOut);
+
+		T push = CSD1130::Vector2DDotProduct(wallVel, normal) - CSD1130::Vector2DDotProduct(velCurr, normal);
+		if (push > T(0))
+			velCurr += normal * push;
+
+		return CSD1130::Vector2DLength(velCurr);
+	}
+
+	/**************************************************************************/
+	/*!
+		Where along E (from P0) the closest point to C is, in [0, 1]. A
+		wall of zero length is all at P0
+	 */
+	/**************************************************************************/
+	template <typename T>
+	T ClosestOnKinematicWall(const CSD1130::Vector2DT<T> &C,
+							const CSD1130::Vector2DT<T> &P0,
+							const CSD1130::Vector2DT<T> &E)
+	{
+		T lengthSq = CSD1130::Vector2DSquareLength(E);
+		if (!(lengthSq > T(0)))
+			return T(0);
+
+		T s = CSD1130::Vector2DDotProduct(C - P0, E) / lengthSq;
+		if (!(s > T(0)))
+			return T(0);
+		return (s > T(1)) ? T(1) : s;
+	}
+}
+
+/******************************************************************************/
+/*!
+* \brief Builds the kinematic walls and their tree
+* \param set:		output - walls
+* \param pWalls:	input - walls at rest
+* \param wallNum:	input - number of walls
+ */
+/******************************************************************************/
+template <typename T>
+void BuildKinematicWallSet(KinematicWallSetT<T> &set,
+							const KinematicWallT<T> *pWalls,
+							unsigned int wallNum)
+{
+	set.m_walls		= new KinematicWallT<T>[wallNum];
+	set.m_num		= wallNum;
+	set.m_nodes		= new KinematicNodeT<T>[wallNum * 2];
+	set.m_nodeNum	= 0;
+	set.m_order		= new unsigned int[wallNum];
+
+	for (unsigned int w = 0; w < wallNum; ++w)
+	{
+		KinematicWallT<T> &wall = set.m_walls[w];
+		CSD1130::Vector2DT<T> pt0, pt1;
+
+		wall			= pWalls[w];
+		wall.m_phase	= T(0);
+		wall.m_angle	= T(0);
+		wall.m_move0	= CSD1130::Vector2DT<T>{ T(0), T(0) };
+		wall.m_move1	= CSD1130::Vector2DT<T>{ T(0), T(0) };
+
+		KinematicWallEnds(wall, wall.m_phase, wall.m_angle, pt0, pt1);
+		BuildLineSegment(wall.m_line, pt0, pt1);
+
+		set.m_order[w] = w;
+	}
+
+	if (wallNum == 0)
+		return;
+
+	BuildKinematicNode(set, 0, wallNum);
+	RefitKinematicNodes(set);
+}
+
+/******************************************************************************/
+/*!
+* \brief Releases the kinematic walls
+* \param set:	input/output - walls, empty afterwards
+ */
+/******************************************************************************/
+template <typename T>
+void FreeKinematicWallSet(KinematicWallSetT<T> &set)
+{
+	delete []set.m_walls;
+	delete []set.m_nodes;
+	delete []set.m_order;
+
+	set = KinematicWallSetT<T>{};
+}
+
+/******************************************************************************/
+/*!
+* \brief Starts a step of the kinematic walls
+* \param set:	input/output - walls
+* \param dt:	input - time step
+ */
+/******************************************************************************/
+template <typename T>
+void StepKinematicWalls(KinematicWallSetT<T> &set,
+						T dt)
+{
+	const T PI_T		= T(KINEMATIC_PI);
+	const T TWO_PI_T	= T(KINEMATIC_PI * 2.0);
+
+	for (unsigned int w = 0; w < set.m_num; ++w)
+	{
+		KinematicWallT<T> &wall = set.m_walls[w];
+		CSD1130::Vector2DT<T> pt0, pt1, end0, end1;
+
+		// from the time the last step ended, worked out again rather than
+		// moved along (the error would add up)
+		KinematicWallEnds(wall, wall.m_phase, wall.m_angle, pt0, pt1);
+
+		wall.m_phase += dt;
+		if (wall.m_period > T(0))
+		{
+			while (wall.m_phase >= wall.m_period * T(2))
+				wall.m_phase -= wall.m_period * T(2);
+		}
+
+		wall.m_angle += wall.m_spin * dt;
+		if (wall.m_angle > PI_T)
+			wall.m_angle -= TWO_PI_T;
+		else if (wall.m_angle < -PI_T)
+			wall.m_angle += TWO_PI_T;
+
+		KinematicWallEnds(wall, wall.m_phase, wall.m_angle, end0, end1);
+
+		BuildLineSegment(wall.m_line, pt0, pt1);
+		wall.m_move0 = end0 - pt0;
+		wall.m_move1 = end1 - pt1;
+	}
+
+	if (set.m_nodeNum)
+		RefitKinematicNodes(set);
+}
+
+/******************************************************************************/
+/*!
+* \brief Kinematic walls that can be in a box over the step
+* \param set:		input - walls
+* \param boxMin:	input - bottom left of the box
+* \param boxMax:	input - top right of the box
+* \param pOut:		output - walls
+* \return unsigned int: number of walls
+ */
+/******************************************************************************/
+template <typename T>
+unsigned int QueryKinematicWalls(const KinematicWallSetT<T> &set,
+								const CSD1130::Vector2DT<T> &boxMin,
+								const CSD1130::Vector2DT<T> &boxMax,
+								unsigned int *pOut)
+{
+	if (set.m_nodeNum == 0)
+		return 0;
+
+	unsigned int stack[KINEMATIC_STACK_MAX];
+	int top		= 0;
+	unsigned int num = 0;
+
+	stack[top++] = 0;
+	while (top > 0)
+	{
+		const KinematicNodeT<T> &node = set.m_nodes[stack[--top]];
+
+		if (node.m_boxMax.x < boxMin.x || boxMax.x < node.m_boxMin.x ||
+			node.m_boxMax.y < boxMin.y || boxMax.y < node.m_boxMin.y)
+			continue;
+
+		if (node.m_num)
+		{
+			for (unsigned int k = node.m_first; k < node.m_first + node.m_num; ++k)
+				pOut[num++] = set.m_order[k];
+			continue;
+		}
+
+		unsigned int n = (unsigned int)(&node - set.m_nodes);
+
+		stack[top++] = node.m_first;
+		stack[top++] = n + 1;
+	}
+
+	return num;
+}
+
+/******************************************************************************/
+/*!
+* \brief Circle against a kinematic wall, by conservative advancement
+* \param circle:			input - circle, at timeFrom
+* \param ptEnd:				input - circle position at the end of the step
+* \param timeFrom:			input - step time of the circle data
+* \param wall:				input - wall
+* \param interPt:			output - circle position at the hit
+* \param normalAtCollision:	output - from the wall to the circle
+* \param wallMove:			output - move of the wall point touched, over the step
+* \param interTime:			output - step time of the hit
+* \return int: 1 on a hit
+ */
+/******************************************************************************/
+template <typename T>
+int CollisionIntersection_CircleKinematicWall(const CircleT<T> &circle,
+											const CSD1130::Vector2DT<T> &ptEnd,
+											T timeFrom,
+											const KinematicWallT<T> &wall,
+											CSD1130::Vector2DT<T> &interPt,
+											CSD1130::Vector2DT<T> &normalAtCollision,
+											CSD1130::Vector2DT<T> &wallMove,
+											T &interTime)
+{
+	T rest = T(1) - timeFrom;
+	if (!(rest > T(0)))
+		return 0;
+
+	// everything over what is left of the step, u going from 0 to 1
+	CSD1130::Vector2DT<T> D		= ptEnd - circle.m_center;
+	CSD1130::Vector2DT<T> M0	= wall.m_move0 * rest;
+	CSD1130::Vector2DT<T> M1	= wall.m_move1 * rest;
+	CSD1130::Vector2DT<T> A0	= wall.m_line.m_pt0 + wall.m_move0 * timeFrom;
+	CSD1130::Vector2DT<T> A1	= wall.m_line.m_pt1 + wall.m_move1 * timeFrom;
+
+	// no point of the wall moves farther than its ends, so the gap never
+	// closes faster than this
+	T move0		= CSD1130::Vector2DLength(M0);
+	T move1		= CSD1130::Vector2DLength(M1);
+	T bound		= CSD1130::Vector2DLength(D) + ((move0 > move1) ? move0 : move1);
+	T contact	= T(KINEMATIC_CONTACT);
+	T u			= T(0);
+
+	for (int k = 0; ; ++k)
+	{
+		CSD1130::Vector2DT<T> C		= circle.m_center + D * u;
+		CSD1130::Vector2DT<T> P0	= A0 + M0 * u;
+		CSD1130::Vector2DT<T> E		= A1 + M1 * u - P0;
+
+		T s							= ClosestOnKinematicWall(C, P0, E);
+		CSD1130::Vector2DT<T> away	= C - (P0 + E * s);
+		T dist						= CSD1130::Vector2DLength(away);
+		T gap						= dist - circle.m_radius;
+
+		if (gap <= contact)
+		{
+			if (!(dist > T(0)))
+				return 0;
+
+			CSD1130::Vector2DT<T> n = away / dist;
+			CSD1130::Vector2DT<T> w = wall.m_move0 * (T(1) - s) + wall.m_move1 * s;
+
+			// moving apart already
+			if (!(CSD1130::Vector2DDotProduct(D - w * rest, n) < T(0)))
+				return 0;
+
+			interPt				= C;
+			normalAtCollision	= n;
+			wallMove			= w;
+			interTime			= timeFrom + rest * u;
+			return 1;
+		}
+
+		if (!(bound > T(0)) || k == KINEMATIC_ADVANCE_MAX)
+			return 0;
+
+		u += gap / bound;
+		if (u > T(1))
+			return 0;
+	}
+}
+
+/******************************************************************************/
+/*!
+* \brief Bounce off a kinematic wall
+* \param ptInter:	input - circle position at the hit
+* \param normal:	input - from the wall to the circle
+* \param wallMove:	input - move of the wall point touched, over the step
+* \param interTime:	input - step time of the hit
+* \param dt:		input - time step
+* \param velCurr:	input/output - circle velocity
+* \param ptEnd:		output - circle position at the end of the step
+* \return T: new speed
+ */
+/******************************************************************************/
+template <typename T>
+T CollisionResponse_CircleKinematicWall(const CSD1130::Vector2DT<T> &ptInter,
+										const CSD1130::Vector2DT<T> &normal,
+										const CSD1130::Vector2DT<T> &wallMove,
+										T interTime,
+										T dt,
+										CSD1130::Vector2DT<T> &velCurr,
+										CSD1130::Vector2DT<T> &ptEnd)
+{
+	T speed = BounceOffKinematicWall(normal, wallMove, dt, velCurr);
+
+	ptEnd = ptInter + velCurr * (dt * (T(1) - interTime));
+	return speed;
+}
+
+/******************************************************************************/
+/*!
+* \brief Pushes a circle out of where a kinematic wall ends the step
+* \param radius:	input - circle radius
+* \param wall:		input - wall
+* \param dt:		input - time step
+* \param velCurr:	input/output - circle velocity
+* \param ptEnd:		input/output - circle position at the end of the step
+* \return int: 1 if the circle was pushed
+ */
+/******************************************************************************/
+template <typename T>
+int CollisionResolve_CircleKinematicWall(T radius,
+										const KinematicWallT<T> &wall,
+										T dt,
+										CSD1130::Vector2DT<T> &velCurr,
+										CSD1130::Vector2DT<T> &ptEnd)
+{
+	CSD1130::Vector2DT<T> P0	= wall.m_line.m_pt0 + wall.m_move0;
+	CSD1130::Vector2DT<T> E		= wall.m_line.m_pt1 + wall.m_move1 - P0;
+
+	T s								= ClosestOnKinematicWall(ptEnd, P0, E);
+	CSD1130::Vector2DT<T> onWall	= P0 + E * s;
+	CSD1130::Vector2DT<T> away		= ptEnd - onWall;
+	T dist							= CSD1130::Vector2DLength(away);
+
+	if (!(dist > T(0)) || !(dist < radius))
+		return 0;
+
+	CSD1130::Vector2DT<T> n = away / dist;
+
+	ptEnd = onWall + n * radius;
+	BounceOffKinematicWall(n, wall.m_move0 * (T(1) - s) + wall.m_move1 * s, dt, velCurr);
+	return 1;
+}
+
+#define CSD1130_INSTANTIATE_KINEMATIC_WALLS(T)																		\
+	template void BuildKinematicWallSet<T>(KinematicWallSetT<T>&, const KinematicWallT<T>*, unsigned int);				\
+	template void FreeKinematicWallSet<T>(KinematicWallSetT<T>&);														\
+	template void StepKinematicWalls<T>(KinematicWallSetT<T>&, T);														\
+	template unsigned int QueryKinematicWalls<T>(const KinematicWallSetT<T>&, const CSD1130::Vector2DT<T>&,			\
+		const CSD1130::Vector2DT<T>&, unsigned int*);																	\
+	template int CollisionIntersection_CircleKinematicWall<T>(const CircleT<T>&, const CSD1130::Vector2DT<T>&, T,		\
+		const KinematicWallT<T>&, CSD1130::Vector2DT<T>&, CSD1130::Vector2DT<T>&, CSD1130::Vector2DT<T>&, T&);			\
+	template T CollisionResponse_CircleKinematicWall<T>(const CSD1130::Vector2DT<T>&, const CSD1130::Vector2DT<T>&,	\
+		const CSD1130::Vector2DT<T>&, T, T, CSD1130::Vector2DT<T>&, CSD1130::Vector2DT<T>&);										\
+	template int CollisionResolve_CircleKinematicWall<T>(T, const KinematicWallT<T>&, T, CSD1130::Vector2DT<T>&,				\
+		CSD1130::Vector2DT<T>&);
+
+CSD1130_INSTANTIATE_KINEMATIC_WALLS(float)
+CSD1130_INSTANTIATE_KINEMATIC_WALLS(double)
+CSD1130_INSTANTIATE_KINEMATIC_WALLS(CSD1130::Fixed)
+
+#undef CSD1130_INSTANTIATE_KINEMATIC_WALLS
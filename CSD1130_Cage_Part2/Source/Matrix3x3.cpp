@@ -13,26 +13,29 @@ prior written consent of DigiPen Institute of Technology is prohibited.
  /******************************************************************************/
 
 #include "Matrix3x3.h"
+#include "FastMath.h"
 #include <math.h>
 constexpr float PI = 3.14159265358f;
 
 namespace CSD1130
 {
 	// constructors
-	Matrix3x3::Matrix3x3(const float* pArr)
+	template <typename T>
+	Matrix3x3T<T>::Matrix3x3T(const T* pArr)
 	{
 		// initialize
-		*this = Matrix3x3();
+		*this = Matrix3x3T();
 
 		// set copy parameter to this
 		for (size_t i = 0; i < 9; i++)
 		{
-			float* curr = this->m + i;
+			T* curr = this->m + i;
 			*curr = *(pArr + i);
 		}
 	}
 
-	Matrix3x3::Matrix3x3(float _00, float _01, float _02, float _10, float _11, float _12, float _20, float _21, float _22)
+	template <typename T>
+	Matrix3x3T<T>::Matrix3x3T(T _00, T _01, T _02, T _10, T _11, T _12, T _20, T _21, T _22)
 	{
 		// set parameters to corresponding attributes
 		m00 = _00;
@@ -49,7 +52,8 @@ namespace CSD1130
 	}
 
 	// operator overloads
-	Matrix3x3& Matrix3x3::operator=(const Matrix3x3& rhs)
+	template <typename T>
+	Matrix3x3T<T>& Matrix3x3T<T>::operator=(const Matrix3x3T& rhs)
 	{
 		// copy values 
 		for (size_t i = 0; i < 9; i++)
@@ -59,7 +63,8 @@ namespace CSD1130
 		return *this;
 	}
 
-	Matrix3x3& Matrix3x3::operator*=(const Matrix3x3& rhs)
+	template <typename T>
+	Matrix3x3T<T>& Matrix3x3T<T>::operator*=(const Matrix3x3T& rhs)
 	{
 		// use * operator overload
 		*this = *this * rhs;
@@ -67,10 +72,11 @@ namespace CSD1130
 	}
 
 
-	Matrix3x3 operator*(const Matrix3x3& lhs, const Matrix3x3& rhs)
+	template <typename T>
+	Matrix3x3T<T> operator*(const Matrix3x3T<T>& lhs, const Matrix3x3T<T>& rhs)
 	{
 		// initialize output matrix
-		Matrix3x3 out = Matrix3x3();
+		Matrix3x3T<T> out = Matrix3x3T<T>();
 
 
 		// multiply 
@@ -79,7 +85,7 @@ namespace CSD1130
 			for (unsigned int j = 0; j < 3; ++j)
 			{
 				// calculate each value in the matrix 
-				float sum = 0;
+				T sum = T(0);
 
 				// [row][col] x [col][row] for square matrix multiplication
 				for (unsigned int k = 0; k < 3; ++k)
@@ -93,9 +99,10 @@ namespace CSD1130
 		return out;
 	}
 
-	Vector2D operator*(const Matrix3x3& pMtx, const Vector2D& rhs)
+	template <typename T>
+	Vector2DT<T> operator*(const Matrix3x3T<T>& pMtx, const Vector2DT<T>& rhs)
 	{
-		Vector2D out = rhs;
+		Vector2DT<T> out = rhs;
 
 		// 3x3 matrix * 2x1 matrix
 		out.x = pMtx.m00 * rhs.x + pMtx.m01 * rhs.y + pMtx.m02;
@@ -104,18 +111,20 @@ namespace CSD1130
 	}
 
 	// functions
-	void Mtx33Identity(Matrix3x3& pResult)
+	template <typename T>
+	void Mtx33Identity(Matrix3x3T<T>& pResult)
 	{
 		// empty matrix
-		pResult = Matrix3x3();
+		pResult = Matrix3x3T<T>();
 
-		// set diagonals to 1.f
-		pResult.m00 = 1.f;
-		pResult.m11 = 1.f;
-		pResult.m22 = 1.f;
+		// set diagonals to 1
+		pResult.m00 = T(1);
+		pResult.m11 = T(1);
+		pResult.m22 = T(1);
 	}
 
-	void Mtx33Translate(Matrix3x3& pResult, float x, float y)
+	template <typename T>
+	void Mtx33Translate(Matrix3x3T<T>& pResult, T x, T y)
 	{
 		// set identity matrix
 		Mtx33Identity(pResult);
@@ -125,7 +134,8 @@ namespace CSD1130
 		pResult.m12 += y;
 	}
 
-	void Mtx33Scale(Matrix3x3& pResult, float x, float y)
+	template <typename T>
+	void Mtx33Scale(Matrix3x3T<T>& pResult, T x, T y)
 	{
 		// set identity matrix
 		Mtx33Identity(pResult);
@@ -135,28 +145,35 @@ namespace CSD1130
 		pResult.m11 = y;
 	}
 
-	void Mtx33RotRad(Matrix3x3& pResult, float angle)
+	template <typename T>
+	void Mtx33RotRad(Matrix3x3T<T>& pResult, T angle)
 	{
 		// create identity matrix
 		Mtx33Identity(pResult);
 
+		// sine and cosine only computed once each
+		T s, c;
+		FastSinCos(angle, s, c);
+
 		// set rotation matrix
-		pResult.m00 = cosf(angle);
-		pResult.m01 = -sinf(angle);
-		pResult.m10 = sinf(angle);
-		pResult.m11 = cosf(angle);
+		pResult.m00 = c;
+		pResult.m01 = -s;
+		pResult.m10 = s;
+		pResult.m11 = c;
 	}
 
-	void Mtx33RotDeg(Matrix3x3& pResult, float angle)
+	template <typename T>
+	void Mtx33RotDeg(Matrix3x3T<T>& pResult, T angle)
 	{
 		// convert deg to rad
-		angle *= PI / 180.f;
+		angle *= T(PI / 180.f);
 
 		// rotate using rad
 		Mtx33RotRad(pResult, angle);
 	}
 
-	void Mtx33Transpose(Matrix3x3& pResult, const Matrix3x3& pMtx)
+	template <typename T>
+	void Mtx33Transpose(Matrix3x3T<T>& pResult, const Matrix3x3T<T>& pMtx)
 	{
 		// invert the rows and columns
 		for (size_t i = 0; i < 3; i++)
@@ -168,7 +185,8 @@ namespace CSD1130
 		}
 	}
 
-	void Mtx33Inverse(Matrix3x3* pResult, float* determinant, const Matrix3x3& pMtx)
+	template <typename T>
+	void Mtx33Inverse(Matrix3x3T<T>* pResult, T* determinant, const Matrix3x3T<T>& pMtx)
 	{
 		// calculate determinant 
 		*determinant =	(pMtx.m00 * pMtx.m11 * pMtx.m22 +
@@ -179,14 +197,14 @@ namespace CSD1130
 						pMtx.m12 * pMtx.m21 * pMtx.m00);
 
 		// if inversion fails
-		if (*determinant == 0.f) {
+		if (*determinant == T(0)) {
 			pResult = nullptr;
-			*determinant = 0.f;
+			*determinant = T(0);
 			return;
 		}
 
 		// create adjoint matrix
-		Matrix3x3 adjoint = 
+		Matrix3x3T<T> adjoint = 
 		{
 			(pMtx.m11 * pMtx.m22 - pMtx.m12 * pMtx.m21),	-(pMtx.m01 * pMtx.m22 - pMtx.m02 * pMtx.m21),	(pMtx.m01 * pMtx.m12 - pMtx.m02 * pMtx.m11),
 			-(pMtx.m10 * pMtx.m22 - pMtx.m12 * pMtx.m20),	(pMtx.m00 * pMtx.m22 - pMtx.m02 * pMtx.m20),	-(pMtx.m00 * pMtx.m12 - pMtx.m02 * pMtx.m10),
@@ -199,4 +217,23 @@ namespace CSD1130
 			pResult->m[i] = adjoint.m[i] / *determinant;
 		}
 	}
+
+	// explicit instantiations for the supported scalar types (see Scalar.h)
+	#define CSD1130_INSTANTIATE_MATRIX3X3(T)															\
+		template union Matrix3x3T<T>;																	\
+		template Matrix3x3T<T>	operator* <T>(const Matrix3x3T<T>&, const Matrix3x3T<T>&);				\
+		template Vector2DT<T>	operator* <T>(const Matrix3x3T<T>&, const Vector2DT<T>&);				\
+		template void Mtx33Identity<T>(Matrix3x3T<T>&);													\
+		template void Mtx33Translate<T>(Matrix3x3T<T>&, T, T);											\
+		template void Mtx33Scale<T>(Matrix3x3T<T>&, T, T);												\
+		template void Mtx33RotRad<T>(Matrix3x3T<T>&, T);												\
+		template void Mtx33RotDeg<T>(Matrix3x3T<T>&, T);												\
+		template void Mtx33Transpose<T>(Matrix3x3T<T>&, const Matrix3x3T<T>&);							\
+		template void Mtx33Inverse<T>(Matrix3x3T<T>*, T*, const Matrix3x3T<T>&);
+
+	CSD1130_INSTANTIATE_MATRIX3X3(float)
+	CSD1130_INSTANTIATE_MATRIX3X3(double)
+	CSD1130_INSTANTIATE_MATRIX3X3(Fixed)
+
+	#undef CSD1130_INSTANTIATE_MATRIX3X3
 }
\ No newline at end of file
@@ -0,0 +1,175 @@
+/******************************************************************************/
+/*!
+\file		Morton.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 19, 2023
+\brief
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+#include <algorithm>
+
+namespace
+{
+	// Cells on each side of the grid the keys are taken on
+	const int		MORTON_CELL_MAX		= 0xFFFF;
+
+	// Entries out of order (one in MORTON_INSERT_RATIO), or shifts in the
+	// insertion sort (MORTON_SHIFT_RATIO per entry), past which a full sort
+	// beats moving them one by one
+	const unsigned int	MORTON_INSERT_RATIO	= 16;
+	const unsigned int	MORTON_SHIFT_RATIO	= 8;
+
+	bool KeyLess(const MortonEntry &a, const MortonEntry &b)
+	{
+		return a.m_key < b.m_key;
+	}
+
+	/**************************************************************************/
+	/*!
+		The low 16 bits of x, moved to the even bits
+	 */
+	/**************************************************************************/
+	unsigned int SpreadBits(unsigned int x)
+	{
+		x &= 0x0000FFFF;
+		x = (x | (x << 8)) & 0x00FF00FF;
+		x = (x | (x << 4)) & 0x0F0F0F0F;
+		x = (x | (x << 2)) & 0x33333333;
+		x = (x | (x << 1)) & 0x55555555;
+		return x;
+	}
+
+	/**************************************************************************/
+	/*!
+		Cell of v on [vMin, vMin + MORTON_CELL_MAX / scale]. Truncated in
+		double: every scalar type converts to it exactly enough
+	 */
+	/**************************************************************************/
+	template <typename T>
+	unsigned int CellOf(T v, T vMin, T scale)
+	{
+		T cell = (v - vMin) * scale;
+
+		if (cell <= T(0))
+			return 0;
+		if (cell >= T(MORTON_CELL_MAX))
+			return MORTON_CELL_MAX;
+		return (unsigned int)(double)cell;
+	}
+}
+
+/******************************************************************************/
+/*!
+* \brief Z-order key of a grid cell
+* \param x:		input - column, low 16 bits
+* \param y:		input - row, low 16 bits
+* \return unsigned int: the bits of x and y, interleaved
+ */
+/******************************************************************************/
+unsigned int MortonKey(unsigned int x,
+						unsigned int y)
+{
+	return SpreadBits(x) | (SpreadBits(y) << 1);
+}
+
+/******************************************************************************/
+/*!
+* \brief Z-order keys of the ball centers
+* \param pBalls:	input - balls
+* \param ballNum:	input - number of balls
+* \param boxMin:	input - bottom left corner of the grid
+* \param side:		input - side of the grid
+* \param pEntries:	output - { key, index } of each ball, in ball order
+ */
+/******************************************************************************/
+template <typename T>
+void MortonKeys(const CircleT<T> *pBalls,
+				unsigned int ballNum,
+				const CSD1130::Vector2DT<T> &boxMin,
+				T side,
+				MortonEntry *pEntries)
+{
+	T scale = (side > T(0)) ? T(MORTON_CELL_MAX) / side : T(0);
+
+	for (unsigned int i = 0; i < ballNum; ++i)
+	{
+		const CSD1130::Vector2DT<T> &pt = pBalls[i].m_center;
+
+		pEntries[i].m_key	= MortonKey(CellOf(pt.x, boxMin.x, scale), CellOf(pt.y, boxMin.y, scale));
+		pEntries[i].m_item	= i;
+	}
+}
+
+/******************************************************************************/
+/*!
+* \brief Sort of the entries by key: insertion sort when few of them are
+	out of order and they didn't go far, std::stable_sort otherwise
+* \param pEntries:	input/output - entries
+* \param entryNum:	input - number of entries
+* \return unsigned int: number of entries that were out of place
+ */
+/******************************************************************************/
+unsigned int SortMortonEntries(MortonEntry *pEntries,
+								unsigned int entryNum)
+{
+	unsigned int descents = 0;
+
+	for (unsigned int i = 1; i < entryNum; ++i)
+		descents += (pEntries[i - 1].m_key > pEntries[i].m_key) ? 1 : 0;
+
+	if (descents == 0)
+		return 0;
+
+	if (descents * MORTON_INSERT_RATIO > entryNum)
+	{
+		std::stable_sort(pEntries, pEntries + entryNum, KeyLess);
+		return descents;
+	}
+
+	// a few entries that went far: the insertion sort stops, what it sorted
+	// keeps its order through the full sort
+	unsigned long long shiftMax	= (unsigned long long)entryNum * MORTON_SHIFT_RATIO;
+	unsigned long long shifts	= 0;
+	unsigned int moved			= 0;
+
+	for (unsigned int i = 1; i < entryNum; ++i)
+	{
+		if (pEntries[i - 1].m_key <= pEntries[i].m_key)
+			continue;
+
+		MortonEntry entry	= pEntries[i];
+		unsigned int j		= i;
+
+		for (; j > 0 && pEntries[j - 1].m_key > entry.m_key; --j)
+			pEntries[j] = pEntries[j - 1];
+
+		pEntries[j] = entry;
+		++moved;
+
+		shifts += i - j;
+		if (shifts > shiftMax)
+		{
+			std::stable_sort(pEntries, pEntries + entryNum, KeyLess);
+			return descents;
+		}
+	}
+
+	return moved;
+}
+
+#define CSD1130_INSTANTIATE_MORTON(T)																	\
+	template void MortonKeys<T>(const CircleT<T>*, unsigned int, const CSD1130::Vector2DT<T>&, T, MortonEntry*);
+
+CSD1130_INSTANTIATE_MORTON(float)
+CSD1130_INSTANTIATE_MORTON(double)
+CSD1130_INSTANTIATE_MORTON(CSD1130::Fixed)
+
+#undef CSD1130_INSTANTIATE_MORTON
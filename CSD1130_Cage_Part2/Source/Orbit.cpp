@@ -0,0 +1,209 @@
+/******************************************************************************/
+/*!
+\file		Orbit.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 14, 2023
+\brief
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+namespace
+{
+	// Bounces kept per ball: an orbit has to be seen twice
+	const unsigned int	RING_SIZE	= 2 * ORBIT_BOUNCE_MAX;
+
+	/**************************************************************************/
+	/*!
+		Bounce n of a ball (n from the start of its history)
+	 */
+	/**************************************************************************/
+	template <typename T>
+	const BounceT<T> &BounceOf(const OrbitSetT<T> &set, unsigned int ball, unsigned int n)
+	{
+		return set.m_bounces[ball * RING_SIZE + n % RING_SIZE];
+	}
+
+	/**************************************************************************/
+	/*!
+		Same hit point and velocity, within the tolerance
+	 */
+	/**************************************************************************/
+	template <typename T>
+	bool SameBounce(const BounceT<T> &a, const BounceT<T> &b, T tolerance)
+	{
+		return CSD1130::ScalarAbs(a.m_hit.x - b.m_hit.x) <= tolerance &&
+				CSD1130::ScalarAbs(a.m_hit.y - b.m_hit.y) <= tolerance &&
+				CSD1130::ScalarAbs(a.m_vel.x - b.m_vel.x) <= tolerance &&
+				CSD1130::ScalarAbs(a.m_vel.y - b.m_vel.y) <= tolerance;
+	}
+}
+
+/******************************************************************************/
+/*!
+* \brief Allocates the bounce history of the balls
+* \param set:		output - orbits, every ball off orbit
+* \param ballNum:	input - number of balls
+* \param tolerance:	input - hit points and velocities this close match
+ */
+/******************************************************************************/
+template <typename T>
+void InitOrbitSet(OrbitSetT<T> &set,
+					unsigned int ballNum,
+					T tolerance)
+{
+	set.m_bounces	= new BounceT<T>[ballNum * RING_SIZE];
+	set.m_bounceNum	= new unsigned int[ballNum]();
+	set.m_period	= new unsigned int[ballNum]();
+	set.m_duration	= new double[ballNum]();
+	set.m_ballNum	= ballNum;
+	set.m_tolerance	= tolerance;
+}
+
+/******************************************************************************/
+/*!
+* \brief Releases the bounce history
+* \param set:	input/output - orbits, empty afterwards
+ */
+/******************************************************************************/
+template <typename T>
+void FreeOrbitSet(OrbitSetT<T> &set)
+{
+	delete []set.m_bounces;
+	delete []set.m_bounceNum;
+	delete []set.m_period;
+	delete []set.m_duration;
+
+	set.m_bounces	= 0;
+	set.m_bounceNum	= 0;
+	set.m_period	= 0;
+	set.m_duration	= 0;
+	set.m_ballNum	= 0;
+}
+
+/******************************************************************************/
+/*!
+* \brief Forgets the bounces of a ball, and its orbit
+* \param set:	input/output - orbits
+* \param ball:	input - ball
+ */
+/******************************************************************************/
+template <typename T>
+void ResetOrbit(OrbitSetT<T> &set,
+				unsigned int ball)
+{
+	set.m_bounceNum[ball]	= 0;
+	set.m_period[ball]		= 0;
+}
+
+/******************************************************************************/
+/*!
+* \brief Records a bounce, and looks for an orbit ending with it
+* \param set:	input/output - orbits
+* \param ball:	input - ball, off orbit
+* \param hit:	input - where its path turned
+* \param vel:	input - velocity it left with
+* \param time:	input - when it turned
+* \return bool: true if its last k bounces repeat the k before (k <= ORBIT_BOUNCE_MAX)
+ */
+/******************************************************************************/
+template <typename T>
+bool AddBounce(OrbitSetT<T> &set,
+				unsigned int ball,
+				const CSD1130::Vector2DT<T> &hit,
+				const CSD1130::Vector2DT<T> &vel,
+				double time)
+{
+	unsigned int n = set.m_bounceNum[ball];
+
+	BounceT<T> &bounce	= set.m_bounces[ball * RING_SIZE + n % RING_SIZE];
+	bounce.m_hit		= hit;
+	bounce.m_vel		= vel;
+	bounce.m_time		= time;
+
+	set.m_bounceNum[ball] = ++n;
+
+	// shortest orbit first: a 2 bounce orbit also repeats every 4 bounces
+	for (unsigned int k = 1; k <= ORBIT_BOUNCE_MAX && 2 * k <= n; ++k)
+	{
+		unsigned int j = 0;
+		while (j < k && SameBounce(BounceOf(set, ball, n - 1 - j), BounceOf(set, ball, n - 1 - j - k), set.m_tolerance))
+			++j;
+
+		if (j < k)
+			continue;
+
+		double duration = BounceOf(set, ball, n - 1).m_time - BounceOf(set, ball, n - 1 - k).m_time;
+		if (duration <= 0.0)
+			continue;
+
+		set.m_period[ball]		= k;
+		set.m_duration[ball]	= duration;
+		return true;
+	}
+
+	return false;
+}
+
+/******************************************************************************/
+/*!
+* \brief State of a ball on an orbit
+* \param set:	input - orbits
+* \param ball:	input - ball
+* \param time:	input - time
+* \param pos:	output - position at time
+* \param vel:	output - velocity at time
+* \return bool: false if the ball isn't on an orbit
+ */
+/******************************************************************************/
+template <typename T>
+bool OrbitState(const OrbitSetT<T> &set,
+				unsigned int ball,
+				double time,
+				CSD1130::Vector2DT<T> &pos,
+				CSD1130::Vector2DT<T> &vel)
+{
+	unsigned int k = set.m_period[ball];
+	if (k == 0)
+		return false;
+
+	// the orbit is bounces [first, first + k), starting at t0
+	unsigned int	first	= set.m_bounceNum[ball] - k;
+	double			t0		= BounceOf(set, ball, first).m_time;
+	double			phase	= fmod(time - t0, set.m_duration[ball]);
+
+	if (phase < 0.0)
+		phase += set.m_duration[ball];
+
+	// last bounce before the phase
+	unsigned int j = k - 1;
+	while (j > 0 && BounceOf(set, ball, first + j).m_time - t0 > phase)
+		--j;
+
+	const BounceT<T> &bounce = BounceOf(set, ball, first + j);
+
+	vel = bounce.m_vel;
+	pos = bounce.m_hit + bounce.m_vel * T(phase - (bounce.m_time - t0));
+	return true;
+}
+
+#define CSD1130_INSTANTIATE_ORBIT(T)																					\
+	template void InitOrbitSet<T>(OrbitSetT<T>&, unsigned int, T);														\
+	template void FreeOrbitSet<T>(OrbitSetT<T>&);																		\
+	template void ResetOrbit<T>(OrbitSetT<T>&, unsigned int);															\
+	template bool AddBounce<T>(OrbitSetT<T>&, unsigned int, const CSD1130::Vector2DT<T>&, const CSD1130::Vector2DT<T>&,	\
+		double);																										\
+	template bool OrbitState<T>(const OrbitSetT<T>&, unsigned int, double, CSD1130::Vector2DT<T>&,						\
+		CSD1130::Vector2DT<T>&);
+
+CSD1130_INSTANTIATE_ORBIT(float)
+CSD1130_INSTANTIATE_ORBIT(double)
+CSD1130_INSTANTIATE_ORBIT(CSD1130::Fixed)
+
+#undef CSD1130_INSTANTIATE_ORBIT
@@ -0,0 +1,312 @@
+/******************************************************************************/
+/*!
+\file		Particles.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 7, 2023
+\brief
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+// same test as in Collision.cpp
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define CSD1130_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	// Wall bounces a particle can take in one step; past that it stays
+	// against the last wall it hit (wedged in a corner)
+	const int	PARTICLE_BOUNCE_MAX	= 4;
+
+	/**************************************************************************/
+	/*!
+		Step of particle i, one wall at a time
+	 */
+	/**************************************************************************/
+	template <typename T>
+	void StepParticle(ParticleSetT<T> &set,
+						unsigned int i,
+						const LineSegmentT<T> *pWalls,
+						unsigned int wallNum,
+						T dt)
+	{
+		CSD1130::Vector2DT<T>	pos{ set.m_x[i], set.m_y[i] };
+		CSD1130::Vector2DT<T>	vel{ set.m_vx[i], set.m_vy[i] };
+		CSD1130::Vector2DT<T>	V = vel * dt;
+
+		for (int bounce = 0; ; ++bounce)
+		{
+			const LineSegmentT<T>	*pHit	= 0;
+			T						best	= T(1);
+			T						interTime;
+
+			for (unsigned int w = 0; w < wallNum; ++w)
+			{
+				if (CollisionIntersection_PointLineSegment(pos, pos + V, pWalls[w], interTime) && interTime < best)
+				{
+					best	= interTime;
+					pHit	= pWalls + w;
+				}
+			}
+
+			pos += V * best;
+
+			if (!pHit || bounce == PARTICLE_BOUNCE_MAX)
+				break;
+
+			// what is left of the step, and the velocity, mirrored about the wall
+			const CSD1130::Vector2DT<T> &n = pHit->m_normal;
+
+			V	= V * (T(1) - best);
+			V	-= T(2) * CSD1130::Vector2DDotProduct(V, n) * n;
+			vel	-= T(2) * CSD1130::Vector2DDotProduct(vel, n) * n;
+		}
+
+		set.m_x[i]	= pos.x;
+		set.m_y[i]	= pos.y;
+		set.m_vx[i]	= vel.x;
+		set.m_vy[i]	= vel.y;
+	}
+
+	/**************************************************************************/
+	/*!
+		Step of the whole set, picked per scalar type (see the float version
+		below)
+	 */
+	/**************************************************************************/
+	template <typename T>
+	struct StepParticleSet
+	{
+		static void Run(ParticleSetT<T> &set, const LineSegmentT<T> *pWalls, unsigned int wallNum, T dt)
+		{
+			for (unsigned int i = 0; i < set.m_num; ++i)
+				StepParticle(set, i, pWalls, wallNum, dt);
+		}
+	};
+
+#ifdef CSD1130_SSE2
+	/**************************************************************************/
+	/*!
+		float version: 4 particles at a time against each wall, with the same
+		test as CollisionIntersection_PointLineSegment. The particles of a
+		block bounce together: a particle that didn't hit anything has no
+		step left and no normal to reflect off, so it just rides along
+	 */
+	/**************************************************************************/
+	template <>
+	struct StepParticleSet<float>
+	{
+		static void Run(ParticleSet &set, const LineSegment *pWalls, unsigned int wallNum, float dt)
+		{
+			// the walls as the kernel reads them: P0, E = P1 - P0, n. Copied
+			// every step (the walls can be others), into room that only grows
+			if (set.m_wallMax < wallNum)
+			{
+				delete []set.m_wall;
+				set.m_wall		= new float[wallNum * 6];
+				set.m_wallMax	= wallNum;
+			}
+
+			float *wall = set.m_wall;
+			for (unsigned int w = 0; w < wallNum; ++w)
+			{
+				wall[w * 6 + 0] = pWalls[w].m_pt0.x;
+				wall[w * 6 + 1] = pWalls[w].m_pt0.y;
+				wall[w * 6 + 2] = pWalls[w].m_pt1.x - pWalls[w].m_pt0.x;
+				wall[w * 6 + 3] = pWalls[w].m_pt1.y - pWalls[w].m_pt0.y;
+				wall[w * 6 + 4] = pWalls[w].m_normal.x;
+				wall[w * 6 + 5] = pWalls[w].m_normal.y;
+			}
+
+			const __m128 zero	= _mm_setzero_ps();
+			const __m128 one	= _mm_set1_ps(1.0f);
+			const __m128 two	= _mm_set1_ps(2.0f);
+			const __m128 step	= _mm_set1_ps(dt);
+
+			unsigned int i = 0;
+			for (; i + 4 <= set.m_num; i += 4)
+			{
+				__m128 x	= _mm_loadu_ps(set.m_x + i);
+				__m128 y	= _mm_loadu_ps(set.m_y + i);
+				__m128 vx	= _mm_loadu_ps(set.m_vx + i);
+				__m128 vy	= _mm_loadu_ps(set.m_vy + i);
+				__m128 Vx	= _mm_mul_ps(vx, step);
+				__m128 Vy	= _mm_mul_ps(vy, step);
+
+				for (int bounce = 0; ; ++bounce)
+				{
+					__m128	best	= one;
+					__m128	nx		= zero;
+					__m128	ny		= zero;
+					int		hit		= 0;
+
+					for (unsigned int w = 0; w < wallNum; ++w)
+					{
+						const float *pWall = wall + w * 6;
+
+						__m128 Ex		= _mm_set1_ps(pWall[2]);
+						__m128 Ey		= _mm_set1_ps(pWall[3]);
+						__m128 PsP0x	= _mm_sub_ps(_mm_set1_ps(pWall[0]), x);
+						__m128 PsP0y	= _mm_sub_ps(_mm_set1_ps(pWall[1]), y);
+
+						__m128 VxE		= _mm_sub_ps(_mm_mul_ps(Vx, Ey), _mm_mul_ps(Vy, Ex));
+						__m128 tNum		= _mm_sub_ps(_mm_mul_ps(PsP0x, Ey), _mm_mul_ps(PsP0y, Ex));
+						__m128 uNum		= _mm_sub_ps(_mm_mul_ps(PsP0x, Vy), _mm_mul_ps(PsP0y, Vx));
+
+						// against the normal, 0 <= t < best, 0 <= u <= 1
+						__m128 lanes	= _mm_and_ps(_mm_cmplt_ps(VxE, zero),
+										_mm_and_ps(_mm_and_ps(_mm_cmple_ps(tNum, zero), _mm_cmpgt_ps(tNum, _mm_mul_ps(best, VxE))),
+													_mm_and_ps(_mm_cmple_ps(uNum, zero), _mm_cmpge_ps(uNum, VxE))));
+
+						if (_mm_movemask_ps(lanes) == 0)
+							continue;
+
+						hit		|= _mm_movemask_ps(lanes);
+						best	= _mm_or_ps(_mm_and_ps(lanes, _mm_div_ps(tNum, VxE)), _mm_andnot_ps(lanes, best));
+						nx		= _mm_or_ps(_mm_and_ps(lanes, _mm_set1_ps(pWall[4])), _mm_andnot_ps(lanes, nx));
+						ny		= _mm_or_ps(_mm_and_ps(lanes, _mm_set1_ps(pWall[5])), _mm_andnot_ps(lanes, ny));
+					}
+
+					x = _mm_add_ps(x, _mm_mul_ps(Vx, best));
+					y = _mm_add_ps(y, _mm_mul_ps(Vy, best));
+
+					if (hit == 0 || bounce == PARTICLE_BOUNCE_MAX)
+						break;
+
+					__m128 rest	= _mm_sub_ps(one, best);
+					Vx			= _mm_mul_ps(Vx, rest);
+					Vy			= _mm_mul_ps(Vy, rest);
+
+					__m128 Vn	= _mm_mul_ps(two, _mm_add_ps(_mm_mul_ps(Vx, nx), _mm_mul_ps(Vy, ny)));
+					__m128 vn	= _mm_mul_ps(two, _mm_add_ps(_mm_mul_ps(vx, nx), _mm_mul_ps(vy, ny)));
+					Vx			= _mm_sub_ps(Vx, _mm_mul_ps(Vn, nx));
+					Vy			= _mm_sub_ps(Vy, _mm_mul_ps(Vn, ny));
+					vx			= _mm_sub_ps(vx, _mm_mul_ps(vn, nx));
+					vy			= _mm_sub_ps(vy, _mm_mul_ps(vn, ny));
+				}
+
+				_mm_storeu_ps(set.m_x + i, x);
+				_mm_storeu_ps(set.m_y + i, y);
+				_mm_storeu_ps(set.m_vx + i, vx);
+				_mm_storeu_ps(set.m_vy + i, vy);
+			}
+
+			// the last (up to 3) ones
+			for (; i < set.m_num; ++i)
+				StepParticle(set, i, pWalls, wallNum, dt);
+		}
+	};
+#endif
+}
+
+/******************************************************************************/
+/*!
+* \brief Allocates an empty particle set
+* \param set:			output - particles
+* \param particleMax:	input - room for particles
+ */
+/******************************************************************************/
+template <typename T>
+void InitParticleSet(ParticleSetT<T> &set,
+					unsigned int particleMax)
+{
+	set.m_x		= new T[particleMax];
+	set.m_y		= new T[particleMax];
+	set.m_vx	= new T[particleMax];
+	set.m_vy	= new T[particleMax];
+	set.m_num	= 0;
+	set.m_max	= particleMax;
+
+	set.m_wall		= 0;
+	set.m_wallMax	= 0;
+}
+
+/******************************************************************************/
+/*!
+* \brief Releases the particle set
+* \param set:	input/output - particles, empty afterwards
+ */
+/******************************************************************************/
+template <typename T>
+void FreeParticleSet(ParticleSetT<T> &set)
+{
+	delete []set.m_x;
+	delete []set.m_y;
+	delete []set.m_vx;
+	delete []set.m_vy;
+	delete []set.m_wall;
+
+	set.m_x		= 0;
+	set.m_y		= 0;
+	set.m_vx	= 0;
+	set.m_vy	= 0;
+	set.m_num	= 0;
+	set.m_max	= 0;
+
+	set.m_wall		= 0;
+	set.m_wallMax	= 0;
+}
+
+/******************************************************************************/
+/*!
+* \brief Adds a particle
+* \param set:	input/output - particles
+* \param pos:	input - position
+* \param vel:	input - velocity
+* \return unsigned int: index of the particle, set.m_max if the set is full
+ */
+/******************************************************************************/
+template <typename T>
+unsigned int AddParticle(ParticleSetT<T> &set,
+						const CSD1130::Vector2DT<T> &pos,
+						const CSD1130::Vector2DT<T> &vel)
+{
+	if (set.m_num == set.m_max)
+		return set.m_max;
+
+	unsigned int i = set.m_num++;
+
+	set.m_x[i]	= pos.x;
+	set.m_y[i]	= pos.y;
+	set.m_vx[i]	= vel.x;
+	set.m_vy[i]	= vel.y;
+	return i;
+}
+
+/******************************************************************************/
+/*!
+* \brief Moves the particles one step, bouncing them off the walls
+* \param set:		input/output - particles
+* \param pWalls:	input - walls
+* \param wallNum:	input - number of walls
+* \param dt:		input - time step
+ */
+/******************************************************************************/
+template <typename T>
+void StepParticles(ParticleSetT<T> &set,
+					const LineSegmentT<T> *pWalls,
+					unsigned int wallNum,
+					T dt)
+{
+	StepParticleSet<T>::Run(set, pWalls, wallNum, dt);
+}
+
+#define CSD1130_INSTANTIATE_PARTICLES(T)																				\
+	template void InitParticleSet<T>(ParticleSetT<T>&, unsigned int);													\
+	template void FreeParticleSet<T>(ParticleSetT<T>&);																	\
+	template unsigned int AddParticle<T>(ParticleSetT<T>&, const CSD1130::Vector2DT<T>&, const CSD1130::Vector2DT<T>&);	\
+	template void StepParticles<T>(ParticleSetT<T>&, const LineSegmentT<T>*, unsigned int, T);
+
+CSD1130_INSTANTIATE_PARTICLES(float)
+CSD1130_INSTANTIATE_PARTICLES(double)
+CSD1130_INSTANTIATE_PARTICLES(CSD1130::Fixed)
+
+#undef CSD1130_INSTANTIATE_PARTICLES
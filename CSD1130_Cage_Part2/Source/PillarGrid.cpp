@@ -0,0 +1,202 @@
+/******************************************************************************/
+/*!
+\file		PillarGrid.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	March 31, 2023
+\brief
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+namespace
+{
+	// Pillars per cell the grid aims for, and a cap on the number of cells
+	const double		PILLARS_PER_CELL	= 2.0;
+	const double		CELL_NUM_MAX		= 1 << 20;
+
+	/**************************************************************************/
+	/*!
+		Cell coordinate of v along one axis, clamped to [0, cellNum - 1].
+		Done in double: every scalar type converts to it exactly enough, and
+		the result only decides which pillars get tested
+	 */
+	/**************************************************************************/
+	template <typename T>
+	int CellCoord(T v, T min, T cellSize, int cellNum)
+	{
+		double c = floor((double)(v - min) / (double)cellSize);
+
+		if (c < 0.0)
+			return 0;
+		if (c > (double)(cellNum - 1))
+			return cellNum - 1;
+		return (int)c;
+	}
+}
+
+/******************************************************************************/
+/*!
+* \brief Builds the uniform grid over the pillars
+* \param grid:		output - grid, with its own copy of the pillars
+* \param pPillars:	input - pillars
+* \param pillarNum:	input - number of pillars
+ */
+/******************************************************************************/
+template <typename T>
+void BuildPillarGrid(PillarGridT<T> &grid,
+					const CircleT<T> *pPillars,
+					unsigned int pillarNum)
+{
+	grid.m_pillars.m_x		= new T[pillarNum];
+	grid.m_pillars.m_y		= new T[pillarNum];
+	grid.m_pillars.m_radius	= new T[pillarNum];
+	grid.m_pillars.m_num	= pillarNum;
+
+	// bounds of the pillar centers
+	grid.m_minX			= pillarNum ? pPillars[0].m_center.x : T(0);
+	grid.m_minY			= pillarNum ? pPillars[0].m_center.y : T(0);
+	grid.m_maxRadius	= T(0);
+
+	T maxX = grid.m_minX, maxY = grid.m_minY;
+	for (unsigned int i = 0; i < pillarNum; ++i)
+	{
+		const CircleT<T> &pillar = pPillars[i];
+
+		if (pillar.m_center.x < grid.m_minX)	grid.m_minX			= pillar.m_center.x;
+		if (pillar.m_center.y < grid.m_minY)	grid.m_minY			= pillar.m_center.y;
+		if (pillar.m_center.x > maxX)			maxX				= pillar.m_center.x;
+		if (pillar.m_center.y > maxY)			maxY				= pillar.m_center.y;
+		if (pillar.m_radius > grid.m_maxRadius)	grid.m_maxRadius	= pillar.m_radius;
+	}
+
+	// cells big enough to hold a pillar, and PILLARS_PER_CELL of them on average
+	double width	= (double)(maxX - grid.m_minX);
+	double height	= (double)(maxY - grid.m_minY);
+	double cellSize	= sqrt(width * height * PILLARS_PER_CELL / (pillarNum ? pillarNum : 1));
+
+	if (cellSize < 2.0 * (double)grid.m_maxRadius)
+		cellSize = 2.0 * (double)grid.m_maxRadius;
+	if (cellSize <= 0.0)
+		cellSize = 1.0;
+	while ((floor(width / cellSize) + 1.0) * (floor(height / cellSize) + 1.0) > CELL_NUM_MAX)
+		cellSize *= 2.0;
+
+	grid.m_cellSize		= T(cellSize);
+	grid.m_cellsX		= (int)floor(width / cellSize) + 1;
+	grid.m_cellsY		= (int)floor(height / cellSize) + 1;
+
+	// counting sort of the pillars by cell
+	unsigned int cellNum	= (unsigned int)(grid.m_cellsX * grid.m_cellsY);
+	unsigned int *pCell		= new unsigned int[pillarNum];
+
+	grid.m_cellStart = new unsigned int[cellNum + 1];
+	for (unsigned int c = 0; c <= cellNum; ++c)
+		grid.m_cellStart[c] = 0;
+
+	for (unsigned int i = 0; i < pillarNum; ++i)
+	{
+		int x = CellCoord(pPillars[i].m_center.x, grid.m_minX, grid.m_cellSize, grid.m_cellsX);
+		int y = CellCoord(pPillars[i].m_center.y, grid.m_minY, grid.m_cellSize, grid.m_cellsY);
+
+		pCell[i] = (unsigned int)(y * grid.m_cellsX + x);
+		++grid.m_cellStart[pCell[i] + 1];
+	}
+
+	for (unsigned int c = 0; c < cellNum; ++c)
+		grid.m_cellStart[c + 1] += grid.m_cellStart[c];
+
+	unsigned int *pNext = new unsigned int[cellNum];
+	for (unsigned int c = 0; c < cellNum; ++c)
+		pNext[c] = grid.m_cellStart[c];
+
+	for (unsigned int i = 0; i < pillarNum; ++i)
+	{
+		unsigned int p = pNext[pCell[i]]++;
+
+		grid.m_pillars.m_x[p]		= pPillars[i].m_center.x;
+		grid.m_pillars.m_y[p]		= pPillars[i].m_center.y;
+		grid.m_pillars.m_radius[p]	= pPillars[i].m_radius;
+	}
+
+	delete []pNext;
+	delete []pCell;
+}
+
+/******************************************************************************/
+/*!
+* \brief Releases the grid
+* \param grid:	input/output - grid, empty afterwards
+ */
+/******************************************************************************/
+template <typename T>
+void FreePillarGrid(PillarGridT<T> &grid)
+{
+	delete []grid.m_pillars.m_x;
+	delete []grid.m_pillars.m_y;
+	delete []grid.m_pillars.m_radius;
+	delete []grid.m_cellStart;
+
+	grid.m_pillars.m_x		= 0;
+	grid.m_pillars.m_y		= 0;
+	grid.m_pillars.m_radius	= 0;
+	grid.m_pillars.m_num	= 0;
+	grid.m_cellStart		= 0;
+	grid.m_cellsX			= 0;
+	grid.m_cellsY			= 0;
+}
+
+/******************************************************************************/
+/*!
+* \brief Finds the cells holding the pillars a circle inside a box can touch
+* \param grid:		input - grid
+* \param boxMin:	input - bottom left corner of the box
+* \param boxMax:	input - top right corner of the box
+* \param x0, y0:	output - first cell
+* \param x1, y1:	output - last cell (included)
+* \return bool: false if no pillar can be touched
+ */
+/******************************************************************************/
+template <typename T>
+bool PillarGridCellRange(const PillarGridT<T> &grid,
+						const CSD1130::Vector2DT<T> &boxMin,
+						const CSD1130::Vector2DT<T> &boxMax,
+						int &x0, int &y0,
+						int &x1, int &y1)
+{
+	if (grid.m_pillars.m_num == 0)
+		return false;
+
+	// pillars are filed by center, so grow the box by the biggest radius
+	T minX = boxMin.x - grid.m_maxRadius, minY = boxMin.y - grid.m_maxRadius;
+	T maxX = boxMax.x + grid.m_maxRadius, maxY = boxMax.y + grid.m_maxRadius;
+
+	T gridMaxX = grid.m_minX + grid.m_cellSize * T(grid.m_cellsX);
+	T gridMaxY = grid.m_minY + grid.m_cellSize * T(grid.m_cellsY);
+
+	if (maxX < grid.m_minX || maxY < grid.m_minY || minX > gridMaxX || minY > gridMaxY)
+		return false;
+
+	x0 = CellCoord(minX, grid.m_minX, grid.m_cellSize, grid.m_cellsX);
+	y0 = CellCoord(minY, grid.m_minY, grid.m_cellSize, grid.m_cellsY);
+	x1 = CellCoord(maxX, grid.m_minX, grid.m_cellSize, grid.m_cellsX);
+	y1 = CellCoord(maxY, grid.m_minY, grid.m_cellSize, grid.m_cellsY);
+	return true;
+}
+
+#define CSD1130_INSTANTIATE_PILLAR_GRID(T)																				\
+	template void BuildPillarGrid<T>(PillarGridT<T>&, const CircleT<T>*, unsigned int);								\
+	template void FreePillarGrid<T>(PillarGridT<T>&);																	\
+	template bool PillarGridCellRange<T>(const PillarGridT<T>&, const CSD1130::Vector2DT<T>&,							\
+		const CSD1130::Vector2DT<T>&, int&, int&, int&, int&);
+
+CSD1130_INSTANTIATE_PILLAR_GRID(float)
+CSD1130_INSTANTIATE_PILLAR_GRID(double)
+CSD1130_INSTANTIATE_PILLAR_GRID(CSD1130::Fixed)
+
+#undef CSD1130_INSTANTIATE_PILLAR_GRID
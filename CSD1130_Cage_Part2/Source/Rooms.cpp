@@ -0,0 +1,453 @@
+/******************************************************************************/
+/*!
+\file		Rooms.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 20, 2023
+\brief
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+namespace
+{
+	// Rooms a ball is tested in at once: its own and the ones past the
+	// portals it is close to (a ball in a crossroads)
+	const unsigned int	ROOM_GATHER_MAX		= 8;
+
+	// Walls (or vertices) of each class in a room entry
+	const unsigned int	ROOM_STRIDE			= (unsigned int)LINE_CLASS::LINE_CLASS_NUM + 1;
+
+	/**************************************************************************/
+	/*!
+		Merges the ascending lists pData[pFirst[l], pLast[l]) into pOut,
+		each item once. Returns the number of items written
+	 */
+	/**************************************************************************/
+	unsigned int MergeLists(const unsigned int *pData,
+							unsigned int *pFirst,
+							const unsigned int *pLast,
+							unsigned int listNum,
+							unsigned int *pOut)
+	{
+		unsigned int num = 0;
+
+		for (;;)
+		{
+			unsigned int best = listNum;
+			for (unsigned int l = 0; l < listNum; ++l)
+			{
+				if (pFirst[l] < pLast[l] && (best == listNum || pData[pFirst[l]] < pData[pFirst[best]]))
+					best = l;
+			}
+
+			if (best == listNum)
+				return num;
+
+			unsigned int item = pData[pFirst[best]++];
+			if (num == 0 || pOut[num - 1] != item)
+				pOut[num++] = item;
+		}
+	}
+
+	// Ends of walls closer than this are taken as the same corner (the level
+	// file gives each wall its own copy of a corner, rounded its own way)
+	const double		ROOM_JOIN_DISTANCE	= 0.01;
+
+	/**************************************************************************/
+	/*!
+		True if walls a and b share an end
+	 */
+	/**************************************************************************/
+	template <typename T>
+	bool WallsMeet(const LineSegmentT<T> &a, const LineSegmentT<T> &b)
+	{
+		T joinSq = T(ROOM_JOIN_DISTANCE * ROOM_JOIN_DISTANCE);
+
+		return CSD1130::Vector2DSquareDistance(a.m_pt0, b.m_pt0) <= joinSq ||
+				CSD1130::Vector2DSquareDistance(a.m_pt0, b.m_pt1) <= joinSq ||
+				CSD1130::Vector2DSquareDistance(a.m_pt1, b.m_pt0) <= joinSq ||
+				CSD1130::Vector2DSquareDistance(a.m_pt1, b.m_pt1) <= joinSq;
+	}
+
+	/**************************************************************************/
+	/*!
+		Marks the walls of room r, and the walls meeting them at an end: at
+		the corner where the walls of the rooms around it join, a ball in a
+		room can touch the end of a wall of the room across the corner.
+		Returns the number of walls marked
+	 */
+	/**************************************************************************/
+	template <typename T>
+	unsigned int MarkRoomWalls(unsigned int r,
+								const unsigned int *pRoomWallStart,
+								const unsigned int *pRoomWalls,
+								const LineSegmentT<T> *pWalls,
+								unsigned int wallNum,
+								unsigned char *pMark)
+	{
+		unsigned int num = 0;
+
+		for (unsigned int k = pRoomWallStart[r]; k < pRoomWallStart[r + 1]; ++k)
+		{
+			if (pRoomWalls[k] < wallNum && !pMark[pRoomWalls[k]])
+			{
+				pMark[pRoomWalls[k]] = 1;
+				++num;
+			}
+		}
+
+		for (unsigned int w = 0; w < wallNum; ++w)
+		{
+			if (pMark[w])
+				continue;
+
+			for (unsigned int k = pRoomWallStart[r]; k < pRoomWallStart[r + 1]; ++k)
+			{
+				if (pRoomWalls[k] < wallNum && WallsMeet(pWalls[w], pWalls[pRoomWalls[k]]))
+				{
+					pMark[w] = 2;
+					++num;
+					break;
+				}
+			}
+		}
+
+		return num;
+	}
+
+	/**************************************************************************/
+	/*!
+		True if pt is inside the bounds of room r
+	 */
+	/**************************************************************************/
+	template <typename T>
+	bool InRoomBox(const RoomSetT<T> &set, unsigned int r, const CSD1130::Vector2DT<T> &pt)
+	{
+		return set.m_boxMin[r].x <= pt.x && pt.x <= set.m_boxMax[r].x &&
+				set.m_boxMin[r].y <= pt.y && pt.y <= set.m_boxMax[r].y;
+	}
+}
+
+/******************************************************************************/
+/*!
+* \brief Builds the rooms
+* \param set:				output - rooms
+* \param roomNum:			input - number of rooms
+* \param pBoxMin:			input - bottom left of the bounds of each room
+* \param pBoxMax:			input - top right of the bounds of each room
+* \param pRoomWallStart:	input - room r is pRoomWalls[pRoomWallStart[r], pRoomWallStart[r + 1])
+* \param pRoomWalls:		input - walls of the rooms, indices into pWalls
+* \param pWalls:			input - walls, grouped by class
+* \param pClassStart:		input - class c is pWalls[pClassStart[c], pClassStart[c + 1])
+* \param pVertices:			input - wall vertices
+* \param vertexNum:			input - number of vertices
+* \param pPortals:			input - portals
+* \param portalNum:			input - number of portals
+ */
+/******************************************************************************/
+template <typename T>
+void BuildRoomSet(RoomSetT<T> &set,
+				unsigned int roomNum,
+				const CSD1130::Vector2DT<T> *pBoxMin,
+				const CSD1130::Vector2DT<T> *pBoxMax,
+				const unsigned int *pRoomWallStart,
+				const unsigned int *pRoomWalls,
+				const LineSegmentT<T> *pWalls,
+				const unsigned int *pClassStart,
+				const LineVertexT<T> *pVertices,
+				unsigned int vertexNum,
+				const PortalT<T> *pPortals,
+				unsigned int portalNum)
+{
+	unsigned int wallNum = pClassStart[(int)LINE_CLASS::LINE_CLASS_NUM];
+
+	// the walls of a room, marked, then read back in wall order: sorted,
+	// each one once, and grouped by class like pWalls
+	unsigned char *mark		= new unsigned char[wallNum]();
+	unsigned int listNum	= 0;
+
+	for (unsigned int r = 0; r < roomNum; ++r)
+	{
+		listNum += MarkRoomWalls(r, pRoomWallStart, pRoomWalls, pWalls, wallNum, mark);
+		for (unsigned int w = 0; w < wallNum; ++w)
+			mark[w] = 0;
+	}
+
+	set.m_roomNum		= roomNum;
+	set.m_boxMin		= new CSD1130::Vector2DT<T>[roomNum];
+	set.m_boxMax		= new CSD1130::Vector2DT<T>[roomNum];
+	set.m_wallStart		= new unsigned int[roomNum * ROOM_STRIDE];
+	set.m_walls			= new unsigned int[listNum];
+	set.m_vertexStart	= new unsigned int[roomNum + 1];
+	set.m_vertices		= new unsigned int[listNum * 2];
+
+	unsigned int wallCount		= 0;
+	unsigned int vertexCount	= 0;
+	T joinSq					= T(ROOM_JOIN_DISTANCE * ROOM_JOIN_DISTANCE);
+
+	for (unsigned int r = 0; r < roomNum; ++r)
+	{
+		set.m_boxMin[r] = pBoxMin[r];
+		set.m_boxMax[r] = pBoxMax[r];
+
+		unsigned int first = wallCount;
+		MarkRoomWalls(r, pRoomWallStart, pRoomWalls, pWalls, wallNum, mark);
+
+		for (int c = 0; c < (int)LINE_CLASS::LINE_CLASS_NUM; ++c)
+		{
+			set.m_wallStart[r * ROOM_STRIDE + c] = wallCount;
+
+			for (unsigned int w = pClassStart[c]; w < pClassStart[c + 1]; ++w)
+			{
+				if (!mark[w])
+					continue;
+
+				set.m_walls[wallCount++]	= w;
+				mark[w]						= 0;
+			}
+		}
+		set.m_wallStart[r * ROOM_STRIDE + (int)LINE_CLASS::LINE_CLASS_NUM] = wallCount;
+
+		// the vertices ending any of these walls
+		set.m_vertexStart[r] = vertexCount;
+		for (unsigned int v = 0; v < vertexNum; ++v)
+		{
+			const CSD1130::Vector2DT<T> &pt = pVertices[v].m_pt;
+
+			for (unsigned int k = first; k < wallCount; ++k)
+			{
+				const LineSegmentT<T> &wall = pWalls[set.m_walls[k]];
+
+				if (CSD1130::Vector2DSquareDistance(wall.m_pt0, pt) <= joinSq || CSD1130::Vector2DSquareDistance(wall.m_pt1, pt) <= joinSq)
+				{
+					set.m_vertices[vertexCount++] = v;
+					break;
+				}
+			}
+		}
+	}
+	set.m_vertexStart[roomNum] = vertexCount;
+
+	delete []mark;
+
+	// portals, and the ones of each room
+	set.m_portals		= new PortalT<T>[portalNum];
+	set.m_portalNum		= portalNum;
+	set.m_portalStart	= new unsigned int[roomNum + 1]();
+	set.m_roomPortals	= new unsigned int[portalNum * 2];
+
+	for (unsigned int p = 0; p < portalNum; ++p)
+	{
+		set.m_portals[p] = pPortals[p];
+
+		if (pPortals[p].m_front < roomNum)
+			++set.m_portalStart[pPortals[p].m_front + 1];
+		if (pPortals[p].m_back < roomNum && pPortals[p].m_back != pPortals[p].m_front)
+			++set.m_portalStart[pPortals[p].m_back + 1];
+	}
+
+	for (unsigned int r = 0; r < roomNum; ++r)
+		set.m_portalStart[r + 1] += set.m_portalStart[r];
+
+	unsigned int *next = new unsigned int[roomNum + 1];
+	for (unsigned int r = 0; r <= roomNum; ++r)
+		next[r] = set.m_portalStart[r];
+
+	for (unsigned int p = 0; p < portalNum; ++p)
+	{
+		if (pPortals[p].m_front < roomNum)
+			set.m_roomPortals[next[pPortals[p].m_front]++] = p;
+		if (pPortals[p].m_back < roomNum && pPortals[p].m_back != pPortals[p].m_front)
+			set.m_roomPortals[next[pPortals[p].m_back]++] = p;
+	}
+
+	delete []next;
+}
+
+/******************************************************************************/
+/*!
+* \brief Releases the rooms
+* \param set:	input/output - rooms, empty afterwards
+ */
+/******************************************************************************/
+template <typename T>
+void FreeRoomSet(RoomSetT<T> &set)
+{
+	delete []set.m_boxMin;
+	delete []set.m_boxMax;
+	delete []set.m_wallStart;
+	delete []set.m_walls;
+	delete []set.m_vertexStart;
+	delete []set.m_vertices;
+	delete []set.m_portals;
+	delete []set.m_portalStart;
+	delete []set.m_roomPortals;
+
+	set = RoomSetT<T>{};
+}
+
+/******************************************************************************/
+/*!
+* \brief Room holding a point
+* \param set:	input - rooms
+* \param pt:	input - point
+* \return unsigned int: first room whose bounds hold pt, ROOM_NONE if none
+ */
+/******************************************************************************/
+template <typename T>
+unsigned int FindRoom(const RoomSetT<T> &set,
+					const CSD1130::Vector2DT<T> &pt)
+{
+	for (unsigned int r = 0; r < set.m_roomNum; ++r)
+		if (InRoomBox(set, r, pt))
+			return r;
+
+	return ROOM_NONE;
+}
+
+/******************************************************************************/
+/*!
+* \brief Follows a ball through the portals of its room
+* \param set:		input - rooms
+* \param room:		input - room of the ball at ptStart
+* \param ptStart:	input - start of the step
+* \param ptEnd:		input - end of the step
+* \return unsigned int: room past the portal the step goes through, room if
+*	none. A ball that ends up outside of the bounds of room anyway (a
+*	bounce took it around the end of a portal) is looked for by bounds
+ */
+/******************************************************************************/
+template <typename T>
+unsigned int CrossPortals(const RoomSetT<T> &set,
+						unsigned int room,
+						const CSD1130::Vector2DT<T> &ptStart,
+						const CSD1130::Vector2DT<T> &ptEnd)
+{
+	if (room >= set.m_roomNum)
+		return room;
+
+	for (unsigned int k = set.m_portalStart[room]; k < set.m_portalStart[room + 1]; ++k)
+	{
+		const PortalT<T>		&portal	= set.m_portals[set.m_roomPortals[k]];
+		const LineSegmentT<T>	&line	= portal.m_line;
+
+		T d0 = CSD1130::Vector2DDotProduct(ptStart - line.m_pt0, line.m_normal);
+		T d1 = CSD1130::Vector2DDotProduct(ptEnd - line.m_pt0, line.m_normal);
+
+		unsigned int to;
+		if (d0 > T(0) && d1 <= T(0) && portal.m_front == room)
+			to = portal.m_back;
+		else if (d0 <= T(0) && d1 > T(0) && portal.m_back == room)
+			to = portal.m_front;
+		else
+			continue;
+
+		// where the step crosses the line of the portal, between its ends?
+		CSD1130::Vector2DT<T> pt	= ptStart + (ptEnd - ptStart) * (d0 / (d0 - d1));
+		CSD1130::Vector2DT<T> E		= line.m_pt1 - line.m_pt0;
+		T s							= CSD1130::Vector2DDotProduct(pt - line.m_pt0, E);
+
+		if (T(0) <= s && s <= CSD1130::Vector2DDotProduct(E, E))
+			return to;
+	}
+
+	if (InRoomBox(set, room, ptEnd))
+		return room;
+
+	unsigned int found = FindRoom(set, ptEnd);
+	return (found != ROOM_NONE) ? found : room;
+}
+
+/******************************************************************************/
+/*!
+* \brief Walls and vertices a ball in a room can touch
+* \param set:			input - rooms
+* \param room:			input - room of the ball
+* \param center:		input - ball center
+* \param reach:			input - the rooms past the portals this close are added
+* \param pWalls:		output - walls, grouped by class, in wall order
+* \param pClassStart:	output - class c is pWalls[pClassStart[c], pClassStart[c + 1])
+* \param pVertices:		output - vertices, in vertex order
+* \return unsigned int: number of vertices
+ */
+/******************************************************************************/
+template <typename T>
+unsigned int GatherRoomWalls(const RoomSetT<T> &set,
+							unsigned int room,
+							const CSD1130::Vector2DT<T> &center,
+							T reach,
+							unsigned int *pWalls,
+							unsigned int *pClassStart,
+							unsigned int *pVertices)
+{
+	unsigned int rooms[ROOM_GATHER_MAX];
+	unsigned int roomNum	= 0;
+	T reachSq				= reach * reach;
+
+	rooms[roomNum++] = room;
+
+	for (unsigned int k = set.m_portalStart[room]; k < set.m_portalStart[room + 1] && roomNum < ROOM_GATHER_MAX; ++k)
+	{
+		const PortalT<T> &portal = set.m_portals[set.m_roomPortals[k]];
+		unsigned int other = (portal.m_front == room) ? portal.m_back : portal.m_front;
+
+		if (other >= set.m_roomNum || DistanceSquared_PointLineSegment(center, portal.m_line) > reachSq)
+			continue;
+
+		unsigned int r = 0;
+		while (r < roomNum && rooms[r] != other)
+			++r;
+
+		if (r == roomNum)
+			rooms[roomNum++] = other;
+	}
+
+	unsigned int first[ROOM_GATHER_MAX];
+	unsigned int last[ROOM_GATHER_MAX];
+	unsigned int num = 0;
+
+	for (int c = 0; c < (int)LINE_CLASS::LINE_CLASS_NUM; ++c)
+	{
+		pClassStart[c] = num;
+
+		for (unsigned int r = 0; r < roomNum; ++r)
+		{
+			first[r]	= set.m_wallStart[rooms[r] * ROOM_STRIDE + c];
+			last[r]		= set.m_wallStart[rooms[r] * ROOM_STRIDE + c + 1];
+		}
+
+		num += MergeLists(set.m_walls, first, last, roomNum, pWalls + num);
+	}
+	pClassStart[(int)LINE_CLASS::LINE_CLASS_NUM] = num;
+
+	for (unsigned int r = 0; r < roomNum; ++r)
+	{
+		first[r]	= set.m_vertexStart[rooms[r]];
+		last[r]		= set.m_vertexStart[rooms[r] + 1];
+	}
+
+	return MergeLists(set.m_vertices, first, last, roomNum, pVertices);
+}
+
+#define CSD1130_INSTANTIATE_ROOMS(T)																					\
+	template void BuildRoomSet<T>(RoomSetT<T>&, unsigned int, const CSD1130::Vector2DT<T>*,							\
+		const CSD1130::Vector2DT<T>*, const unsigned int*, const unsigned int*, const LineSegmentT<T>*,				\
+		const unsigned int*, const LineVertexT<T>*, unsigned int, const PortalT<T>*, unsigned int);					\
+	template void FreeRoomSet<T>(RoomSetT<T>&);																			\
+	template unsigned int FindRoom<T>(const RoomSetT<T>&, const CSD1130::Vector2DT<T>&);								\
+	template unsigned int CrossPortals<T>(const RoomSetT<T>&, unsigned int, const CSD1130::Vector2DT<T>&,				\
+		const CSD1130::Vector2DT<T>&);																					\
+	template unsigned int GatherRoomWalls<T>(const RoomSetT<T>&, unsigned int, const CSD1130::Vector2DT<T>&, T,		\
+		unsigned int*, unsigned int*, unsigned int*);
+
+CSD1130_INSTANTIATE_ROOMS(float)
+CSD1130_INSTANTIATE_ROOMS(double)
+CSD1130_INSTANTIATE_ROOMS(CSD1130::Fixed)
+
+#undef CSD1130_INSTANTIATE_ROOMS
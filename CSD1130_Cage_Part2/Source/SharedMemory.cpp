@@ -0,0 +1,140 @@
+/******************************************************************************/
+/*!
+\file		SharedMemory.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 25, 2023
+\brief
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/******************************************************************************/
+/*!
+* \brief Maps named shared memory
+* \param name:		input - name
+* \param bytes:		input/output - size, given to create it, found otherwise
+* \param access:	input - created, read only or read/write
+* \param pHandle:	output - for UnmapSharedMemory
+* \return void*: the address, 0 if it can't be mapped
+ */
+/******************************************************************************/
+void *MapSharedMemory(const char *name,
+						size_t &bytes,
+						SHARED_ACCESS access,
+						void *&pHandle)
+{
+	pHandle = 0;
+
+	bool create = (access == SHARED_ACCESS::ACCESS_CREATE);
+	bool write	= (access != SHARED_ACCESS::ACCESS_READ);
+
+#ifdef _WIN32
+	HANDLE mapping;
+
+	if (create)
+		mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, 0, PAGE_READWRITE, (DWORD)((unsigned long long)bytes >> 32),
+			(DWORD)(bytes & 0xFFFFFFFF), name);
+	else
+		mapping = OpenFileMappingA(write ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, FALSE, name);
+
+	if (mapping == 0)
+		return 0;
+
+	void *pAddress = MapViewOfFile(mapping, write ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, create ? bytes : 0);
+	if (pAddress == 0)
+	{
+		CloseHandle(mapping);
+		return 0;
+	}
+
+	if (!create)
+	{
+		MEMORY_BASIC_INFORMATION info;
+		VirtualQuery(pAddress, &info, sizeof(info));
+		bytes = info.RegionSize;
+	}
+
+	pHandle = mapping;
+	return pAddress;
+#else
+	// a new one replaces the old one: the processes still on it keep it
+	// as it is, where resizing it would pull it from under them
+	std::string path = std::string("/") + name;
+	if (create)
+		shm_unlink(path.c_str());
+
+	int file;
+	if (create)
+		file = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+	else
+		file = shm_open(path.c_str(), write ? O_RDWR : O_RDONLY, 0);
+
+	if (file < 0)
+		return 0;
+
+	struct stat info;
+	if ((create && ftruncate(file, (off_t)bytes) != 0) || fstat(file, &info) != 0 || info.st_size <= 0)
+	{
+		close(file);
+		return 0;
+	}
+
+	bytes = (size_t)info.st_size;
+	void *pAddress = mmap(0, bytes, write ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, file, 0);
+	close(file);
+
+	return (pAddress == MAP_FAILED) ? 0 : pAddress;
+#endif
+}
+
+/******************************************************************************/
+/*!
+* \brief Unmaps shared memory
+* \param pAddress:	input - address MapSharedMemory gave
+* \param bytes:		input - size
+* \param pHandle:	input - handle MapSharedMemory gave
+ */
+/******************************************************************************/
+void UnmapSharedMemory(const void *pAddress,
+						size_t bytes,
+						void *pHandle)
+{
+#ifdef _WIN32
+	(void)bytes;
+	UnmapViewOfFile(pAddress);
+	CloseHandle((HANDLE)pHandle);
+#else
+	(void)pHandle;
+	munmap((void*)pAddress, bytes);
+#endif
+}
+
+/******************************************************************************/
+/*!
+* \brief Takes the name of shared memory away
+* \param name:		input - name
+ */
+/******************************************************************************/
+void RemoveSharedMemory(const char *name)
+{
+#ifdef _WIN32
+	(void)name;
+#else
+	shm_unlink((std::string("/") + name).c_str());
+#endif
+}
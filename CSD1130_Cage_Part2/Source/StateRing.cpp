@@ -0,0 +1,362 @@
+/******************************************************************************/
+/*!
+\file		StateRing.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 24, 2023
+\brief
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+#include <new>
+#include <string.h>
+
+namespace
+{
+	const char			STATE_RING_TAG[4]		= { 'C', 'S', 'T', 'A' };
+	const unsigned int	STATE_RING_VERSION		= 1;
+
+	// Cap on the slots of a ring
+	const unsigned int	STATE_SLOT_NUM_MAX		= 1 << 12;
+
+	/**************************************************************************/
+	/*!
+		Bytes of a slot, a multiple of 64 so the slots don't share cache
+		lines
+	 */
+	/**************************************************************************/
+	size_t SlotBytes(unsigned int ballMax, unsigned int eventMax)
+	{
+		size_t bytes = sizeof(StateSlotHeader) + 2 * (size_t)ballMax * sizeof(CSD1130::Vec2) +
+			(size_t)eventMax * sizeof(StateEvent);
+
+		return (bytes + 63) & ~(size_t)63;
+	}
+
+	/**************************************************************************/
+	/*!
+		Where the arrays of a slot are
+	 */
+	/**************************************************************************/
+	template <typename B>
+	B *SlotPos(B *pSlot)
+	{
+		return pSlot + sizeof(StateSlotHeader);
+	}
+
+	template <typename B>
+	B *SlotVel(B *pSlot, unsigned int ballMax)
+	{
+		return SlotPos(pSlot) + (size_t)ballMax * sizeof(CSD1130::Vec2);
+	}
+
+	template <typename B>
+	B *SlotEvents(B *pSlot, unsigned int ballMax)
+	{
+		return SlotVel(pSlot, ballMax) + (size_t)ballMax * sizeof(CSD1130::Vec2);
+	}
+
+	/**************************************************************************/
+	/*!
+		Points the view at the slot of step. Returns false if the slot holds
+		another step, or is being written
+	 */
+	/**************************************************************************/
+	bool ViewSlot(const StateReader &reader, unsigned int step, StateView &view)
+	{
+		const StateRingHeader	&header	= *reader.m_header;
+		const unsigned char		*pSlot	= reader.m_slots + (size_t)(step & (header.m_slotNum - 1)) * header.m_slotBytes;
+		const StateSlotHeader	*pHead	= (const StateSlotHeader*)pSlot;
+
+		unsigned int seq = pHead->m_seq.load(std::memory_order_acquire);
+		if (seq & 1)
+			return false;
+
+		view.m_step			= pHead->m_step;
+		view.m_ballNum		= pHead->m_ballNum;
+		view.m_eventNum		= pHead->m_eventNum;
+		view.m_eventLost	= pHead->m_eventLost;
+		view.m_pos			= (const CSD1130::Vec2*)SlotPos(pSlot);
+		view.m_vel			= (const CSD1130::Vec2*)SlotVel(pSlot, header.m_ballMax);
+		view.m_events		= (const StateEvent*)SlotEvents(pSlot, header.m_ballMax);
+		view.m_slot			= pHead;
+		view.m_seq			= seq;
+
+		return StateViewValid(view) && view.m_step == step;
+	}
+}
+
+/******************************************************************************/
+/*!
+* \brief Creates the shared memory of a state ring
+* \param publisher:	output - publisher, nothing published yet
+* \param name:		input - name of the shared memory
+* \param ballMax:	input - balls published at most
+* \param eventMax:	input - bounces published per step at most
+* \param slotNum:	input - steps kept, rounded up to a power of 2
+* \return bool: false if it can't be created
+ */
+/******************************************************************************/
+bool OpenStatePublisher(StatePublisher &publisher,
+						const char *name,
+						unsigned int ballMax,
+						unsigned int eventMax,
+						unsigned int slotNum)
+{
+	publisher = StatePublisher{};
+
+	unsigned int slots = 1;
+	while (slots < slotNum && slots < STATE_SLOT_NUM_MAX)
+		slots <<= 1;
+
+	size_t slotBytes	= SlotBytes(ballMax, eventMax);
+	size_t bytes		= sizeof(StateRingHeader) + slots * slotBytes;
+	if (slotBytes > 0xFFFFFFFF || strlen(name) >= sizeof(publisher.m_name))
+		return false;
+
+	void *pHandle;
+	unsigned char *pAddress = (unsigned char*)MapSharedMemory(name, bytes, SHARED_ACCESS::ACCESS_CREATE, pHandle);
+	if (pAddress == 0)
+		return false;
+
+	// the tag goes in last: a reader that maps the memory before that
+	// doesn't take it for a ring
+	StateRingHeader *pHeader = new (pAddress) StateRingHeader;
+	memset(pHeader->m_tag, 0, sizeof(pHeader->m_tag));
+	pHeader->m_version		= STATE_RING_VERSION;
+	pHeader->m_slotNum		= slots;
+	pHeader->m_ballMax		= ballMax;
+	pHeader->m_eventMax		= eventMax;
+	pHeader->m_slotBytes	= (unsigned int)slotBytes;
+	pHeader->m_pad			= 0;
+	pHeader->m_published.store(0, std::memory_order_relaxed);
+
+	unsigned char *pSlots = pAddress + sizeof(StateRingHeader);
+	for (unsigned int s = 0; s < slots; ++s)
+	{
+		StateSlotHeader *pHead = new (pSlots + s * slotBytes) StateSlotHeader;
+		pHead->m_seq.store(0, std::memory_order_relaxed);
+		pHead->m_step = 0xFFFFFFFF;
+	}
+
+	std::atomic_thread_fence(std::memory_order_release);
+	memcpy(pHeader->m_tag, STATE_RING_TAG, sizeof(STATE_RING_TAG));
+
+	publisher.m_header	= pHeader;
+	publisher.m_slots	= pSlots;
+	publisher.m_bytes	= bytes;
+	publisher.m_handle	= pHandle;
+	publisher.m_lastVel	= new CSD1130::Vec2[ballMax];
+	publisher.m_first	= true;
+	publisher.m_step	= 0;
+	strcpy(publisher.m_name, name);
+
+	return true;
+}
+
+/******************************************************************************/
+/*!
+* \brief Publishes the balls of a world, and its bounces since the last call
+* \param publisher:	input/output - publisher
+* \param world:		input - world
+* \return bool: false, and nothing published, if a ball of the world is past
+*				the ballMax of the ring
+ */
+/******************************************************************************/
+bool PublishCageWorld(StatePublisher &publisher,
+						const CageWorld &world)
+{
+	if (publisher.m_header == 0)
+		return false;
+
+	// all or nothing: a reader can't tell a ball left out from one that
+	// stopped
+	for (unsigned int i = 0; i < world.m_ballNum; ++i)
+		if (world.m_ballId[i] >= publisher.m_header->m_ballMax)
+			return false;
+
+	StateRingHeader	&header		= *publisher.m_header;
+	unsigned int	step		= publisher.m_step++;
+	unsigned char	*pSlot		= publisher.m_slots + (size_t)(step & (header.m_slotNum - 1)) * header.m_slotBytes;
+	StateSlotHeader	*pHead		= (StateSlotHeader*)pSlot;
+	CSD1130::Vec2	*pPos		= (CSD1130::Vec2*)SlotPos(pSlot);
+	CSD1130::Vec2	*pVel		= (CSD1130::Vec2*)SlotVel(pSlot, header.m_ballMax);
+	StateEvent		*pEvents	= (StateEvent*)SlotEvents(pSlot, header.m_ballMax);
+	unsigned int	ballNum		= world.m_ballNum;
+	unsigned int	eventNum	= 0, eventLost = 0;
+
+	// odd: the readers leave the slot alone, or find out they read it while
+	// it changed
+	unsigned int seq = pHead->m_seq.load(std::memory_order_relaxed);
+	pHead->m_seq.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	for (unsigned int i = 0; i < world.m_ballNum; ++i)
+	{
+		unsigned int k = world.m_ballId[i];
+
+		const CSD1130::Vec2 &pos = world.m_ballData[i].m_center;
+		const CSD1130::Vec2 &vel = world.m_ballVel[i];
+
+		pPos[k] = pos;
+		pVel[k] = vel;
+
+		// a bounce is any change of velocity, whatever the ball hit
+		if (!publisher.m_first && (vel.x != publisher.m_lastVel[k].x || vel.y != publisher.m_lastVel[k].y))
+		{
+			if (eventNum < header.m_eventMax)
+				pEvents[eventNum++] = StateEvent{ k, pos, vel };
+			else
+				++eventLost;
+		}
+
+		publisher.m_lastVel[k] = vel;
+	}
+
+	pHead->m_step		= step;
+	pHead->m_ballNum	= ballNum;
+	pHead->m_eventNum	= eventNum;
+	pHead->m_eventLost	= eventLost;
+
+	pHead->m_seq.store(seq + 2, std::memory_order_release);
+	header.m_published.store(step + 1, std::memory_order_release);
+
+	publisher.m_first = false;
+	return true;
+}
+
+/******************************************************************************/
+/*!
+* \brief Releases the shared memory of a state ring
+* \param publisher:	input/output - publisher, empty afterwards
+ */
+/******************************************************************************/
+void FreeStatePublisher(StatePublisher &publisher)
+{
+	if (publisher.m_header)
+	{
+		UnmapSharedMemory(publisher.m_header, publisher.m_bytes, publisher.m_handle);
+		RemoveSharedMemory(publisher.m_name);
+	}
+
+	delete []publisher.m_lastVel;
+
+	publisher = StatePublisher{};
+}
+
+/******************************************************************************/
+/*!
+* \brief Maps the shared memory of a state ring, read only
+* \param reader:	output - reader
+* \param name:		input - name of the shared memory
+* \return bool: false if there is no ring of that name
+ */
+/******************************************************************************/
+bool OpenStateReader(StateReader &reader,
+						const char *name)
+{
+	reader = StateReader{};
+
+	size_t bytes = 0;
+	void *pHandle;
+	const unsigned char *pAddress = (const unsigned char*)MapSharedMemory(name, bytes, SHARED_ACCESS::ACCESS_READ, pHandle);
+	if (pAddress == 0)
+		return false;
+
+	const StateRingHeader *pHeader = (const StateRingHeader*)pAddress;
+
+	if (bytes < sizeof(StateRingHeader) || memcmp(pHeader->m_tag, STATE_RING_TAG, sizeof(STATE_RING_TAG)) != 0)
+	{
+		UnmapSharedMemory(pAddress, bytes, pHandle);
+		return false;
+	}
+
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	if (pHeader->m_version != STATE_RING_VERSION || pHeader->m_slotNum == 0 ||
+		(pHeader->m_slotNum & (pHeader->m_slotNum - 1)) != 0 ||
+		pHeader->m_slotBytes < SlotBytes(pHeader->m_ballMax, pHeader->m_eventMax) ||
+		bytes < sizeof(StateRingHeader) + (size_t)pHeader->m_slotNum * pHeader->m_slotBytes)
+	{
+		UnmapSharedMemory(pAddress, bytes, pHandle);
+		return false;
+	}
+
+	reader.m_header	= pHeader;
+	reader.m_slots	= pAddress + sizeof(StateRingHeader);
+	reader.m_bytes	= bytes;
+	reader.m_handle	= pHandle;
+
+	return true;
+}
+
+/******************************************************************************/
+/*!
+* \brief Points a view at the latest step published
+* \param reader:	input - reader
+* \param view:		output - view
+* \return bool: false if nothing is published, or the slot is being written
+ */
+/******************************************************************************/
+bool ReadLatestState(const StateReader &reader,
+						StateView &view)
+{
+	unsigned int published = reader.m_header->m_published.load(std::memory_order_acquire);
+	if (published == 0)
+		return false;
+
+	return ViewSlot(reader, published - 1, view);
+}
+
+/******************************************************************************/
+/*!
+* \brief Points a view at a step
+* \param reader:	input - reader
+* \param step:		input - step
+* \param view:		output - view
+* \return bool: false if the ring doesn't have the step (yet, or anymore)
+ */
+/******************************************************************************/
+bool ReadState(const StateReader &reader,
+				unsigned int step,
+				StateView &view)
+{
+	unsigned int published = reader.m_header->m_published.load(std::memory_order_acquire);
+	if (published - step - 1 >= reader.m_header->m_slotNum)
+		return false;
+
+	return ViewSlot(reader, step, view);
+}
+
+/******************************************************************************/
+/*!
+* \brief Checks that what was read through a view is the step it says
+* \param view:		input - view
+* \return bool: false if the slot was written over since the view was taken
+ */
+/******************************************************************************/
+bool StateViewValid(const StateView &view)
+{
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return view.m_slot->m_seq.load(std::memory_order_relaxed) == view.m_seq;
+}
+
+/******************************************************************************/
+/*!
+* \brief Unmaps the shared memory of a state ring
+* \param reader:	input/output - reader, empty afterwards
+ */
+/******************************************************************************/
+void CloseStateReader(StateReader &reader)
+{
+	if (reader.m_header)
+		UnmapSharedMemory(reader.m_header, reader.m_bytes, reader.m_handle);
+
+	reader = StateReader{};
+}
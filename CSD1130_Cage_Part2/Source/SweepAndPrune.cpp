@@ -0,0 +1,290 @@
+/******************************************************************************/
+/*!
+\file		SweepAndPrune.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 3, 2023
+\brief
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+#include <algorithm>
+
+namespace
+{
+	// Room for pairs allocated the first time some are found
+	const unsigned int	PAIR_NUM_MIN	= 64;
+
+	// Row height, in biggest ball diameters: the box of a ball at rest spans
+	// at most 2 rows, the box of a fast one a few more
+	const double		ROW_DIAMETERS	= 4.0;
+
+	// Rows further than this from row 0 are merged (a ball lost far away)
+	const double		ROW_MAX			= 1 << 30;
+
+	/**************************************************************************/
+	/*!
+		Row holding y. Done in double: every scalar type converts to it
+		exactly enough, and the row only decides which boxes get compared
+	 */
+	/**************************************************************************/
+	template <typename T>
+	int RowOf(const SweepAndPruneT<T> &sap, T y)
+	{
+		double r = floor((double)(y - sap.m_originY) / (double)sap.m_rowHeight);
+
+		if (r < -ROW_MAX)
+			return -(int)ROW_MAX;
+		if (r > ROW_MAX)
+			return (int)ROW_MAX;
+		return (int)r;
+	}
+
+	/**************************************************************************/
+	/*!
+		Sort order of the boxes: by row, then along x
+	 */
+	/**************************************************************************/
+	template <typename T>
+	bool BoxLess(const SweepAndPruneBoxT<T> &a, const SweepAndPruneBoxT<T> &b)
+	{
+		return a.m_row < b.m_row || (a.m_row == b.m_row && a.m_minX < b.m_minX);
+	}
+
+	/**************************************************************************/
+	/*!
+		Box around the path of a ball, from its center to ptEnd, reaching as
+		far as the path is long on every side of the center. A bounce off
+		another ball can make the path longer than the box reaches: the
+		boxes are refreshed (UpdateSweepAndPrune again) after the bounces
+	 */
+	/**************************************************************************/
+	template <typename T>
+	void RefreshBox(const SweepAndPruneT<T> &sap,
+					SweepAndPruneBoxT<T> &box,
+					const CircleT<T> &ball,
+					const CSD1130::Vector2DT<T> &ptEnd)
+	{
+		const CSD1130::Vector2DT<T> &ptStart = ball.m_center;
+
+		T reach = CSD1130::StepReach(ptEnd - ptStart) + ball.m_radius;
+
+		box.m_minX	= ptStart.x - reach;
+		box.m_maxX	= ptStart.x + reach;
+		box.m_minY	= ptStart.y - reach;
+		box.m_maxY	= ptStart.y + reach;
+		box.m_row	= RowOf(sap, box.m_minY);
+	}
+
+	/**************************************************************************/
+	/*!
+		Appends the pair (a, b), growing m_pairs when it is full
+	 */
+	/**************************************************************************/
+	template <typename T>
+	void AddPair(SweepAndPruneT<T> &sap, unsigned int a, unsigned int b)
+	{
+		if (sap.m_pairNum == sap.m_pairMax)
+		{
+			unsigned int pairMax	= sap.m_pairMax ? sap.m_pairMax * 2 : PAIR_NUM_MIN;
+			unsigned int *pPairs	= new unsigned int[pairMax * 2];
+
+			std::copy(sap.m_pairs, sap.m_pairs + sap.m_pairNum * 2, pPairs);
+			delete []sap.m_pairs;
+
+			sap.m_pairs		= pPairs;
+			sap.m_pairMax	= pairMax;
+		}
+
+		sap.m_pairs[sap.m_pairNum * 2]		= a;
+		sap.m_pairs[sap.m_pairNum * 2 + 1]	= b;
+		++sap.m_pairNum;
+	}
+}
+
+/******************************************************************************/
+/*!
+* \brief Allocates the broadphase and sorts the balls from scratch
+* \param sap:		output - broadphase
+* \param pBalls:	input - balls
+* \param ballNum:	input - number of balls
+ */
+/******************************************************************************/
+template <typename T>
+void InitSweepAndPrune(SweepAndPruneT<T> &sap,
+						const CircleT<T> *pBalls,
+						unsigned int ballNum)
+{
+	sap.m_boxes		= new SweepAndPruneBoxT<T>[ballNum];
+	sap.m_num		= ballNum;
+
+	sap.m_pairs		= 0;
+	sap.m_pairNum	= 0;
+	sap.m_pairMax	= 0;
+
+	// rows start under the lowest ball
+	T maxRadius		= T(0);
+	sap.m_originY	= ballNum ? pBalls[0].m_center.y : T(0);
+	for (unsigned int i = 0; i < ballNum; ++i)
+	{
+		if (pBalls[i].m_radius > maxRadius)
+			maxRadius = pBalls[i].m_radius;
+		if (pBalls[i].m_center.y < sap.m_originY)
+			sap.m_originY = pBalls[i].m_center.y;
+	}
+
+	sap.m_originY	= sap.m_originY - maxRadius;
+	sap.m_rowHeight	= maxRadius * T(2.0 * ROW_DIAMETERS);
+	if (!(sap.m_rowHeight > T(0)))
+		sap.m_rowHeight = T(1);
+
+	for (unsigned int i = 0; i < ballNum; ++i)
+	{
+		RefreshBox(sap, sap.m_boxes[i], pBalls[i], pBalls[i].m_center);
+		sap.m_boxes[i].m_ball = i;
+	}
+
+	// the balls can be anywhere in the level file, too far from sorted for
+	// the insertion sort; ties go by index so every build gets the same order
+	std::sort(sap.m_boxes, sap.m_boxes + ballNum, [](const SweepAndPruneBoxT<T> &a, const SweepAndPruneBoxT<T> &b)
+	{
+		return BoxLess(a, b) || (!BoxLess(b, a) && a.m_ball < b.m_ball);
+	});
+}
+
+/******************************************************************************/
+/*!
+* \brief Releases the broadphase
+* \param sap:	input/output - broadphase, empty afterwards
+ */
+/******************************************************************************/
+template <typename T>
+void FreeSweepAndPrune(SweepAndPruneT<T> &sap)
+{
+	delete []sap.m_boxes;
+	delete []sap.m_pairs;
+
+	sap.m_boxes		= 0;
+	sap.m_pairs		= 0;
+	sap.m_num		= 0;
+	sap.m_pairNum	= 0;
+	sap.m_pairMax	= 0;
+}
+
+/******************************************************************************/
+/*!
+* \brief Finds the pairs of balls that can touch during the step
+* \param sap:		input/output - broadphase
+* \param pBalls:	input - balls, at the start of the step
+* \param pPosNext:	input - ball positions at the end of the step
+* \return unsigned int: number of pairs in sap.m_pairs
+ */
+/******************************************************************************/
+template <typename T>
+unsigned int UpdateSweepAndPrune(SweepAndPruneT<T> &sap,
+								const CircleT<T> *pBalls,
+								const CSD1130::Vector2DT<T> *pPosNext)
+{
+	unsigned int			n		= sap.m_num;
+	SweepAndPruneBoxT<T>	*boxes	= sap.m_boxes;
+
+	sap.m_maxWidth = T(0);
+	for (unsigned int k = 0; k < n; ++k)
+	{
+		RefreshBox(sap, boxes[k], pBalls[boxes[k].m_ball], pPosNext[boxes[k].m_ball]);
+
+		if (boxes[k].m_maxX - boxes[k].m_minX > sap.m_maxWidth)
+			sap.m_maxWidth = boxes[k].m_maxX - boxes[k].m_minX;
+	}
+
+	// insertion sort: last step's order is almost right, each box only
+	// moves past the few neighbours it overtook (or the rest of its row and
+	// the start of the next one, when it changes row)
+	for (unsigned int k = 1; k < n; ++k)
+	{
+		if (!BoxLess(boxes[k], boxes[k - 1]))
+			continue;
+
+		SweepAndPruneBoxT<T>	box	= boxes[k];
+		unsigned int			j	= k;
+
+		for (; j > 0 && BoxLess(box, boxes[j - 1]); --j)
+			boxes[j] = boxes[j - 1];
+
+		boxes[j] = box;
+	}
+
+	sap.m_pairNum = 0;
+	for (unsigned int k = 0; k < n; ++k)
+	{
+		const SweepAndPruneBoxT<T> &a = boxes[k];
+
+		// same row: the boxes overlapping it along x are the ones right
+		// after it that start before it ends
+		unsigned int j = k + 1;
+		for (; j < n && boxes[j].m_row == a.m_row && !(a.m_maxX < boxes[j].m_minX); ++j)
+		{
+			const SweepAndPruneBoxT<T> &b = boxes[j];
+
+			if (a.m_minY <= b.m_maxY && b.m_minY <= a.m_maxY)
+				AddPair(sap, a.m_ball, b.m_ball);
+		}
+
+		// rows above, up to the one holding its top: boxes there can start
+		// before it (by the widest box at most), and are only paired from
+		// the lower box, so no pair is found twice
+		int rowLast = RowOf(sap, a.m_maxY);
+		for (int row = a.m_row + 1; row <= rowLast; ++row)
+		{
+			SweepAndPruneBoxT<T> from;
+			from.m_row	= row;
+			from.m_minX	= a.m_minX - sap.m_maxWidth;
+
+			j = (unsigned int)(std::lower_bound(boxes + k + 1, boxes + n, from, BoxLess<T>) - boxes);
+			for (; j < n && boxes[j].m_row == row && !(a.m_maxX < boxes[j].m_minX); ++j)
+			{
+				const SweepAndPruneBoxT<T> &b = boxes[j];
+
+				if (!(b.m_maxX < a.m_minX) && b.m_minY <= a.m_maxY)
+					AddPair(sap, a.m_ball, b.m_ball);
+			}
+		}
+	}
+
+	return sap.m_pairNum;
+}
+
+/******************************************************************************/
+/*!
+* \brief Renumbers the balls, keeping the order of the boxes
+* \param sap:			input/output - broadphase
+* \param pNewIndex:	input - ball i is now ball pNewIndex[i]
+ */
+/******************************************************************************/
+template <typename T>
+void RemapSweepAndPrune(SweepAndPruneT<T> &sap,
+						const unsigned int *pNewIndex)
+{
+	for (unsigned int k = 0; k < sap.m_num; ++k)
+		sap.m_boxes[k].m_ball = pNewIndex[sap.m_boxes[k].m_ball];
+
+	// the pairs are of the last update, with the old numbers
+	sap.m_pairNum = 0;
+}
+
+#define CSD1130_INSTANTIATE_SWEEP_AND_PRUNE(T)																			\
+	template void InitSweepAndPrune<T>(SweepAndPruneT<T>&, const CircleT<T>*, unsigned int);							\
+	template void FreeSweepAndPrune<T>(SweepAndPruneT<T>&);																\
+	template unsigned int UpdateSweepAndPrune<T>(SweepAndPruneT<T>&, const CircleT<T>*, const CSD1130::Vector2DT<T>*);	\
+	template void RemapSweepAndPrune<T>(SweepAndPruneT<T>&, const unsigned int*);
+
+CSD1130_INSTANTIATE_SWEEP_AND_PRUNE(float)
+CSD1130_INSTANTIATE_SWEEP_AND_PRUNE(double)
+CSD1130_INSTANTIATE_SWEEP_AND_PRUNE(CSD1130::Fixed)
+
+#undef CSD1130_INSTANTIATE_SWEEP_AND_PRUNE
@@ -0,0 +1,115 @@
+/******************************************************************************/
+/*!
+\file		Tiling.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 18, 2023
+\brief
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+	// L1 data cache of most x86 and ARM cores
+	const unsigned int	CACHE_L1_DEFAULT	= 32 * 1024;
+
+	/**************************************************************************/
+	/*!
+		Size of the level 1 data cache, from the system, 0 if unknown
+	 */
+	/**************************************************************************/
+	unsigned int QueryCacheSizeL1()
+	{
+#ifdef _WIN32
+		DWORD bytes = 0;
+		GetLogicalProcessorInformation(0, &bytes);
+		if (bytes == 0)
+			return 0;
+
+		unsigned int count = bytes / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION);
+		SYSTEM_LOGICAL_PROCESSOR_INFORMATION *pInfo = new SYSTEM_LOGICAL_PROCESSOR_INFORMATION[count];
+		unsigned int size = 0;
+
+		if (GetLogicalProcessorInformation(pInfo, &bytes))
+		{
+			for (unsigned int i = 0; i < count && size == 0; ++i)
+			{
+				if (pInfo[i].Relationship == RelationCache && pInfo[i].Cache.Level == 1 &&
+					(pInfo[i].Cache.Type == CacheData || pInfo[i].Cache.Type == CacheUnified))
+					size = pInfo[i].Cache.Size;
+			}
+		}
+
+		delete []pInfo;
+		return size;
+#elif defined(_SC_LEVEL1_DCACHE_SIZE)
+		long size = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+		return size > 0 ? (unsigned int)size : 0;
+#else
+		return 0;
+#endif
+	}
+
+	/**************************************************************************/
+	/*!
+		Size of the level 1 data cache, CACHE_L1_DEFAULT if unknown
+	 */
+	/**************************************************************************/
+	unsigned int FindCacheSizeL1()
+	{
+		unsigned int size = QueryCacheSizeL1();
+		return size ? size : CACHE_L1_DEFAULT;
+	}
+}
+
+/******************************************************************************/
+/*!
+* \brief Size of the L1 data cache
+* \return unsigned int: in bytes
+ */
+/******************************************************************************/
+unsigned int CacheSizeL1(void)
+{
+	// asked once, by the first caller (the worlds of a batch step on many threads)
+	static const unsigned int size = FindCacheSizeL1();
+
+	return size;
+}
+
+/******************************************************************************/
+/*!
+* \brief Picks the block sizes of a loop over every (outer, inner) pair
+* \param outerBytes:	input - size of an item of the outer array
+* \param innerBytes:	input - size of an item of the inner array
+* \param outerTile:		output - outer items in a block
+* \param innerTile:		output - inner items in a block
+ */
+/******************************************************************************/
+void ChooseTileSizes(unsigned int outerBytes,
+					unsigned int innerBytes,
+					unsigned int &outerTile,
+					unsigned int &innerTile)
+{
+	// what is left is for the stack and whatever else the loop touches
+	unsigned int cache = CacheSizeL1();
+
+	outerTile = (cache / 4) / (outerBytes ? outerBytes : 1);
+	innerTile = (cache / 2) / (innerBytes ? innerBytes : 1);
+
+	if (outerTile == 0)
+		outerTile = 1;
+	if (innerTile == 0)
+		innerTile = 1;
+}
@@ -13,125 +13,165 @@ prior written consent of DigiPen Institute of Technology is prohibited.
  /******************************************************************************/
 
 #include "Vector2D.h"
-#include <math.h>
+#include "FastMath.h"
 
 namespace CSD1130
 {
 	// constructor
-	Vector2D::Vector2D(float _x, float _y) :x(_x), y(_y) {}
+	template <typename T>
+	Vector2DT<T>::Vector2DT(T _x, T _y) :x(_x), y(_y) {}
 
-	Vector2D& Vector2D::operator+=(const Vector2D& rhs)
+	template <typename T>
+	Vector2DT<T>& Vector2DT<T>::operator+=(const Vector2DT& rhs)
 	{
 		x += rhs.x;
 		y += rhs.y;
 		return *this;
 	}
 
-	Vector2D& Vector2D::operator-=(const Vector2D& rhs)
+	template <typename T>
+	Vector2DT<T>& Vector2DT<T>::operator-=(const Vector2DT& rhs)
 	{
 		x -= rhs.x;
 		y -= rhs.y;
 		return *this;
 	}
 
-	Vector2D& Vector2D::operator*=(float rhs)
+	template <typename T>
+	Vector2DT<T>& Vector2DT<T>::operator*=(T rhs)
 	{
 		x *= rhs;
 		y *= rhs;
 		return *this;
 	}
 
-	Vector2D& Vector2D::operator/=(float rhs)
+	template <typename T>
+	Vector2DT<T>& Vector2DT<T>::operator/=(T rhs)
 	{
 		x /= rhs;
 		y /= rhs;
 		return *this;
 	}
 
-	Vector2D Vector2D::operator-() const
+	template <typename T>
+	Vector2DT<T> Vector2DT<T>::operator-() const
 	{
-		Vector2D out{ -x, -y };
+		Vector2DT out{ -x, -y };
 		return out;
 	}
 
-	Vector2D operator+(const Vector2D& lhs, const Vector2D& rhs)
+	template <typename T>
+	Vector2DT<T> operator+(const Vector2DT<T>& lhs, const Vector2DT<T>& rhs)
 	{
-		Vector2D out{ lhs.x + rhs.x, lhs.y + rhs.y };
+		Vector2DT<T> out{ lhs.x + rhs.x, lhs.y + rhs.y };
 		return out;
 	}
 
-	Vector2D operator-(const Vector2D& lhs, const Vector2D& rhs)
+	template <typename T>
+	Vector2DT<T> operator-(const Vector2DT<T>& lhs, const Vector2DT<T>& rhs)
 	{
-		Vector2D out{ lhs.x - rhs.x, lhs.y - rhs.y };
+		Vector2DT<T> out{ lhs.x - rhs.x, lhs.y - rhs.y };
 		return out;
 	}
 
-	Vector2D operator*(const Vector2D& lhs, float rhs)
+	template <typename T>
+	Vector2DT<T> operator*(const Vector2DT<T>& lhs, T rhs)
 	{
-		Vector2D out{ lhs.x * rhs, lhs.y * rhs };
+		Vector2DT<T> out{ lhs.x * rhs, lhs.y * rhs };
 		return out;
 	}
 
-	Vector2D operator*(float rhs, const Vector2D& lhs)
+	template <typename T>
+	Vector2DT<T> operator*(T rhs, const Vector2DT<T>& lhs)
 	{
-		Vector2D out{ lhs.x * rhs, lhs.y * rhs };
+		Vector2DT<T> out{ lhs.x * rhs, lhs.y * rhs };
 		return out;
 	}
 
-	Vector2D operator/(const Vector2D& lhs, float rhs)
+	template <typename T>
+	Vector2DT<T> operator/(const Vector2DT<T>& lhs, T rhs)
 	{
-		Vector2D out{ lhs.x / rhs, lhs.y / rhs };
+		Vector2DT<T> out{ lhs.x / rhs, lhs.y / rhs };
 		return out;
 	}
 
 	// functions
-	void Vector2DNormalize(Vector2D& pResult, const Vector2D& pVec0)
+	template <typename T>
+	void Vector2DNormalize(Vector2DT<T>& pResult, const Vector2DT<T>& pVec0)
 	{
 		// divide x and y by length of vector to get 1 unit vector
-		float len = Vector2DLength(pVec0);
-		pResult.x = pVec0.x / len;
-		pResult.y = pVec0.y / len;
+		Vector2DNormalizeLength(pResult, pVec0);
 	}
 
-	float Vector2DLength(const Vector2D& pVec0)
+	template <typename T>
+	T Vector2DLength(const Vector2DT<T>& pVec0)
 	{
 		// square root to get actual length
-		float out = sqrtf(Vector2DSquareLength(pVec0));
+		T out = ScalarSqrt(Vector2DSquareLength(pVec0));
 		return out;
 	}
 
-	float Vector2DSquareLength(const Vector2D& pVec0)
+	template <typename T>
+	T Vector2DSquareLength(const Vector2DT<T>& pVec0)
 	{
 		// get squared length using pythagoras theorem
-		float out = powf(pVec0.x, 2.f) + powf(pVec0.y, 2.f);
+		T out = pVec0.x * pVec0.x + pVec0.y * pVec0.y;
 		return out;
 	}
 
-	float Vector2DDistance(const Vector2D& pVec0, const Vector2D& pVec1)
+	template <typename T>
+	T Vector2DDistance(const Vector2DT<T>& pVec0, const Vector2DT<T>& pVec1)
 	{
 		// square root to get actual distance
-		float out = sqrtf(Vector2DSquareDistance(pVec0, pVec1));
+		T out = ScalarSqrt(Vector2DSquareDistance(pVec0, pVec1));
 		return out;
 	}
 
-	float Vector2DSquareDistance(const Vector2D& pVec0, const Vector2D& pVec1)
+	template <typename T>
+	T Vector2DSquareDistance(const Vector2DT<T>& pVec0, const Vector2DT<T>& pVec1)
 	{
 		// get squared distance using pythagoras theorem
-		float out = powf((pVec1.x - pVec0.x), 2.f) + powf((pVec1.y - pVec0.y), 2.f);
+		T dx = pVec1.x - pVec0.x;
+		T dy = pVec1.y - pVec0.y;
+		T out = dx * dx + dy * dy;
 		return out;
 	}
 
-	float Vector2DDotProduct(const Vector2D& pVec0, const Vector2D& pVec1)
+	template <typename T>
+	T Vector2DDotProduct(const Vector2DT<T>& pVec0, const Vector2DT<T>& pVec1)
 	{
 		// x1 * x2 + y1 * y2
-		float out = pVec0.x * pVec1.x + pVec0.y * pVec1.y;
+		T out = pVec0.x * pVec1.x + pVec0.y * pVec1.y;
 		return out;
 	}
 
-	float Vector2DCrossProductMag(const Vector2D& pVec0, const Vector2D& pVec1)
+	template <typename T>
+	T Vector2DCrossProductMag(const Vector2DT<T>& pVec0, const Vector2DT<T>& pVec1)
 	{
 		// x1 * y2 - y1 * x2
-		float out = pVec0.x * pVec1.y - pVec0.y * pVec1.x;
+		T out = pVec0.x * pVec1.y - pVec0.y * pVec1.x;
 		return out;
 	}
+
+	// explicit instantiations for the supported scalar types (see Scalar.h)
+	#define CSD1130_INSTANTIATE_VECTOR2D(T)																\
+		template union Vector2DT<T>;																		\
+		template Vector2DT<T> operator+ <T>(const Vector2DT<T>&, const Vector2DT<T>&);					\
+		template Vector2DT<T> operator- <T>(const Vector2DT<T>&, const Vector2DT<T>&);					\
+		template Vector2DT<T> operator* <T>(const Vector2DT<T>&, T);										\
+		template Vector2DT<T> operator* <T>(T, const Vector2DT<T>&);										\
+		template Vector2DT<T> operator/ <T>(const Vector2DT<T>&, T);										\
+		template void	Vector2DNormalize<T>(Vector2DT<T>&, const Vector2DT<T>&);						\
+		template T		Vector2DLength<T>(const Vector2DT<T>&);											\
+		template T		Vector2DSquareLength<T>(const Vector2DT<T>&);									\
+		template T		Vector2DDistance<T>(const Vector2DT<T>&, const Vector2DT<T>&);					\
+		template T		Vector2DSquareDistance<T>(const Vector2DT<T>&, const Vector2DT<T>&);			\
+		template T		Vector2DDotProduct<T>(const Vector2DT<T>&, const Vector2DT<T>&);				\
+		template T		Vector2DCrossProductMag<T>(const Vector2DT<T>&, const Vector2DT<T>&);
+
+	CSD1130_INSTANTIATE_VECTOR2D(float)
+	CSD1130_INSTANTIATE_VECTOR2D(double)
+	CSD1130_INSTANTIATE_VECTOR2D(Fixed)
+
+	#undef CSD1130_INSTANTIATE_VECTOR2D
 }
\ No newline at end of file
@@ -0,0 +1,815 @@
+/******************************************************************************/
+/*!
+\file		WallStream.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 22, 2023
+\brief
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	const char			WALL_PACK_TAG[4]	= { 'C', 'W', 'A', 'L' };
+	const unsigned int	WALL_PACK_VERSION	= 2;
+
+	// Cap on the tiles of a pack a side
+	const unsigned int	WALL_PACK_SIDE_MAX	= 1 << 14;
+
+	const unsigned int	TILE_NONE			= 0xFFFFFFFF;
+	const unsigned int	TILE_CELL_NUM		= WALL_TILE_CELLS * WALL_TILE_CELLS;
+
+	// m_state of a tile
+	const unsigned char	TILE_OUT			= 0;
+	const unsigned char	TILE_ASKED			= 1;	// the thread is asked for it
+	const unsigned char	TILE_IN				= 2;
+}
+
+/******************************************************************************/
+/*!
+	The reading thread has its own file, the simulation another for the
+	tiles it can't wait for. m_asked, m_reading and m_read are shared, under
+	m_lock
+ */
+/******************************************************************************/
+template <typename T>
+struct WallStreamWorkerT
+{
+	WallPackHeader			m_header;
+	const WallPackTile		*m_entries;
+	std::ifstream			m_file;
+	std::ifstream			m_fileNow;
+
+	std::thread				m_thread;
+	std::mutex				m_lock;
+	std::condition_variable	m_wake;				// a tile was asked for, or time to quit
+	std::condition_variable	m_ready;			// a tile was read
+	std::deque<unsigned int>	m_asked;
+	unsigned int			m_reading;			// tile being read, TILE_NONE if none
+	std::vector<std::pair<unsigned int, WallTileT<T>*>>	m_read;	// read, not taken in yet
+	bool					m_quit;
+};
+
+namespace
+{
+	/**************************************************************************/
+	/*!
+		Cells [first, last] of a grid of num cells of size from min covering
+		[lo, hi], clamped to the grid. Done in double, from the floats of the
+		pack, so every scalar type gets the same cells. Returns false when
+		[lo, hi] misses the grid
+	 */
+	/**************************************************************************/
+	bool GridRange(double lo, double hi, double min, double size, unsigned int num, unsigned int &first, unsigned int &last)
+	{
+		double a = floor((lo - min) / size);
+		double b = floor((hi - min) / size);
+
+		if (b < 0.0 || a > (double)(num - 1))
+			return false;
+
+		first	= (a < 0.0) ? 0 : (unsigned int)a;
+		last	= (b > (double)(num - 1)) ? num - 1 : (unsigned int)b;
+		return true;
+	}
+
+	/**************************************************************************/
+	/*!
+		Memory a tile of wallNum walls is taken to need before it is read,
+		with each wall in two cells
+	 */
+	/**************************************************************************/
+	template <typename T>
+	size_t TileBytes(unsigned int wallNum)
+	{
+		return sizeof(WallTileT<T>) + (size_t)wallNum * (sizeof(LineSegmentT<T>) + 3 * sizeof(unsigned int)) +
+				(TILE_CELL_NUM + 1) * sizeof(unsigned int);
+	}
+
+	/**************************************************************************/
+	/*!
+		Reads tile t and builds its walls and cells. Returns 0 if the file
+		can't be read
+	 */
+	/**************************************************************************/
+	template <typename T>
+	WallTileT<T> *ReadWallTile(std::ifstream &file, const WallPackHeader &header, const WallPackTile &entry, unsigned int t)
+	{
+		WallPackWall *pFile	= new WallPackWall[entry.m_wallNum];
+		unsigned int num	= entry.m_wallNum;
+
+		file.clear();
+		file.seekg((std::streamoff)entry.m_offset);
+		if (!file.read((char*)pFile, (std::streamsize)num * sizeof(WallPackWall)))
+		{
+			delete []pFile;
+			return 0;
+		}
+
+		WallTileT<T> *pTile	= new WallTileT<T>;
+		pTile->m_walls		= new LineSegmentT<T>[num];
+		pTile->m_ids		= new unsigned int[num];
+		pTile->m_num		= num;
+		pTile->m_cellStart	= new unsigned int[TILE_CELL_NUM + 1];
+
+		for (unsigned int c = 0; c <= TILE_CELL_NUM; ++c)
+			pTile->m_cellStart[c] = 0;
+
+		double cellSize	= (double)header.m_tileSize / WALL_TILE_CELLS;
+		double tileX	= (double)header.m_minX + (double)header.m_tileSize * (t % header.m_tilesX);
+		double tileY	= (double)header.m_minY + (double)header.m_tileSize * (t / header.m_tilesX);
+
+		// counting sort of the walls into the cells their boxes overlap
+		unsigned int *pRange = new unsigned int[num * 4];
+		for (unsigned int k = 0; k < num; ++k)
+		{
+			const WallPackWall &wall = pFile[k];
+			unsigned int *r = pRange + k * 4;
+
+			BuildLineSegment(pTile->m_walls[k],
+							CSD1130::Vector2DT<T>{ T(wall.m_x0), T(wall.m_y0) },
+							CSD1130::Vector2DT<T>{ T(wall.m_x1), T(wall.m_y1) });
+			pTile->m_ids[k] = wall.m_id;
+
+			// the pack puts a wall in the tiles it overlaps, so this one, but
+			// for rounding on the edge
+			if (!GridRange((double)std::min(wall.m_x0, wall.m_x1), (double)std::max(wall.m_x0, wall.m_x1), tileX, cellSize,
+					WALL_TILE_CELLS, r[0], r[2]) ||
+				!GridRange((double)std::min(wall.m_y0, wall.m_y1), (double)std::max(wall.m_y0, wall.m_y1), tileY, cellSize,
+					WALL_TILE_CELLS, r[1], r[3]))
+			{
+				r[0] = r[1] = 1;
+				r[2] = r[3] = 0;
+			}
+
+			for (unsigned int y = r[1]; y <= r[3]; ++y)
+				for (unsigned int x = r[0]; x <= r[2]; ++x)
+					++pTile->m_cellStart[y * WALL_TILE_CELLS + x + 1];
+		}
+
+		for (unsigned int c = 0; c < TILE_CELL_NUM; ++c)
+			pTile->m_cellStart[c + 1] += pTile->m_cellStart[c];
+
+		unsigned int next[TILE_CELL_NUM];
+		for (unsigned int c = 0; c < TILE_CELL_NUM; ++c)
+			next[c] = pTile->m_cellStart[c];
+
+		// in wall order, so each cell lists its walls in id order
+		pTile->m_cellWalls = new unsigned int[pTile->m_cellStart[TILE_CELL_NUM]];
+		for (unsigned int k = 0; k < num; ++k)
+		{
+			const unsigned int *r = pRange + k * 4;
+
+			for (unsigned int y = r[1]; y <= r[3]; ++y)
+				for (unsigned int x = r[0]; x <= r[2]; ++x)
+					pTile->m_cellWalls[next[y * WALL_TILE_CELLS + x]++] = k;
+		}
+
+		pTile->m_bytes = sizeof(WallTileT<T>) + (size_t)num * (sizeof(LineSegmentT<T>) + sizeof(unsigned int)) +
+						(TILE_CELL_NUM + 1 + pTile->m_cellStart[TILE_CELL_NUM]) * sizeof(unsigned int);
+
+		delete []pRange;
+		delete []pFile;
+		return pTile;
+	}
+
+	/**************************************************************************/
+	/*!
+		Releases a tile
+	 */
+	/**************************************************************************/
+	template <typename T>
+	void FreeWallTile(WallTileT<T> *pTile)
+	{
+		delete []pTile->m_walls;
+		delete []pTile->m_ids;
+		delete []pTile->m_cellStart;
+		delete []pTile->m_cellWalls;
+		delete pTile;
+	}
+
+	/**************************************************************************/
+	/*!
+		Body of the reading thread: reads the tiles asked for, in the order
+		they were asked, until told to quit
+	 */
+	/**************************************************************************/
+	template <typename T>
+	void ReadAskedTiles(WallStreamWorkerT<T> *pWorker)
+	{
+		std::unique_lock<std::mutex> lock(pWorker->m_lock);
+
+		for (;;)
+		{
+			pWorker->m_wake.wait(lock, [pWorker]() { return pWorker->m_quit || !pWorker->m_asked.empty(); });
+			if (pWorker->m_quit)
+				return;
+
+			unsigned int t = pWorker->m_asked.front();
+			pWorker->m_asked.pop_front();
+			pWorker->m_reading = t;
+
+			lock.unlock();
+			WallTileT<T> *pTile = ReadWallTile<T>(pWorker->m_file, pWorker->m_header, pWorker->m_entries[t], t);
+			lock.lock();
+
+			pWorker->m_read.push_back({ t, pTile });
+			pWorker->m_reading = TILE_NONE;
+			pWorker->m_ready.notify_all();
+		}
+	}
+
+	/**************************************************************************/
+	/*!
+		Puts tile t in memory. asked: it was counted in m_pendingBytes
+	 */
+	/**************************************************************************/
+	template <typename T>
+	void TakeTile(WallStreamT<T> &stream, unsigned int t, WallTileT<T> *pTile, bool asked)
+	{
+		if (asked)
+			stream.m_pendingBytes -= TileBytes<T>(stream.m_entries[t].m_wallNum);
+
+		stream.m_tiles[t]								= pTile;
+		stream.m_state[t]								= TILE_IN;
+		stream.m_lastUse[t]								= stream.m_clock;
+		stream.m_resident[stream.m_residentNum++]		= t;
+		stream.m_bytes									+= pTile->m_bytes;
+		++stream.m_loadNum;
+	}
+
+	/**************************************************************************/
+	/*!
+		Tile t couldn't be read: it is left out, to be read again the next
+		time it is needed. asked: it was counted in m_pendingBytes
+	 */
+	/**************************************************************************/
+	template <typename T>
+	void MissTile(WallStreamT<T> &stream, unsigned int t, bool asked)
+	{
+		if (asked)
+			stream.m_pendingBytes -= TileBytes<T>(stream.m_entries[t].m_wallNum);
+
+		if (stream.m_failNum++ == 0)
+			printf("Failed to read tile %u of the wall pack, read again when needed\n", t);
+
+		stream.m_state[t] = TILE_OUT;
+	}
+
+	/**************************************************************************/
+	/*!
+		Takes in the tiles the thread has read. lock holds the thread lock,
+		and is released
+	 */
+	/**************************************************************************/
+	template <typename T>
+	void TakeReadTiles(WallStreamT<T> &stream, std::unique_lock<std::mutex> &lock)
+	{
+		std::vector<std::pair<unsigned int, WallTileT<T>*>> read;
+		read.swap(stream.m_worker->m_read);
+		lock.unlock();
+
+		for (const std::pair<unsigned int, WallTileT<T>*> &tile : read)
+		{
+			if (tile.second)
+				TakeTile(stream, tile.first, tile.second, true);
+			else
+				MissTile(stream, tile.first, true);
+		}
+	}
+
+	/**************************************************************************/
+	/*!
+		Tile t, read first if it is not in memory: taken back from the
+		thread if it is still waiting there, waited for if the thread is on
+		it. Returns 0 if it can't be read
+	 */
+	/**************************************************************************/
+	template <typename T>
+	WallTileT<T> *NeedTile(WallStreamT<T> &stream, unsigned int t)
+	{
+		if (stream.m_state[t] == TILE_IN)
+			return stream.m_tiles[t];
+
+		WallStreamWorkerT<T> &worker = *stream.m_worker;
+		++stream.m_missNum;
+
+		if (stream.m_state[t] == TILE_ASKED)
+		{
+			std::unique_lock<std::mutex> lock(worker.m_lock);
+			std::deque<unsigned int>::iterator it = std::find(worker.m_asked.begin(), worker.m_asked.end(), t);
+
+			if (it == worker.m_asked.end())
+			{
+				worker.m_ready.wait(lock, [&worker, t]() { return worker.m_reading != t; });
+				TakeReadTiles(stream, lock);
+
+				// the thread couldn't read it, one more go here
+				if (stream.m_state[t] == TILE_IN)
+					return stream.m_tiles[t];
+			}
+			else
+			{
+				worker.m_asked.erase(it);
+				lock.unlock();
+
+				stream.m_pendingBytes -= TileBytes<T>(stream.m_entries[t].m_wallNum);
+			}
+		}
+
+		WallTileT<T> *pTile = ReadWallTile<T>(worker.m_fileNow, stream.m_header, stream.m_entries[t], t);
+		if (pTile == 0)
+		{
+			MissTile(stream, t, false);
+			return 0;
+		}
+
+		TakeTile(stream, t, pTile, false);
+		return pTile;
+	}
+
+	/**************************************************************************/
+	/*!
+		Tiles [x0, x1] x [y0, y1] overlapping the box. Returns false if none
+	 */
+	/**************************************************************************/
+	template <typename T>
+	bool TileRange(const WallStreamT<T> &stream,
+					const CSD1130::Vector2DT<T> &boxMin,
+					const CSD1130::Vector2DT<T> &boxMax,
+					unsigned int &x0, unsigned int &y0,
+					unsigned int &x1, unsigned int &y1)
+	{
+		const WallPackHeader &header = stream.m_header;
+
+		return stream.m_tileNum != 0 &&
+				GridRange((double)boxMin.x, (double)boxMax.x, (double)header.m_minX, (double)header.m_tileSize, header.m_tilesX,
+					x0, x1) &&
+				GridRange((double)boxMin.y, (double)boxMax.y, (double)header.m_minY, (double)header.m_tileSize, header.m_tilesY,
+					y0, y1);
+	}
+}
+
+/******************************************************************************/
+/*!
+* \brief Cuts the walls into tiles and writes the pack file
+* \param path:		input - pack file
+* \param pWalls:	input - walls
+* \param wallNum:	input - number of walls
+* \param tileSize:	input - side of a tile
+* \return bool: false if the file couldn't be written
+ */
+/******************************************************************************/
+bool WriteWallPack(const char *path,
+					const LineSegment *pWalls,
+					unsigned int wallNum,
+					float tileSize)
+{
+	if (!(tileSize > 0.0f))
+		return false;
+
+	float minX = wallNum ? pWalls[0].m_pt0.x : 0.0f, minY = wallNum ? pWalls[0].m_pt0.y : 0.0f;
+	float maxX = minX, maxY = minY;
+
+	for (unsigned int i = 0; i < wallNum; ++i)
+	{
+		const LineSegment &wall = pWalls[i];
+
+		minX = std::min(minX, std::min(wall.m_pt0.x, wall.m_pt1.x));
+		minY = std::min(minY, std::min(wall.m_pt0.y, wall.m_pt1.y));
+		maxX = std::max(maxX, std::max(wall.m_pt0.x, wall.m_pt1.x));
+		maxY = std::max(maxY, std::max(wall.m_pt0.y, wall.m_pt1.y));
+	}
+
+	WallPackHeader header;
+	std::copy(WALL_PACK_TAG, WALL_PACK_TAG + 4, header.m_tag);
+	header.m_version	= WALL_PACK_VERSION;
+	header.m_minX		= minX;
+	header.m_minY		= minY;
+	header.m_tileSize	= tileSize;
+	header.m_tilesX		= (unsigned int)std::min(floor(((double)maxX - minX) / tileSize) + 1.0, (double)WALL_PACK_SIDE_MAX);
+	header.m_tilesY		= (unsigned int)std::min(floor(((double)maxY - minY) / tileSize) + 1.0, (double)WALL_PACK_SIDE_MAX);
+	header.m_wallNum	= wallNum;
+
+	if (header.m_tilesX == WALL_PACK_SIDE_MAX || header.m_tilesY == WALL_PACK_SIDE_MAX)
+		return false;
+
+	// counting sort of the walls into the tiles their boxes overlap
+	unsigned int tileNum	= header.m_tilesX * header.m_tilesY;
+	unsigned int *pStart	= new unsigned int[tileNum + 1];
+	unsigned int *pRange	= new unsigned int[(size_t)wallNum * 4];
+
+	for (unsigned int t = 0; t <= tileNum; ++t)
+		pStart[t] = 0;
+
+	for (unsigned int i = 0; i < wallNum; ++i)
+	{
+		const LineSegment &wall = pWalls[i];
+		unsigned int *r = pRange + (size_t)i * 4;
+
+		GridRange((double)std::min(wall.m_pt0.x, wall.m_pt1.x), (double)std::max(wall.m_pt0.x, wall.m_pt1.x), (double)minX,
+			(double)tileSize, header.m_tilesX, r[0], r[2]);
+		GridRange((double)std::min(wall.m_pt0.y, wall.m_pt1.y), (double)std::max(wall.m_pt0.y, wall.m_pt1.y), (double)minY,
+			(double)tileSize, header.m_tilesY, r[1], r[3]);
+
+		for (unsigned int y = r[1]; y <= r[3]; ++y)
+			for (unsigned int x = r[0]; x <= r[2]; ++x)
+				++pStart[y * header.m_tilesX + x + 1];
+	}
+
+	for (unsigned int t = 0; t < tileNum; ++t)
+		pStart[t + 1] += pStart[t];
+
+	WallPackTile *pEntries	= new WallPackTile[tileNum];
+	unsigned long long base	= sizeof(WallPackHeader) + (unsigned long long)tileNum * sizeof(WallPackTile);
+
+	for (unsigned int t = 0; t < tileNum; ++t)
+	{
+		pEntries[t].m_offset	= base + (unsigned long long)pStart[t] * sizeof(WallPackWall);
+		pEntries[t].m_wallNum	= pStart[t + 1] - pStart[t];
+		pEntries[t].m_pad		= 0;
+	}
+
+	// the id of a wall is its place once the walls are grouped by class,
+	// in their order inside a class, as BuildCageWorld groups the walls
+	// it keeps: walls gathered in id order are tested in the same order
+	unsigned int classStart[(int)LINE_CLASS::LINE_CLASS_NUM + 1] = { 0 };
+	for (unsigned int i = 0; i < wallNum; ++i)
+		++classStart[(int)pWalls[i].m_class + 1];
+
+	for (int c = 0; c < (int)LINE_CLASS::LINE_CLASS_NUM; ++c)
+		classStart[c + 1] += classStart[c];
+
+	// in id order, so each tile lists its walls in id order
+	WallPackWall *pPacked = new WallPackWall[pStart[tileNum]];
+	for (int c = 0; c < (int)LINE_CLASS::LINE_CLASS_NUM; ++c)
+	{
+		unsigned int id = classStart[c];
+
+		for (unsigned int i = 0; i < wallNum; ++i)
+		{
+			const LineSegment &wall = pWalls[i];
+			const unsigned int *r = pRange + (size_t)i * 4;
+
+			if ((int)wall.m_class != c)
+				continue;
+
+			for (unsigned int y = r[1]; y <= r[3]; ++y)
+				for (unsigned int x = r[0]; x <= r[2]; ++x)
+					pPacked[pStart[y * header.m_tilesX + x]++] = { id, wall.m_pt0.x, wall.m_pt0.y, wall.m_pt1.x, wall.m_pt1.y };
+
+			++id;
+		}
+	}
+
+	std::ofstream outFile(path, std::ios::binary);
+	outFile.write((const char*)&header, sizeof(header));
+	outFile.write((const char*)pEntries, (std::streamsize)tileNum * sizeof(WallPackTile));
+	outFile.write((const char*)pPacked, (std::streamsize)pStart[tileNum] * sizeof(WallPackWall));
+
+	bool written = outFile.good();
+
+	delete []pPacked;
+	delete []pEntries;
+	delete []pRange;
+	delete []pStart;
+	return written;
+}
+
+/******************************************************************************/
+/*!
+* \brief Opens a pack and starts its reading thread
+* \param stream:	output - stream, no tile in memory
+* \param path:		input - pack file
+* \param budget:	input - memory the tiles can take, in bytes
+* \return bool: false if the file is not a pack
+ */
+/******************************************************************************/
+template <typename T>
+bool OpenWallStream(WallStreamT<T> &stream,
+					const char *path,
+					size_t budget)
+{
+	stream = WallStreamT<T>{};
+
+	std::ifstream inFile(path, std::ios::binary);
+	WallPackHeader header;
+
+	if (!inFile.read((char*)&header, sizeof(header)) || !std::equal(WALL_PACK_TAG, WALL_PACK_TAG + 4, header.m_tag) ||
+		header.m_version != WALL_PACK_VERSION || header.m_tilesX == 0 || header.m_tilesY == 0 ||
+		header.m_tilesX >= WALL_PACK_SIDE_MAX || header.m_tilesY >= WALL_PACK_SIDE_MAX || !(header.m_tileSize > 0.0f))
+		return false;
+
+	unsigned int tileNum	= header.m_tilesX * header.m_tilesY;
+	WallPackTile *pEntries	= new WallPackTile[tileNum];
+
+	if (!inFile.read((char*)pEntries, (std::streamsize)tileNum * sizeof(WallPackTile)))
+	{
+		delete []pEntries;
+		return false;
+	}
+
+	stream.m_header		= header;
+	stream.m_entries	= pEntries;
+	stream.m_tileNum	= tileNum;
+	stream.m_tiles		= new WallTileT<T>*[tileNum]();
+	stream.m_state		= new unsigned char[tileNum]();
+	stream.m_lastUse	= new unsigned int[tileNum]();
+	stream.m_resident	= new unsigned int[tileNum];
+	stream.m_budget		= budget;
+
+	WallStreamWorkerT<T> *pWorker = new WallStreamWorkerT<T>;
+	pWorker->m_header	= header;
+	pWorker->m_entries	= pEntries;
+	pWorker->m_reading	= TILE_NONE;
+	pWorker->m_quit		= false;
+	pWorker->m_file.open(path, std::ios::binary);
+	pWorker->m_fileNow.open(path, std::ios::binary);
+	pWorker->m_thread	= std::thread(ReadAskedTiles<T>, pWorker);
+
+	stream.m_worker = pWorker;
+	return true;
+}
+
+/******************************************************************************/
+/*!
+* \brief Stops the reading thread and releases the stream
+* \param stream:	input/output - stream, empty afterwards
+ */
+/******************************************************************************/
+template <typename T>
+void FreeWallStream(WallStreamT<T> &stream)
+{
+	if (stream.m_worker)
+	{
+		WallStreamWorkerT<T> *pWorker = stream.m_worker;
+		{
+			std::lock_guard<std::mutex> lock(pWorker->m_lock);
+			pWorker->m_quit = true;
+		}
+		pWorker->m_wake.notify_all();
+		pWorker->m_thread.join();
+
+		for (const std::pair<unsigned int, WallTileT<T>*> &tile : pWorker->m_read)
+			if (tile.second)
+				FreeWallTile(tile.second);
+
+		delete pWorker;
+	}
+
+	for (unsigned int k = 0; k < stream.m_residentNum; ++k)
+		FreeWallTile(stream.m_tiles[stream.m_resident[k]]);
+
+	delete []stream.m_entries;
+	delete []stream.m_tiles;
+	delete []stream.m_state;
+	delete []stream.m_lastUse;
+	delete []stream.m_resident;
+	delete []stream.m_gathered;
+	delete []stream.m_gatheredVertices;
+	delete []stream.m_found;
+	delete []stream.m_foundWalls;
+
+	stream = WallStreamT<T>{};
+}
+
+/******************************************************************************/
+/*!
+* \brief Starts a step, taking in the tiles read since the last one
+* \param stream:	input/output - stream
+ */
+/******************************************************************************/
+template <typename T>
+void BeginWallStreamStep(WallStreamT<T> &stream)
+{
+	if (stream.m_tileNum == 0)
+		return;
+
+	++stream.m_clock;
+
+	std::unique_lock<std::mutex> lock(stream.m_worker->m_lock);
+	TakeReadTiles(stream, lock);
+}
+
+/******************************************************************************/
+/*!
+* \brief Asks the reading thread for the tiles overlapping a box
+* \param stream:	input/output - stream
+* \param boxMin:	input - bottom left corner of the box
+* \param boxMax:	input - top right corner of the box
+ */
+/******************************************************************************/
+template <typename T>
+void PrefetchWallTiles(WallStreamT<T> &stream,
+						const CSD1130::Vector2DT<T> &boxMin,
+						const CSD1130::Vector2DT<T> &boxMax)
+{
+	unsigned int x0, y0, x1, y1;
+	if (!TileRange(stream, boxMin, boxMax, x0, y0, x1, y1))
+		return;
+
+	for (unsigned int y = y0; y <= y1; ++y)
+	{
+		for (unsigned int x = x0; x <= x1; ++x)
+		{
+			unsigned int t = y * stream.m_header.m_tilesX + x;
+
+			if (stream.m_state[t] == TILE_IN)
+				stream.m_lastUse[t] = stream.m_clock;
+
+			if (stream.m_state[t] != TILE_OUT || stream.m_entries[t].m_wallNum == 0)
+				continue;
+
+			size_t bytes = TileBytes<T>(stream.m_entries[t].m_wallNum);
+			if (stream.m_bytes + stream.m_pendingBytes + bytes > stream.m_budget)
+				continue;
+
+			stream.m_state[t]		= TILE_ASKED;
+			stream.m_pendingBytes	+= bytes;
+			{
+				std::lock_guard<std::mutex> lock(stream.m_worker->m_lock);
+				stream.m_worker->m_asked.push_back(t);
+			}
+			stream.m_worker->m_wake.notify_one();
+		}
+	}
+}
+
+/******************************************************************************/
+/*!
+* \brief Gathers the walls in the cells overlapping a box
+* \param stream:	input/output - stream, the walls in m_gathered
+* \param boxMin:	input - bottom left corner of the box
+* \param boxMax:	input - top right corner of the box
+* \return unsigned int: number of walls
+ */
+/******************************************************************************/
+template <typename T>
+unsigned int GatherStreamedWalls(WallStreamT<T> &stream,
+								const CSD1130::Vector2DT<T> &boxMin,
+								const CSD1130::Vector2DT<T> &boxMax)
+{
+	unsigned int x0, y0, x1, y1;
+	if (!TileRange(stream, boxMin, boxMax, x0, y0, x1, y1))
+		return 0;
+
+	const WallPackHeader &header	= stream.m_header;
+	double cellSize					= (double)header.m_tileSize / WALL_TILE_CELLS;
+	unsigned int foundNum			= 0;
+
+	for (unsigned int y = y0; y <= y1; ++y)
+	{
+		for (unsigned int x = x0; x <= x1; ++x)
+		{
+			unsigned int t = y * header.m_tilesX + x;
+			if (stream.m_entries[t].m_wallNum == 0)
+				continue;
+
+			const WallTileT<T> *pTile = NeedTile(stream, t);
+			if (pTile == 0)
+				continue;
+
+			stream.m_lastUse[t] = stream.m_clock;
+
+			unsigned int cx0, cy0, cx1, cy1;
+			if (!GridRange((double)boxMin.x, (double)boxMax.x, (double)header.m_minX + (double)header.m_tileSize * x, cellSize,
+					WALL_TILE_CELLS, cx0, cx1) ||
+				!GridRange((double)boxMin.y, (double)boxMax.y, (double)header.m_minY + (double)header.m_tileSize * y, cellSize,
+					WALL_TILE_CELLS, cy0, cy1))
+				continue;
+
+			for (unsigned int cy = cy0; cy <= cy1; ++cy)
+			{
+				for (unsigned int cx = cx0; cx <= cx1; ++cx)
+				{
+					unsigned int c = cy * WALL_TILE_CELLS + cx;
+
+					for (unsigned int k = pTile->m_cellStart[c]; k < pTile->m_cellStart[c + 1]; ++k)
+					{
+						if (foundNum == stream.m_foundMax)
+						{
+							unsigned int foundMax = stream.m_foundMax ? stream.m_foundMax * 2 : 256;
+
+							unsigned long long *pFound = new unsigned long long[foundMax];
+							const LineSegmentT<T> **pFoundWalls = new const LineSegmentT<T>*[foundMax];
+							std::copy(stream.m_found, stream.m_found + foundNum, pFound);
+							std::copy(stream.m_foundWalls, stream.m_foundWalls + foundNum, pFoundWalls);
+
+							delete []stream.m_found;
+							delete []stream.m_foundWalls;
+							delete []stream.m_gathered;
+							delete []stream.m_gatheredVertices;
+							stream.m_found				= pFound;
+							stream.m_foundWalls			= pFoundWalls;
+							stream.m_gathered			= new LineSegmentT<T>[foundMax];
+							stream.m_gatheredVertices	= new LineVertexT<T>[(size_t)foundMax * 2];
+							stream.m_foundMax			= foundMax;
+						}
+
+						unsigned int w = pTile->m_cellWalls[k];
+						stream.m_found[foundNum]		= ((unsigned long long)pTile->m_ids[w] << 32) | foundNum;
+						stream.m_foundWalls[foundNum]	= pTile->m_walls + w;
+						++foundNum;
+					}
+				}
+			}
+		}
+	}
+
+	// a wall in several cells (or tiles) is found in each, once is enough
+	std::sort(stream.m_found, stream.m_found + foundNum);
+
+	unsigned int num = 0;
+	for (unsigned int k = 0; k < foundNum; ++k)
+	{
+		if (k > 0 && (stream.m_found[k] >> 32) == (stream.m_found[k - 1] >> 32))
+			continue;
+
+		stream.m_gathered[num++] = *stream.m_foundWalls[stream.m_found[k] & 0xFFFFFFFF];
+	}
+
+	return num;
+}
+
+/******************************************************************************/
+/*!
+* \brief Merges the end points of the gathered walls into vertices
+* \param stream:	input/output - stream, the vertices in m_gatheredVertices
+* \param wallNum:	input - walls gathered last (m_gathered[0 .. wallNum))
+* \return unsigned int: number of vertices
+ */
+/******************************************************************************/
+template <typename T>
+unsigned int GatherStreamedVertices(WallStreamT<T> &stream,
+									unsigned int wallNum)
+{
+	if (wallNum == 0)
+		return 0;
+
+	return BuildLineVertices(stream.m_gathered, wallNum, stream.m_gatheredVertices);
+}
+
+/******************************************************************************/
+/*!
+* \brief Ends a step, dropping the tiles used the longest ago while the
+		tiles in memory take more than the budget
+* \param stream:	input/output - stream
+ */
+/******************************************************************************/
+template <typename T>
+void EndWallStreamStep(WallStreamT<T> &stream)
+{
+	while (stream.m_bytes > stream.m_budget)
+	{
+		unsigned int oldest = stream.m_residentNum;
+		for (unsigned int k = 0; k < stream.m_residentNum; ++k)
+		{
+			unsigned int t = stream.m_resident[k];
+
+			if (stream.m_lastUse[t] != stream.m_clock &&
+				(oldest == stream.m_residentNum || stream.m_lastUse[t] < stream.m_lastUse[stream.m_resident[oldest]]))
+				oldest = k;
+		}
+
+		if (oldest == stream.m_residentNum)
+			return;
+
+		unsigned int t = stream.m_resident[oldest];
+		stream.m_resident[oldest] = stream.m_resident[--stream.m_residentNum];
+
+		stream.m_bytes		-= stream.m_tiles[t]->m_bytes;
+		FreeWallTile(stream.m_tiles[t]);
+		stream.m_tiles[t]	= 0;
+		stream.m_state[t]	= TILE_OUT;
+		++stream.m_dropNum;
+	}
+}
+
+#define CSD1130_INSTANTIATE_WALL_STREAM(T)																				\
+	template bool OpenWallStream<T>(WallStreamT<T>&, const char*, size_t);												\
+	template void FreeWallStream<T>(WallStreamT<T>&);																	\
+	template void BeginWallStreamStep<T>(WallStreamT<T>&);																\
+	template void PrefetchWallTiles<T>(WallStreamT<T>&, const CSD1130::Vector2DT<T>&, const CSD1130::Vector2DT<T>&);	\
+	template unsigned int GatherStreamedWalls<T>(WallStreamT<T>&, const CSD1130::Vector2DT<T>&,							\
+		const CSD1130::Vector2DT<T>&);																					\
+	template unsigned int GatherStreamedVertices<T>(WallStreamT<T>&, unsigned int);										\
+	template void EndWallStreamStep<T>(WallStreamT<T>&);
+
+CSD1130_INSTANTIATE_WALL_STREAM(float)
+CSD1130_INSTANTIATE_WALL_STREAM(double)
+CSD1130_INSTANTIATE_WALL_STREAM(CSD1130::Fixed)
+
+#undef CSD1130_INSTANTIATE_WALL_STREAM
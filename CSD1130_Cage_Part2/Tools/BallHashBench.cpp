@@ -0,0 +1,224 @@
+/******************************************************************************/
+/*!
+\file		BallHashBench.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 26, 2023
+\brief
+	Times the ball hash: the rebuild after every ball moved (what a step
+	costs) and the region, radius and nearest queries, for random balls
+	(radius 2 to 6, about one ball per 400 square units). The first
+	queries are checked against a scan of every ball.
+
+	BallHashBench [balls ...]			(10000 100000 1000000 by default)
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace
+{
+	const float			AREA_PER_BALL	= 400.0f;
+	const float			RADIUS_MIN		= 2.0f;
+	const float			RADIUS_MAX		= 6.0f;
+	const float			BALL_STEP		= 2.0f;		// move of a ball between two rebuilds, on each axis
+	const float			REGION_SIZE		= 50.0f;
+	const float			QUERY_RADIUS	= 30.0f;
+	const unsigned int	NEAREST_NUM		= 8;
+	const unsigned int	REBUILD_NUM		= 10;
+	const unsigned int	QUERY_NUM		= 100000;
+	const unsigned int	CHECK_NUM		= 1000;		// queries checked against the scan
+	const unsigned int	OUT_MAX			= 4096;
+
+	typedef std::chrono::steady_clock Clock;
+
+	double Seconds(Clock::time_point start)
+	{
+		return std::chrono::duration<double>(Clock::now() - start).count();
+	}
+
+	/**************************************************************************/
+	/*!
+		Balls touching a box or a circle, the slow way
+	 */
+	/**************************************************************************/
+	std::vector<unsigned int> ScanRegion(const std::vector<Circle> &balls, const CSD1130::Vec2 &boxMin, const CSD1130::Vec2 &boxMax)
+	{
+		std::vector<unsigned int> found;
+		for (unsigned int i = 0; i < balls.size(); ++i)
+		{
+			const Circle &ball = balls[i];
+			float dx = std::max(std::max(boxMin.x - ball.m_center.x, ball.m_center.x - boxMax.x), 0.0f);
+			float dy = std::max(std::max(boxMin.y - ball.m_center.y, ball.m_center.y - boxMax.y), 0.0f);
+
+			if (dx * dx + dy * dy <= ball.m_radius * ball.m_radius)
+				found.push_back(i);
+		}
+		return found;
+	}
+
+	std::vector<unsigned int> ScanRadius(const std::vector<Circle> &balls, const CSD1130::Vec2 &center, float radius)
+	{
+		std::vector<unsigned int> found;
+		for (unsigned int i = 0; i < balls.size(); ++i)
+		{
+			float dx = balls[i].m_center.x - center.x, dy = balls[i].m_center.y - center.y;
+			float reach = balls[i].m_radius + radius;
+
+			if (dx * dx + dy * dy <= reach * reach)
+				found.push_back(i);
+		}
+		return found;
+	}
+
+	/**************************************************************************/
+	/*!
+		Same balls, in any order
+	 */
+	/**************************************************************************/
+	bool SameBalls(std::vector<unsigned int> found, std::vector<unsigned int> expected)
+	{
+		std::sort(found.begin(), found.end());
+		std::sort(expected.begin(), expected.end());
+		return found == expected;
+	}
+
+	/**************************************************************************/
+	/*!
+		Benchmarks ballNum balls, returns false if a query disagreed with
+		the scan
+	 */
+	/**************************************************************************/
+	bool BenchBallHash(unsigned int ballNum)
+	{
+		std::mt19937 random(ballNum);
+		float side = sqrtf(ballNum * AREA_PER_BALL);
+
+		std::uniform_real_distribution<float> field(-0.5f * side, 0.5f * side), radius(RADIUS_MIN, RADIUS_MAX),
+			step(-BALL_STEP, BALL_STEP);
+
+		std::vector<Circle> balls(ballNum);
+		for (Circle &ball : balls)
+		{
+			ball.m_center	= CSD1130::Vec2{ field(random), field(random) };
+			ball.m_radius	= radius(random);
+		}
+
+		BallHash hash;
+		InitBallHash(hash, ballNum, 2.0f * RADIUS_MAX);
+		BuildBallHash(hash, balls.data());
+
+		// the balls move, the table is built again
+		double rebuild = 0.0;
+		for (unsigned int r = 0; r < REBUILD_NUM; ++r)
+		{
+			for (Circle &ball : balls)
+			{
+				ball.m_center.x += step(random);
+				ball.m_center.y += step(random);
+			}
+
+			Clock::time_point start = Clock::now();
+			BuildBallHash(hash, balls.data());
+			rebuild += Seconds(start);
+		}
+
+		std::vector<CSD1130::Vec2> points(QUERY_NUM);
+		for (CSD1130::Vec2 &pt : points)
+			pt = CSD1130::Vec2{ field(random), field(random) };
+
+		std::vector<unsigned int> out(OUT_MAX);
+		std::vector<float> distSq(NEAREST_NUM);
+		unsigned long long total = 0;
+		unsigned int wrong = 0;
+
+		Clock::time_point start = Clock::now();
+		for (const CSD1130::Vec2 &pt : points)
+			total += QueryBallHashRegion(hash, pt, CSD1130::Vec2{ pt.x + REGION_SIZE, pt.y + REGION_SIZE }, out.data(), OUT_MAX);
+		double region = Seconds(start);
+
+		start = Clock::now();
+		for (const CSD1130::Vec2 &pt : points)
+			total += QueryBallHashRadius(hash, pt, QUERY_RADIUS, out.data(), OUT_MAX);
+		double circle = Seconds(start);
+
+		start = Clock::now();
+		for (const CSD1130::Vec2 &pt : points)
+			total += QueryBallHashNearest(hash, pt, NEAREST_NUM, out.data(), distSq.data());
+		double nearest = Seconds(start);
+
+		// the same queries, the slow way
+		for (unsigned int q = 0; q < CHECK_NUM; ++q)
+		{
+			const CSD1130::Vec2 &pt = points[q];
+			CSD1130::Vec2 boxMax{ pt.x + REGION_SIZE, pt.y + REGION_SIZE };
+
+			unsigned int num = QueryBallHashRegion(hash, pt, boxMax, out.data(), OUT_MAX);
+			if (!SameBalls(std::vector<unsigned int>(out.begin(), out.begin() + num), ScanRegion(balls, pt, boxMax)))
+				++wrong;
+
+			num = QueryBallHashRadius(hash, pt, QUERY_RADIUS, out.data(), OUT_MAX);
+			if (!SameBalls(std::vector<unsigned int>(out.begin(), out.begin() + num), ScanRadius(balls, pt, QUERY_RADIUS)))
+				++wrong;
+
+			// the k-th distance has to be the k-th smallest of them all
+			num = QueryBallHashNearest(hash, pt, NEAREST_NUM, out.data(), distSq.data());
+
+			std::vector<float> all(ballNum);
+			for (unsigned int i = 0; i < ballNum; ++i)
+				all[i] = CSD1130::Vector2DSquareDistance(balls[i].m_center, pt);
+			std::nth_element(all.begin(), all.begin() + (num - 1), all.end());
+
+			if (num != std::min(NEAREST_NUM, ballNum) || distSq[num - 1] != all[num - 1])
+				++wrong;
+		}
+
+		FreeBallHash(hash);
+
+		printf("%8u  %9.3f ms  %9.3f us  %9.3f us  %9.3f us  %s\n", ballNum, rebuild / REBUILD_NUM * 1.0e3,
+			region / QUERY_NUM * 1.0e6, circle / QUERY_NUM * 1.0e6, nearest / QUERY_NUM * 1.0e6,
+			wrong ? "MISMATCH" : "ok");
+
+		// keeps the queries from being optimized away
+		if (total == 0)
+			printf("no ball found\n");
+
+		return wrong == 0;
+	}
+}
+
+/******************************************************************************/
+/*!
+	Starting point of the benchmark
+*/
+/******************************************************************************/
+int main(int argc, char **argv)
+{
+	std::vector<unsigned int> sizes;
+	for (int a = 1; a < argc; ++a)
+		sizes.push_back((unsigned int)atoi(argv[a]));
+
+	if (sizes.empty())
+		sizes = { 10000, 100000, 1000000 };
+
+	printf("   balls    rebuild      region %gx%g  radius %g   %u-nearest   vs scan\n", REGION_SIZE, REGION_SIZE,
+		QUERY_RADIUS, NEAREST_NUM);
+
+	bool ok = true;
+	for (unsigned int ballNum : sizes)
+		ok = BenchBallHash(ballNum) && ok;
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+/******************************************************************************/
+/*!
+\file		BatchCheck.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 26, 2023
+\brief
+	Checks that a batch of worlds steps the same whatever the number of
+	threads: copies of a level (each with its own step, so no two worlds
+	are alike) are stepped by a batch with 1 thread and by one with a
+	thread per hardware thread (2 at least), and their balls are compared
+	bit for bit.
+
+	BatchCheck <level> [worlds] [steps] [threads]		(16 worlds, 300 steps)
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	const float			STEP_DT			= 0.01667f;		// as the game steps
+	const float			STEP_DT_SPREAD	= 0.001f;		// world w steps STEP_DT * (1 + w * STEP_DT_SPREAD)
+	const unsigned int	STEPS_PER_CALL	= 10;			// steps of each StepCageBatch
+
+	/**************************************************************************/
+	/*!
+		Steps worldNum copies of the level steps times with threadNum
+		threads, the balls of the batch in pos and vel. Returns the seconds
+		it took
+	 */
+	/**************************************************************************/
+	double StepCopies(const CageLevel &level, unsigned int worldNum, unsigned int steps, unsigned int threadNum,
+						std::vector<CSD1130::Vec2> &pos, std::vector<CSD1130::Vec2> &vel)
+	{
+		std::vector<CageWorld> worlds(worldNum);
+		for (unsigned int w = 0; w < worldNum; ++w)
+		{
+			BuildCageWorld(worlds[w], level, 1, 0);
+			worlds[w].m_dt = STEP_DT * (1.0f + w * STEP_DT_SPREAD);
+		}
+
+		CageBatch batch;
+		InitCageBatch(batch, worlds.data(), worldNum, threadNum);
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		for (unsigned int s = 0; s < steps; s += STEPS_PER_CALL)
+			StepCageBatch(batch, (steps - s < STEPS_PER_CALL) ? steps - s : STEPS_PER_CALL);
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		pos.assign(batch.m_pos, batch.m_pos + batch.m_ballStart[worldNum]);
+		vel.assign(batch.m_vel, batch.m_vel + batch.m_ballStart[worldNum]);
+
+		FreeCageBatch(batch);
+		for (CageWorld &world : worlds)
+			FreeCageWorld(world);
+
+		return seconds;
+	}
+}
+
+/******************************************************************************/
+/*!
+	Starting point of the check
+*/
+/******************************************************************************/
+int main(int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: %s <level> [worlds] [steps] [threads]\n", argv[0]);
+		return 2;
+	}
+
+	unsigned int worldNum	= (argc > 2) ? (unsigned int)atoi(argv[2]) : 16;
+	unsigned int steps		= (argc > 3) ? (unsigned int)atoi(argv[3]) : 300;
+	unsigned int threadNum	= (argc > 4) ? (unsigned int)atoi(argv[4]) : std::thread::hardware_concurrency();
+
+	if (threadNum < 2)
+		threadNum = 2;
+
+	CageLevel level;
+	if (!ReadCageLevel(level, argv[1]))
+	{
+		fprintf(stderr, "can't read the level %s\n", argv[1]);
+		return 2;
+	}
+
+	std::vector<CSD1130::Vec2> pos1, vel1, posN, velN;
+	double seconds1 = StepCopies(level, worldNum, steps, 1, pos1, vel1);
+	double secondsN = StepCopies(level, worldNum, steps, threadNum, posN, velN);
+
+	FreeCageLevel(level);
+
+	// bit for bit, -0.0f and 0.0f included
+	unsigned int wrong = 0;
+	for (size_t k = 0; k < pos1.size(); ++k)
+		if (memcmp(&pos1[k], &posN[k], sizeof(CSD1130::Vec2)) != 0 || memcmp(&vel1[k], &velN[k], sizeof(CSD1130::Vec2)) != 0)
+			++wrong;
+
+	printf("%u worlds x %u steps, %u balls: 1 thread %.3f s, %u threads %.3f s\n", worldNum, steps,
+		(unsigned int)pos1.size(), seconds1, threadNum, secondsN);
+	printf("%s: %u balls differ\n", wrong ? "FAIL" : "pass", wrong);
+
+	return wrong ? 1 : 0;
+}
@@ -0,0 +1,173 @@
+/******************************************************************************/
+/*!
+\file		EventCheck.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 26, 2023
+\brief
+	Checks the event driven simulation (m_eventDriven) against the stepped
+	one, ball collisions off (the event driven one has none):
+
+	- step by step: the balls of the event driven world are handed to a
+	  stepped world, both take one step, and every ball has to land within
+	  EVENT_STEP_TOLERANCE of itself. An impact queued late (or not at all)
+	  lets a ball go into the cage for a step and fails this
+	- over the whole run: how far apart the two worlds get, each on its
+	  own from the level, is printed but not checked. They round
+	  differently (the event driven one goes from where the ball last
+	  bounced, the stepped one adds up its steps), and each bounce off a
+	  pillar or a wall end multiplies the difference (3 to 5 times in a
+	  dense pillar field), so the drift says how chaotic the level is,
+	  not whether the impacts are right
+
+	EventCheck <level> [steps] [mode]				(600 steps, mode 1)
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace
+{
+	const float			STEP_DT					= 0.01667f;		// as the game steps
+	const float			EVENT_STEP_TOLERANCE	= 0.01f;		// one step from the same balls
+
+	/**************************************************************************/
+	/*!
+		Ball positions of the world, in the order of the level
+	 */
+	/**************************************************************************/
+	void BallPositions(const CageWorld &world, std::vector<CSD1130::Vec2> &pos)
+	{
+		pos.resize(world.m_ballNum);
+		for (unsigned int i = 0; i < world.m_ballNum; ++i)
+			pos[world.m_ballId[i]] = world.m_ballData[i].m_center;
+	}
+
+	/**************************************************************************/
+	/*!
+		Farthest apart a ball is in the two, and which
+	 */
+	/**************************************************************************/
+	float Farthest(const std::vector<CSD1130::Vec2> &a, const std::vector<CSD1130::Vec2> &b, unsigned int &ball)
+	{
+		float farthest = 0.0f;
+		for (unsigned int k = 0; k < a.size(); ++k)
+		{
+			float d = hypotf(a[k].x - b[k].x, a[k].y - b[k].y);
+			if (d > farthest)
+			{
+				farthest	= d;
+				ball		= k;
+			}
+		}
+		return farthest;
+	}
+
+	/**************************************************************************/
+	/*!
+		Builds the world of the level, stepped or event driven
+	 */
+	/**************************************************************************/
+	void BuildWorld(CageWorld &world, const CageLevel &level, int mode)
+	{
+		BuildCageWorld(world, level, 1, 0);
+		world.m_dt				= STEP_DT;
+		world.m_ballCollisions	= 0;
+		world.m_eventDriven		= mode;
+	}
+}
+
+/******************************************************************************/
+/*!
+	Starting point of the check
+*/
+/******************************************************************************/
+int main(int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: %s <level> [steps] [mode]\n", argv[0]);
+		return 2;
+	}
+
+	unsigned int steps	= (argc > 2) ? (unsigned int)atoi(argv[2]) : 600;
+	int mode			= (argc > 3) ? atoi(argv[3]) : 1;
+
+	CageLevel level;
+	if (!ReadCageLevel(level, argv[1]))
+	{
+		fprintf(stderr, "can't read the level %s\n", argv[1]);
+		return 2;
+	}
+
+	// events against one stepped step from the same balls
+	CageWorld events, follower, stepped;
+	BuildWorld(events, level, mode);
+	BuildWorld(follower, level, 0);
+	BuildWorld(stepped, level, 0);
+
+	std::vector<CageWorldBall> balls(events.m_ballNum);
+	std::vector<CSD1130::Vec2> posEvents, posFollower, posStepped;
+
+	float stepError = 0.0f, drift = 0.0f;
+	unsigned int stepErrorStep = 0, stepErrorBall = 0, driftStep = 0, driftBall = 0;
+
+	for (unsigned int s = 0; s < steps; ++s)
+	{
+		for (unsigned int i = 0; i < events.m_ballNum; ++i)
+		{
+			balls[i].m_id		= events.m_ballId[i];
+			balls[i].m_ball		= events.m_ballData[i];
+			balls[i].m_vel		= events.m_ballVel[i];
+			balls[i].m_speed	= events.m_ballSpeed[i];
+		}
+		ReplaceCageWorldBalls(follower, balls.data(), (unsigned int)balls.size());
+
+		StepCageWorld(events);
+		StepCageWorld(follower);
+		StepCageWorld(stepped);
+
+		BallPositions(events, posEvents);
+		BallPositions(follower, posFollower);
+		BallPositions(stepped, posStepped);
+
+		unsigned int ball = 0;
+		float error = Farthest(posEvents, posFollower, ball);
+		if (error > stepError)
+		{
+			stepError		= error;
+			stepErrorStep	= s;
+			stepErrorBall	= ball;
+		}
+
+		float d = Farthest(posEvents, posStepped, ball);
+		if (d > drift)
+		{
+			drift		= d;
+			driftStep	= s;
+			driftBall	= ball;
+		}
+	}
+
+	FreeCageWorld(events);
+	FreeCageWorld(follower);
+	FreeCageWorld(stepped);
+	FreeCageLevel(level);
+
+	bool stepOk = stepError <= EVENT_STEP_TOLERANCE;
+
+	printf("%u steps apart: max drift %g (ball %u, step %u)\n", steps, drift, driftBall, driftStep);
+	printf("%s: one step from the same balls, max error %g (ball %u, step %u), bound %g\n", stepOk ? "pass" : "FAIL",
+		stepError, stepErrorBall, stepErrorStep, EVENT_STEP_TOLERANCE);
+
+	return stepOk ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+/******************************************************************************/
+/*!
+\file		FastBallCheck.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 26, 2023
+\brief
+	Checks that balls going much further in a step than CONTACT_REACH stay
+	in the cage: every ball of a level is set at one high speed, and the
+	level is stepped in float and in fixed point, with and without the
+	ball collisions. A ball whose center leaves the box of the walls went
+	through one.
+
+	FastBallCheck <level> [speed] [steps]			(2000, 600 steps)
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace
+{
+	/**************************************************************************/
+	/*!
+		Steps the level steps times, returns false (and says where) as soon
+		as a ball is out of the box of the walls
+	 */
+	/**************************************************************************/
+	bool StaysInside(const CageLevel &level, int fixedPoint, int ballCollisions, unsigned int steps,
+					const CSD1130::Vec2 &boxMin, const CSD1130::Vec2 &boxMax)
+	{
+		CageWorld world;
+		BuildCageWorld(world, level, 1, fixedPoint);
+		world.m_ballCollisions = ballCollisions;
+
+		bool inside = true;
+		for (unsigned int k = 0; k < steps && inside; ++k)
+		{
+			StepCageWorld(world);
+
+			for (unsigned int i = 0; i < world.m_ballNum && inside; ++i)
+			{
+				const CSD1130::Vec2 &pos = world.m_ballData[i].m_center;
+
+				inside = pos.x >= boxMin.x && pos.x <= boxMax.x && pos.y >= boxMin.y && pos.y <= boxMax.y;
+				if (!inside)
+					printf("  ball %u out at step %u: %g, %g (speed %g)\n", world.m_ballId[i], k, pos.x, pos.y,
+						world.m_ballSpeed[i]);
+			}
+		}
+
+		FreeCageWorld(world);
+		return inside;
+	}
+}
+
+/******************************************************************************/
+/*!
+	Starting point of the check
+*/
+/******************************************************************************/
+int main(int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: %s <level> [speed] [steps]\n", argv[0]);
+		return 2;
+	}
+
+	float speed			= (argc > 2) ? (float)atof(argv[2]) : 2000.0f;
+	unsigned int steps	= (argc > 3) ? (unsigned int)atoi(argv[3]) : 600;
+
+	CageLevel level;
+	if (!ReadCageLevel(level, argv[1]) || level.m_wallNum == 0)
+	{
+		fprintf(stderr, "can't read the level %s\n", argv[1]);
+		return 2;
+	}
+
+	for (unsigned int i = 0; i < level.m_ballNum; ++i)
+		level.m_balls[i].m_speed = speed;
+
+	CSD1130::Vec2 boxMin = level.m_wallPts[0];
+	CSD1130::Vec2 boxMax = level.m_wallPts[0];
+	for (unsigned int p = 1; p < level.m_wallNum * 2; ++p)
+	{
+		const CSD1130::Vec2 &pt = level.m_wallPts[p];
+		boxMin.x = (pt.x < boxMin.x) ? pt.x : boxMin.x;
+		boxMin.y = (pt.y < boxMin.y) ? pt.y : boxMin.y;
+		boxMax.x = (pt.x > boxMax.x) ? pt.x : boxMax.x;
+		boxMax.y = (pt.y > boxMax.y) ? pt.y : boxMax.y;
+	}
+
+	unsigned int failNum = 0;
+	for (int fixedPoint = 0; fixedPoint < 2; ++fixedPoint)
+	{
+		for (int ballCollisions = 0; ballCollisions < 2; ++ballCollisions)
+		{
+			bool ok = StaysInside(level, fixedPoint, ballCollisions, steps, boxMin, boxMax);
+			printf("%s, ball collisions %s: %s\n", fixedPoint ? "fixed" : "float", ballCollisions ? "on" : "off",
+				ok ? "pass" : "FAIL");
+
+			failNum += ok ? 0 : 1;
+		}
+	}
+
+	printf("%u balls at %g x %u steps: %s\n", level.m_ballNum, speed, steps, failNum ? "FAIL" : "pass");
+
+	FreeCageLevel(level);
+	return failNum ? 1 : 0;
+}
@@ -0,0 +1,190 @@
+/******************************************************************************/
+/*!
+\file		FastMathCheck.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 26, 2023
+\brief
+	Checks the fast math paths (CSD1130_FAST_MATH): each fast function
+	against its precise version (in double) and its own error bound, and
+	the balls of a level against their precise paths, within
+	FAST_MATH_DRIFT_MAX. Built twice (see the Makefile): the precise build
+	records the ball positions of the level step by step, the fast build
+	steps the same level and compares. The level is stepped without ball
+	collisions: they are chaotic, and would measure the level instead.
+
+	FastMathCheck <level> record <file> [steps]
+	FastMathCheckFast <level> compare <file> [steps]
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+	const float		STEP_DT			= 0.01667f;		// as the game steps
+	const int		KERNEL_SAMPLES	= 1000000;		// inputs each fast function is tried with
+	const float		ANGLE_MAX		= 1000.0f;		// FastSinCos is tried on [-ANGLE_MAX, ANGLE_MAX]
+
+	/**************************************************************************/
+	/*!
+		Ball positions of the world, in the order of the level
+	 */
+	/**************************************************************************/
+	void BallPositions(const CageWorld &world, std::vector<CSD1130::Vec2> &pos)
+	{
+		pos.resize(world.m_ballNum);
+		for (unsigned int i = 0; i < world.m_ballNum; ++i)
+			pos[world.m_ballId[i]] = world.m_ballData[i].m_center;
+	}
+
+	/**************************************************************************/
+	/*!
+		Largest error of each fast function over random inputs, against
+		the same function in double. Returns false if one is over its bound
+	 */
+	/**************************************************************************/
+	bool CheckKernels()
+	{
+		std::mt19937 random(1130);
+		std::uniform_real_distribution<float> angles(-ANGLE_MAX, ANGLE_MAX);
+		std::uniform_real_distribution<float> coords(-1000.0f, 1000.0f);
+		std::uniform_real_distribution<double> exponents(-20.0, 26.0);
+
+		double sinCosError = 0.0, rsqrtError = 0.0, normalizeError = 0.0;
+
+		for (int k = 0; k < KERNEL_SAMPLES; ++k)
+		{
+			float angle = angles(random), s, c;
+			CSD1130::FastSinCos(angle, s, c);
+			sinCosError = fmax(sinCosError, fmax(fabs(s - sin((double)angle)), fabs(c - cos((double)angle))));
+
+			float x = (float)exp2(exponents(random));
+			rsqrtError = fmax(rsqrtError, fabs(CSD1130::FastRSqrt(x) * sqrt((double)x) - 1.0));
+
+			CSD1130::Vec2 v{ coords(random), coords(random) }, dir;
+			float len		= CSD1130::Vector2DNormalizeLength(dir, v);
+			double length	= hypot((double)v.x, (double)v.y);
+
+			if (length > 0.0)
+				normalizeError = fmax(normalizeError, fmax(fabs(len / length - 1.0),
+					fmax(fabs(dir.x - v.x / length), fabs(dir.y - v.y / length))));
+		}
+
+		bool sinCosOk		= sinCosError <= CSD1130::FAST_SINCOS_ERROR_MAX;
+		bool rsqrtOk		= rsqrtError <= CSD1130::FAST_RSQRT_ERROR_MAX;
+		bool normalizeOk	= normalizeError <= CSD1130::FAST_RSQRT_ERROR_MAX;
+
+		printf("%s: FastSinCos max error %g, bound %g\n", sinCosOk ? "pass" : "FAIL", sinCosError,
+			CSD1130::FAST_SINCOS_ERROR_MAX);
+		printf("%s: FastRSqrt max relative error %g, bound %g\n", rsqrtOk ? "pass" : "FAIL", rsqrtError,
+			CSD1130::FAST_RSQRT_ERROR_MAX);
+		printf("%s: Vector2DNormalizeLength max relative error %g, bound %g\n", normalizeOk ? "pass" : "FAIL",
+			normalizeError, CSD1130::FAST_RSQRT_ERROR_MAX);
+
+		return sinCosOk && rsqrtOk && normalizeOk;
+	}
+}
+
+/******************************************************************************/
+/*!
+	Starting point of the check
+*/
+/******************************************************************************/
+int main(int argc, char **argv)
+{
+	if (argc < 4 || (strcmp(argv[2], "record") != 0 && strcmp(argv[2], "compare") != 0))
+	{
+		fprintf(stderr, "usage: %s <level> record|compare <file> [steps]\n", argv[0]);
+		return 2;
+	}
+
+	bool record			= (strcmp(argv[2], "record") == 0);
+	unsigned int steps	= (argc > 4) ? (unsigned int)atoi(argv[4]) : CSD1130::FAST_MATH_DRIFT_STEPS;
+
+	CageLevel level;
+	if (!ReadCageLevel(level, argv[1]))
+	{
+		fprintf(stderr, "can't read the level %s\n", argv[1]);
+		return 2;
+	}
+
+	CageWorld world;
+	BuildCageWorld(world, level, 1, 0);
+	world.m_dt				= STEP_DT;
+	world.m_ballCollisions	= 0;
+
+	FILE *pFile = fopen(argv[3], record ? "wb" : "rb");
+	if (pFile == 0)
+	{
+		fprintf(stderr, "can't open %s\n", argv[3]);
+		return 2;
+	}
+
+	std::vector<CSD1130::Vec2> pos, precise(world.m_ballNum);
+	float drift = 0.0f;
+	unsigned int driftStep = 0, driftBall = 0;
+	bool ok = true;
+
+	for (unsigned int s = 0; s < steps && ok; ++s)
+	{
+		StepCageWorld(world);
+		BallPositions(world, pos);
+
+		if (record)
+		{
+			ok = fwrite(pos.data(), sizeof(CSD1130::Vec2), pos.size(), pFile) == pos.size();
+			continue;
+		}
+
+		if (fread(precise.data(), sizeof(CSD1130::Vec2), precise.size(), pFile) != precise.size())
+		{
+			fprintf(stderr, "%s holds less than %u steps of this level\n", argv[3], steps);
+			ok = false;
+			break;
+		}
+
+		for (unsigned int k = 0; k < world.m_ballNum; ++k)
+		{
+			float d = hypotf(pos[k].x - precise[k].x, pos[k].y - precise[k].y);
+			if (d > drift)
+			{
+				drift		= d;
+				driftStep	= s;
+				driftBall	= k;
+			}
+		}
+	}
+
+	fclose(pFile);
+	FreeCageWorld(world);
+	FreeCageLevel(level);
+
+	if (!ok)
+		return 1;
+
+	if (record)
+	{
+		printf("recorded %u steps of %u balls\n", steps, (unsigned int)pos.size());
+		return 0;
+	}
+
+	bool pass = drift < CSD1130::FAST_MATH_DRIFT_MAX;
+	printf("%s: max drift %g (ball %u, step %u) over %u steps, bound %g\n", pass ? "pass" : "FAIL", drift, driftBall,
+		driftStep, steps, CSD1130::FAST_MATH_DRIFT_MAX);
+
+	pass = CheckKernels() && pass;
+
+	return pass ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+/******************************************************************************/
+/*!
+\file		FixedPointCheck.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 26, 2023
+\brief
+	Checks that the fixed-point simulation steps the same bits whatever
+	it is built with: a level is stepped in fixed point and the checksum
+	of the world (m_simChecksum) is recorded after every step, then
+	compared step by step by another build (the fast math one in the
+	Makefile, or the same tool built on another machine or compiler).
+
+	FixedPointCheck <level> record <file> [steps]		(600 steps)
+	FixedPointCheck <level> compare <file> [steps]
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************/
+/*!
+	Starting point of the check
+*/
+/******************************************************************************/
+int main(int argc, char **argv)
+{
+	if (argc < 4 || (strcmp(argv[2], "record") != 0 && strcmp(argv[2], "compare") != 0))
+	{
+		fprintf(stderr, "usage: %s <level> record|compare <file> [steps]\n", argv[0]);
+		return 2;
+	}
+
+	bool record			= (strcmp(argv[2], "record") == 0);
+	unsigned int steps	= (argc > 4) ? (unsigned int)atoi(argv[4]) : 600;
+
+	CageLevel level;
+	if (!ReadCageLevel(level, argv[1]))
+	{
+		fprintf(stderr, "can't read the level %s\n", argv[1]);
+		return 2;
+	}
+
+	FILE *pFile = fopen(argv[3], record ? "wb" : "rb");
+	if (pFile == 0)
+	{
+		fprintf(stderr, "can't open %s\n", argv[3]);
+		FreeCageLevel(level);
+		return 2;
+	}
+
+	CageWorld world;
+	BuildCageWorld(world, level, 1, 1);
+
+	unsigned long long recorded = 0;
+	unsigned int wrongStep = steps;
+	bool ok = true;
+
+	for (unsigned int s = 0; s < steps && ok && wrongStep == steps; ++s)
+	{
+		StepCageWorld(world);
+
+		if (record)
+			ok = fwrite(&world.m_simChecksum, sizeof(world.m_simChecksum), 1, pFile) == 1;
+		else if (fread(&recorded, sizeof(recorded), 1, pFile) != 1)
+		{
+			fprintf(stderr, "%s holds less than %u steps of this level\n", argv[3], steps);
+			ok = false;
+		}
+		else if (recorded != world.m_simChecksum)
+			wrongStep = s;
+	}
+
+	unsigned long long checksum = world.m_simChecksum;
+
+	fclose(pFile);
+	FreeCageWorld(world);
+	FreeCageLevel(level);
+
+	if (!ok)
+		return 1;
+
+	if (record)
+	{
+		printf("recorded %u steps, checksum %016llX\n", steps, checksum);
+		return 0;
+	}
+
+	if (wrongStep != steps)
+	{
+		printf("FAIL: checksum %016llX at step %u, recorded %016llX\n", checksum, wrongStep, recorded);
+		return 1;
+	}
+
+	printf("pass: %u steps, checksum %016llX\n", steps, checksum);
+	return 0;
+}
@@ -0,0 +1,162 @@
+/******************************************************************************/
+/*!
+\file		LevelCheck.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 26, 2023
+\brief
+	Checks that ReadCageLevel turns malformed levels down: a small level
+	with every section is written to a file as it is (it has to be read)
+	and spoiled one way at a time (it has to be refused): counts missing,
+	negative or past what the file holds, sections cut short, negative
+	radii, walls and kinematic walls without length, room walls and portal
+	rooms that aren't there, and a file of positions instead of a level.
+	The levels given after the directory have to be read.
+
+	LevelCheck <directory> [level...]
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+#include <stdio.h>
+#include <string>
+
+namespace
+{
+	/**************************************************************************/
+	/*!
+		The sections of a level file, as text
+	 */
+	/**************************************************************************/
+	struct LevelText
+	{
+		std::string		m_balls		= "2\n"
+									"PosX: 0 PosY: 0 Dir: 30 Speed: 100 Radius: 10\n"
+									"PosX: 50 PosY: 20 Dir: 0 Speed: 80 Radius: 0\n";
+		std::string		m_walls		= "4\n"
+									"P0X: 100 P0Y: -100 P1X: -100 P1Y: -100\n"
+									"P0X: 100 P0Y: 100 P1X: 100 P1Y: -100\n"
+									"P0X: -100 P0Y: 100 P1X: 100 P1Y: 100\n"
+									"P0X: -100 P0Y: -100 P1X: -100 P1Y: 100\n";
+		std::string		m_arcs		= "0\n";
+		std::string		m_pillars	= "1\n"
+									"PosX: 30 PosY: -40 Radius: 5\n";
+		std::string		m_rooms		= "1\n"
+									"MinX: -100 MinY: -100 MaxX: 100 MaxY: 100 Walls: 4 0 1 2 3\n"
+									"0\n";
+		std::string		m_kinematic	= "1\n"
+									"P0X: -20 P0Y: 50 P1X: 20 P1Y: 50 PivotX: 0 PivotY: 50 VelX: 0 VelY: 0 Spin: 90 Period: 0\n";
+
+		std::string Text() const
+		{
+			return m_balls + m_walls + m_arcs + m_pillars + m_rooms + m_kinematic;
+		}
+	};
+
+	/**************************************************************************/
+	/*!
+		Writes text to path, reads it back as a level, says if that went as
+		expected
+	 */
+	/**************************************************************************/
+	bool ReadAsExpected(const std::string &path, const char *name, const std::string &text, bool good)
+	{
+		FILE *pFile = fopen(path.c_str(), "wb");
+		if (pFile == 0 || fwrite(text.data(), 1, text.size(), pFile) != text.size())
+		{
+			fprintf(stderr, "can't write %s\n", path.c_str());
+			if (pFile)
+				fclose(pFile);
+			return false;
+		}
+		fclose(pFile);
+
+		CageLevel level;
+		bool read = ReadCageLevel(level, path.c_str());
+		FreeCageLevel(level);
+		remove(path.c_str());
+
+		bool ok = (read == good);
+		printf("%s: %s %s\n", ok ? "pass" : "FAIL", name, read ? "read" : "refused");
+		return ok;
+	}
+}
+
+/******************************************************************************/
+/*!
+	Starting point of the check
+*/
+/******************************************************************************/
+int main(int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: %s <directory> [level...]\n", argv[0]);
+		return 2;
+	}
+
+	std::string path = std::string(argv[1]) + "/LevelCheck.txt";
+	unsigned int failNum = 0;
+
+	LevelText good;
+	failNum += ReadAsExpected(path, "whole level", good.Text(), true) ? 0 : 1;
+	failNum += ReadAsExpected(path, "balls and walls only", good.m_balls + good.m_walls, true) ? 0 : 1;
+
+	struct Spoiled
+	{
+		const char		*m_name;
+		std::string		LevelText::*m_section;
+		const char		*m_text;
+	};
+
+	const Spoiled spoiled[] =
+	{
+		{ "empty file",					&LevelText::m_balls,		"" },
+		{ "negative ball count",		&LevelText::m_balls,		"-2\nPosX: 0 PosY: 0 Dir: 30 Speed: 100 Radius: 10\n" },
+		{ "ball count past the file",	&LevelText::m_balls,		"1000000000\nPosX: 0 PosY: 0 Dir: 30 Speed: 100 Radius: 10\n" },
+		{ "balls cut short",			&LevelText::m_balls,		"3\nPosX: 0 PosY: 0 Dir: 30 Speed: 100 Radius: 10\n" },
+		{ "ball cut short",				&LevelText::m_balls,		"1\nPosX: 0 PosY: 0 Dir: 30 Speed: 100\n" },
+		{ "negative ball radius",		&LevelText::m_balls,		"1\nPosX: 0 PosY: 0 Dir: 30 Speed: 100 Radius: -10\n" },
+		{ "no wall count",				&LevelText::m_walls,		"" },
+		{ "walls cut short",			&LevelText::m_walls,		"2\nP0X: 100 P0Y: -100 P1X: -100 P1Y: -100\n" },
+		{ "wall without length",		&LevelText::m_walls,		"1\nP0X: 100 P0Y: -100 P1X: 100 P1Y: -100\n" },
+		{ "arc without radius",			&LevelText::m_arcs,			"1\nPosX: 0 PosY: 0 Radius: 0 Angle0: 0 Angle1: 90\n" },
+		{ "pillar count not a number",	&LevelText::m_pillars,		"Pillars\nPosX: 30 PosY: -40 Radius: 5\n" },
+		{ "negative pillar radius",		&LevelText::m_pillars,		"1\nPosX: 30 PosY: -40 Radius: -5\n" },
+		{ "pillars cut short",			&LevelText::m_pillars,		"2\nPosX: 30 PosY: -40 Radius: 5\n" },
+		{ "room wall not there",		&LevelText::m_rooms,		"1\nMinX: -100 MinY: -100 MaxX: 100 MaxY: 100 Walls: 2 0 7\n0\n" },
+		{ "portal room not there",		&LevelText::m_rooms,		"1\nMinX: -100 MinY: -100 MaxX: 100 MaxY: 100 Walls: 1 0\n"
+																	"1\nP0X: 0 P0Y: -100 P1X: 0 P1Y: 100 Front: 0 Back: 3\n" },
+		{ "kinematic wall without length", &LevelText::m_kinematic,	"1\nP0X: 20 P0Y: 50 P1X: 20 P1Y: 50 PivotX: 0 PivotY: 50 VelX: 0 VelY: 0 Spin: 90 Period: 0\n" },
+		{ "kinematic walls cut short",	&LevelText::m_kinematic,	"2\nP0X: -20 P0Y: 50 P1X: 20 P1Y: 50 PivotX: 0 PivotY: 50 VelX: 0 VelY: 0 Spin: 90 Period: 0\n" },
+		{ "kinematic wall cut short",	&LevelText::m_kinematic,	"1\nP0X: -20 P0Y: 50 P1X: 20 P1Y: 50 PivotX: 0 PivotY: 50\n" },
+	};
+
+	for (const Spoiled &s : spoiled)
+	{
+		LevelText level;
+		level.*s.m_section = s.m_text;
+		failNum += ReadAsExpected(path, s.m_name, level.Text(), false) ? 0 : 1;
+	}
+
+	// ball positions, as a run of the game prints them
+	failNum += ReadAsExpected(path, "positions file", "-37.14 34.66 38.48\n-26.79 4.54 31.74\n", false) ? 0 : 1;
+
+	for (int i = 2; i < argc; ++i)
+	{
+		CageLevel level;
+		bool read = ReadCageLevel(level, argv[i]);
+		FreeCageLevel(level);
+
+		printf("%s: %s %s\n", read ? "pass" : "FAIL", argv[i], read ? "read" : "refused");
+		failNum += read ? 0 : 1;
+	}
+
+	printf("%s: %u levels not read as expected\n", failNum ? "FAIL" : "pass", failNum);
+	return failNum ? 1 : 0;
+}
@@ -0,0 +1,161 @@
+/******************************************************************************/
+/*!
+\file		ScalarBench.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 26, 2023
+\brief
+	Times CollisionIntersection_CircleLineSegment for each scalar type
+	(float, double, Fixed): every moving ball against every wall, the
+	same random balls and walls for each type. Next to the pairs per
+	second: the bytes of balls and walls the test reads per second, and
+	what summing a buffer much larger than the caches reads per second
+	(MEMORY_BUFFER_SIZE). A type that reads much less than the memory
+	gives is held back by its arithmetic, not by the memory.
+
+	ScalarBench [balls] [walls] [rounds]			(2048 balls, 64 walls, 20 rounds)
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace
+{
+	const double	FIELD_SIZE			= 300.0;	// balls and walls in [-FIELD_SIZE, FIELD_SIZE]
+	const double	BALL_RADIUS			= 10.0;
+	const double	BALL_STEP			= 5.0;		// longest move of a ball in a step, on each axis
+	const size_t	MEMORY_BUFFER_SIZE	= 256 << 20;	// bytes, well past the last level cache
+	const int		MEMORY_ROUNDS		= 4;
+
+	/**************************************************************************/
+	/*!
+		What the test of a scalar type did: pairs tested per second
+		(millions), bytes of balls and walls read per second (GB), and the
+		hits found
+	 */
+	/**************************************************************************/
+	struct ScalarResult
+	{
+		double				m_pairs;
+		double				m_bandwidth;
+		unsigned long long	m_hits;
+	};
+
+	/**************************************************************************/
+	/*!
+		Bytes read from memory per second (GB), summing a buffer of
+		MEMORY_BUFFER_SIZE bytes; the sum is returned so the reads stay
+	 */
+	/**************************************************************************/
+	double MemoryBandwidth(unsigned long long &sum)
+	{
+		std::vector<unsigned long long> buffer(MEMORY_BUFFER_SIZE / sizeof(unsigned long long), 1);
+		sum = 0;
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		for (int r = 0; r < MEMORY_ROUNDS; ++r)
+			for (size_t k = 0; k < buffer.size(); ++k)
+				sum += buffer[k];
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return (double)MEMORY_ROUNDS * MEMORY_BUFFER_SIZE / seconds * 1.0e-9;
+	}
+
+	/**************************************************************************/
+	/*!
+		Tests every ball against every wall, rounds times, in scalar type T.
+		A ball (start and end) is read once per round, a wall once per ball
+	 */
+	/**************************************************************************/
+	template <typename T>
+	ScalarResult BenchScalar(unsigned int ballNum, unsigned int wallNum, unsigned int rounds)
+	{
+		std::mt19937 random(1);
+		std::uniform_real_distribution<double> field(-FIELD_SIZE, FIELD_SIZE), step(-BALL_STEP, BALL_STEP);
+
+		std::vector<CircleT<T>> balls(ballNum);
+		std::vector<CSD1130::Vector2DT<T>> ends(ballNum);
+		std::vector<LineSegmentT<T>> walls(wallNum);
+
+		for (unsigned int i = 0; i < ballNum; ++i)
+		{
+			double x = field(random), y = field(random);
+
+			balls[i].m_center	= CSD1130::Vector2DT<T>{ T(x), T(y) };
+			balls[i].m_radius	= T(BALL_RADIUS);
+			ends[i]				= CSD1130::Vector2DT<T>{ T(x + step(random)), T(y + step(random)) };
+		}
+
+		for (unsigned int j = 0; j < wallNum; ++j)
+		{
+			double x0 = field(random), y0 = field(random), x1 = field(random), y1 = field(random);
+			BuildLineSegment(walls[j], CSD1130::Vector2DT<T>{ T(x0), T(y0) }, CSD1130::Vector2DT<T>{ T(x1), T(y1) });
+		}
+
+		CSD1130::Vector2DT<T> interPt, normal;
+		T interTime;
+		unsigned long long hits = 0;
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		for (unsigned int r = 0; r < rounds; ++r)
+			for (unsigned int i = 0; i < ballNum; ++i)
+				for (unsigned int j = 0; j < wallNum; ++j)
+					hits += CollisionIntersection_CircleLineSegment(balls[i], ends[i], walls[j], interPt, normal, interTime, true);
+
+		double seconds	= std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		double bytes	= (double)rounds * ballNum *
+							(sizeof(CircleT<T>) + sizeof(CSD1130::Vector2DT<T>) + (double)wallNum * sizeof(LineSegmentT<T>));
+
+		return ScalarResult{ (double)rounds * ballNum * wallNum / seconds * 1.0e-6, bytes / seconds * 1.0e-9, hits };
+	}
+
+	/**************************************************************************/
+	/*!
+		Prints what the test of a scalar type did
+	 */
+	/**************************************************************************/
+	void PrintResult(const char *name, const ScalarResult &result)
+	{
+		printf("  %-7s %6.1f M pairs/s  %6.2f GB/s read  (%llu hits)\n", name, result.m_pairs, result.m_bandwidth,
+			result.m_hits);
+	}
+}
+
+/******************************************************************************/
+/*!
+	Starting point of the benchmark
+*/
+/******************************************************************************/
+int main(int argc, char **argv)
+{
+	unsigned int ballNum	= (argc > 1) ? (unsigned int)atoi(argv[1]) : 2048;
+	unsigned int wallNum	= (argc > 2) ? (unsigned int)atoi(argv[2]) : 64;
+	unsigned int rounds		= (argc > 3) ? (unsigned int)atoi(argv[3]) : 20;
+
+	ScalarResult resultF = BenchScalar<float>(ballNum, wallNum, rounds);
+	ScalarResult resultD = BenchScalar<double>(ballNum, wallNum, rounds);
+	ScalarResult resultX = BenchScalar<CSD1130::Fixed>(ballNum, wallNum, rounds);
+
+	unsigned long long sum;
+	double memory = MemoryBandwidth(sum);
+
+	printf("%u balls x %u walls, %u rounds\n", ballNum, wallNum, rounds);
+	PrintResult("float", resultF);
+	PrintResult("double", resultD);
+	PrintResult("Fixed", resultX);
+	printf("  memory  %6.2f GB/s read, summing %u MB (sum %llu)\n", memory, (unsigned int)(MEMORY_BUFFER_SIZE >> 20), sum);
+
+	return 0;
+}
@@ -0,0 +1,319 @@
+/******************************************************************************/
+/*!
+\file		ShardRunner.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 26, 2023
+\brief
+	Runs a level as shards (see CageShard.h): one shard space, one forked
+	process per shard, all stepping together. After every step each shard
+	copies its m_owned to a second shared memory, and shard 0 checks that
+	every ball has exactly one owner. At the end the time each shard spent
+	stepping and waiting at the barrier is printed. A shard that fails is
+	named; the others are stopped through m_failed of the space.
+	With stall, that shard hangs halfway (stops stepping, doesn't exit) and
+	the others have to give up at the barrier, SHARD_STALL_TIMEOUT seconds
+	later, on their own.
+	Linux only (fork, wait, shm_open).
+
+	ShardRunner <level> [shards] [steps] [stall]	(4 shards, 600 steps)
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifdef _WIN32
+#error ShardRunner runs the shards as forked processes: Linux only
+#endif
+
+#include "main.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+	const float			STEP_DT					= 0.01667f;		// as the game steps
+	const float			SHARD_STALL_TIMEOUT		= 1.0f;			// m_timeout of the space, with a stalled shard
+
+	// exit status of a shard that gave up at the barrier
+	const int			SHARD_GAVE_UP			= 3;
+
+	/**************************************************************************/
+	/*!
+		Shared by the shards besides their space: the first ball found
+		without exactly one owner, then m_owned of every shard for the even
+		and odd steps ([parity][shard][ball])
+	 */
+	/**************************************************************************/
+	struct OwnerCheck
+	{
+		unsigned int	m_badNum;			// steps with a ball not owned once
+		unsigned int	m_badStep;
+		unsigned int	m_badBall;
+		unsigned int	m_badOwners;
+	};
+
+	size_t OwnerCheckBytes(unsigned int shardNum, unsigned int ballNum)
+	{
+		return sizeof(OwnerCheck) + 2 * (size_t)shardNum * ballNum;
+	}
+
+	unsigned char *Owned(OwnerCheck *pCheck, unsigned int ballNum, unsigned int shardNum, unsigned int step,
+						unsigned int s)
+	{
+		return (unsigned char*)(pCheck + 1) + ((size_t)(step & 1) * shardNum + s) * ballNum;
+	}
+
+	/**************************************************************************/
+	/*!
+		Counts the owners of each ball after step, once every shard has
+		written its m_owned for it. Returns false if one doesn't have one
+		owner
+	 */
+	/**************************************************************************/
+	bool CheckOwners(OwnerCheck *pCheck, unsigned int ballNum, unsigned int shardNum, unsigned int step)
+	{
+		for (unsigned int k = 0; k < ballNum; ++k)
+		{
+			unsigned int owners = 0;
+			for (unsigned int s = 0; s < shardNum; ++s)
+				owners += Owned(pCheck, ballNum, shardNum, step, s)[k];
+
+			if (owners != 1)
+			{
+				if (pCheck->m_badNum++ == 0)
+				{
+					pCheck->m_badStep	= step;
+					pCheck->m_badBall	= k;
+					pCheck->m_badOwners	= owners;
+				}
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**************************************************************************/
+	/*!
+		Body of shard process s. Once StepCageShard returns for step k,
+		every shard has met at its barrier, so they all wrote m_owned for
+		step k - 1; and none writes step k + 1 (same buffer) before shard 0
+		gets to the barrier of step k + 1, after its check.
+		The stalled shard stops halfway and waits, stepping nothing, until
+		the others gave up (twice their timeout at most)
+	 */
+	/**************************************************************************/
+	int RunShard(const char *spaceName, const char *checkName, const CageLevel &level, unsigned int s, unsigned int steps,
+				unsigned int stall)
+	{
+		ShardSpace space;
+		if (!OpenShardSpace(space, spaceName))
+			return 2;
+
+		unsigned int shardNum	= space.m_header->m_shardNum;
+		unsigned int ballNum	= space.m_header->m_ballNum;
+
+		size_t bytes = 0;
+		void *pHandle;
+		OwnerCheck *pCheck = (OwnerCheck*)MapSharedMemory(checkName, bytes, SHARED_ACCESS::ACCESS_WRITE, pHandle);
+		if (pCheck == 0)
+		{
+			FreeShardSpace(space);
+			return 2;
+		}
+
+		CageShard shard;
+		BuildCageShard(shard, space, level, s, 1);
+
+		int result = 0;
+		for (unsigned int k = 0; k < steps; ++k)
+		{
+			if (s == stall && k == steps / 2)
+			{
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				while (space.m_header->m_failed.load() == 0 &&
+					std::chrono::steady_clock::now() - start < std::chrono::duration<float>(2.0f * space.m_header->m_timeout))
+					std::this_thread::sleep_for(std::chrono::milliseconds(10));
+				break;
+			}
+
+			if (!StepCageShard(shard))
+			{
+				fprintf(stderr, "shard %u: stopped at step %u, a shard didn't get to the barrier (failed, or not in %g s)\n", s, k,
+					space.m_header->m_timeout);
+				result = SHARD_GAVE_UP;
+				break;
+			}
+
+			if (s == 0 && k > 0)
+				CheckOwners(pCheck, ballNum, shardNum, k - 1);
+
+			memcpy(Owned(pCheck, ballNum, shardNum, k, s), shard.m_owned, ballNum);
+		}
+
+		FreeCageShard(shard);
+		UnmapSharedMemory(pCheck, bytes, pHandle);
+		FreeShardSpace(space);
+		return result;
+	}
+}
+
+/******************************************************************************/
+/*!
+	Starting point of the runner
+*/
+/******************************************************************************/
+int main(int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: %s <level> [shards] [steps] [stall]\n", argv[0]);
+		return 2;
+	}
+
+	unsigned int shardNum	= (argc > 2) ? (unsigned int)atoi(argv[2]) : 4;
+	unsigned int steps		= (argc > 3) ? (unsigned int)atoi(argv[3]) : 600;
+	unsigned int stall		= (argc > 4) ? (unsigned int)atoi(argv[4]) : shardNum;
+
+	CageLevel level;
+	if (!ReadCageLevel(level, argv[1]))
+	{
+		fprintf(stderr, "can't read the level %s\n", argv[1]);
+		return 2;
+	}
+
+	char spaceName[32], checkName[32];
+	sprintf(spaceName, "CageShard_%d", (int)getpid());
+	sprintf(checkName, "CageShardOwners_%d", (int)getpid());
+
+	ShardSpace space;
+	if (!CreateShardSpace(space, spaceName, level, shardNum, STEP_DT))
+	{
+		fprintf(stderr, "can't make the space of %u shards\n", shardNum);
+		FreeCageLevel(level);
+		return 2;
+	}
+
+	unsigned int ballNum = space.m_header->m_ballNum;
+
+	size_t bytes = OwnerCheckBytes(shardNum, ballNum);
+	void *pHandle;
+	OwnerCheck *pCheck = (OwnerCheck*)MapSharedMemory(checkName, bytes, SHARED_ACCESS::ACCESS_CREATE, pHandle);
+	if (pCheck == 0)
+	{
+		fprintf(stderr, "can't make the shared memory %s\n", checkName);
+		FreeShardSpace(space);
+		FreeCageLevel(level);
+		return 2;
+	}
+
+	if (stall < shardNum)
+		space.m_header->m_timeout = SHARD_STALL_TIMEOUT;
+
+	std::vector<pid_t> shards;
+	bool started = true;
+
+	for (unsigned int s = 0; s < shardNum && started; ++s)
+	{
+		pid_t pid = fork();
+		if (pid == 0)
+			_exit(RunShard(spaceName, checkName, level, s, steps, stall));
+
+		started = (pid > 0);
+		if (started)
+			shards.push_back(pid);
+	}
+
+	// short of one, the others would wait for it at the barrier: they are
+	// told to stop
+	bool ok = started;
+	if (!started)
+	{
+		fprintf(stderr, "can't start the shards\n");
+		space.m_header->m_failed.store(1);
+	}
+
+	unsigned int gaveUpNum = 0;
+	for (size_t left = shards.size(); left > 0; --left)
+	{
+		int status;
+		pid_t pid = wait(&status);
+		if (pid < 0)
+			break;
+
+		unsigned int s = 0;
+		while (s < shards.size() && shards[s] != pid)
+			++s;
+
+		if (WIFEXITED(status) && WEXITSTATUS(status) == 0)
+			continue;
+
+		if (WIFEXITED(status) && WEXITSTATUS(status) == SHARD_GAVE_UP)
+			++gaveUpNum;
+		else if (WIFSIGNALED(status))
+			fprintf(stderr, "shard %u was killed (signal %d)\n", s, WTERMSIG(status));
+		else
+			fprintf(stderr, "shard %u failed (exit %d)\n", s, WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+
+		// the others stop at their next barrier instead of waiting for it
+		space.m_header->m_failed.store(1);
+		ok = false;
+	}
+
+	// the stalled shard is found out by all the others, and only by them
+	if (stall < shardNum)
+	{
+		bool caught = started && gaveUpNum + 1 == shardNum && shards.size() == shardNum;
+
+		printf("%s: shard %u stalled at step %u, %u shards gave up after %g s\n", caught ? "pass" : "FAIL", stall,
+			steps / 2, gaveUpNum, space.m_header->m_timeout);
+
+		UnmapSharedMemory(pCheck, bytes, pHandle);
+		RemoveSharedMemory(checkName);
+		FreeShardSpace(space);
+		FreeCageLevel(level);
+		return caught ? 0 : 1;
+	}
+
+	// the last step, no shard checks it
+	if (ok && steps > 0)
+		CheckOwners(pCheck, ballNum, shardNum, steps - 1);
+
+	if (ok)
+	{
+		printf("%u shards x %u steps, %u balls, halo %g\n", shardNum, steps, ballNum, space.m_header->m_halo);
+		printf("shard  owned  ghosts  migrated  stray    step (s)    wait (s)\n");
+
+		for (unsigned int s = 0; s < shardNum; ++s)
+		{
+			const ShardStats &stats = space.m_stats[s];
+			printf("%5u  %5u  %6u  %8u  %5u  %10.3f  %10.3f\n", s, stats.m_owned, stats.m_ghostNum, stats.m_migrateNum,
+				stats.m_strayNum, stats.m_stepTime, stats.m_waitTime);
+		}
+
+		if (pCheck->m_badNum == 0)
+			printf("pass: every ball had one owner after every step\n");
+		else
+		{
+			printf("FAIL: %u steps with a ball not owned once, first ball %u after step %u (%u owners)\n",
+				pCheck->m_badNum, pCheck->m_badBall, pCheck->m_badStep, pCheck->m_badOwners);
+			ok = false;
+		}
+	}
+
+	UnmapSharedMemory(pCheck, bytes, pHandle);
+	RemoveSharedMemory(checkName);
+	FreeShardSpace(space);
+	FreeCageLevel(level);
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,270 @@
+/******************************************************************************/
+/*!
+\file		StateCheck.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 26, 2023
+\brief
+	Checks the reading end of a state ring (see StateRing.h) against a live
+	publisher: a thread steps a level and publishes every step, as fast as
+	it can, while the reader takes the latest step again and again. What a
+	view gives is copied out, and kept only if StateViewValid still says so
+	afterwards. Once the publisher is done, the reader steps its own world
+	of the level, and at every step it copied the positions, velocities
+	and bounces have to be the same, bit for bit. A reader that took a slot while it was written over
+	fails this.
+	Also checks that a ring too small for the balls publishes nothing.
+
+	StateCheck <level> [steps] [slots]				(3000 steps, 4 slots)
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+#include <atomic>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+	const float			STEP_DT			= 0.01667f;		// as the game steps
+
+	/**************************************************************************/
+	/*!
+		A step as the reader copied it out of the ring
+	 */
+	/**************************************************************************/
+	struct StepCopy
+	{
+		unsigned int				m_step;
+		unsigned int				m_eventNum;
+		unsigned int				m_eventLost;
+		std::vector<CSD1130::Vec2>	m_pos;
+		std::vector<CSD1130::Vec2>	m_vel;
+	};
+
+	/**************************************************************************/
+	/*!
+		Copies the latest step out of the ring. Returns false if there is
+		none, or it was written over while it was copied
+	 */
+	/**************************************************************************/
+	bool CopyLatest(const StateReader &reader, StepCopy &copy)
+	{
+		StateView view;
+		if (!ReadLatestState(reader, view) || view.m_ballNum > reader.m_header->m_ballMax)
+			return false;
+
+		copy.m_step			= view.m_step;
+		copy.m_eventNum		= view.m_eventNum;
+		copy.m_eventLost	= view.m_eventLost;
+		copy.m_pos.assign(view.m_pos, view.m_pos + view.m_ballNum);
+		copy.m_vel.assign(view.m_vel, view.m_vel + view.m_ballNum);
+
+		return StateViewValid(view);
+	}
+
+	/**************************************************************************/
+	/*!
+		Number of balls of the world whose velocity is not the one in vel
+		(by ball of the level), and vel updated
+	 */
+	/**************************************************************************/
+	unsigned int Bounces(const CageWorld &world, std::vector<CSD1130::Vec2> &vel)
+	{
+		unsigned int bounces = 0;
+		for (unsigned int i = 0; i < world.m_ballNum; ++i)
+		{
+			CSD1130::Vec2 &last = vel[world.m_ballId[i]];
+			if (memcmp(&last, &world.m_ballVel[i], sizeof(CSD1130::Vec2)) != 0)
+				++bounces;
+
+			last = world.m_ballVel[i];
+		}
+		return bounces;
+	}
+
+	/**************************************************************************/
+	/*!
+		True if the copy holds the balls of the world, bit for bit
+	 */
+	/**************************************************************************/
+	bool SameBalls(const CageWorld &world, const StepCopy &copy)
+	{
+		if (copy.m_pos.size() != world.m_ballNum)
+			return false;
+
+		for (unsigned int i = 0; i < world.m_ballNum; ++i)
+		{
+			unsigned int k = world.m_ballId[i];
+			if (memcmp(&copy.m_pos[k], &world.m_ballData[i].m_center, sizeof(CSD1130::Vec2)) != 0 ||
+				memcmp(&copy.m_vel[k], &world.m_ballVel[i], sizeof(CSD1130::Vec2)) != 0)
+				return false;
+		}
+		return true;
+	}
+
+	/**************************************************************************/
+	/*!
+		Builds the world of the level, as the publisher and the reader both
+		step it
+	 */
+	/**************************************************************************/
+	void BuildWorld(CageWorld &world, const CageLevel &level)
+	{
+		BuildCageWorld(world, level, 1, 0);
+		world.m_dt = STEP_DT;
+	}
+}
+
+/******************************************************************************/
+/*!
+	Starting point of the check
+*/
+/******************************************************************************/
+int main(int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: %s <level> [steps] [slots]\n", argv[0]);
+		return 2;
+	}
+
+	unsigned int steps		= (argc > 2) ? (unsigned int)atoi(argv[2]) : 3000;
+	unsigned int slotNum	= (argc > 3) ? (unsigned int)atoi(argv[3]) : 4;
+
+	CageLevel level;
+	if (!ReadCageLevel(level, argv[1]) || level.m_ballNum == 0)
+	{
+		fprintf(stderr, "can't read the level %s\n", argv[1]);
+		return 2;
+	}
+
+	char name[32];
+	sprintf(name, "CageStateCheck_%d", (int)getpid());
+
+	CageWorld published;
+	BuildWorld(published, level);
+
+	// a ring a ball short: nothing goes in
+	StatePublisher publisher;
+	if (!OpenStatePublisher(publisher, name, published.m_ballNum - 1, published.m_ballNum, slotNum))
+	{
+		fprintf(stderr, "can't make the shared memory %s\n", name);
+		FreeCageWorld(published);
+		FreeCageLevel(level);
+		return 2;
+	}
+
+	bool tooSmallOk = !PublishCageWorld(publisher, published) && publisher.m_header->m_published.load() == 0;
+	FreeStatePublisher(publisher);
+
+	OpenStatePublisher(publisher, name, published.m_ballNum, published.m_ballNum, slotNum);
+
+	StateReader reader;
+	if (publisher.m_header == 0 || !OpenStateReader(reader, name))
+	{
+		fprintf(stderr, "can't open the shared memory %s\n", name);
+		FreeStatePublisher(publisher);
+		FreeCageWorld(published);
+		FreeCageLevel(level);
+		return 2;
+	}
+
+	std::atomic<bool> done(false);
+	std::thread writer([&]()
+	{
+		for (unsigned int s = 0; s < steps; ++s)
+		{
+			StepCageWorld(published);
+			PublishCageWorld(publisher, published);
+
+			// lets the reader in on a single core
+			std::this_thread::yield();
+		}
+		done.store(true, std::memory_order_release);
+	});
+
+	// copies of every new step seen, checked once the writer is done (the
+	// reader stepping its own world meanwhile would read a step in a hundred)
+	std::vector<StepCopy> copies;
+	StepCopy copy;
+	unsigned int tornNum = 0;
+	bool last = false;
+
+	while (!last)
+	{
+		// once the writer is done, one more read gets the last step
+		last = done.load(std::memory_order_acquire);
+
+		if (!CopyLatest(reader, copy))
+			++tornNum;
+		else if (copies.empty() || copy.m_step > copies.back().m_step)
+			copies.push_back(copy);
+
+		std::this_thread::yield();
+	}
+
+	writer.join();
+
+	// the reader's own world, through every step; vel is its velocities a
+	// step behind, for the bounces
+	CageWorld own;
+	BuildWorld(own, level);
+
+	std::vector<CSD1130::Vec2> vel(own.m_ballNum);
+	for (unsigned int i = 0; i < own.m_ballNum; ++i)
+		vel[own.m_ballId[i]] = own.m_ballVel[i];
+
+	unsigned int wrongNum = 0, wrongStep = 0;
+	size_t c = 0;
+
+	for (unsigned int s = 0; s < steps && c < copies.size(); ++s)
+	{
+		StepCageWorld(own);
+
+		// the first step has no bounces published: there was no velocity before
+		unsigned int bounces = Bounces(own, vel);
+		if (s == 0)
+			bounces = 0;
+
+		if (copies[c].m_step != s)
+			continue;
+
+		if (!SameBalls(own, copies[c]) || copies[c].m_eventNum + copies[c].m_eventLost != bounces)
+		{
+			if (wrongNum++ == 0)
+				wrongStep = s;
+		}
+		++c;
+	}
+
+	unsigned int readNum = (unsigned int)copies.size();
+	bool allThere = c == copies.size() && readNum > 0 && copies.back().m_step + 1 == steps;
+
+	CloseStateReader(reader);
+	FreeStatePublisher(publisher);
+	FreeCageWorld(own);
+	FreeCageWorld(published);
+	FreeCageLevel(level);
+
+	bool ok = tooSmallOk && wrongNum == 0 && allThere;
+
+	printf("%u steps, %u slots: %u steps read, %u reads torn or not there yet, last step read %u\n", steps, slotNum,
+		readNum, tornNum, readNum ? copies.back().m_step : 0);
+	printf("%s: ring a ball short %s\n", tooSmallOk ? "pass" : "FAIL", tooSmallOk ? "left empty" : "written");
+	if (wrongNum)
+		printf("FAIL: %u steps read differ from the reader's world, first step %u\n", wrongNum, wrongStep);
+	else
+		printf("%s: every step read is the reader's world\n", ok ? "pass" : "FAIL");
+
+	return ok ? 0 : 1;
+}
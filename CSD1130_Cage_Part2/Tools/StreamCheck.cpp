@@ -0,0 +1,158 @@
+/******************************************************************************/
+/*!
+\file		StreamCheck.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 26, 2023
+\brief
+	Checks that a level runs the same with its walls streamed from a wall
+	pack (see WallStream.h) as with its walls in memory: the pack of the
+	walls is written in the directory, and the level is stepped both ways,
+	in float and in fixed point, with and without the ball collisions.
+	Every step, every ball has to be at the same position with the same
+	velocity, bit for bit. The tiles are kept under a small budget, so
+	they are dropped and read again on the way.
+	The rooms are left out both ways: they name walls of the level, a
+	pack level has none.
+
+	StreamCheck <directory> <level> [steps]			(600 steps)
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+	const float			STEP_DT			= 0.01667f;		// as the game steps
+	const float			TILE_SIZE		= 128.0f;
+	const unsigned int	CHECK_BUDGET	= 16;			// KB, a few tiles
+
+	/**************************************************************************/
+	/*!
+		True if the two worlds hold the same balls, bit for bit
+	 */
+	/**************************************************************************/
+	bool SameBalls(const CageWorld &a, const CageWorld &b)
+	{
+		if (a.m_ballNum != b.m_ballNum)
+			return false;
+
+		for (unsigned int i = 0; i < a.m_ballNum; ++i)
+		{
+			if (a.m_ballId[i] != b.m_ballId[i] ||
+				memcmp(&a.m_ballData[i].m_center, &b.m_ballData[i].m_center, sizeof(CSD1130::Vec2)) != 0 ||
+				memcmp(&a.m_ballVel[i], &b.m_ballVel[i], sizeof(CSD1130::Vec2)) != 0)
+				return false;
+		}
+		return true;
+	}
+
+	/**************************************************************************/
+	/*!
+		Steps the level both ways, returns the first step the balls differ
+		at (steps if none)
+	 */
+	/**************************************************************************/
+	unsigned int FirstDifference(const CageLevel &inMemory, const CageLevel &streamed, int fixedPoint, int ballCollisions,
+								unsigned int steps)
+	{
+		CageWorld a, b;
+		BuildCageWorld(a, inMemory, 1, fixedPoint);
+		BuildCageWorld(b, streamed, 1, fixedPoint);
+
+		a.m_dt = b.m_dt = STEP_DT;
+		a.m_ballCollisions = b.m_ballCollisions = ballCollisions;
+
+		unsigned int s = 0;
+		for (; s < steps; ++s)
+		{
+			StepCageWorld(a);
+			StepCageWorld(b);
+
+			if (!SameBalls(a, b))
+				break;
+		}
+
+		FreeCageWorld(a);
+		FreeCageWorld(b);
+		return s;
+	}
+}
+
+/******************************************************************************/
+/*!
+	Starting point of the check
+*/
+/******************************************************************************/
+int main(int argc, char **argv)
+{
+	if (argc < 3)
+	{
+		fprintf(stderr, "usage: %s <directory> <level> [steps]\n", argv[0]);
+		return 2;
+	}
+
+	unsigned int steps = (argc > 3) ? (unsigned int)atoi(argv[3]) : 600;
+
+	CageLevel level;
+	if (!ReadCageLevel(level, argv[2]) || !level.m_packPath.empty())
+	{
+		fprintf(stderr, "can't read the level %s (or its walls are in a pack already)\n", argv[2]);
+		return 2;
+	}
+
+	std::string path = std::string(argv[1]) + "/StreamCheck.pack";
+
+	std::vector<LineSegment> walls(level.m_wallNum);
+	for (unsigned int i = 0; i < level.m_wallNum; ++i)
+		BuildLineSegment(walls[i], level.m_wallPts[i * 2], level.m_wallPts[i * 2 + 1]);
+
+	if (!WriteWallPack(path.c_str(), walls.data(), (unsigned int)walls.size(), TILE_SIZE))
+	{
+		fprintf(stderr, "can't write %s\n", path.c_str());
+		FreeCageLevel(level);
+		return 2;
+	}
+
+	// the level without its rooms, and again with its walls in the pack;
+	// both share the arrays of the level
+	CageLevel inMemory		= level;
+	inMemory.m_roomNum		= 0;
+	inMemory.m_portalNum	= 0;
+
+	CageLevel streamed		= inMemory;
+	streamed.m_wallNum		= 0;
+	streamed.m_packPath		= path;
+	streamed.m_packBudget	= CHECK_BUDGET;
+
+	unsigned int failNum = 0;
+	for (int fixedPoint = 0; fixedPoint < 2; ++fixedPoint)
+	{
+		for (int ballCollisions = 0; ballCollisions < 2; ++ballCollisions)
+		{
+			unsigned int step = FirstDifference(inMemory, streamed, fixedPoint, ballCollisions, steps);
+			if (step == steps)
+				printf("pass: %s, ball collisions %s\n", fixedPoint ? "fixed" : "float", ballCollisions ? "on" : "off");
+			else
+				printf("FAIL: %s, ball collisions %s, streamed balls differ at step %u\n", fixedPoint ? "fixed" : "float",
+					ballCollisions ? "on" : "off", step);
+
+			failNum += (step == steps) ? 0 : 1;
+		}
+	}
+
+	remove(path.c_str());
+	FreeCageLevel(level);
+
+	printf("%s: %u walls streamed x %u steps\n", failNum ? "FAIL" : "pass", (unsigned int)walls.size(), steps);
+	return failNum ? 1 : 0;
+}
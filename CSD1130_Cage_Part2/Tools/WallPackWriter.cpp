@@ -0,0 +1,119 @@
+/******************************************************************************/
+/*!
+\file		WallPackWriter.cpp
+\author 	Ian Chua
+\par    	email: i.chua@digipen.edu
+\date   	April 26, 2023
+\brief
+	Writes the wall pack of a level: its walls cut into tiles (see
+	WriteWallPack), for the level file to name in its wall pack section.
+	The pack is then opened and every wall is looked for in it.
+
+	WallPackWriter <level> <pack> [tileSize]		(256 by default)
+
+Copyright (C) 2023 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "main.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace
+{
+	const float		TILE_SIZE		= 256.0f;
+	const size_t	CHECK_BUDGET	= (size_t)1 << 30;	// every tile fits
+
+	/**************************************************************************/
+	/*!
+		Reads the whole pack back, returns false if a wall is missing or
+		not where it was. The walls come back in id order: grouped by
+		class, in level order inside a class
+	 */
+	/**************************************************************************/
+	bool CheckWallPack(const char *path, std::vector<LineSegment> walls)
+	{
+		std::stable_sort(walls.begin(), walls.end(), [](const LineSegment &a, const LineSegment &b)
+		{
+			return a.m_class < b.m_class;
+		});
+
+		WallStream stream;
+		if (!OpenWallStream(stream, path, CHECK_BUDGET))
+			return false;
+
+		const WallPackHeader &header = stream.m_header;
+		CSD1130::Vec2 boxMin{ header.m_minX, header.m_minY };
+		CSD1130::Vec2 boxMax{ header.m_minX + header.m_tilesX * header.m_tileSize,
+								header.m_minY + header.m_tilesY * header.m_tileSize };
+
+		BeginWallStreamStep(stream);
+		unsigned int num = GatherStreamedWalls(stream, boxMin, boxMax);
+
+		bool ok = (num == walls.size()) && stream.m_failNum == 0;
+		for (unsigned int k = 0; k < num && ok; ++k)
+		{
+			const LineSegment &wall = walls[k];
+			const LineSegment &read = stream.m_gathered[k];
+
+			ok = read.m_pt0.x == wall.m_pt0.x && read.m_pt0.y == wall.m_pt0.y &&
+				read.m_pt1.x == wall.m_pt1.x && read.m_pt1.y == wall.m_pt1.y;
+		}
+
+		printf("%u tiles (%u x %u), %u of %u walls read back\n", stream.m_tileNum, header.m_tilesX, header.m_tilesY, num,
+			(unsigned int)walls.size());
+
+		EndWallStreamStep(stream);
+		FreeWallStream(stream);
+		return ok;
+	}
+}
+
+/******************************************************************************/
+/*!
+	Starting point of the writer
+*/
+/******************************************************************************/
+int main(int argc, char **argv)
+{
+	if (argc < 3)
+	{
+		fprintf(stderr, "usage: %s <level> <pack> [tileSize]\n", argv[0]);
+		return 2;
+	}
+
+	float tileSize = (argc > 3) ? (float)atof(argv[3]) : TILE_SIZE;
+
+	CageLevel level;
+	if (!ReadCageLevel(level, argv[1]))
+	{
+		fprintf(stderr, "can't read the level %s\n", argv[1]);
+		return 2;
+	}
+
+	// the walls in level order, WriteWallPack groups them
+	std::vector<LineSegment> walls(level.m_wallNum);
+	for (unsigned int i = 0; i < level.m_wallNum; ++i)
+		BuildLineSegment(walls[i], level.m_wallPts[i * 2], level.m_wallPts[i * 2 + 1]);
+
+	FreeCageLevel(level);
+
+	if (!WriteWallPack(argv[2], walls.data(), (unsigned int)walls.size(), tileSize))
+	{
+		fprintf(stderr, "can't write %s (tile size %g)\n", argv[2], tileSize);
+		return 1;
+	}
+
+	if (!CheckWallPack(argv[2], walls))
+	{
+		fprintf(stderr, "%s doesn't read back as written\n", argv[2]);
+		return 1;
+	}
+
+	return 0;
+}